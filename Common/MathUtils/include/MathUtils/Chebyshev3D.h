@@ -282,41 +282,45 @@ inline Bool_t Chebyshev3D::isInside(const Double_t* par) const
 /// Evaluates Chebyshev parameterization for 3d->DimOut function
 inline void Chebyshev3D::Eval(const Float_t* par, Float_t* res)
 {
+  Float_t mapped[3];
   for (int i = 3; i--;) {
-    mTemporaryCoefficient[i] = mapToInternal(par[i], i);
+    mapped[i] = mapToInternal(par[i], i);
   }
   for (int i = mOutputArrayDimension; i--;) {
-    res[i] = getChebyshevCalc(i)->Eval(mTemporaryCoefficient);
+    res[i] = getChebyshevCalc(i)->Eval(mapped);
   }
 }
 
 /// Evaluates Chebyshev parameterization for 3d->DimOut function
 inline void Chebyshev3D::Eval(const Double_t* par, Double_t* res)
 {
+  Float_t mapped[3];
   for (int i = 3; i--;) {
-    mTemporaryCoefficient[i] = mapToInternal(par[i], i);
+    mapped[i] = mapToInternal(par[i], i);
   }
   for (int i = mOutputArrayDimension; i--;) {
-    res[i] = getChebyshevCalc(i)->Eval(mTemporaryCoefficient);
+    res[i] = getChebyshevCalc(i)->Eval(mapped);
   }
 }
 
 /// Evaluates Chebyshev parameterization for idim-th output dimension of 3d->DimOut function
 inline Double_t Chebyshev3D::Eval(const Double_t* par, int idim)
 {
+  Float_t mapped[3];
   for (int i = 3; i--;) {
-    mTemporaryCoefficient[i] = mapToInternal(par[i], i);
+    mapped[i] = mapToInternal(par[i], i);
   }
-  return getChebyshevCalc(idim)->Eval(mTemporaryCoefficient);
+  return getChebyshevCalc(idim)->Eval(mapped);
 }
 
 /// Evaluates Chebyshev parameterization for idim-th output dimension of 3d->DimOut function
 inline Float_t Chebyshev3D::Eval(const Float_t* par, int idim)
 {
+  Float_t mapped[3];
   for (int i = 3; i--;) {
-    mTemporaryCoefficient[i] = mapToInternal(par[i], i);
+    mapped[i] = mapToInternal(par[i], i);
   }
-  return getChebyshevCalc(idim)->Eval(mTemporaryCoefficient);
+  return getChebyshevCalc(idim)->Eval(mapped);
 }
 
 /// Returns the gradient matrix
@@ -18,6 +18,7 @@
 
 #include <TNamed.h> // for TNamed
 #include <cstdio>   // for FILE, stdout
+#include <vector>   // for vector
 #include "Rtypes.h" // for Float_t, UShort_t, Int_t, Double_t, etc
 
 class TString;
@@ -190,6 +191,17 @@ class Chebyshev3DCalc : public TNamed
   Float_t* mTemporaryCoefficients2D; //[mNumberOfColumns] temp. coeffs for 2d summation
   Float_t* mTemporaryCoefficients1D; //[mNumberOfRows] temp. coeffs for 1d summation
 
+  /// Scratch space of the calling thread for the summations of Eval, so that the
+  /// same parameterization (e.g. the field map) can be evaluated from several threads
+  static Float_t* getThreadCoefficients(int size)
+  {
+    thread_local std::vector<Float_t> coefs;
+    if (coefs.size() < static_cast<size_t>(size)) {
+      coefs.resize(size);
+    }
+    return coefs.data();
+  }
+
   ClassDefOverride(o2::math_utils::Chebyshev3DCalc,
                    2) // Class for interpolation of 3D->1 function by Chebyshev parametrization
 };
@@ -217,32 +229,36 @@ inline Float_t Chebyshev3DCalc::chebyshevEvaluation1D(Float_t x, const Float_t*
 /// VERY IMPORTANT: par must contain the function arguments ALREADY MAPPED to [-1:1] interval
 inline Float_t Chebyshev3DCalc::Eval(const Float_t* par) const
 {
+  Float_t* coefs1D = getThreadCoefficients(mNumberOfRows + mNumberOfColumns);
+  Float_t* coefs2D = coefs1D + mNumberOfRows;
   for (int id0 = mNumberOfRows; id0--;) {
     int nCLoc = mNumberOfColumnsAtRow[id0]; // number of significant coefs on this row
     int col0 = mColumnAtRowBeginning[id0];  // beginning of local column in the 2D boundary matrix
     for (int id1 = nCLoc; id1--;) {
       int id = id1 + col0;
-      mTemporaryCoefficients2D[id1] = chebyshevEvaluation1D(par[2], mCoefficients + mCoefficientBound2D1[id], mCoefficientBound2D0[id]);
+      coefs2D[id1] = chebyshevEvaluation1D(par[2], mCoefficients + mCoefficientBound2D1[id], mCoefficientBound2D0[id]);
     }
-    mTemporaryCoefficients1D[id0] = chebyshevEvaluation1D(par[1], mTemporaryCoefficients2D, nCLoc);
+    coefs1D[id0] = chebyshevEvaluation1D(par[1], coefs2D, nCLoc);
   }
-  return chebyshevEvaluation1D(par[0], mTemporaryCoefficients1D, mNumberOfRows);
+  return chebyshevEvaluation1D(par[0], coefs1D, mNumberOfRows);
 }
 
 /// Evaluates Chebyshev parameterization for 3D function.
 /// VERY IMPORTANT: par must contain the function arguments ALREADY MAPPED to [-1:1] interval
 inline Double_t Chebyshev3DCalc::Eval(const Double_t* par) const
 {
+  Float_t* coefs1D = getThreadCoefficients(mNumberOfRows + mNumberOfColumns);
+  Float_t* coefs2D = coefs1D + mNumberOfRows;
   for (int id0 = mNumberOfRows; id0--;) {
     int nCLoc = mNumberOfColumnsAtRow[id0]; // number of significant coefs on this row
     int col0 = mColumnAtRowBeginning[id0];  // beginning of local column in the 2D boundary matrix
     for (int id1 = nCLoc; id1--;) {
       int id = id1 + col0;
-      mTemporaryCoefficients2D[id1] = chebyshevEvaluation1D(par[2], mCoefficients + mCoefficientBound2D1[id], mCoefficientBound2D0[id]);
+      coefs2D[id1] = chebyshevEvaluation1D(par[2], mCoefficients + mCoefficientBound2D1[id], mCoefficientBound2D0[id]);
     }
-    mTemporaryCoefficients1D[id0] = chebyshevEvaluation1D(par[1], mTemporaryCoefficients2D, nCLoc);
+    coefs1D[id0] = chebyshevEvaluation1D(par[1], coefs2D, nCLoc);
   }
-  return chebyshevEvaluation1D(par[0], mTemporaryCoefficients1D, mNumberOfRows);
+  return chebyshevEvaluation1D(par[0], coefs1D, mNumberOfRows);
 }
 } // namespace math_utils
 } // namespace o2
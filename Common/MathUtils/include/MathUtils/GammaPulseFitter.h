@@ -0,0 +1,240 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file GammaPulseFitter.h
+/// \brief Least-squares fit of the Gamma-n pulse shape of the calorimeter front-end electronics
+
+#ifndef ALICEO2_MATHUTILS_GAMMAPULSEFITTER_H_
+#define ALICEO2_MATHUTILS_GAMMAPULSEFITTER_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+namespace o2
+{
+namespace math_utils
+{
+
+/// Least-squares fitter of the Gamma-n pulse shape
+///   f(t) = A * x^n * exp(n * (1 - x)), x = (t - t0 + tau) / tau, f(t) = 0 for x <= 0,
+/// whose maximum A is reached at t = t0, to a sequence of samples taken at t = 0, 1, 2, ...
+/// The amplitude A and the time t0 are obtained with a Levenberg-Marquardt solver working on
+/// fixed-size arrays, without any allocation. All the samples have the same weight, the chi2
+/// is the sum of the squared residuals, like for a ROOT fit with the option "W".
+///
+/// The pulses are fitted in batches of NBatch channels iterated in lockstep: the samples of a
+/// batch are transposed so that the loops over the channels, which contain the evaluation of the
+/// shape and of the normal equations, can be vectorised by the compiler.
+template <typename T = float, int NMaxSamples = 64, int NBatch = 8>
+class GammaPulseFitter
+{
+ public:
+  static constexpr T NoLimit = std::numeric_limits<T>::max();
+
+  /// input and result of the fit of one channel
+  struct Pulse {
+    const T* samples = nullptr; ///< samples, sample i being taken at t = i
+    int nSamples = 0;           ///< number of samples (at most NMaxSamples are used)
+    T amp = 0;                  ///< initial value of the amplitude, then fitted amplitude
+    T time = 0;                 ///< initial value of the peak time, then fitted peak time
+    T ampMin = -NoLimit;        ///< lower limit of the amplitude
+    T ampMax = NoLimit;         ///< upper limit of the amplitude
+    T timeMin = -NoLimit;       ///< lower limit of the peak time
+    T timeMax = NoLimit;        ///< upper limit of the peak time
+    T chi2 = 0;                 ///< sum of the squared residuals at the minimum
+    int nIterations = 0;        ///< number of iterations performed
+    bool converged = false;     ///< whether the minimisation converged
+  };
+
+  GammaPulseFitter(T tau, int order) : mTau(tau), mOrder(order) {}
+
+  void setMaxIterations(int n) { mMaxIterations = n; }
+  int getMaxIterations() const { return mMaxIterations; }
+  /// convergence when the amplitude changes by less than ampTolerance * |A| and the time by less than timeTolerance
+  void setTolerances(T ampTolerance, T timeTolerance)
+  {
+    mAmpTolerance = ampTolerance;
+    mTimeTolerance = timeTolerance;
+  }
+  T getTau() const { return mTau; }
+  int getOrder() const { return mOrder; }
+
+  /// value of the pulse shape at time t
+  T shape(T t, T amp, T time) const
+  {
+    T x = (t - time + mTau) / mTau;
+    return x > 0 ? amp * power(x) * std::exp(mOrder * (1 - x)) : 0;
+  }
+
+  /// fit a single pulse, return true if the minimisation converged
+  bool fit(Pulse& pulse) const
+  {
+    fit(&pulse, 1);
+    return pulse.converged;
+  }
+
+  /// fit nPulses pulses, by batches of NBatch
+  void fit(Pulse* pulses, size_t nPulses) const
+  {
+    for (size_t first = 0; first < nPulses; first += NBatch) {
+      fitBatch(pulses + first, std::min(nPulses - first, size_t(NBatch)));
+    }
+  }
+
+ private:
+  /// sums of the normal equations of the linearised problem
+  struct Sums {
+    T chi2[NBatch];
+    T aa[NBatch]; // J_A * J_A
+    T at[NBatch]; // J_A * J_t
+    T tt[NBatch]; // J_t * J_t
+    T ar[NBatch]; // J_A * r
+    T tr[NBatch]; // J_t * r
+  };
+
+  T power(T x) const
+  {
+    T res = 1;
+    for (int i = 0; i < mOrder; i++) {
+      res *= x;
+    }
+    return res;
+  }
+
+  static T clamp(T val, T min, T max) { return val < min ? min : (val > max ? max : val); }
+
+  /// evaluate chi2 and normal equations at (amp, time) for all channels of the batch
+  void evaluate(const T (&y)[NMaxSamples][NBatch], const T (&w)[NMaxSamples][NBatch], int nSamples,
+                const T (&amp)[NBatch], const T (&time)[NBatch], Sums& sums) const
+  {
+    sums = Sums{};
+    const T invTau = 1 / mTau;
+    for (int i = 0; i < nSamples; i++) {
+      for (int c = 0; c < NBatch; c++) {
+        T x = (i - time[c] + mTau) * invTau;
+        bool positive = x > 0;
+        T xs = positive ? x : T(1);
+        T g = positive ? power(xs) * std::exp(mOrder * (1 - xs)) : T(0);
+        T ja = g;                                           // df/dA
+        T jt = amp[c] * g * mOrder * invTau * (1 - 1 / xs); // df/dt0
+        T r = w[i][c] * (y[i][c] - amp[c] * g);
+        ja *= w[i][c];
+        jt *= w[i][c];
+        sums.chi2[c] += r * r;
+        sums.aa[c] += ja * ja;
+        sums.at[c] += ja * jt;
+        sums.tt[c] += jt * jt;
+        sums.ar[c] += ja * r;
+        sums.tr[c] += jt * r;
+      }
+    }
+  }
+
+  void fitBatch(Pulse* pulses, size_t nPulses) const
+  {
+    // transpose the samples, unused samples and channels have weight 0
+    T y[NMaxSamples][NBatch] = {}, w[NMaxSamples][NBatch] = {};
+    T amp[NBatch], time[NBatch], trialAmp[NBatch], trialTime[NBatch], lambda[NBatch];
+    bool active[NBatch];
+    int nSamples = 0;
+    for (int c = 0; c < NBatch; c++) {
+      active[c] = size_t(c) < nPulses;
+      amp[c] = active[c] ? clamp(pulses[c].amp, pulses[c].ampMin, pulses[c].ampMax) : T(0);
+      time[c] = active[c] ? clamp(pulses[c].time, pulses[c].timeMin, pulses[c].timeMax) : T(0);
+      lambda[c] = T(1.e-3);
+      if (!active[c]) {
+        continue;
+      }
+      int n = std::min(pulses[c].nSamples, NMaxSamples);
+      nSamples = std::max(nSamples, n);
+      for (int i = 0; i < n; i++) {
+        y[i][c] = pulses[c].samples[i];
+        w[i][c] = 1;
+      }
+      pulses[c].nIterations = 0;
+      pulses[c].converged = false;
+    }
+
+    Sums current, trial;
+    evaluate(y, w, nSamples, amp, time, current);
+    for (int iter = 0; iter < mMaxIterations; iter++) {
+      // new trial point from the damped normal equations
+      bool anyActive = false;
+      for (int c = 0; c < NBatch; c++) {
+        trialAmp[c] = amp[c];
+        trialTime[c] = time[c];
+        if (!active[c]) {
+          continue;
+        }
+        T m11 = current.aa[c] * (1 + lambda[c]), m22 = current.tt[c] * (1 + lambda[c]), m12 = current.at[c];
+        T det = m11 * m22 - m12 * m12;
+        if (!(std::abs(det) > std::numeric_limits<T>::min())) { // degenerate problem, e.g. no sample above the baseline
+          active[c] = false;
+          continue;
+        }
+        trialAmp[c] = clamp(amp[c] + (current.ar[c] * m22 - current.tr[c] * m12) / det, pulses[c].ampMin, pulses[c].ampMax);
+        trialTime[c] = clamp(time[c] + (current.tr[c] * m11 - current.ar[c] * m12) / det, pulses[c].timeMin, pulses[c].timeMax);
+        anyActive = true;
+      }
+      if (!anyActive) {
+        break;
+      }
+      evaluate(y, w, nSamples, trialAmp, trialTime, trial);
+      for (int c = 0; c < NBatch; c++) {
+        if (!active[c]) {
+          continue;
+        }
+        pulses[c].nIterations++;
+        if (trial.chi2[c] <= current.chi2[c]) { // accept the step and move towards Gauss-Newton
+          T dAmp = trialAmp[c] - amp[c], dTime = trialTime[c] - time[c];
+          amp[c] = trialAmp[c];
+          time[c] = trialTime[c];
+          current.chi2[c] = trial.chi2[c];
+          current.aa[c] = trial.aa[c];
+          current.at[c] = trial.at[c];
+          current.tt[c] = trial.tt[c];
+          current.ar[c] = trial.ar[c];
+          current.tr[c] = trial.tr[c];
+          lambda[c] = std::max(lambda[c] * T(0.1), T(1.e-7));
+          if (std::abs(dAmp) <= mAmpTolerance * std::max(std::abs(amp[c]), T(1)) && std::abs(dTime) <= mTimeTolerance) {
+            pulses[c].converged = true;
+            active[c] = false;
+          }
+        } else { // reject the step and move towards steepest descent
+          lambda[c] *= 10;
+          if (lambda[c] > T(1.e7)) { // no improvement possible anymore, we are at the minimum
+            pulses[c].converged = true;
+            active[c] = false;
+          }
+        }
+      }
+    }
+
+    for (size_t c = 0; c < nPulses; c++) {
+      pulses[c].amp = amp[c];
+      pulses[c].time = time[c];
+      pulses[c].chi2 = current.chi2[c];
+    }
+  }
+
+  T mTau;                   ///< time constant of the shape, in units of the sample spacing
+  int mOrder;               ///< order n of the shape
+  int mMaxIterations = 50;  ///< max. number of iterations
+  T mAmpTolerance = 1.e-5;  ///< relative amplitude tolerance
+  T mTimeTolerance = 1.e-5; ///< absolute time tolerance
+};
+
+} // namespace math_utils
+} // namespace o2
+
+#endif
@@ -0,0 +1,91 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testGammaPulseFitter.cxx
+/// \brief This task tests the GammaPulseFitter against the TMinuit fit of the same function
+
+#define BOOST_TEST_MODULE Test MathUtils GammaPulseFitter
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <random>
+#include <vector>
+#include "TF1.h"
+#include "TGraph.h"
+#include "TMath.h"
+#include "MathUtils/GammaPulseFitter.h"
+
+using Fitter = o2::math_utils::GammaPulseFitter<double, 32>;
+
+constexpr double Tau = 2.35;
+constexpr int Order = 2;
+
+double response(double* x, double* par)
+{
+  double xx = (x[0] - par[1] + par[2]) / par[2];
+  return xx <= 0 ? 0. : par[0] * TMath::Power(xx, par[3]) * TMath::Exp(par[3] * (1 - xx));
+}
+
+BOOST_AUTO_TEST_CASE(GammaPulseFitter_test)
+{
+  Fitter fitter(Tau, Order);
+  std::mt19937 gen(4242);
+  std::normal_distribution<double> noise(0., 2.);
+  std::uniform_real_distribution<double> ampDist(20., 800.), timeDist(4., 8.);
+
+  const int nPulses = 50, nSamples = 15;
+  std::vector<std::vector<double>> samples(nPulses, std::vector<double>(nSamples));
+  std::vector<Fitter::Pulse> pulses(nPulses);
+  for (int ip = 0; ip < nPulses; ip++) {
+    double amp = ampDist(gen), time = timeDist(gen);
+    for (int i = 0; i < nSamples; i++) {
+      samples[ip][i] = fitter.shape(i, amp, time) + noise(gen);
+    }
+    auto& pulse = pulses[ip];
+    pulse.samples = samples[ip].data();
+    pulse.nSamples = nSamples;
+    pulse.amp = 1.1 * amp;
+    pulse.time = time - 0.5;
+    pulse.ampMin = 0.5 * pulse.amp;
+    pulse.ampMax = 2 * pulse.amp;
+    pulse.timeMin = pulse.time - 4;
+    pulse.timeMax = pulse.time + 4;
+  }
+  const auto initial = pulses;
+  auto single = pulses;
+  fitter.fit(pulses.data(), pulses.size());
+
+  TF1 signalF("signal", response, 0, nSamples, 4);
+  for (int ip = 0; ip < nPulses; ip++) {
+    // same result for the fit alone and in a batch
+    fitter.fit(single[ip]);
+    BOOST_CHECK(pulses[ip].converged);
+    BOOST_CHECK_EQUAL(pulses[ip].amp, single[ip].amp);
+    BOOST_CHECK_EQUAL(pulses[ip].time, single[ip].time);
+
+    // compatible with the TMinuit fit
+    TGraph gSig(nSamples);
+    for (int i = 0; i < nSamples; i++) {
+      gSig.SetPoint(i, i, samples[ip][i]);
+    }
+    // same starting values and limits
+    signalF.SetParameters(initial[ip].amp, initial[ip].time, Tau, Order);
+    signalF.FixParameter(2, Tau);
+    signalF.FixParameter(3, Order);
+    signalF.SetParLimits(0, initial[ip].ampMin, initial[ip].ampMax);
+    signalF.SetParLimits(1, initial[ip].timeMin, initial[ip].timeMax);
+    int status = gSig.Fit(&signalF, "QROW");
+    BOOST_REQUIRE_EQUAL(status, 0);
+    BOOST_CHECK_CLOSE(pulses[ip].amp, signalF.GetParameter(0), 0.1);
+    BOOST_CHECK_SMALL(pulses[ip].time - signalF.GetParameter(1), 1.e-2);
+    BOOST_CHECK_CLOSE(pulses[ip].chi2, signalF.GetChisquare(), 0.1);
+  }
+}
@@ -45,6 +45,7 @@ struct SimConfigData {
   int mInternalChunkSize;                    //
   int mStartSeed;                            // base for random number seeds
   int mSimWorkers = 1;                       // number of parallel sim workers (when it applies)
+  int mGenWorkers = 1;                       // number of parallel event generator instances (when it applies)
   bool mFilterNoHitEvents = false;           // whether to filter out events not leaving any response
   std::string mCCDBUrl;                      // the URL where to find CCDB
   long mTimestamp;                           // timestamp to anchor transport simulation to
@@ -52,7 +53,7 @@ struct SimConfigData {
   bool mUniformField = false;                // uniform magnetic field
   bool mAsService = false;                   // if simulation should be run as service/deamon (does not exit after run)
 
-  ClassDefNV(SimConfigData, 4);
+  ClassDefNV(SimConfigData, 5);
 };
 
 // A singleton class which can be used
@@ -113,6 +114,7 @@ class SimConfig
   int getInternalChunkSize() const { return mConfigData.mInternalChunkSize; }
   int getStartSeed() const { return mConfigData.mStartSeed; }
   int getNSimWorkers() const { return mConfigData.mSimWorkers; }
+  int getNGenWorkers() const { return mConfigData.mGenWorkers; }
   bool isFilterOutNoHitEvents() const { return mConfigData.mFilterNoHitEvents; }
   bool asService() const { return mConfigData.mAsService; }
 
@@ -47,6 +47,7 @@ void SimConfig::initOptions(boost::program_options::options_description& options
     "seed", bpo::value<int>()->default_value(-1), "initial seed (default: -1 random)")(
     "field", bpo::value<std::string>()->default_value("-5"), "L3 field rounded to kGauss, allowed values +-2,+-5 and 0; +-5U for uniform field ")(
     "nworkers,j", bpo::value<int>()->default_value(nsimworkersdefault), "number of parallel simulation workers (only for parallel mode)")(
+    "nGenWorkers", bpo::value<int>()->default_value(1), "number of generator instances pre-generating events in the primary server (only for parallel mode)")(
     "noemptyevents", "only writes events with at least one hit")(
     "CCDBUrl", bpo::value<std::string>()->default_value("ccdb-test.cern.ch:8080"), "URL for CCDB to be used.")(
     "timestamp", bpo::value<long>()->default_value(-1), "global timestamp value (for anchoring) - default is now")(
@@ -106,6 +107,7 @@ bool SimConfig::resetFromParsedMap(boost::program_options::variables_map const&
   mConfigData.mInternalChunkSize = vm["chunkSizeI"].as<int>();
   mConfigData.mStartSeed = vm["seed"].as<int>();
   mConfigData.mSimWorkers = vm["nworkers"].as<int>();
+  mConfigData.mGenWorkers = vm["nGenWorkers"].as<int>();
   mConfigData.mTimestamp = vm["timestamp"].as<long>();
   mConfigData.mCCDBUrl = vm["CCDBUrl"].as<std::string>();
   mConfigData.mAsService = vm["asservice"].as<bool>();
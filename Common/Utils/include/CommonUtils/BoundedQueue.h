@@ -0,0 +1,137 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file BoundedQueue.h
+/// \brief Blocking FIFO of limited capacity to hand over work between producer and consumer threads
+
+#ifndef ALICEO2_UTILS_BOUNDEDQUEUE_H_
+#define ALICEO2_UTILS_BOUNDEDQUEUE_H_
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace o2
+{
+namespace utils
+{
+
+/*
+ BoundedQueue: thread-safe FIFO with a maximum capacity.
+
+ push() blocks the producer while the queue is full (backpressure), pop() blocks the consumer
+ while it is empty. Once close() was called the pending items can still be popped, after which
+ pop() returns false, which is the signal for the consumer thread to exit.
+
+ ```C++
+  BoundedQueue<Item> queue(4);
+  std::thread consumer([&queue]() { Item it; while (queue.pop(it)) { process(it); } });
+  queue.push(std::move(item)); // blocks if 4 items are pending
+  queue.close();
+  consumer.join();
+ ```
+*/
+template <typename T>
+class BoundedQueue
+{
+ public:
+  explicit BoundedQueue(size_t capacity = 1) : mCapacity(capacity > 0 ? capacity : 1) {}
+  BoundedQueue(const BoundedQueue&) = delete;
+  BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+  /// add new item, waiting for free space if needed; returns false if the queue was closed
+  bool push(T&& item)
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mNotFull.wait(lock, [this]() { return mClosed || mItems.size() < mCapacity; });
+    if (mClosed) {
+      return false;
+    }
+    mItems.emplace_back(std::move(item));
+    lock.unlock();
+    mNotEmpty.notify_one();
+    return true;
+  }
+
+  /// extract the oldest item, waiting for it if needed; returns false if the queue is closed and drained
+  bool pop(T& item)
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mNotEmpty.wait(lock, [this]() { return mClosed || !mItems.empty(); });
+    if (mItems.empty()) {
+      return false;
+    }
+    item = std::move(mItems.front());
+    mItems.pop_front();
+    lock.unlock();
+    mNotFull.notify_one();
+    return true;
+  }
+
+  /// extract the oldest item if available, never blocks
+  bool tryPop(T& item)
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (mItems.empty()) {
+      return false;
+    }
+    item = std::move(mItems.front());
+    mItems.pop_front();
+    lock.unlock();
+    mNotFull.notify_one();
+    return true;
+  }
+
+  /// refuse further pushes and wake up all waiting threads
+  void close()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mClosed = true;
+    }
+    mNotFull.notify_all();
+    mNotEmpty.notify_all();
+  }
+
+  /// block until the consumer has taken all pending items
+  void waitEmpty()
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mNotFull.wait(lock, [this]() { return mItems.empty(); });
+  }
+
+  size_t size() const
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mItems.size();
+  }
+
+  bool isClosed() const
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mClosed;
+  }
+
+  size_t getCapacity() const { return mCapacity; }
+
+ private:
+  size_t mCapacity = 1;
+  bool mClosed = false;
+  std::deque<T> mItems;
+  mutable std::mutex mMutex;
+  std::condition_variable mNotFull;
+  std::condition_variable mNotEmpty;
+};
+
+} // namespace utils
+} // namespace o2
+
+#endif
@@ -20,6 +20,7 @@
 #define COMMON_UTILS_INCLUDE_COMMONUTILS_RNGHELPER_H_
 
 #include <TRandom.h>
+#include <TRandom3.h>
 #include <fcntl.h>
 
 namespace o2
@@ -61,6 +62,26 @@ class RngHelper
   }
 };
 
+// a TRandom which dispatches to one TRandom3 engine per thread;
+// when installed as gRandom, code running concurrently in several threads (such as
+// event generators) draws independent sequences which can be seeded per thread
+class ThreadLocalRandom : public TRandom
+{
+ public:
+  Double_t Rndm() override { return engine().Rndm(); }
+  void RndmArray(Int_t n, Float_t* array) override { engine().RndmArray(n, array); }
+  void RndmArray(Int_t n, Double_t* array) override { engine().RndmArray(n, array); }
+  void SetSeed(ULong_t seed = 0) override { engine().SetSeed(seed); }
+  UInt_t GetSeed() const override { return engine().GetSeed(); }
+
+ private:
+  static TRandom3& engine()
+  {
+    thread_local TRandom3 rng;
+    return rng;
+  }
+};
+
 } // namespace utils
 } // namespace o2
 
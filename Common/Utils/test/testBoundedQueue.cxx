@@ -0,0 +1,58 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   testBoundedQueue.cxx
+/// @brief  unit tests for the BoundedQueue producer/consumer FIFO
+
+#define BOOST_TEST_MODULE BoundedQueue unit test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <thread>
+#include <vector>
+#include "CommonUtils/BoundedQueue.h"
+
+using o2::utils::BoundedQueue;
+
+BOOST_AUTO_TEST_CASE(test_bounded_queue_order)
+{
+  const int nItems = 1000;
+  BoundedQueue<int> queue(3);
+  std::vector<int> received;
+  std::thread consumer([&queue, &received]() {
+    int v;
+    while (queue.pop(v)) {
+      received.push_back(v);
+    }
+  });
+  for (int i = 0; i < nItems; i++) {
+    BOOST_CHECK(queue.size() <= queue.getCapacity());
+    BOOST_CHECK(queue.push(int(i)));
+  }
+  queue.close();
+  consumer.join();
+  BOOST_REQUIRE(received.size() == nItems);
+  for (int i = 0; i < nItems; i++) {
+    BOOST_CHECK(received[i] == i);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_bounded_queue_close)
+{
+  BoundedQueue<int> queue(2);
+  BOOST_CHECK(queue.push(1));
+  queue.close();
+  BOOST_CHECK(!queue.push(2));
+  int v = 0;
+  BOOST_CHECK(queue.pop(v) && v == 1); // pending items are still delivered
+  BOOST_CHECK(!queue.pop(v));
+  BOOST_CHECK(!queue.tryPop(v));
+}
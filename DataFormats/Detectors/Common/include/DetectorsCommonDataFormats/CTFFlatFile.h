@@ -0,0 +1,140 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file CTFFlatFile.h
+/// \brief Flat (non-ROOT) container for the CTF data
+
+#ifndef ALICEO2_CTF_FLATFILE_H
+#define ALICEO2_CTF_FLATFILE_H
+
+#include <array>
+#include <string>
+#include <vector>
+#include <gsl/span>
+#include "DetectorsCommonDataFormats/CTFHeader.h"
+#include "DetectorsCommonDataFormats/DetID.h"
+#include "DetectorsCommonDataFormats/EncodedBlocks.h"
+
+namespace o2
+{
+namespace ctf
+{
+
+/// Layout of the flat CTF file:
+/// CTFFlatFileHeader followed by the sequence of entries (1 entry per TF). Every entry consists of
+/// CTFFlatEntryHeader, table of CTFFlatBlockInfo (1 per stored detector) and the flat EncodedBlocks
+/// images of the detectors, each aligned to o2::ctf::Alignment w.r.t. the file start. Since the images
+/// are stored exactly as they are sent by the encoders, the file can be memory-mapped and the images
+/// used in place.
+
+struct CTFFlatFileHeader {
+  static constexpr uint64_t MAGIC = 0x4c46465443324f; // "O2CTFFL"
+  static constexpr uint32_t VERSION = 1;
+  uint64_t magic = MAGIC;
+  uint32_t version = VERSION;
+  uint32_t headerSize = sizeof(CTFFlatFileHeader);
+};
+
+struct CTFFlatEntryHeader {
+  static constexpr uint32_t MAGIC = 0x45465443; // "CTFE"
+  uint32_t magic = MAGIC;
+  uint32_t nBlocks = 0;      // number of detector images in the entry
+  uint64_t run = 0;          // run number
+  uint32_t firstTForbit = 0; // 1st orbit of the TF
+  uint32_t tfCounter = 0;    // TF counter
+  uint32_t detectors = 0;    // mask of stored detectors
+  uint32_t reserved = 0;
+  uint64_t entrySize = 0; // total size of the entry including this header and the padding
+
+  CTFHeader getCTFHeader() const { return CTFHeader{run, firstTForbit, o2::detectors::DetID::mask_t(detectors)}; }
+};
+
+struct CTFFlatBlockInfo {
+  uint32_t detID = 0;
+  uint32_t reserved = 0;
+  uint64_t offset = 0; // offset of the image w.r.t. the entry start
+  uint64_t size = 0;   // size of the image in bytes
+};
+
+/// sequential writer of the flat CTF file
+class CTFFlatFileWriter
+{
+ public:
+  using Images = std::array<gsl::span<const BufferType>, o2::detectors::DetID::nDetectors>;
+
+  CTFFlatFileWriter() = default;
+  CTFFlatFileWriter(const CTFFlatFileWriter&) = delete;
+  CTFFlatFileWriter& operator=(const CTFFlatFileWriter&) = delete;
+  ~CTFFlatFileWriter() { close(); }
+
+  void open(const std::string& fileName);
+  void close();
+  bool isOpen() const { return mFD >= 0; }
+
+  /// write entry made of the CTFHeader and flat EncodedBlocks images of the detectors (indexed by DetID,
+  /// empty spans are skipped), return the number of bytes written
+  size_t writeEntry(const CTFHeader& header, uint32_t tfCounter, const Images& images);
+
+  const std::string& getFileName() const { return mFileName; }
+  size_t getSize() const { return mSize; }
+  size_t getNEntries() const { return mNEntries; }
+
+ private:
+  void writeRaw(const void* ptr, size_t sz);
+  void writePadding(size_t sz);
+
+  int mFD = -1;
+  size_t mSize = 0;
+  size_t mNEntries = 0;
+  std::string mFileName;
+};
+
+/// reader of the flat CTF file: the file is memory-mapped and the detector images are provided in place
+class CTFFlatFileReader
+{
+ public:
+  CTFFlatFileReader() = default;
+  CTFFlatFileReader(const CTFFlatFileReader&) = delete;
+  CTFFlatFileReader& operator=(const CTFFlatFileReader&) = delete;
+  ~CTFFlatFileReader() { close(); }
+
+  /// check if the file starts with the flat CTF file signature
+  static bool isFlatFile(const std::string& fileName);
+
+  void open(const std::string& fileName);
+  void close();
+  bool isOpen() const { return mData != nullptr; }
+
+  size_t getNEntries() const { return mEntries.size(); }
+  const CTFFlatEntryHeader& getEntryHeader(size_t entry) const { return *reinterpret_cast<const CTFFlatEntryHeader*>(mData + mEntries[entry]); }
+  CTFHeader getCTFHeader(size_t entry) const { return getEntryHeader(entry).getCTFHeader(); }
+
+  /// image of the detector EncodedBlocks in the mapped memory, empty if the detector is not stored.
+  /// The mapping is private, i.e. eventual modifications of the image are not propagated to the file
+  gsl::span<BufferType> getImage(size_t entry, o2::detectors::DetID det) const;
+
+  /// advise the kernel to start reading the entry in the background
+  void prefetch(size_t entry) const;
+
+  const std::string& getFileName() const { return mFileName; }
+  size_t getSize() const { return mSize; }
+
+ private:
+  BufferType* mData = nullptr;
+  size_t mSize = 0;
+  std::vector<size_t> mEntries; // offsets of the entries
+  std::string mFileName;
+};
+
+} // namespace ctf
+} // namespace o2
+
+#endif
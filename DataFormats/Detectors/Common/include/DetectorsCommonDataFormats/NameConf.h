@@ -100,8 +100,11 @@ class NameConf : public o2::conf::ConfigurableParamHelper<NameConf>
   // CTF tree name
   static constexpr std::string_view CTFTREENAME = "ctf"; // hardcoded
 
+  // extension of the flat (non-ROOT) CTF files
+  static constexpr std::string_view CTFFLATEXT = "ctf"; // hardcoded
+
   // CTF Filename
-  static std::string getCTFFileName(uint32_t run, uint32_t orb, uint32_t id, const std::string_view prefix = "o2_ctf");
+  static std::string getCTFFileName(uint32_t run, uint32_t orb, uint32_t id, const std::string_view prefix = "o2_ctf", const std::string_view ext = ROOT_EXT_STRING);
 
   // CTF Dictionary
   static std::string getCTFDictFileName();
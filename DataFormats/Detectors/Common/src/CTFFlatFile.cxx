@@ -0,0 +1,210 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file CTFFlatFile.cxx
+/// \brief Flat (non-ROOT) container for the CTF data
+
+#include "DetectorsCommonDataFormats/CTFFlatFile.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+using namespace o2::ctf;
+using DetID = o2::detectors::DetID;
+
+//___________________________________________________________________
+void CTFFlatFileWriter::open(const std::string& fileName)
+{
+  close();
+  mFD = ::open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (mFD < 0) {
+    throw std::runtime_error(fmt::format("Failed to open flat CTF file {}: {}", fileName, std::strerror(errno)));
+  }
+  mFileName = fileName;
+  mSize = 0;
+  mNEntries = 0;
+  CTFFlatFileHeader fileHeader;
+  writeRaw(&fileHeader, sizeof(fileHeader));
+  writePadding(alignSize(mSize) - mSize);
+}
+
+//___________________________________________________________________
+void CTFFlatFileWriter::close()
+{
+  if (mFD >= 0) {
+    ::close(mFD);
+    mFD = -1;
+  }
+}
+
+//___________________________________________________________________
+size_t CTFFlatFileWriter::writeEntry(const CTFHeader& header, uint32_t tfCounter, const Images& images)
+{
+  if (!isOpen()) {
+    throw std::runtime_error("Flat CTF file is not open");
+  }
+  CTFFlatEntryHeader entryHeader;
+  entryHeader.run = header.run;
+  entryHeader.firstTForbit = header.firstTForbit;
+  entryHeader.tfCounter = tfCounter;
+  std::vector<CTFFlatBlockInfo> blocks;
+  for (int id = DetID::First; id <= DetID::Last; id++) {
+    if (!images[id].empty()) {
+      blocks.push_back(CTFFlatBlockInfo{uint32_t(id), 0, 0, images[id].size()});
+      entryHeader.detectors |= DetID::getMask(id).to_ulong();
+    }
+  }
+  entryHeader.nBlocks = blocks.size();
+  // the entry starts at aligned position, assign aligned offsets to the images
+  size_t offs = alignSize(sizeof(CTFFlatEntryHeader) + blocks.size() * sizeof(CTFFlatBlockInfo));
+  for (auto& bl : blocks) {
+    bl.offset = offs;
+    offs += alignSize(bl.size);
+  }
+  entryHeader.entrySize = offs;
+
+  auto entryStart = mSize;
+  writeRaw(&entryHeader, sizeof(entryHeader));
+  writeRaw(blocks.data(), blocks.size() * sizeof(CTFFlatBlockInfo));
+  for (const auto& bl : blocks) {
+    writePadding(entryStart + bl.offset - mSize);
+    writeRaw(images[bl.detID].data(), bl.size);
+  }
+  writePadding(entryStart + entryHeader.entrySize - mSize);
+  mNEntries++;
+  return entryHeader.entrySize;
+}
+
+//___________________________________________________________________
+void CTFFlatFileWriter::writeRaw(const void* ptr, size_t sz)
+{
+  auto* cptr = reinterpret_cast<const char*>(ptr);
+  while (sz) {
+    auto res = ::write(mFD, cptr, sz);
+    if (res < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error(fmt::format("Failed to write to flat CTF file {}: {}", mFileName, std::strerror(errno)));
+    }
+    cptr += res;
+    sz -= res;
+    mSize += res;
+  }
+}
+
+//___________________________________________________________________
+void CTFFlatFileWriter::writePadding(size_t sz)
+{
+  static const char zeros[Alignment] = {0};
+  while (sz) {
+    size_t chunk = std::min(sz, sizeof(zeros));
+    writeRaw(zeros, chunk);
+    sz -= chunk;
+  }
+}
+
+//___________________________________________________________________
+bool CTFFlatFileReader::isFlatFile(const std::string& fileName)
+{
+  CTFFlatFileHeader fileHeader;
+  int fd = ::open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  auto res = ::read(fd, &fileHeader, sizeof(fileHeader));
+  ::close(fd);
+  return res == sizeof(fileHeader) && fileHeader.magic == CTFFlatFileHeader::MAGIC;
+}
+
+//___________________________________________________________________
+void CTFFlatFileReader::open(const std::string& fileName)
+{
+  close();
+  int fd = ::open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error(fmt::format("Failed to open flat CTF file {}: {}", fileName, std::strerror(errno)));
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(CTFFlatFileHeader)) {
+    ::close(fd);
+    throw std::runtime_error(fmt::format("Flat CTF file {} is too short or not accessible", fileName));
+  }
+  mSize = st.st_size;
+  // private writable mapping: the decoders get non-const buffers, eventual writes stay in the process
+  void* ptr = mmap(nullptr, mSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  ::close(fd); // the mapping stays valid
+  if (ptr == MAP_FAILED) {
+    mSize = 0;
+    throw std::runtime_error(fmt::format("Failed to map flat CTF file {}: {}", fileName, std::strerror(errno)));
+  }
+  mData = reinterpret_cast<BufferType*>(ptr);
+  mFileName = fileName;
+  madvise(mData, mSize, MADV_SEQUENTIAL);
+
+  const auto& fileHeader = *reinterpret_cast<const CTFFlatFileHeader*>(mData);
+  if (fileHeader.magic != CTFFlatFileHeader::MAGIC || fileHeader.version > CTFFlatFileHeader::VERSION) {
+    close();
+    throw std::runtime_error(fmt::format("File {} is not a flat CTF file of supported version", fileName));
+  }
+  // build the index of entries
+  size_t offs = alignSize(fileHeader.headerSize);
+  while (offs + sizeof(CTFFlatEntryHeader) <= mSize) {
+    const auto& entryHeader = *reinterpret_cast<const CTFFlatEntryHeader*>(mData + offs);
+    if (entryHeader.magic != CTFFlatEntryHeader::MAGIC || entryHeader.entrySize == 0 || offs + entryHeader.entrySize > mSize) {
+      LOGP(ERROR, "Corrupted entry {} at offset {} in flat CTF file {}, ignoring the rest", mEntries.size(), offs, fileName);
+      break;
+    }
+    mEntries.push_back(offs);
+    offs += entryHeader.entrySize;
+  }
+}
+
+//___________________________________________________________________
+void CTFFlatFileReader::close()
+{
+  if (mData) {
+    munmap(mData, mSize);
+    mData = nullptr;
+  }
+  mSize = 0;
+  mEntries.clear();
+}
+
+//___________________________________________________________________
+gsl::span<BufferType> CTFFlatFileReader::getImage(size_t entry, DetID det) const
+{
+  auto* entryStart = mData + mEntries[entry];
+  const auto& entryHeader = *reinterpret_cast<const CTFFlatEntryHeader*>(entryStart);
+  const auto* blocks = reinterpret_cast<const CTFFlatBlockInfo*>(entryStart + sizeof(CTFFlatEntryHeader));
+  for (uint32_t ib = 0; ib < entryHeader.nBlocks; ib++) {
+    if (blocks[ib].detID == uint32_t(det)) {
+      return gsl::span<BufferType>(entryStart + blocks[ib].offset, blocks[ib].size);
+    }
+  }
+  return {};
+}
+
+//___________________________________________________________________
+void CTFFlatFileReader::prefetch(size_t entry) const
+{
+  // madvise requires page-aligned start
+  static const size_t pageSize = sysconf(_SC_PAGESIZE);
+  size_t start = mEntries[entry], end = start + getEntryHeader(entry).entrySize;
+  start -= start % pageSize;
+  madvise(mData + start, end - start, MADV_WILLNEED);
+}
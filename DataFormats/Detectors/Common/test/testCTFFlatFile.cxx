@@ -0,0 +1,71 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test CTFFlatFile
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "DetectorsCommonDataFormats/CTFFlatFile.h"
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+using namespace o2::ctf;
+using DetID = o2::detectors::DetID;
+
+BOOST_AUTO_TEST_CASE(CTFFlatFileTest)
+{
+  const std::string fileName = "test_ctf_flat_file.ctf";
+  const int nEntries = 3;
+  std::vector<std::vector<BufferType>> payloads;
+  payloads.reserve(2 * nEntries);
+  {
+    CTFFlatFileWriter writer;
+    writer.open(fileName);
+    for (int ie = 0; ie < nEntries; ie++) {
+      CTFFlatFileWriter::Images images;
+      auto& its = payloads.emplace_back(100 + 37 * ie);
+      auto& tpc = payloads.emplace_back(1000 + 3 * ie);
+      for (size_t i = 0; i < its.size(); i++) {
+        its[i] = BufferType(i + ie);
+      }
+      for (size_t i = 0; i < tpc.size(); i++) {
+        tpc[i] = BufferType(3 * i + ie);
+      }
+      images[DetID::ITS] = gsl::span<const BufferType>(its.data(), its.size());
+      images[DetID::TPC] = gsl::span<const BufferType>(tpc.data(), tpc.size());
+      CTFHeader header{1234, uint32_t(256 * ie)};
+      writer.writeEntry(header, ie, images);
+    }
+    BOOST_CHECK(writer.getNEntries() == nEntries);
+  }
+
+  BOOST_CHECK(CTFFlatFileReader::isFlatFile(fileName));
+  CTFFlatFileReader reader;
+  reader.open(fileName);
+  BOOST_REQUIRE(reader.getNEntries() == nEntries);
+  for (int ie = 0; ie < nEntries; ie++) {
+    reader.prefetch(ie);
+    const auto& eh = reader.getEntryHeader(ie);
+    BOOST_CHECK(eh.run == 1234 && eh.firstTForbit == 256 * ie && eh.tfCounter == ie && eh.nBlocks == 2);
+    BOOST_CHECK(eh.detectors == (DetID::getMask(DetID::ITS) | DetID::getMask(DetID::TPC)).to_ulong());
+    auto its = reader.getImage(ie, DetID::ITS);
+    auto tpc = reader.getImage(ie, DetID::TPC);
+    BOOST_CHECK(reader.getImage(ie, DetID::TRD).empty());
+    BOOST_CHECK((reinterpret_cast<size_t>(its.data()) % Alignment) == 0);
+    BOOST_CHECK((reinterpret_cast<size_t>(tpc.data()) % Alignment) == 0);
+    BOOST_REQUIRE(its.size() == payloads[2 * ie].size() && tpc.size() == payloads[2 * ie + 1].size());
+    BOOST_CHECK(std::equal(its.begin(), its.end(), payloads[2 * ie].begin()));
+    BOOST_CHECK(std::equal(tpc.begin(), tpc.end(), payloads[2 * ie + 1].begin()));
+  }
+  reader.close();
+  std::remove(fileName.c_str());
+}
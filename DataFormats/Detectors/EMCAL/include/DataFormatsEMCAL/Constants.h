@@ -104,7 +104,8 @@ enum FitAlgorithm {
   Standard = 0,  ///< Standard raw fitter
   Gamma2 = 1,    ///< Gamma2 raw fitter
   NeuralNet = 2, ///< Neural net raw fitter
-  NONE = 3
+  NONE = 3,
+  LevenbergMarquardt = 4 ///< Standard raw fitter response fitted with a Levenberg-Marquardt solver
 };
 
 } // namespace emcal
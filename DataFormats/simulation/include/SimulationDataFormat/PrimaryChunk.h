@@ -12,8 +12,12 @@
 #ifndef ALICEO2_DATA_PRIMARYCHUNK_H_
 #define ALICEO2_DATA_PRIMARYCHUNK_H_
 
+#include <cstdint>
 #include <cstring>
+#include <vector>
 #include <SimulationDataFormat/MCEventHeader.h>
+#include <TParticle.h>
+#include <TVector3.h>
 
 namespace o2
 {
@@ -52,6 +56,56 @@ struct PrimaryChunk {
   std::vector<TParticle> mParticles; // the particles for this chunk
   ClassDefNV(PrimaryChunk, 1);
 };
+
+// Flat (memcpy-able) record of a primary particle, used to ship the particles of a
+// chunk from the primary server to the simulation workers without ROOT streaming
+struct FlatPrimary {
+  double px, py, pz, e;
+  double vx, vy, vz, t;
+  double polx, poly, polz;
+  double weight;
+  double calcMass;
+  int32_t pdg;
+  int32_t status;
+  int32_t mother[2];
+  int32_t daughter[2];
+  uint32_t uniqueID; // carries the production process
+  uint32_t bits;     // TObject status bits, carrying the ParticleStatus flags
+
+  FlatPrimary() = default;
+  explicit FlatPrimary(TParticle const& p)
+    : px(p.Px()), py(p.Py()), pz(p.Pz()), e(p.Energy()), vx(p.Vx()), vy(p.Vy()), vz(p.Vz()), t(p.T()), weight(p.GetWeight()), calcMass(p.GetCalcMass()), pdg(p.GetPdgCode()), status(p.GetStatusCode()), mother{p.GetFirstMother(), p.GetSecondMother()}, daughter{p.GetFirstDaughter(), p.GetLastDaughter()}, uniqueID(p.GetUniqueID()), bits(p.TestBits(TObject::kBitMask))
+  {
+    TVector3 pol;
+    p.GetPolarisation(pol);
+    polx = pol.X();
+    poly = pol.Y();
+    polz = pol.Z();
+  }
+
+  TParticle toParticle() const
+  {
+    TParticle p(pdg, status, mother[0], mother[1], daughter[0], daughter[1], px, py, pz, e, vx, vy, vz, t);
+    p.SetPolarisation(polx, poly, polz);
+    p.SetWeight(weight);
+    p.SetCalcMass(calcMass);
+    p.SetUniqueID(uniqueID);
+    p.SetBit(bits);
+    return p;
+  }
+};
+
+// decodes the particles of a chunk sent as a contiguous array of FlatPrimary
+inline void decodePrimaries(void const* buffer, size_t size, std::vector<TParticle>& particles)
+{
+  auto flat = reinterpret_cast<FlatPrimary const*>(buffer);
+  const auto n = size / sizeof(FlatPrimary);
+  particles.clear();
+  particles.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    particles.emplace_back(flat[i].toParticle());
+  }
+}
 } // namespace data
 } // namespace o2
 
@@ -25,11 +25,10 @@
 #include "Rtypes.h"
 #include "TParticle.h"
 
-#include <map>
 #include <memory>
-#include <stack>
 #include <utility>
 #include <functional>
+#include <vector>
 
 class TClonesArray;
 class TRefArray;
@@ -44,8 +43,9 @@ class Detector;
 namespace data
 {
 /// This class handles the particle stack for the transport simulation.
-/// For the stack FILO functunality, it uses the STL stack. To store
-/// the tracks during transport, a TParticle array is used.
+/// For the stack FILO functionality, it uses a vector of compact particle
+/// records (the TParticle handed to the transport engine is only filled when
+/// a particle is popped). To store the tracks during transport, a MCTrack array is used.
 /// At the end of the event, tracks satisfying the filter criteria
 /// are copied to a MCTrack array, which is stored in the output.
 ///
@@ -181,6 +181,7 @@ class Stack : public FairGenericStack
 
   // methods concerning track references
   void addTrackReference(const o2::TrackReference& p);
+  std::vector<o2::TrackReference> const* getTrackRefs() const { return mTrackRefs; }
 
   // get primaries
   const std::vector<TParticle>& getPrimaries() const { return mPrimaryParticles; }
@@ -230,9 +231,24 @@ class Stack : public FairGenericStack
   typedef std::function<bool(const TParticle& p, const std::vector<TParticle>& particles)> TransportFcn;
 
  private:
-  /// STL stack (FILO) used to handle the TParticles for tracking
-  /// stack entries refer to
-  std::stack<TParticle> mStack; //!
+  /// plain record of a particle waiting for transport; secondaries are kept in this form
+  /// only, primaries refer to their TParticle in mPrimaryParticles
+  struct PendingParticle {
+    double px, py, pz, e;
+    double vx, vy, vz, t;
+    double polx, poly, polz;
+    double weight;
+    int pdg;
+    int status;
+    int mother[2];
+    int daughter[2];
+    int process;
+    int primary = -1; // index in mPrimaryParticles or -1 for secondaries
+    bool toBeDone;
+  };
+
+  /// FILO of the particles to be tracked; the storage is kept from event to event
+  std::vector<PendingParticle> mStack; //!
 
   /// Array of TParticles (contains all TParticles put into or created
   /// by the transport)
@@ -242,7 +258,7 @@ class Stack : public FairGenericStack
   std::vector<int> mTrackIDtoParticlesEntry; //! an O(1) mapping of trackID to the entry of mParticles
   // the current TParticle object
   TParticle mCurrentParticle;
-  TParticle mCurrentParticle0;
+  PendingParticle mCurrentParticle0{}; //! last secondary pushed
 
   // keep primary particles in its original form
   // (mainly for the PopPrimaryParticleInterface
@@ -251,8 +267,8 @@ class Stack : public FairGenericStack
   /// vector of reducded tracks written to the output
   std::vector<o2::MCTrack>* mTracks;
 
-  /// STL map from particle index to persistent track index
-  std::map<Int_t, Int_t> mIndexMap; //!
+  /// map from particle index to persistent track index (-1 if not kept)
+  std::vector<int> mIndexMap; //!
 
   /// cache active O2 detectors
   std::vector<o2::base::Detector*> mActiveDetectors; //!
@@ -315,7 +331,10 @@ class Stack : public FairGenericStack
 
   void handleTransportPrimary(TParticle& p);
 
-  ClassDefOverride(Stack, 1);
+  /// fill the TParticle given to the transport from a pending record
+  void fillParticle(const PendingParticle& rec, TParticle& p) const;
+
+  ClassDefOverride(Stack, 2);
 };
 
 inline void Stack::addTrackReference(const o2::TrackReference& ref)
@@ -77,6 +77,7 @@ Stack::Stack(Int_t size)
     mTrackRefs(new std::vector<o2::TrackReference>),
     mIsG4Like(false)
 {
+  mStack.reserve(size);
   auto vmc = TVirtualMC::GetMC();
   if (vmc) {
     mIsG4Like = !(vmc->SecondariesAreOrdered());
@@ -205,7 +206,8 @@ void Stack::PushTrack(Int_t toBeDone, Int_t parentId, Int_t pdgCode, Double_t px
   // - in all cases to push a secondary particle
   //
   //
-  // Create new TParticle and add it to the TParticle array
+  // Secondaries are only kept as a plain record on the stack and as MCTrack in mParticles,
+  // a TParticle is created for primaries only
 
   Int_t trackId = mNumberOfEntriesInParticles;
   // Set track variable
@@ -213,20 +215,11 @@ void Stack::PushTrack(Int_t toBeDone, Int_t parentId, Int_t pdgCode, Double_t px
   //  Int_t daughter1Id = -1;
   //  Int_t daughter2Id = -1;
   Int_t iStatus = (proc == kPPrimary) ? is : trackId;
-  TParticle p(pdgCode, iStatus, parentId, secondparentId, daughter1Id, daughter2Id, px, py, pz, e, vx, vy, vz, time);
-  p.SetPolarisation(polx, poly, polz);
-  p.SetWeight(weight);
-  p.SetUniqueID(proc); // using the unique ID to transfer process ID
-  p.SetBit(ParticleStatus::kPrimary, proc == kPPrimary ? 1 : 0); // set primary bit
-  p.SetBit(ParticleStatus::kToBeDone, toBeDone == 1 ? 1 : 0);    // set to be done bit
   mNumberOfEntriesInParticles++;
 
   insertInVector(mTrackIDtoParticlesEntry, trackId, (int)(mParticles.size()));
 
-  handleTransportPrimary(p); // handle selective transport of primary particles
-
-  // Push particle on the stack if toBeDone is set
-  if (p.TestBit(ParticleStatus::kPrimary)) {
+  if (proc == kPPrimary) {
     // This is a particle from the primary particle generator
     //
     // SetBit is used to pass information about the primary particle to the stack during transport.
@@ -238,9 +231,17 @@ void Stack::PushTrack(Int_t toBeDone, Int_t parentId, Int_t pdgCode, Double_t px
     // in case we pushed a secondary track of a previous simulation to be continued.
     // We save therefore in the UniqueID the correct process
     // while the particle will still be treated as a primary given its bit settings
+    TParticle p(pdgCode, iStatus, parentId, secondparentId, daughter1Id, daughter2Id, px, py, pz, e, vx, vy, vz, time);
+    p.SetPolarisation(polx, poly, polz);
+    p.SetWeight(weight);
+    p.SetUniqueID(proc); // using the unique ID to transfer process ID
+    p.SetBit(ParticleStatus::kPrimary, 1);
+    p.SetBit(ParticleStatus::kToBeDone, toBeDone == 1 ? 1 : 0);
+
+    handleTransportPrimary(p); // handle selective transport of primary particles
     p.SetUniqueID(proc2);
 
-    mIndexMap[trackId] = trackId;
+    insertInVector(mIndexMap, trackId, trackId);
     p.SetBit(ParticleStatus::kKeep, 1);
     if (p.TestBit(ParticleStatus::kToBeDone)) {
       mNumberOfPrimariesforTracking++;
@@ -248,11 +249,43 @@ void Stack::PushTrack(Int_t toBeDone, Int_t parentId, Int_t pdgCode, Double_t px
     mNumberOfPrimaryParticles++;
     mPrimaryParticles.push_back(p);
     mTracks->emplace_back(p);
+    PendingParticle rec{};
+    rec.primary = mPrimaryParticles.size() - 1;
+    mStack.push_back(rec);
   } else {
-    mParticles.emplace_back(p);
-    mCurrentParticle0 = p;
+    PendingParticle rec{px, py, pz, e, vx, vy, vz, time, polx, poly, polz, weight, pdgCode, iStatus,
+                        {parentId, secondparentId}, {daughter1Id, daughter2Id}, proc, -1, toBeDone == 1};
+    // same content as the MCTrack constructed from the corresponding TParticle
+    auto& track = mParticles.emplace_back(pdgCode, parentId, secondparentId, daughter1Id, daughter2Id,
+                                          px, py, pz, vx, vy, vz, time * 1e09, 0);
+    track.setProcess(proc);
+    track.setToBeDone(rec.toBeDone);
+    mCurrentParticle0 = rec;
+    mStack.push_back(rec);
+  }
+}
+
+void Stack::fillParticle(const PendingParticle& rec, TParticle& p) const
+{
+  if (rec.primary >= 0) {
+    p = mPrimaryParticles[rec.primary];
+    return;
   }
-  mStack.push(p);
+  // bring p to the state of a TParticle constructed from these values;
+  // the momentum must be set first since SetPdgCode derives the mass of unknown codes from it
+  p.ResetBit(TObject::kBitMask);
+  p.SetMomentum(rec.px, rec.py, rec.pz, rec.e);
+  p.SetProductionVertex(rec.vx, rec.vy, rec.vz, rec.t);
+  p.SetPdgCode(rec.pdg);
+  p.SetStatusCode(rec.status);
+  p.SetFirstMother(rec.mother[0]);
+  p.SetLastMother(rec.mother[1]);
+  p.SetFirstDaughter(rec.daughter[0]);
+  p.SetLastDaughter(rec.daughter[1]);
+  p.SetPolarisation(rec.polx, rec.poly, rec.polz);
+  p.SetWeight(rec.weight);
+  p.SetUniqueID(rec.process);
+  p.SetBit(ParticleStatus::kToBeDone, rec.toBeDone);
 }
 
 void Stack::handleTransportPrimary(TParticle& p)
@@ -279,14 +312,16 @@ void Stack::PushTrack(int toBeDone, TParticle& p)
   // - during parallel simulation to push primary particles (called by the stack itself)
   if (p.TestBit(ParticleStatus::kPrimary)) {
     // one to one mapping for primaries
-    mIndexMap[mNumberOfPrimaryParticles] = mNumberOfPrimaryParticles;
+    insertInVector(mIndexMap, mNumberOfPrimaryParticles, mNumberOfPrimaryParticles);
     mNumberOfPrimaryParticles++;
     mPrimaryParticles.push_back(p);
     // Push particle on the stack
     if (p.TestBit(ParticleStatus::kToBeDone)) {
       mNumberOfPrimariesforTracking++;
     }
-    mStack.push(p);
+    PendingParticle rec{};
+    rec.primary = mPrimaryParticles.size() - 1;
+    mStack.push_back(rec);
     mTracks->emplace_back(p);
   }
 }
@@ -302,7 +337,7 @@ void Stack::SetCurrentTrack(Int_t iTrack)
     mCurrentParticle = p;
     mIndexOfCurrentPrimary = iTrack;
   } else {
-    mCurrentParticle = mCurrentParticle0;
+    fillParticle(mCurrentParticle0, mCurrentParticle);
   }
 }
 
@@ -344,9 +379,9 @@ TParticle* Stack::PopNextTrack(Int_t& iTrack)
   TParticle* nextParticle = nullptr;
   while (!found && !mStack.empty()) {
     // get next particle from stack
-    mCurrentParticle = mStack.top();
+    fillParticle(mStack.back(), mCurrentParticle);
     // remove particle from the top
-    mStack.pop();
+    mStack.pop_back();
     // test if primary to be transported
     if (mCurrentParticle.TestBit(ParticleStatus::kToBeDone)) {
       if (mCurrentParticle.TestBit(ParticleStatus::kPrimary)) {
@@ -512,7 +547,7 @@ void Stack::FinishPrimary()
       continue;
     }
     Int_t index3 = (mIsG4Like) ? invreOrderedIndices[index2] : index2;
-    mIndexMap[idTrack] = index3 + indexoffset;
+    insertInVector(mIndexMap, idTrack, index3 + indexoffset);
   }
 
   // we can now clear the particles buffer!
@@ -533,6 +568,10 @@ void Stack::UpdateTrackIndex(TRefArray* detList)
     LOG(INFO) << "No TrackIndex update necessary\n";
     return;
   }
+  // any track ID of this event can be looked up, discarded tracks map to -1
+  if (mIndexMap.size() < (size_t)mNumberOfEntriesInParticles) {
+    mIndexMap.resize(mNumberOfEntriesInParticles, -1);
+  }
 
   // we are getting the detectorlist from FairRoot as TRefArray
   // at each call, but this list never changes so we cache it here
@@ -559,13 +598,11 @@ void Stack::UpdateTrackIndex(TRefArray* detList)
   // use some caching since repeated trackIDs
   for (auto& ref : *mTrackRefs) {
     const auto id = ref.getTrackID();
-    auto iter = mIndexMap.find(id);
-    if (iter == mIndexMap.end()) {
+    const auto newid = mIndexMap[id];
+    if (newid == -1) {
       LOG(INFO) << "Invalid trackref ... needs to be rmoved \n";
-      ref.setTrackID(-1);
-    } else {
-      ref.setTrackID(iter->second);
     }
+    ref.setTrackID(newid);
   }
 
   // sort trackrefs according to new track index
@@ -590,9 +627,8 @@ void Stack::Reset()
 
   mIndexOfCurrentTrack = -1;
   mNumberOfPrimaryParticles = mNumberOfEntriesInParticles = mNumberOfEntriesInTracks = 0;
-  while (!mStack.empty()) {
-    mStack.pop();
-  }
+  mStack.clear();
+  mIndexMap.clear();
   mParticles.clear();
   mTracks->clear();
   if (!mIsExternalMode && (mPrimariesDone != mNumberOfPrimariesforTracking)) {
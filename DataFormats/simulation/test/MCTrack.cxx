@@ -22,6 +22,7 @@
 #include "SimulationDataFormat/PrimaryChunk.h"
 #include "TFile.h"
 #include "TParticle.h"
+#include "TRefArray.h"
 #include "TMCProcess.h"
 
 using namespace o2;
@@ -93,3 +94,159 @@ BOOST_AUTO_TEST_CASE(Stack_test)
     BOOST_CHECK(inst->getPrimaries().size() == 2);
   }
 }
+
+// transport-like sequence of pushes and pops on the stack; the popped particles and the
+// kept MCTracks are compared to what the former TParticle based stack produced
+BOOST_AUTO_TEST_CASE(Stack_transport_test)
+{
+  o2::data::Stack st;
+  st.pruneKinematics(true);
+  int ntr;
+  int itr;
+  // how the TParticle based stack recorded a secondary
+  auto makeSecondary = [](int pdg, int trackId, int parent, double px, double py, double pz, double e,
+                          double vx, double vy, double vz, double t, TMCProcess proc) {
+    TParticle p(pdg, trackId, parent, -1, -1, -1, px, py, pz, e, vx, vy, vz, t);
+    p.SetPolarisation(0.1, 0.2, 0.3);
+    p.SetWeight(0.5);
+    p.SetUniqueID(proc);
+    p.SetBit(ParticleStatus::kToBeDone, 1);
+    return p;
+  };
+  auto checkSameParticle = [](TParticle const& a, TParticle const& b) {
+    BOOST_CHECK(a.GetPdgCode() == b.GetPdgCode());
+    BOOST_CHECK(a.GetStatusCode() == b.GetStatusCode());
+    BOOST_CHECK(a.GetFirstMother() == b.GetFirstMother() && a.GetSecondMother() == b.GetSecondMother());
+    BOOST_CHECK(a.GetFirstDaughter() == b.GetFirstDaughter() && a.GetLastDaughter() == b.GetLastDaughter());
+    BOOST_CHECK(a.Px() == b.Px() && a.Py() == b.Py() && a.Pz() == b.Pz() && a.Energy() == b.Energy());
+    BOOST_CHECK(a.Vx() == b.Vx() && a.Vy() == b.Vy() && a.Vz() == b.Vz() && a.T() == b.T());
+    BOOST_CHECK(a.GetCalcMass() == b.GetCalcMass());
+    BOOST_CHECK(a.GetWeight() == b.GetWeight());
+    BOOST_CHECK(a.GetUniqueID() == b.GetUniqueID());
+    BOOST_CHECK(a.TestBit(ParticleStatus::kPrimary) == b.TestBit(ParticleStatus::kPrimary));
+    BOOST_CHECK(a.TestBit(ParticleStatus::kToBeDone) == b.TestBit(ParticleStatus::kToBeDone));
+    BOOST_CHECK_CLOSE(a.GetPolarTheta(), b.GetPolarTheta(), 1e-6);
+    BOOST_CHECK_CLOSE(a.GetPolarPhi(), b.GetPolarPhi(), 1e-6);
+  };
+  auto checkSameKinematics = [](o2::MCTrack const& a, o2::MCTrack const& b) {
+    BOOST_CHECK(a.GetPdgCode() == b.GetPdgCode());
+    BOOST_CHECK(a.getProcess() == b.getProcess());
+    BOOST_CHECK(a.getToBeDone() == b.getToBeDone());
+    BOOST_CHECK(a.GetStartVertexMomentumX() == b.GetStartVertexMomentumX());
+    BOOST_CHECK(a.GetStartVertexMomentumY() == b.GetStartVertexMomentumY());
+    BOOST_CHECK(a.GetStartVertexMomentumZ() == b.GetStartVertexMomentumZ());
+    BOOST_CHECK(a.GetStartVertexCoordinatesX() == b.GetStartVertexCoordinatesX());
+    BOOST_CHECK(a.GetStartVertexCoordinatesY() == b.GetStartVertexCoordinatesY());
+    BOOST_CHECK(a.GetStartVertexCoordinatesZ() == b.GetStartVertexCoordinatesZ());
+    BOOST_CHECK(a.GetStartVertexCoordinatesT() == b.GetStartVertexCoordinatesT());
+  };
+
+  // two primaries, track ids 0 and 1
+  st.PushTrack(1, -1, 211, 0.1, 0.2, 1., 1.03, 0., 0., 0., 0., 0., 0., 0., kPPrimary, ntr, 1., 1);
+  st.PushTrack(1, -1, -211, -0.1, 0.3, 2., 2.03, 0., 0., 0., 0., 0., 0., 0., kPPrimary, ntr, 1., 1);
+
+  // the last pushed primary is transported first
+  auto part = st.PopNextTrack(itr);
+  BOOST_CHECK(part != nullptr && itr == 1);
+  BOOST_CHECK(part->GetPdgCode() == -211);
+
+  // 2: secondary of primary 1
+  auto ref2 = makeSecondary(2212, 2, 1, 0.05, 0.1, 0.5, 1.08, 1., 2., 3., 1e-9, kPHInhElas);
+  st.PushTrack(1, 1, 2212, 0.05, 0.1, 0.5, 1.08, 1., 2., 3., 1e-9, 0.1, 0.2, 0.3, kPHInhElas, ntr, 0.5, 0);
+  BOOST_CHECK(ntr == 2);
+  part = st.PopNextTrack(itr);
+  BOOST_CHECK(part != nullptr && itr == 2);
+  checkSameParticle(*part, ref2);
+  BOOST_CHECK(st.GetCurrentTrack() == part);
+
+  // 3 and 4: secondaries of 2; only 4 leaves a hit
+  auto ref3 = makeSecondary(22, 3, 2, 0.01, 0., 0.02, 0.0223, 4., 5., 6., 2e-9, kPHInhElas);
+  auto ref4 = makeSecondary(2112, 4, 2, 0., -0.1, 0.4, 1.03, 7., 8., 9., 3e-9, kPHInhElas);
+  st.PushTrack(1, 2, 22, 0.01, 0., 0.02, 0.0223, 4., 5., 6., 2e-9, 0.1, 0.2, 0.3, kPHInhElas, ntr, 0.5, 0);
+  BOOST_CHECK(ntr == 3);
+  st.PushTrack(1, 2, 2112, 0., -0.1, 0.4, 1.03, 7., 8., 9., 3e-9, 0.1, 0.2, 0.3, kPHInhElas, ntr, 0.5, 0);
+  BOOST_CHECK(ntr == 4);
+  BOOST_CHECK(st.GetCurrentParentTrackNumber() == 1);
+
+  part = st.PopNextTrack(itr);
+  BOOST_CHECK(part != nullptr && itr == 4);
+  checkSameParticle(*part, ref4);
+  st.addHit(1);
+  part = st.PopNextTrack(itr);
+  BOOST_CHECK(part != nullptr && itr == 3);
+  checkSameParticle(*part, ref3);
+  st.FinishPrimary();
+
+  part = st.PopNextTrack(itr);
+  BOOST_CHECK(part != nullptr && itr == 0);
+  BOOST_CHECK(part->GetPdgCode() == 211);
+  st.FinishPrimary();
+  BOOST_CHECK(st.PopNextTrack(itr) == nullptr && itr == -1);
+
+  // track 3 has no hits and is not needed for the history, so it is dropped
+  auto tracks = st.getMCTracks();
+  BOOST_CHECK(tracks->size() == 4);
+  BOOST_CHECK((*tracks)[0].getFirstDaughterTrackId() == -1);
+  BOOST_CHECK((*tracks)[1].getFirstDaughterTrackId() == 2 && (*tracks)[1].getLastDaughterTrackId() == 2);
+  BOOST_CHECK((*tracks)[2].getMotherTrackId() == 1);
+  BOOST_CHECK((*tracks)[2].getFirstDaughterTrackId() == 3 && (*tracks)[2].getLastDaughterTrackId() == 3);
+  BOOST_CHECK((*tracks)[3].getMotherTrackId() == 2);
+  BOOST_CHECK((*tracks)[2].getHitMask() == 0);
+  BOOST_CHECK((*tracks)[3].leftTrace(1));
+  checkSameKinematics((*tracks)[2], o2::MCTrack(ref2));
+  checkSameKinematics((*tracks)[3], o2::MCTrack(ref4));
+
+  // track references are remapped to the kept track indices, dropped tracks map to -1
+  for (int id = 0; id < 5; ++id) {
+    st.addTrackReference(o2::TrackReference(0., 0., 0., 0., 0., 0., 1. * id, 0., id, 0));
+  }
+  TRefArray detList;
+  st.UpdateTrackIndex(&detList);
+  std::vector<int> expected{-1, 0, 1, 2, 3};
+  std::vector<float> expectedLength{3., 0., 1., 2., 4.};
+  auto refs = st.getTrackRefs();
+  BOOST_CHECK(refs->size() == expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    BOOST_CHECK((*refs)[i].getTrackID() == expected[i]);
+    BOOST_CHECK((*refs)[i].getLength() == expectedLength[i]);
+  }
+}
+
+// flat encoding of the primaries shipped by the primary server
+BOOST_AUTO_TEST_CASE(PrimaryChunk_flat_test)
+{
+  std::vector<TParticle> prims;
+  prims.emplace_back(211, 1, -1, -1, 1, 2, 0.1, -0.2, 1.5, 1.52, 0.01, -0.02, 3., 1e-9);
+  prims.emplace_back(1000020040, 0, 0, -1, -1, -1, 1., 2., 3., 5., 0., 0., 0., 0.);
+  prims.back().SetPolarisation(0.3, -0.4, 0.5);
+  prims.back().SetWeight(0.25);
+  prims.back().SetUniqueID(kPDecay);
+  prims.back().SetBit(ParticleStatus::kPrimary);
+  prims.back().SetBit(ParticleStatus::kToBeDone);
+
+  std::vector<o2::data::FlatPrimary> flat;
+  for (auto& p : prims) {
+    flat.emplace_back(p);
+  }
+
+  std::vector<TParticle> decoded;
+  o2::data::decodePrimaries(flat.data(), flat.size() * sizeof(o2::data::FlatPrimary), decoded);
+  BOOST_CHECK(decoded.size() == prims.size());
+  for (size_t i = 0; i < prims.size(); ++i) {
+    auto& a = prims[i];
+    auto& b = decoded[i];
+    BOOST_CHECK(a.GetPdgCode() == b.GetPdgCode());
+    BOOST_CHECK(a.GetStatusCode() == b.GetStatusCode());
+    BOOST_CHECK(a.GetFirstMother() == b.GetFirstMother() && a.GetSecondMother() == b.GetSecondMother());
+    BOOST_CHECK(a.GetFirstDaughter() == b.GetFirstDaughter() && a.GetLastDaughter() == b.GetLastDaughter());
+    BOOST_CHECK(a.Px() == b.Px() && a.Py() == b.Py() && a.Pz() == b.Pz() && a.Energy() == b.Energy());
+    BOOST_CHECK(a.Vx() == b.Vx() && a.Vy() == b.Vy() && a.Vz() == b.Vz() && a.T() == b.T());
+    BOOST_CHECK(a.GetWeight() == b.GetWeight());
+    BOOST_CHECK(a.GetCalcMass() == b.GetCalcMass());
+    BOOST_CHECK(a.GetUniqueID() == b.GetUniqueID());
+    BOOST_CHECK(a.TestBit(ParticleStatus::kPrimary) == b.TestBit(ParticleStatus::kPrimary));
+    BOOST_CHECK(a.TestBit(ParticleStatus::kToBeDone) == b.TestBit(ParticleStatus::kToBeDone));
+    BOOST_CHECK_CLOSE(a.GetPolarTheta(), b.GetPolarTheta(), 1e-6);
+    BOOST_CHECK_CLOSE(a.GetPolarPhi(), b.GetPolarPhi(), 1e-6);
+  }
+}
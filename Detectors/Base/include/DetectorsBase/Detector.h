@@ -156,9 +156,10 @@ class Detector : public FairDetector
 
   // interface to update track indices of data objects
   // usually called by the Stack, at the end of an event, which might have changed
-  // the track indices due to filtering
+  // the track indices due to filtering; the mapping is indexed by the old track ID
+  // and gives -1 for tracks which were not kept
   // FIXME: make private friend of stack?
-  virtual void updateHitTrackIndices(std::map<int, int> const&) = 0;
+  virtual void updateHitTrackIndices(std::vector<int> const&) = 0;
 
   // interfaces to attach properly encoded hit information to a FairMQ message
   // and to decode it
@@ -308,14 +309,13 @@ class DetImpl : public o2::base::Detector
   // generic implementation for the updateHitTrackIndices interface
   // assumes Detectors have a GetHits(int) function that return some iterable
   // hits which are o2::BaseHits
-  void updateHitTrackIndices(std::map<int, int> const& indexmapping) override
+  void updateHitTrackIndices(std::vector<int> const& indexmapping) override
   {
     int probe = 0; // some Detectors have multiple hit vectors and we are probing
                    // them via a probe integer until we get a nullptr
     while (auto hits = static_cast<Det*>(this)->Det::getHits(probe++)) {
       for (auto& hit : *hits) {
-        auto iter = indexmapping.find(hit.GetTrackID());
-        hit.SetTrackID(iter->second);
+        hit.SetTrackID(indexmapping[hit.GetTrackID()]);
       }
     }
   }
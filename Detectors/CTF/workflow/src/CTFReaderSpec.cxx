@@ -12,18 +12,25 @@
 /// @file   CTFReaderSpec.cxx
 
 #include <vector>
+#include <array>
+#include <memory>
+#include <thread>
+#include <exception>
 #include <TFile.h>
 #include <TTree.h>
+#include <TROOT.h>
 
 #include "Framework/Logger.h"
 #include "Framework/ControlService.h"
 #include "Framework/ConfigParamRegistry.h"
 #include "Framework/InputSpec.h"
 #include "CommonUtils/StringUtils.h"
+#include "CommonUtils/BoundedQueue.h"
 #include "CTFWorkflow/CTFReaderSpec.h"
 #include "DetectorsCommonDataFormats/EncodedBlocks.h"
 #include "DetectorsCommonDataFormats/NameConf.h"
 #include "DetectorsCommonDataFormats/CTFHeader.h"
+#include "DetectorsCommonDataFormats/CTFFlatFile.h"
 #include "DataFormatsITSMFT/CTF.h"
 #include "DataFormatsTPC/CTF.h"
 #include "DataFormatsTRD/CTF.h"
@@ -64,28 +71,103 @@ bool readFromTree(TTree& tree, const std::string brname, T& dest, int ev = 0)
 
 using DetID = o2::detectors::DetID;
 
+/// read CTF data of particular detector from the tree to the buffer vector
+template <typename VD>
+void readDetFromTree(VD& vec, TTree& tree, DetID det, int ev)
+{
+  switch (det) {
+    case DetID::ITS:
+    case DetID::MFT:
+      o2::itsmft::CTF::readFromTree(vec, tree, det.getName(), ev);
+      break;
+    case DetID::TPC:
+      o2::tpc::CTF::readFromTree(vec, tree, det.getName(), ev);
+      break;
+    case DetID::TRD:
+      o2::trd::CTF::readFromTree(vec, tree, det.getName(), ev);
+      break;
+    case DetID::FT0:
+      o2::ft0::CTF::readFromTree(vec, tree, det.getName(), ev);
+      break;
+    case DetID::FV0:
+      o2::fv0::CTF::readFromTree(vec, tree, det.getName(), ev);
+      break;
+    case DetID::FDD:
+      o2::fdd::CTF::readFromTree(vec, tree, det.getName(), ev);
+      break;
+    case DetID::TOF:
+      o2::tof::CTF::readFromTree(vec, tree, det.getName(), ev);
+      break;
+    case DetID::MID:
+      o2::mid::CTF::readFromTree(vec, tree, det.getName(), ev);
+      break;
+    case DetID::MCH:
+      o2::mch::CTF::readFromTree(vec, tree, det.getName(), ev);
+      break;
+    case DetID::EMC:
+      o2::emcal::CTF::readFromTree(vec, tree, det.getName(), ev);
+      break;
+    case DetID::PHS:
+      o2::phos::CTF::readFromTree(vec, tree, det.getName(), ev);
+      break;
+    case DetID::CPV:
+      o2::cpv::CTF::readFromTree(vec, tree, det.getName(), ev);
+      break;
+    case DetID::ZDC:
+      o2::zdc::CTF::readFromTree(vec, tree, det.getName(), ev);
+      break;
+    case DetID::HMP:
+      o2::hmpid::CTF::readFromTree(vec, tree, det.getName(), ev);
+      break;
+    default:
+      throw std::runtime_error(o2::utils::Str::concat_string("CTF reading is not supported for ", det.getName()));
+  }
+}
+
 class CTFReaderSpec : public o2::framework::Task
 {
  public:
   CTFReaderSpec(DetID::mask_t dm, const std::string& inp, int loop = 1, int delayMUS = 0);
-  ~CTFReaderSpec() override = default;
+  ~CTFReaderSpec() override { stopPrefetchThread(); }
   void init(o2::framework::InitContext& ic) final;
   void run(o2::framework::ProcessingContext& pc) final;
 
  private:
+  /// CTF entry located in the input, with data either detached from the file or provided by the mapped flat file
+  struct CTFEntry {
+    CTFHeader header;
+    std::string fileName;
+    int entry = 0;
+    long nEntries = 0;
+    bool last = false; // no more CTFs to read after this one
+    std::shared_ptr<CTFFlatFileReader> flatFile;
+    std::array<std::vector<o2::ctf::BufferType>, DetID::nDetectors> buffers;
+  };
+
   void openCTFFile(const std::string& flname);
+  void closeCTFFile();
+  bool locateNextCTF(CTFEntry& entry, bool detach);
+  bool advance();
+  void startPrefetchThread();
+  void stopPrefetchThread();
 
   DetID::mask_t mDets;             // detectors
   std::vector<std::string> mInput; // input files
   std::unique_ptr<TFile> mCTFFile;
   std::unique_ptr<TTree> mCTFTree;
+  std::shared_ptr<CTFFlatFileReader> mCTFFlatFile; // shared with the messages pointing to its mapping
   uint32_t mCTFCounter = 0;
   size_t mNextToProcess = 0;
   int mCurrEntry = 0;
   int mLoops = 1;
   int mLoopsCounter = 0;
   int mDelayMUS = 0;
+  int mPrefetch = 0; // if > 0, CTFs are read by the dedicated thread at most this number of TFs ahead
+  bool mZeroCopy = true;
   std::string mCTFDir = "";
+  std::unique_ptr<o2::utils::BoundedQueue<CTFEntry>> mQueue;
+  std::thread mPrefetchThread;
+  std::exception_ptr mPrefetchError;
   TStopwatch mTimer;
 };
 
@@ -101,13 +183,25 @@ CTFReaderSpec::CTFReaderSpec(DetID::mask_t dm, const std::string& inp, int loop,
 void CTFReaderSpec::init(InitContext& ic)
 {
   mCTFDir = o2::utils::Str::rectifyDirectory(ic.options().get<std::string>("input-dir"));
+  mPrefetch = ic.options().get<int>("prefetch");
+  mZeroCopy = !ic.options().get<bool>("copy-flat-ctf");
+  if (mPrefetch > 0 && !mInput.empty()) {
+    LOG(INFO) << "CTFs will be prefetched up to " << mPrefetch << " TFs ahead";
+    startPrefetchThread();
+  }
 }
 
 ///_______________________________________
 void CTFReaderSpec::openCTFFile(const std::string& flname)
 {
+  if (CTFFlatFileReader::isFlatFile(flname)) {
+    mCTFFlatFile = std::make_shared<CTFFlatFileReader>();
+    mCTFFlatFile->open(flname);
+    mCurrEntry = 0;
+    return;
+  }
   mCTFFile.reset(TFile::Open(flname.c_str()));
-  if (!mCTFFile->IsOpen() || mCTFFile->IsZombie()) {
+  if (!mCTFFile || !mCTFFile->IsOpen() || mCTFFile->IsZombie()) {
     LOG(ERROR) << "Failed to open file " << flname;
     throw std::runtime_error("failed to open CTF file");
   }
@@ -119,9 +213,126 @@ void CTFReaderSpec::openCTFFile(const std::string& flname)
 }
 
 ///_______________________________________
-void CTFReaderSpec::run(ProcessingContext& pc)
+void CTFReaderSpec::closeCTFFile()
+{
+  if (mCTFTree) {
+    mCTFTree.reset();
+    mCTFFile->Close();
+    mCTFFile.reset();
+  }
+  mCTFFlatFile.reset(); // the mapping is released once all messages using it are gone
+}
+
+///_______________________________________
+bool CTFReaderSpec::locateNextCTF(CTFEntry& entry, bool detach)
 {
+  // locate next CTF and read its header, if requested, read the data of the detectors (for the flat file: prefetch them)
   if (mNextToProcess >= mInput.size()) {
+    return false;
+  }
+  if (!mCTFTree && !mCTFFlatFile) { // otherwise there is still a file open with multiple entries
+    std::string inputFile = o2::utils::Str::concat_string(mCTFDir, mInput[mNextToProcess]);
+    LOG(INFO) << "Reading CTF input " << mNextToProcess << ' ' << inputFile;
+    openCTFFile(inputFile);
+  }
+  entry.entry = mCurrEntry;
+  if (mCTFFlatFile) {
+    if (mCTFFlatFile->getNEntries() == 0) {
+      throw std::runtime_error(o2::utils::Str::concat_string("no CTFs in flat CTF file ", mCTFFlatFile->getFileName()));
+    }
+    entry.flatFile = mCTFFlatFile;
+    entry.fileName = mCTFFlatFile->getFileName();
+    entry.nEntries = mCTFFlatFile->getNEntries();
+    entry.header = mCTFFlatFile->getCTFHeader(mCurrEntry);
+    if (detach) {
+      mCTFFlatFile->prefetch(mCurrEntry);
+    }
+    return true;
+  }
+  entry.flatFile.reset();
+  entry.fileName = mCTFFile->GetName();
+  entry.nEntries = mCTFTree->GetEntries();
+  if (!readFromTree(*(mCTFTree.get()), "CTFHeader", entry.header, mCurrEntry)) {
+    throw std::runtime_error("did not find CTFHeader");
+  }
+  if (detach) {
+    DetID::mask_t detsTF = mDets & entry.header.detectors;
+    for (int id = DetID::First; id <= DetID::Last; id++) {
+      entry.buffers[id].clear();
+      if (detsTF[id]) {
+        readDetFromTree(entry.buffers[id], *(mCTFTree.get()), id, mCurrEntry);
+      }
+    }
+  }
+  return true;
+}
+
+///_______________________________________
+bool CTFReaderSpec::advance()
+{
+  // move to the next CTF, return false if there are no more CTFs to read
+  long nEntries = mCTFFlatFile ? long(mCTFFlatFile->getNEntries()) : mCTFTree->GetEntries();
+  if (++mCurrEntry < nEntries) {
+    return true;
+  }
+  // this file is done, check if there are other files
+  closeCTFFile();
+  if (++mNextToProcess >= mInput.size()) {
+    if (++mLoopsCounter >= mLoops) {
+      return false;
+    }
+    mNextToProcess = 0;
+    LOG(INFO) << "Starting new loop " << mNextToProcess << " of " << mLoops;
+  }
+  return true;
+}
+
+///_______________________________________
+void CTFReaderSpec::startPrefetchThread()
+{
+  ROOT::EnableThreadSafety();
+  mQueue = std::make_unique<o2::utils::BoundedQueue<CTFEntry>>(mPrefetch);
+  mPrefetchThread = std::thread([this]() {
+    try {
+      CTFEntry entry;
+      while (locateNextCTF(entry, true)) {
+        entry.last = !advance();
+        if (!mQueue->push(std::move(entry))) {
+          break; // reading was interrupted
+        }
+        entry = CTFEntry{};
+      }
+    } catch (...) {
+      mPrefetchError = std::current_exception();
+    }
+    mQueue->close();
+  });
+}
+
+///_______________________________________
+void CTFReaderSpec::stopPrefetchThread()
+{
+  if (mQueue) {
+    mQueue->close();
+  }
+  if (mPrefetchThread.joinable()) {
+    mPrefetchThread.join();
+  }
+}
+
+///_______________________________________
+void CTFReaderSpec::run(ProcessingContext& pc)
+{
+  CTFEntry ctf;
+  if (mQueue) {
+    if (!mQueue->pop(ctf)) {
+      if (mPrefetchError) {
+        stopPrefetchThread();
+        std::rethrow_exception(mPrefetchError);
+      }
+      return;
+    }
+  } else if (mNextToProcess >= mInput.size()) {
     return;
   }
   if (mDelayMUS && mCTFCounter > 0) {
@@ -131,15 +342,10 @@ void CTFReaderSpec::run(ProcessingContext& pc)
   auto cput = mTimer.CpuTime();
   mTimer.Start(false);
 
-  if (!mCTFTree) { // there is still a tree open with multiple entries
-    std::string inputFile = o2::utils::Str::concat_string(mCTFDir, mInput[mNextToProcess]);
-    LOG(INFO) << "Reading CTF input " << mNextToProcess << ' ' << inputFile;
-    openCTFFile(inputFile);
-  }
-  CTFHeader ctfHeader;
-  if (!readFromTree(*(mCTFTree.get()), "CTFHeader", ctfHeader, mCurrEntry)) {
-    throw std::runtime_error("did not find CTFHeader");
+  if (!mQueue) {
+    locateNextCTF(ctf, false);
   }
+  const auto& ctfHeader = ctf.header;
   LOG(INFO) << ctfHeader;
 
   auto setFirstTFOrbit = [&pc, &ctfHeader, this](const std::string& label) {
@@ -156,132 +362,34 @@ void CTFReaderSpec::run(ProcessingContext& pc)
   setFirstTFOrbit("header");
 
   DetID::mask_t detsTF = mDets & ctfHeader.detectors;
-  DetID det;
-
-  det = DetID::ITS;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::itsmft::CTF));
-    o2::itsmft::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
-    setFirstTFOrbit(det.getName());
-  }
-
-  det = DetID::MFT;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::itsmft::CTF));
-    o2::itsmft::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
-    setFirstTFOrbit(det.getName());
-  }
-
-  det = DetID::TPC;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::tpc::CTF));
-    o2::tpc::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
-    setFirstTFOrbit(det.getName());
-  }
-
-  det = DetID::TRD;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::trd::CTF));
-    o2::trd::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
-    setFirstTFOrbit(det.getName());
-  }
-
-  det = DetID::FT0;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::ft0::CTF));
-    o2::ft0::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
-    setFirstTFOrbit(det.getName());
-  }
-
-  det = DetID::FV0;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::fv0::CTF));
-    o2::fv0::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
-    setFirstTFOrbit(det.getName());
-  }
-
-  det = DetID::FDD;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::fdd::CTF));
-    o2::fdd::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
-    setFirstTFOrbit(det.getName());
-  }
-
-  det = DetID::TOF;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::tof::CTF));
-    o2::tof::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
-    setFirstTFOrbit(det.getName());
-  }
-
-  det = DetID::MID;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::mid::CTF));
-    o2::mid::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
-    setFirstTFOrbit(det.getName());
-  }
-
-  det = DetID::MCH;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::mch::CTF));
-    o2::mch::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
-    setFirstTFOrbit(det.getName());
-  }
-
-  det = DetID::EMC;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::emcal::CTF));
-    o2::emcal::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
-    setFirstTFOrbit(det.getName());
-  }
-
-  det = DetID::PHS;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::phos::CTF));
-    o2::phos::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
-    setFirstTFOrbit(det.getName());
-  }
-
-  det = DetID::CPV;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::cpv::CTF));
-    o2::cpv::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
-    setFirstTFOrbit(det.getName());
-  }
-
-  det = DetID::ZDC;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::zdc::CTF));
-    o2::zdc::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
-    setFirstTFOrbit(det.getName());
-  }
-
-  det = DetID::HMP;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::hmpid::CTF));
-    o2::hmpid::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
-    setFirstTFOrbit(det.getName());
-  }
-
-  mTimer.Stop();
-  LOGP(INFO, "Read CTF#{} ({} of {} in {}) in {:.3f} s", mCTFCounter, mCurrEntry, mCTFTree->GetEntries(), mCTFFile->GetName(), mTimer.CpuTime() - cput);
-
-  bool moreToProcess = (++mCurrEntry < mCTFTree->GetEntries());
-  if (!moreToProcess) { // this file is done, check if there are other files
-    mCTFTree.reset();
-    mCTFFile->Close();
-    mCTFFile.reset();
-    moreToProcess = true;
-    if (++mNextToProcess >= mInput.size()) {
-      if (++mLoopsCounter >= mLoops) {
-        moreToProcess = false;
+  for (int id = DetID::First; id <= DetID::Last; id++) {
+    if (!detsTF[id]) {
+      continue;
+    }
+    DetID det(id);
+    if (ctf.flatFile) {
+      auto img = ctf.flatFile->getImage(ctf.entry, det);
+      if (mZeroCopy) {
+        // the message points on the mapped file, the mapping is kept alive until the message is released
+        auto freefct = [](void* data, void* hint) { delete static_cast<std::shared_ptr<CTFFlatFileReader>*>(hint); };
+        auto* hint = new std::shared_ptr<CTFFlatFileReader>(ctf.flatFile);
+        pc.outputs().adoptChunk(Output{det.getDataOrigin(), "CTFDATA", 0, Lifetime::Timeframe}, reinterpret_cast<char*>(img.data()), img.size(), freefct, hint);
       } else {
-        mNextToProcess = 0;
-        LOG(INFO) << "Starting new loop " << mNextToProcess << " of " << mLoops;
+        pc.outputs().snapshot(Output{det.getDataOrigin(), "CTFDATA", 0, Lifetime::Timeframe}, reinterpret_cast<const char*>(img.data()), img.size());
       }
+    } else if (mQueue) {
+      pc.outputs().snapshot(Output{det.getDataOrigin(), "CTFDATA", 0, Lifetime::Timeframe}, reinterpret_cast<const char*>(ctf.buffers[id].data()), ctf.buffers[id].size());
+    } else {
+      auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, 0);
+      readDetFromTree(bufVec, *(mCTFTree.get()), det, ctf.entry);
     }
+    setFirstTFOrbit(det.getName());
   }
 
+  mTimer.Stop();
+  LOGP(INFO, "Read CTF#{} ({} of {} in {}) in {:.3f} s", mCTFCounter, ctf.entry, ctf.nEntries, ctf.fileName, mTimer.CpuTime() - cput);
+
+  bool moreToProcess = mQueue ? !ctf.last : advance();
   mCTFCounter++;
 
   if (!moreToProcess) {
@@ -309,7 +417,9 @@ DataProcessorSpec getCTFReaderSpec(DetID::mask_t dets, const std::string& inp, i
     Inputs{},
     outputs,
     AlgorithmSpec{adaptFromTask<CTFReaderSpec>(dets, inp, loop, delayMUS)},
-    Options{{"input-dir", VariantType::String, "none", {"CTF input directory"}}}};
+    Options{{"input-dir", VariantType::String, "none", {"CTF input directory"}},
+            {"prefetch", VariantType::Int, 0, {"if > 0, read CTFs in the dedicated thread at most this number of TFs ahead"}},
+            {"copy-flat-ctf", VariantType::Bool, false, {"copy CTF data of the flat files to output messages instead of sending the mapped memory"}}}};
 }
 
 } // namespace ctf
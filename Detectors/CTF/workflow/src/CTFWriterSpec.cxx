@@ -20,7 +20,9 @@
 #include "DetectorsCommonDataFormats/CTFHeader.h"
 #include "DetectorsCommonDataFormats/NameConf.h"
 #include "DetectorsCommonDataFormats/EncodedBlocks.h"
+#include "DetectorsCommonDataFormats/CTFFlatFile.h"
 #include "CommonUtils/StringUtils.h"
+#include "CommonUtils/BoundedQueue.h"
 #include "DataFormatsITSMFT/CTF.h"
 #include "DataFormatsTPC/CTF.h"
 #include "DataFormatsTRD/CTF.h"
@@ -39,10 +41,12 @@
 #include <vector>
 #include <array>
 #include <TStopwatch.h>
-#include <vector>
 #include <TFile.h>
 #include <TTree.h>
+#include <TROOT.h>
 #include <filesystem>
+#include <thread>
+#include <exception>
 
 using namespace o2::framework;
 
@@ -79,15 +83,31 @@ class CTFWriterSpec : public o2::framework::Task
  public:
   CTFWriterSpec() = delete;
   CTFWriterSpec(DetID::mask_t dm, uint64_t r = 0, bool doCTF = true, bool doDict = false, bool dictPerDet = false, size_t smn = 0, size_t szmx = 0);
-  ~CTFWriterSpec() override = default;
+  ~CTFWriterSpec() override { stopWriterThread(); }
   void init(o2::framework::InitContext& ic) final;
   void run(o2::framework::ProcessingContext& pc) final;
   void endOfStream(o2::framework::EndOfStreamContext& ec) final;
   bool isPresent(DetID id) const { return mDets[id]; }
 
  private:
+  using Images = CTFFlatFileWriter::Images;
+
+  /// CTF data detached from the input messages, to be written by the writer thread
+  struct CTFEntry {
+    CTFHeader header;
+    uint32_t runNumber = 0;
+    uint32_t tfCounter = 0;
+    size_t ctfID = 0;
+    std::array<std::vector<o2::ctf::BufferType>, DetID::nDetectors> buffers;
+  };
+
   template <typename C>
-  size_t processDet(o2::framework::ProcessingContext& pc, DetID det, CTFHeader& header, TTree* tree);
+  void processDet(o2::framework::ProcessingContext& pc, DetID det, CTFHeader& header, Images& images);
+  template <typename C>
+  size_t appendDetToTree(DetID det, gsl::span<const o2::ctf::BufferType> buf);
+  size_t writeCTF(const CTFHeader& header, uint32_t runNumber, uint32_t tfCounter, size_t ctfID, const Images& images);
+  void startWriterThread();
+  void stopWriterThread();
   template <typename C>
   void storeDictionary(DetID det, CTFHeader& header);
   void storeDictionaries();
@@ -95,13 +115,14 @@ class CTFWriterSpec : public o2::framework::Task
   void closeDictionaryTreeAndFile(CTFHeader& header);
   std::string dictionaryFileName(const std::string& detName = "");
   void closeTFTreeAndFile();
-  void prepareTFTreeAndFile(const o2::header::DataHeader* dh);
-  size_t estimateCTFSize(ProcessingContext& pc);
+  void prepareTFTreeAndFile(uint32_t runNumber, uint32_t firstTForbit, uint32_t tfCounter);
 
   DetID::mask_t mDets; // detectors
   bool mWriteCTF = false;
   bool mCreateDict = false;
   bool mDictPerDetector = false;
+  bool mFlatFormat = false; // write flat CTF container instead of the ROOT tree
+  int mAsyncQueueSize = 0;  // if > 0, CTFs are written by the dedicated thread with at most this number of TFs queued
   int mSaveDictAfter = -1; // if positive and mWriteCTF==true, save dictionary after each mSaveDictAfter TFs processed
   uint64_t mRun = 0;
   size_t mMinSize = 0;     // if > 0, accumulate CTFs in the same tree until the total size exceeds this minimum
@@ -117,6 +138,11 @@ class CTFWriterSpec : public o2::framework::Task
 
   std::unique_ptr<TFile> mCTFFileOut;
   std::unique_ptr<TTree> mCTFTreeOut;
+  std::unique_ptr<CTFFlatFileWriter> mCTFFlatFileOut;
+
+  std::unique_ptr<o2::utils::BoundedQueue<CTFEntry>> mQueue; // CTFs pending to be written by the writer thread
+  std::thread mWriterThread;
+  std::exception_ptr mWriterError; // exception thrown in the writer thread, to be rethrown by the processing one
 
   std::unique_ptr<TFile> mDictFileOut; // file to store dictionary
   std::unique_ptr<TTree> mDictTreeOut; // tree to store dictionary
@@ -135,17 +161,16 @@ class CTFWriterSpec : public o2::framework::Task
 //___________________________________________________________________
 // process data of particular detector
 template <typename C>
-size_t CTFWriterSpec::processDet(o2::framework::ProcessingContext& pc, DetID det, CTFHeader& header, TTree* tree)
+void CTFWriterSpec::processDet(o2::framework::ProcessingContext& pc, DetID det, CTFHeader& header, Images& images)
 {
-  size_t sz = 0;
   if (!isPresent(det) || !pc.inputs().isValid(det.getName())) {
-    return sz;
+    return;
   }
   auto ctfBuffer = pc.inputs().get<gsl::span<o2::ctf::BufferType>>(det.getName());
   const auto ctfImage = C::getImage(ctfBuffer.data());
   ctfImage.print(o2::utils::Str::concat_string(det.getName(), ": "));
   if (mWriteCTF) {
-    sz += ctfImage.appendToTree(*tree, det.getName());
+    images[det] = gsl::span<const o2::ctf::BufferType>(ctfBuffer.data(), ctfBuffer.size());
     header.detectors.set(det);
   }
   if (mCreateDict) {
@@ -167,7 +192,14 @@ size_t CTFWriterSpec::processDet(o2::framework::ProcessingContext& pc, DetID det
       }
     }
   }
-  return sz;
+}
+
+//___________________________________________________________________
+// add flat image of particular detector CTF to the output tree
+template <typename C>
+size_t CTFWriterSpec::appendDetToTree(DetID det, gsl::span<const o2::ctf::BufferType> buf)
+{
+  return C::getImage(buf.data()).appendToTree(*mCTFTreeOut.get(), det.getName());
 }
 
 //___________________________________________________________________
@@ -225,6 +257,13 @@ void CTFWriterSpec::init(InitContext& ic)
   mSaveDictAfter = ic.options().get<int>("save-dict-after");
   mDictDir = o2::utils::Str::rectifyDirectory(ic.options().get<std::string>("ctf-dict-dir"));
   mCTFDir = o2::utils::Str::rectifyDirectory(ic.options().get<std::string>("output-dir"));
+  auto format = ic.options().get<std::string>("file-format");
+  if (format == "flat") {
+    mFlatFormat = true;
+  } else if (format != "root") {
+    throw std::invalid_argument(o2::utils::Str::concat_string("Invalid CTF file-format ", format, ", allowed: root or flat"));
+  }
+  mAsyncQueueSize = ic.options().get<int>("async-queue");
   if (mWriteCTF) {
     if (mMinSize > 0) {
       LOG(INFO) << "Multiple CTFs will be accumulated in the tree/file until its size exceeds " << mMinSize << " bytes";
@@ -232,21 +271,12 @@ void CTFWriterSpec::init(InitContext& ic)
         LOG(INFO) << "but does not exceed " << mMaxSize << " bytes";
       }
     }
-  }
-}
-
-//___________________________________________________________________
-size_t CTFWriterSpec::estimateCTFSize(ProcessingContext& pc)
-{
-  size_t s = 0;
-  for (auto id = DetID::First; id <= DetID::Last; id++) {
-    DetID det(id);
-    if (!isPresent(det) || !pc.inputs().isValid(det.getName())) {
-      continue;
+    LOG(INFO) << "CTFs will be written in " << (mFlatFormat ? "flat" : "ROOT") << " format";
+    if (mAsyncQueueSize > 0) {
+      LOG(INFO) << "CTFs will be written asynchronously, with at most " << mAsyncQueueSize << " TFs queued";
+      startWriterThread();
     }
-    s += pc.inputs().get<gsl::span<o2::ctf::BufferType>>(det.getName()).size();
   }
-  return s;
 }
 
 //___________________________________________________________________
@@ -256,47 +286,46 @@ void CTFWriterSpec::run(ProcessingContext& pc)
   mTimer.Start(false);
   const auto dh = DataRefUtils::getHeader<o2::header::DataHeader*>(pc.inputs().getByPos(0));
 
-  mCurrCTFSize = estimateCTFSize(pc);
-  if (mWriteCTF) {
-    prepareTFTreeAndFile(dh);
-  }
-
   // create header
   CTFHeader header{mRun, dh->firstTForbit};
-  size_t szCTF = 0;
-  szCTF += processDet<o2::itsmft::CTF>(pc, DetID::ITS, header, mCTFTreeOut.get());
-  szCTF += processDet<o2::itsmft::CTF>(pc, DetID::MFT, header, mCTFTreeOut.get());
-  szCTF += processDet<o2::tpc::CTF>(pc, DetID::TPC, header, mCTFTreeOut.get());
-  szCTF += processDet<o2::trd::CTF>(pc, DetID::TRD, header, mCTFTreeOut.get());
-  szCTF += processDet<o2::tof::CTF>(pc, DetID::TOF, header, mCTFTreeOut.get());
-  szCTF += processDet<o2::ft0::CTF>(pc, DetID::FT0, header, mCTFTreeOut.get());
-  szCTF += processDet<o2::fv0::CTF>(pc, DetID::FV0, header, mCTFTreeOut.get());
-  szCTF += processDet<o2::fdd::CTF>(pc, DetID::FDD, header, mCTFTreeOut.get());
-  szCTF += processDet<o2::mid::CTF>(pc, DetID::MID, header, mCTFTreeOut.get());
-  szCTF += processDet<o2::mch::CTF>(pc, DetID::MCH, header, mCTFTreeOut.get());
-  szCTF += processDet<o2::emcal::CTF>(pc, DetID::EMC, header, mCTFTreeOut.get());
-  szCTF += processDet<o2::phos::CTF>(pc, DetID::PHS, header, mCTFTreeOut.get());
-  szCTF += processDet<o2::cpv::CTF>(pc, DetID::CPV, header, mCTFTreeOut.get());
-  szCTF += processDet<o2::zdc::CTF>(pc, DetID::ZDC, header, mCTFTreeOut.get());
-  szCTF += processDet<o2::hmpid::CTF>(pc, DetID::HMP, header, mCTFTreeOut.get());
-
-  mTimer.Stop();
+  Images images;
+  processDet<o2::itsmft::CTF>(pc, DetID::ITS, header, images);
+  processDet<o2::itsmft::CTF>(pc, DetID::MFT, header, images);
+  processDet<o2::tpc::CTF>(pc, DetID::TPC, header, images);
+  processDet<o2::trd::CTF>(pc, DetID::TRD, header, images);
+  processDet<o2::tof::CTF>(pc, DetID::TOF, header, images);
+  processDet<o2::ft0::CTF>(pc, DetID::FT0, header, images);
+  processDet<o2::fv0::CTF>(pc, DetID::FV0, header, images);
+  processDet<o2::fdd::CTF>(pc, DetID::FDD, header, images);
+  processDet<o2::mid::CTF>(pc, DetID::MID, header, images);
+  processDet<o2::mch::CTF>(pc, DetID::MCH, header, images);
+  processDet<o2::emcal::CTF>(pc, DetID::EMC, header, images);
+  processDet<o2::phos::CTF>(pc, DetID::PHS, header, images);
+  processDet<o2::cpv::CTF>(pc, DetID::CPV, header, images);
+  processDet<o2::zdc::CTF>(pc, DetID::ZDC, header, images);
+  processDet<o2::hmpid::CTF>(pc, DetID::HMP, header, images);
 
-  if (mWriteCTF) {
-    szCTF += appendToTree(*mCTFTreeOut.get(), "CTFHeader", header);
-    mAccCTFSize += szCTF;
-    mCTFTreeOut->SetEntries(++mNAccCTF);
-    LOG(INFO) << "TF#" << mNCTF << ": wrote CTF{" << header << "} of size " << szCTF << " to " << mCTFFileOut->GetName() << " in " << mTimer.CpuTime() - cput << " s";
-    if (mNAccCTF > 1) {
-      LOG(INFO) << "Current CTF tree has " << mNAccCTF << " entries with total size of " << mAccCTFSize << " bytes";
+  if (!mWriteCTF) {
+    size_t szCTF = 0;
+    for (const auto& img : images) {
+      szCTF += img.size();
     }
-  } else {
     LOG(INFO) << "TF#" << mNCTF << " CTF writing is disabled, size was " << szCTF << " bytes";
+  } else if (mQueue) {
+    // the input messages will be released once we return, detach the data for the writer thread
+    CTFEntry entry{header, dh->runNumber, dh->tfCounter, mNCTF};
+    for (int id = DetID::First; id <= DetID::Last; id++) {
+      entry.buffers[id].assign(images[id].begin(), images[id].end());
+    }
+    if (!mQueue->push(std::move(entry))) { // the queue is closed only if the writer has failed
+      stopWriterThread();
+      std::rethrow_exception(mWriterError);
+    }
+  } else {
+    writeCTF(header, dh->runNumber, dh->tfCounter, mNCTF, images);
   }
-
-  if (mWriteCTF && mAccCTFSize >= mMinSize) {
-    closeTFTreeAndFile();
-  }
+  mTimer.Stop();
+  LOGP(INFO, "TF#{} processed in {:.3f} s", mNCTF, mTimer.CpuTime() - cput);
 
   mNCTF++;
   if (mCreateDict && mSaveDictAfter > 0 && (mNCTF % mSaveDictAfter) == 0) {
@@ -304,6 +333,123 @@ void CTFWriterSpec::run(ProcessingContext& pc)
   }
 }
 
+//___________________________________________________________________
+size_t CTFWriterSpec::writeCTF(const CTFHeader& header, uint32_t runNumber, uint32_t tfCounter, size_t ctfID, const Images& images)
+{
+  mCurrCTFSize = 0;
+  for (const auto& img : images) {
+    mCurrCTFSize += img.size();
+  }
+  prepareTFTreeAndFile(runNumber, header.firstTForbit, tfCounter);
+
+  size_t szCTF = 0;
+  std::string fileName;
+  if (mFlatFormat) {
+    szCTF = mCTFFlatFileOut->writeEntry(header, tfCounter, images);
+    fileName = mCTFFlatFileOut->getFileName();
+  } else {
+    for (int id = DetID::First; id <= DetID::Last; id++) {
+      if (images[id].empty()) {
+        continue;
+      }
+      switch (id) {
+        case DetID::ITS:
+        case DetID::MFT:
+          szCTF += appendDetToTree<o2::itsmft::CTF>(id, images[id]);
+          break;
+        case DetID::TPC:
+          szCTF += appendDetToTree<o2::tpc::CTF>(id, images[id]);
+          break;
+        case DetID::TRD:
+          szCTF += appendDetToTree<o2::trd::CTF>(id, images[id]);
+          break;
+        case DetID::TOF:
+          szCTF += appendDetToTree<o2::tof::CTF>(id, images[id]);
+          break;
+        case DetID::FT0:
+          szCTF += appendDetToTree<o2::ft0::CTF>(id, images[id]);
+          break;
+        case DetID::FV0:
+          szCTF += appendDetToTree<o2::fv0::CTF>(id, images[id]);
+          break;
+        case DetID::FDD:
+          szCTF += appendDetToTree<o2::fdd::CTF>(id, images[id]);
+          break;
+        case DetID::MID:
+          szCTF += appendDetToTree<o2::mid::CTF>(id, images[id]);
+          break;
+        case DetID::MCH:
+          szCTF += appendDetToTree<o2::mch::CTF>(id, images[id]);
+          break;
+        case DetID::EMC:
+          szCTF += appendDetToTree<o2::emcal::CTF>(id, images[id]);
+          break;
+        case DetID::PHS:
+          szCTF += appendDetToTree<o2::phos::CTF>(id, images[id]);
+          break;
+        case DetID::CPV:
+          szCTF += appendDetToTree<o2::cpv::CTF>(id, images[id]);
+          break;
+        case DetID::ZDC:
+          szCTF += appendDetToTree<o2::zdc::CTF>(id, images[id]);
+          break;
+        case DetID::HMP:
+          szCTF += appendDetToTree<o2::hmpid::CTF>(id, images[id]);
+          break;
+        default:
+          throw std::runtime_error(o2::utils::Str::concat_string("CTF writing is not supported for ", DetID::getName(id)));
+      }
+    }
+    auto hd = header; // appendToTree needs non-const reference
+    szCTF += appendToTree(*mCTFTreeOut.get(), "CTFHeader", hd);
+    mCTFTreeOut->SetEntries(mNAccCTF + 1);
+    fileName = mCTFFileOut->GetName();
+  }
+  mAccCTFSize += szCTF;
+  mNAccCTF++;
+  LOG(INFO) << "TF#" << ctfID << ": wrote CTF{" << header << "} of size " << szCTF << " to " << fileName;
+  if (mNAccCTF > 1) {
+    LOG(INFO) << "Current CTF file has " << mNAccCTF << " entries with total size of " << mAccCTFSize << " bytes";
+  }
+  if (mAccCTFSize >= mMinSize) {
+    closeTFTreeAndFile();
+  }
+  return szCTF;
+}
+
+//___________________________________________________________________
+void CTFWriterSpec::startWriterThread()
+{
+  ROOT::EnableThreadSafety(); // the dictionaries may be stored by the processing thread while the writer fills the CTF tree
+  mQueue = std::make_unique<o2::utils::BoundedQueue<CTFEntry>>(mAsyncQueueSize);
+  mWriterThread = std::thread([this]() {
+    CTFEntry entry;
+    try {
+      while (mQueue->pop(entry)) {
+        Images images;
+        for (int id = DetID::First; id <= DetID::Last; id++) {
+          images[id] = gsl::span<const o2::ctf::BufferType>(entry.buffers[id].data(), entry.buffers[id].size());
+        }
+        writeCTF(entry.header, entry.runNumber, entry.tfCounter, entry.ctfID, images);
+      }
+    } catch (...) {
+      mWriterError = std::current_exception();
+      mQueue->close(); // make the processing thread aware of the failure
+    }
+  });
+}
+
+//___________________________________________________________________
+void CTFWriterSpec::stopWriterThread()
+{
+  if (mQueue) {
+    mQueue->close();
+  }
+  if (mWriterThread.joinable()) {
+    mWriterThread.join();
+  }
+}
+
 //___________________________________________________________________
 void CTFWriterSpec::endOfStream(EndOfStreamContext& ec)
 {
@@ -312,6 +458,10 @@ void CTFWriterSpec::endOfStream(EndOfStreamContext& ec)
     storeDictionaries();
   }
   if (mWriteCTF) {
+    stopWriterThread(); // flush pending CTFs
+    if (mWriterError) {
+      std::rethrow_exception(mWriterError);
+    }
     closeTFTreeAndFile();
   }
   LOGF(INFO, "CTF writing total timing: Cpu: %.3e Real: %.3e s in %d slots",
@@ -319,13 +469,13 @@ void CTFWriterSpec::endOfStream(EndOfStreamContext& ec)
 }
 
 //___________________________________________________________________
-void CTFWriterSpec::prepareTFTreeAndFile(const o2::header::DataHeader* dh)
+void CTFWriterSpec::prepareTFTreeAndFile(uint32_t runNumber, uint32_t firstTForbit, uint32_t tfCounter)
 {
   if (!mWriteCTF) {
     return;
   }
   bool needToOpen = false;
-  if (!mCTFTreeOut) {
+  if (!mCTFTreeOut && !mCTFFlatFileOut) {
     needToOpen = true;
   } else {
     if ((mAccCTFSize >= mMinSize) ||                                                         // min size exceeded, may close the file
@@ -337,8 +487,13 @@ void CTFWriterSpec::prepareTFTreeAndFile(const o2::header::DataHeader* dh)
   }
   if (needToOpen) {
     closeTFTreeAndFile();
-    mCTFFileOut.reset(TFile::Open(o2::utils::Str::concat_string(mCTFDir, o2::base::NameConf::getCTFFileName(dh->runNumber, dh->firstTForbit, dh->tfCounter)).c_str(), "recreate"));
-    mCTFTreeOut = std::make_unique<TTree>(std::string(o2::base::NameConf::CTFTREENAME).c_str(), "O2 CTF tree");
+    if (mFlatFormat) {
+      mCTFFlatFileOut = std::make_unique<CTFFlatFileWriter>();
+      mCTFFlatFileOut->open(o2::utils::Str::concat_string(mCTFDir, o2::base::NameConf::getCTFFileName(runNumber, firstTForbit, tfCounter, "o2_ctf", o2::base::NameConf::CTFFLATEXT)));
+    } else {
+      mCTFFileOut.reset(TFile::Open(o2::utils::Str::concat_string(mCTFDir, o2::base::NameConf::getCTFFileName(runNumber, firstTForbit, tfCounter)).c_str(), "recreate"));
+      mCTFTreeOut = std::make_unique<TTree>(std::string(o2::base::NameConf::CTFTREENAME).c_str(), "O2 CTF tree");
+    }
     mNCTFFiles++;
   }
 }
@@ -351,8 +506,12 @@ void CTFWriterSpec::closeTFTreeAndFile()
     mCTFTreeOut.reset();
     mCTFFileOut->Close();
     mCTFFileOut.reset();
-    mNAccCTF = 0;
   }
+  if (mCTFFlatFileOut) {
+    mCTFFlatFileOut->close();
+    mCTFFlatFileOut.reset();
+  }
+  mNAccCTF = 0;
   mAccCTFSize = 0;
 }
 
@@ -443,7 +602,9 @@ DataProcessorSpec getCTFWriterSpec(DetID::mask_t dets, uint64_t run, bool doCTF,
     AlgorithmSpec{adaptFromTask<CTFWriterSpec>(dets, run, doCTF, doDict, dictPerDet, szmn, szmx)},
     Options{{"save-dict-after", VariantType::Int, -1, {"In dictionary generation mode save it dictionary after certain number of TFs processed"}},
             {"ctf-dict-dir", VariantType::String, "none", {"CTF dictionary directory"}},
-            {"output-dir", VariantType::String, "none", {"CTF output directory"}}}};
+            {"output-dir", VariantType::String, "none", {"CTF output directory"}},
+            {"file-format", VariantType::String, "root", {"CTF file format: root (tree) or flat (memory-mappable container)"}},
+            {"async-queue", VariantType::Int, 0, {"if > 0, write CTFs from the dedicated thread buffering at most this number of TFs"}}}};
 }
 
 } // namespace ctf
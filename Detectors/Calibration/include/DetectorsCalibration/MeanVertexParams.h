@@ -36,6 +36,8 @@ struct MeanVertexParams : public o2::conf::ConfigurableParamHelper<MeanVertexPar
   bool useFit = false;
   int tfPerSlot = 5;
   int maxTFdelay = 3;
+  int nThreadsFill = 1;  // number of threads to fill the slot data
+  int asyncFinalize = 0; // if > 0, finalize slots in separate thread with at most this number of slots pending
 
   O2ParamDef(MeanVertexParams, "MeanVertexCalib");
 };
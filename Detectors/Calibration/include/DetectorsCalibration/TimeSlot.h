@@ -13,6 +13,7 @@
 #define DETECTOR_CALIB_TIMESLOT_H_
 
 #include <memory>
+#include <vector>
 #include <Rtypes.h>
 #include "Framework/Logger.h"
 
@@ -41,6 +42,8 @@ class TimeSlot
     }
     return *this;
   }
+  TimeSlot(TimeSlot&& src) = default;
+  TimeSlot& operator=(TimeSlot&& src) = default;
 
   ~TimeSlot() = default;
 
@@ -59,10 +62,40 @@ class TimeSlot
   // merge data of previous slot to this one and extend the mTFStart to cover prev
   void mergeToPrevious(TimeSlot& prev)
   {
+    prev.mergeShards();
     mContainer->merge(prev.mContainer.get());
     mTFStart = prev.mTFStart;
   }
 
+  // create n shards: copies of the (still empty) container which can be filled concurrently with the main one
+  void createShards(int n)
+  {
+    mShards.clear();
+    mShardPrototype.reset();
+    if (n > 0) {
+      mShardPrototype = std::make_unique<Container>(*mContainer);
+      for (int i = 0; i < n; i++) {
+        mShards.emplace_back(std::make_unique<Container>(*mShardPrototype));
+      }
+    }
+  }
+  int getNShards() const { return mShards.size(); }
+  Container* getShard(int i) { return mShards[i].get(); }
+  void setShardsFilled() { mShardsFilled = true; }
+
+  // add the data accumulated in the shards to the main container and reset the shards
+  void mergeShards()
+  {
+    if (!mShardsFilled) {
+      return;
+    }
+    for (auto& shard : mShards) {
+      mContainer->merge(shard.get());
+      shard = std::make_unique<Container>(*mShardPrototype);
+    }
+    mShardsFilled = false;
+  }
+
   void print() const
   {
     LOGF(INFO, "Calibration slot %5d <=TF<=  %5d", mTFStart, mTFEnd);
@@ -74,6 +107,9 @@ class TimeSlot
   TFType mTFEnd = 0;
   size_t mEntries = 0;
   std::unique_ptr<Container> mContainer; // user object to accumulate the calibration data for this slot
+  std::vector<std::unique_ptr<Container>> mShards; //! extra containers for concurrent filling
+  std::unique_ptr<Container> mShardPrototype;      //! empty container to reset the shards
+  bool mShardsFilled = false;                      //! do the shards have data not merged yet?
 
   ClassDefNV(TimeSlot, 1);
 };
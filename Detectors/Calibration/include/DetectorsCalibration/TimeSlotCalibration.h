@@ -15,9 +15,19 @@
 /// @brief Processor for the multiple time slots calibration
 
 #include "DetectorsCalibration/TimeSlot.h"
+#include "CommonUtils/BoundedQueue.h"
+#include <TROOT.h>
 #include <deque>
 #include <gsl/gsl>
 #include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <vector>
 
 namespace o2
 {
@@ -31,7 +41,11 @@ class TimeSlotCalibration
 
  public:
   TimeSlotCalibration() = default;
-  virtual ~TimeSlotCalibration() = default;
+  virtual ~TimeSlotCalibration()
+  {
+    stopFinalization();
+    stopFillThreads();
+  }
   uint64_t getMaxSlotsDelay() const { return mMaxSlotsDelay; }
   void setMaxSlotsDelay(uint64_t v) { mMaxSlotsDelay = v; }
 
@@ -49,6 +63,24 @@ class TimeSlotCalibration
 
   void setUpdateAtTheEndOfRunOnly() { mUpdateAtTheEndOfRunOnly = kTRUE; }
 
+  /// Fill the slot by nThreads threads (the calling one and a pool of nThreads-1), each one filling its own shard
+  /// of the slot container. The shards are merged to the slot container (via Container::merge) before the slot
+  /// is checked for finalization. Requires Container::fill to be safe to call concurrently on different container objects
+  int getNThreadsFill() const { return mNThreadsFill; }
+  void setNThreadsFill(int n);
+
+  /// Run finalizeSlot in the separate thread, so that the processing of the following TFs is not blocked.
+  /// At most maxPending slots may wait for the finalization before process blocks.
+  /// The finalizeSlot of the derived class should modify only the slot and its own state; it must take the lock
+  /// provided by lockOutput() to publish the results to the output (and to read the settings the owner may change
+  /// meanwhile), but not for the whole finalization. The owner must call waitFinalization (or checkSlotsToFinalize
+  /// with the end-of-run TF) to collect the results. The derived class must call stopFinalization in its destructor.
+  bool isAsyncFinalization() const { return mFinalizeQueue != nullptr; }
+  void setAsyncFinalization(size_t maxPending = 2);
+  void waitFinalization();
+  void stopFinalization();
+  std::unique_lock<std::mutex> lockOutput() { return std::unique_lock<std::mutex>(mOutputMutex); }
+
   int getNSlots() const { return mSlots.size(); }
   Slot& getSlotForTF(TFType tf);
   Slot& getSlot(int i) { return (Slot&)mSlots.at(i); }
@@ -78,9 +110,30 @@ class TimeSlotCalibration
 
  private:
   TFType tf2SlotMin(TFType tf) const;
+  Slot& addSlot(bool front, TFType tstart, TFType tend);
+  void fillSlot(Slot& slot, const gsl::span<const Input> data);
+  void finalizeSlotAndOutput(Slot& slot);
+  void stopFillThreads();
+  void rethrowFinalizeError();
 
   std::deque<Slot> mSlots;
 
+  int mNThreadsFill = 1;                                                      //! number of threads to fill the slot
+  std::unique_ptr<o2::utils::BoundedQueue<std::function<void()>>> mFillQueue; //! shards to fill by the pool
+  std::vector<std::thread> mFillThreads;                                      //! pool filling the shards
+  std::mutex mFillMutex;                                                      //!
+  std::condition_variable mFillDone;                                          //!
+  int mNFillPending = 0;                                                      //! shards of the current TF not filled yet
+  std::exception_ptr mFillError;                                              //! exception thrown by the filling of a shard
+  std::mutex mOutputMutex;                                                    //! lock for the output produced by finalizeSlot
+  std::unique_ptr<o2::utils::BoundedQueue<Slot>> mFinalizeQueue;              //! slots waiting for the asynchronous finalization
+  std::thread mFinalizeThread;                                                //!
+  std::mutex mFinalizeMutex;                                                  //!
+  std::condition_variable mFinalizeDone;                                      //!
+  size_t mNFinalizePending = 0;                                               //! slots queued but not finalized yet
+  std::atomic<bool> mFinalizeStop{false};                                     //! discard pending slots (calibrator is being destroyed)
+  std::exception_ptr mFinalizeError;                                          //! exception thrown in the finalization thread, guarded by mFinalizeMutex
+
   TFType mLastClosedTF = 0;
   TFType mFirstTF = 0;
   TFType mMaxSeenTF = 0; // largest TF processed
@@ -107,6 +160,7 @@ bool TimeSlotCalibration<Input, Container>::process(TFType tf, const gsl::span<c
 {
 
   // process current TF
+  rethrowFinalizeError();
 
   int maxDelay = mMaxSlotsDelay * mSlotLength;
   if (!mUpdateAtTheEndOfRunOnly) {                                                               // if you update at the end of run only, then you accept everything
@@ -120,7 +174,7 @@ bool TimeSlotCalibration<Input, Container>::process(TFType tf, const gsl::span<c
   }
 
   auto& slotTF = getSlotForTF(tf);
-  slotTF.getContainer()->fill(data);
+  fillSlot(slotTF, data);
   if (tf > mMaxSeenTF) {
     mMaxSeenTF = tf; // keep track of the most recent TF processed
   }
@@ -159,18 +213,19 @@ void TimeSlotCalibration<Input, Container>::checkSlotsToFinalize(TFType tf, int
         LOG(INFO) << "Update interval passed (" << checkInterval << "), checking slot for " << mSlots[0].getTFStart() << " <= TF <= " << mSlots[0].getTFEnd();
       }
       mLastCheckedTFInfiniteSlot = tf;
+      mSlots[0].mergeShards();
       if (hasEnoughData(mSlots[0])) {
         mWasCheckedInfiniteSlot = false;
         mSlots[0].setTFStart(mLastClosedTF);
         mSlots[0].setTFEnd(mMaxSeenTF);
         LOG(INFO) << "Finalizing slot for " << mSlots[0].getTFStart() << " <= TF <= " << mSlots[0].getTFEnd();
-        finalizeSlot(mSlots[0]);                  // will be removed after finalization
+        finalizeSlotAndOutput(mSlots[0]);         // will be removed after finalization
         mLastClosedTF = mSlots[0].getTFEnd() + 1; // will not accept any TF below this
         mSlots.erase(mSlots.begin());
         // creating a new slot if we are not at the end of run
         if (tf != INFINITE_TF) {
           LOG(INFO) << "Creating new slot for " << mLastClosedTF << " <= TF <= " << INFINITE_TF_int64;
-          emplaceNewSlot(true, mLastClosedTF, INFINITE_TF_int64);
+          addSlot(true, mLastClosedTF, INFINITE_TF_int64);
         }
       } else {
         LOG(INFO) << "Not enough data to calibrate";
@@ -184,9 +239,10 @@ void TimeSlotCalibration<Input, Container>::checkSlotsToFinalize(TFType tf, int
     for (auto slot = mSlots.begin(); slot != mSlots.end(); slot++) {
       //if (maxDelay == 0 || (slot->getTFEnd() + maxDelay) < tf) {
       if ((slot->getTFEnd() + maxDelay) < tf) {
+        slot->mergeShards();
         if (hasEnoughData(*slot)) {
           LOG(DEBUG) << "Finalizing slot for " << slot->getTFStart() << " <= TF <= " << slot->getTFEnd();
-          finalizeSlot(*slot); // will be removed after finalization
+          finalizeSlotAndOutput(*slot); // will be removed after finalization
         } else if ((slot + 1) != mSlots.end()) {
           LOG(INFO) << "Merging underpopulated slot " << slot->getTFStart() << " <= TF <= " << slot->getTFEnd()
                     << " to slot " << (slot + 1)->getTFStart() << " <= TF <= " << (slot + 1)->getTFEnd();
@@ -206,6 +262,9 @@ void TimeSlotCalibration<Input, Container>::checkSlotsToFinalize(TFType tf, int
       }
     }
   }
+  if (tf == INFINITE_TF) { // end of run: the results must be available on return
+    waitFinalization();
+  }
 }
 
 //_________________________________________________
@@ -217,7 +276,8 @@ void TimeSlotCalibration<Input, Container>::finalizeOldestSlot()
     LOG(WARNING) << "There are no slots defined";
     return;
   }
-  finalizeSlot(mSlots.front());
+  mSlots.front().mergeShards();
+  finalizeSlotAndOutput(mSlots.front());
   mLastClosedTF = mSlots.front().getTFEnd() + 1; // do not accept any TF below this
   mSlots.erase(mSlots.begin());
 }
@@ -249,7 +309,7 @@ TimeSlot<Container>& TimeSlotCalibration<Input, Container>::getSlotForTF(TFType
     if (!mSlots.empty() && mSlots.back().getTFEnd() < tf) {
       mSlots.back().setTFEnd(tf);
     } else if (mSlots.empty()) {
-      emplaceNewSlot(true, mFirstTF, tf);
+      addSlot(true, mFirstTF, tf);
     }
     return mSlots.back();
   }
@@ -259,7 +319,7 @@ TimeSlot<Container>& TimeSlotCalibration<Input, Container>::getSlotForTF(TFType
     auto tftgt = tf2SlotMin(tf);                             // min TF of the slot to which the TF "tf" would belong
     while (tfmn >= tftgt) {
       LOG(INFO) << "Adding new slot for " << tfmn << " <= TF <= " << tfmn + mSlotLength - 1;
-      emplaceNewSlot(true, tfmn, tfmn + mSlotLength - 1);
+      addSlot(true, tfmn, tfmn + mSlotLength - 1);
       if (!tfmn) {
         break;
       }
@@ -277,13 +337,205 @@ TimeSlot<Container>& TimeSlotCalibration<Input, Container>::getSlotForTF(TFType
   auto tfmn = mSlots.empty() ? tf2SlotMin(tf) : tf2SlotMin(mSlots.back().getTFEnd() + 1);
   do {
     LOG(INFO) << "Adding new slot for " << tfmn << " <= TF <= " << tfmn + mSlotLength - 1;
-    emplaceNewSlot(false, tfmn, tfmn + mSlotLength - 1);
+    addSlot(false, tfmn, tfmn + mSlotLength - 1);
     tfmn = tf2SlotMin(mSlots.back().getTFEnd() + 1);
   } while (tf > mSlots.back().getTFEnd());
 
   return mSlots.back();
 }
 
+//_________________________________________________
+template <typename Input, typename Container>
+TimeSlot<Container>& TimeSlotCalibration<Input, Container>::addSlot(bool front, TFType tstart, TFType tend)
+{
+  // create new slot via the user method and, if needed, its shards for concurrent filling
+  auto& slot = emplaceNewSlot(front, tstart, tend);
+  if (mNThreadsFill > 1) {
+    slot.createShards(mNThreadsFill - 1);
+  }
+  return slot;
+}
+
+//_________________________________________________
+template <typename Input, typename Container>
+void TimeSlotCalibration<Input, Container>::fillSlot(Slot& slot, const gsl::span<const Input> data)
+{
+  // fill the slot container, splitting the data between the container and its shards if requested
+  int nShards = slot.getNShards();
+  if (nShards == 0 || data.size() < size_t(nShards + 1)) {
+    slot.getContainer()->fill(data);
+    return;
+  }
+  if (mFillThreads.empty()) { // the slot was created with more threads than set now
+    slot.getContainer()->fill(data);
+    return;
+  }
+  size_t chunk = data.size() / (nShards + 1);
+  {
+    std::lock_guard<std::mutex> lock(mFillMutex);
+    mNFillPending = nShards;
+  }
+  for (int i = 0; i < nShards; i++) {
+    mFillQueue->push([&slot, data, chunk, i]() { slot.getShard(i)->fill(data.subspan(chunk * (i + 1), chunk)); });
+  }
+  std::exception_ptr error;
+  try {
+    slot.getContainer()->fill(data.first(chunk));
+    auto nDone = chunk * (nShards + 1);
+    if (nDone < data.size()) { // remainder of the division
+      slot.getContainer()->fill(data.subspan(nDone));
+    }
+  } catch (...) {
+    error = std::current_exception();
+  }
+  // the shards must be filled before returning in any case, since the data are not owned
+  std::unique_lock<std::mutex> lock(mFillMutex);
+  mFillDone.wait(lock, [this]() { return mNFillPending == 0; });
+  slot.setShardsFilled();
+  if (!error) {
+    error = mFillError;
+  }
+  mFillError = nullptr;
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+//_________________________________________________
+template <typename Input, typename Container>
+void TimeSlotCalibration<Input, Container>::setNThreadsFill(int n)
+{
+  // (re)create the pool of threads filling the shards of the slot containers
+  stopFillThreads();
+  mNThreadsFill = n > 1 ? n : 1;
+  if (mNThreadsFill == 1) {
+    return;
+  }
+  mFillQueue = std::make_unique<o2::utils::BoundedQueue<std::function<void()>>>(mNThreadsFill - 1);
+  for (int i = 1; i < mNThreadsFill; i++) {
+    mFillThreads.emplace_back([this]() {
+      std::function<void()> task;
+      while (mFillQueue->pop(task)) {
+        try {
+          task();
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(mFillMutex);
+          mFillError = std::current_exception();
+        }
+        {
+          std::lock_guard<std::mutex> lock(mFillMutex);
+          mNFillPending--;
+        }
+        mFillDone.notify_all();
+      }
+    });
+  }
+}
+
+//_________________________________________________
+template <typename Input, typename Container>
+void TimeSlotCalibration<Input, Container>::stopFillThreads()
+{
+  if (mFillQueue) {
+    mFillQueue->close();
+  }
+  for (auto& th : mFillThreads) {
+    th.join();
+  }
+  mFillThreads.clear();
+  mFillQueue.reset();
+}
+
+//_________________________________________________
+template <typename Input, typename Container>
+void TimeSlotCalibration<Input, Container>::finalizeSlotAndOutput(Slot& slot)
+{
+  // finalize the slot in place or move it to the finalization thread
+  if (!mFinalizeQueue) {
+    finalizeSlot(slot);
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mFinalizeMutex);
+    mNFinalizePending++;
+  }
+  mFinalizeQueue->push(std::move(slot)); // the slot in the deque is left empty and will be removed by the caller
+}
+
+//_________________________________________________
+template <typename Input, typename Container>
+void TimeSlotCalibration<Input, Container>::setAsyncFinalization(size_t maxPending)
+{
+  if (mFinalizeQueue) {
+    return; // already done
+  }
+  ROOT::EnableThreadSafety(); // finalizeSlot may use ROOT (e.g. fits) outside of the main thread
+  mFinalizeQueue = std::make_unique<o2::utils::BoundedQueue<Slot>>(maxPending);
+  mFinalizeThread = std::thread([this]() {
+    Slot slot;
+    while (mFinalizeQueue->pop(slot)) {
+      std::exception_ptr error;
+      try {
+        if (!mFinalizeStop) {
+          finalizeSlot(slot); // takes the output lock itself to publish the results
+        }
+      } catch (...) {
+        error = std::current_exception();
+      }
+      slot = Slot{};
+      {
+        std::lock_guard<std::mutex> lock(mFinalizeMutex);
+        if (error) {
+          mFinalizeError = error;
+        }
+        mNFinalizePending--;
+      }
+      mFinalizeDone.notify_all();
+    }
+  });
+  LOG(INFO) << "Slots will be finalized asynchronously, at most " << maxPending << " slots pending";
+}
+
+//_________________________________________________
+template <typename Input, typename Container>
+void TimeSlotCalibration<Input, Container>::waitFinalization()
+{
+  // block until all slots passed to the finalization thread are processed
+  if (mFinalizeQueue) {
+    std::unique_lock<std::mutex> lock(mFinalizeMutex);
+    mFinalizeDone.wait(lock, [this]() { return mNFinalizePending == 0; });
+  }
+  rethrowFinalizeError();
+}
+
+//_________________________________________________
+template <typename Input, typename Container>
+void TimeSlotCalibration<Input, Container>::rethrowFinalizeError()
+{
+  std::exception_ptr error;
+  {
+    std::lock_guard<std::mutex> lock(mFinalizeMutex);
+    error = mFinalizeError;
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+//_________________________________________________
+template <typename Input, typename Container>
+void TimeSlotCalibration<Input, Container>::stopFinalization()
+{
+  // stop the finalization thread once the slot being finalized is done, the pending slots are discarded
+  if (mFinalizeQueue) {
+    mFinalizeStop = true; // the derived object is being destroyed, pending slots cannot be finalized anymore
+    mFinalizeQueue->close();
+  }
+  if (mFinalizeThread.joinable()) {
+    mFinalizeThread.join();
+  }
+}
+
 //_________________________________________________
 template <typename Input, typename Container>
 void TimeSlotCalibration<Input, Container>::print() const
@@ -146,6 +146,7 @@ void MeanVertexCalibrator::finalizeSlot(Slot& slot)
   std::map<std::string, std::string> md;
   auto clName = o2::utils::MemFileHelper::getClassName(mSMAMVobj);
   auto flName = o2::ccdb::CcdbApi::generateFileName(clName);
+  auto lock = lockOutput(); // the output might be read by the device meanwhile
   mInfoVector.emplace_back("GRP/MeanVertex", clName, flName, md, startValidity, 99999999999999);
   mMeanVertexVector.emplace_back(mSMAMVobj);
 
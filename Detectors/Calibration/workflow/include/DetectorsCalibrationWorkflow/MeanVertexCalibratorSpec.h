@@ -34,7 +34,7 @@ class MeanVertexCalibDevice : public Task
   void endOfStream(o2::framework::EndOfStreamContext& ec) final;
 
  private:
-  void sendOutput(DataAllocator& output);
+  size_t sendOutput(DataAllocator& output);
 
   std::unique_ptr<o2::calibration::MeanVertexCalibrator> mCalibrator;
 };
@@ -44,6 +44,10 @@ void MeanVertexCalibDevice::init(InitContext& ic)
   mCalibrator = std::make_unique<o2::calibration::MeanVertexCalibrator>(minEnt, useFit, nbX, rangeX, nbY, rangeY, nbZ, rangeZ, nSlots4SMA);
   mCalibrator->setSlotLength(slotL);
   mCalibrator->setMaxSlotsDelay(delay);
+  mCalibrator->setNThreadsFill(params->nThreadsFill);
+  if (params->asyncFinalize > 0) {
+    mCalibrator->setAsyncFinalization(params->asyncFinalize);
+  }
 }
 
 //_____________________________________________________________
@@ -55,9 +59,8 @@ void MeanVertexCalibDevice::run(o2::framework::ProcessingContext& pc)
   auto data = pc.inputs().get<gsl::span<o2::dataformats::PrimaryVertex>>("input");
   LOG(INFO) << "Processing TF " << tfcounter << " with " << data.size() << " tracks";
   mCalibrator->process(tfcounter, data);
-  sendOutput(pc.outputs());
-  const auto& infoVec = mCalibrator->getMeanVertexObjectInfoVector();
-  LOG(INFO) << "Created " << infoVec.size() << " objects for TF " << tfcounter;
+  auto nCreated = sendOutput(pc.outputs());
+  LOG(INFO) << "Created " << nCreated << " objects for TF " << tfcounter;
 }
 
 //_____________________________________________________________
@@ -73,13 +76,14 @@ void MeanVertexCalibDevice::endOfStream(o2::framework::EndOfStreamContext& ec)
 
 //_____________________________________________________________
 
-void MeanVertexCalibDevice::sendOutput(DataAllocator& output)
+size_t MeanVertexCalibDevice::sendOutput(DataAllocator& output)
 {
 
   // extract CCDB infos and calibration objects, convert it to TMemFile and send them to the output
   // TODO in principle, this routine is generic, can be moved to Utils.h
 
   using clbUtils = o2::calibration::Utils;
+  auto lock = mCalibrator->lockOutput(); // the output might be filled by the asynchronous finalization
   const auto& payloadVec = mCalibrator->getMeanVertexObjectVector();
   auto& infoVec = mCalibrator->getMeanVertexObjectInfoVector(); // use non-const version as we update it
   assert(payloadVec.size() == infoVec.size());
@@ -93,9 +97,11 @@ void MeanVertexCalibDevice::sendOutput(DataAllocator& output)
     output.snapshot(Output{clbUtils::gDataOriginCDBPayload, "MEANVERTEX", i}, *image.get()); // vector<char>
     output.snapshot(Output{clbUtils::gDataOriginCDBWrapper, "MEANVERTEX", i}, w);            // root-serialized
   }
-  if (payloadVec.size()) {
+  auto nSent = payloadVec.size();
+  if (nSent) {
     mCalibrator->initOutput(); // reset the outputs once they are already sent
   }
+  return nSent;
 }
 } // namespace calibration
 
@@ -0,0 +1,120 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef EMCALRAWFITTERLM_H_
+#define EMCALRAWFITTERLM_H_
+
+#include <iosfwd>
+#include <array>
+#include <optional>
+#include <variant>
+#include <vector>
+#include <Rtypes.h>
+#include "MathUtils/GammaPulseFitter.h"
+#include "EMCALReconstruction/CaloFitResults.h"
+#include "DataFormatsEMCAL/Constants.h"
+#include "EMCALReconstruction/Bunch.h"
+#include "EMCALReconstruction/CaloRawFitter.h"
+
+namespace o2
+{
+
+namespace emcal
+{
+
+/// \class CaloRawFitterLM
+/// \brief  Raw data fitting: fit of the response function of the standard raw fitter with a Levenberg-Marquardt solver
+/// \ingroup EMCALreconstruction
+///
+/// Same fit as CaloRawFitterStandard (Gamma-n response, fixed tau and order, no pedestal, equal
+/// errors on all samples) without TGraph/TF1/TMinuit: the minimisation is done by the
+/// o2::math_utils::GammaPulseFitter on fixed-size arrays. Several channels can be evaluated in
+/// one call, their peak fits being then done together in batches.
+class CaloRawFitterLM final : public CaloRawFitter
+{
+
+ public:
+  using PulseFitter = o2::math_utils::GammaPulseFitter<double, constants::EMCAL_MAXTIMEBINS>;
+
+  /// \brief Constructor
+  CaloRawFitterLM();
+
+  /// \brief Destructor
+  ~CaloRawFitterLM() final = default;
+
+  /// \brief Evaluation Amplitude and TOF
+  /// \param bunchvector Calo bunches for the tower and event
+  /// \param altrocfg1 ALTRO config register 1 from RCU trailer
+  /// \param altrocfg2 ALTRO config register 2 from RCU trailer
+  /// \return Container with the fit results (amp, time, chi2, ...)
+  /// \throw RawFitterError_t in case the fit failed (including all possible errors from upstream)
+  CaloFitResults evaluate(const gsl::span<const Bunch> bunchvector,
+                          std::optional<unsigned int> altrocfg1,
+                          std::optional<unsigned int> altrocfg2) final;
+
+  /// \brief Evaluation Amplitude and TOF of several channels
+  /// \param channels Calo bunches of each tower
+  /// \param altrocfg1 ALTRO config register 1 from RCU trailer
+  /// \param altrocfg2 ALTRO config register 2 from RCU trailer
+  /// \return For each tower the fit results, or the error in case the evaluation failed
+  std::vector<std::variant<CaloFitResults, RawFitterError_t>> evaluate(const gsl::span<const gsl::span<const Bunch>> channels,
+                                                                       std::optional<unsigned int> altrocfg1,
+                                                                       std::optional<unsigned int> altrocfg2);
+
+  /// \brief Fits the raw signal time distribution
+  /// \param firstTimeBin First timebin of the ALTRO bunch
+  /// \param lastTimeBin Last timebin of the ALTRO bunch
+  /// \param ampEstimate Initial value of the amplitude, allowed to vary between 0.5 and 2 times this value
+  /// \param timeEstimate Initial value of the time, allowed to vary by +-4 time bins
+  /// \return the fit parameters: amplitude, time, chi2
+  /// \throw RawFitterError_t::FIT_ERROR in case the fit failed (insufficient number of samples or no convergence)
+  std::tuple<float, float, float> fitRaw(int firstTimeBin, int lastTimeBin, float ampEstimate, float timeEstimate) const;
+
+  PulseFitter& getPulseFitter() { return mPulseFitter; }
+
+ private:
+  /// evaluation of a channel between the selection of the samples and the peak fit
+  struct ChannelFit {
+    std::array<double, constants::EMCAL_MAXTIMEBINS> samples; ///< samples of the selected bunch (reversed, pedestal subtracted)
+    PulseFitter::Pulse pulse;                                 ///< peak fit, with the time relative to the first fitted sample
+    int first = 0;                                            ///< first fitted sample
+    int nsamples = 0;                                         ///< number of selected samples
+    int timebinOffset = 0;                                    ///< offset of the selected bunch
+    float ampEstimate = 0;                                    ///< amplitude estimated from the max sample
+    float timeEstimate = 0;                                   ///< time estimated from the max sample
+    short maxADC = 0;                                         ///< max ADC value
+    float pedEstimate = 0;                                    ///< pedestal estimate
+    bool selected = false;                                    ///< a bunch with significant signal was found
+    bool doFit = false;                                       ///< the peak fit is possible
+  };
+
+  /// \brief select the samples of the channel and prepare the peak fit
+  void prepareFit(const gsl::span<const Bunch> bunchvector, std::optional<unsigned int> altrocfg1, std::optional<unsigned int> altrocfg2, ChannelFit& fit);
+
+  /// \brief set the pulse fit for the samples first to last of the selected bunch
+  void setPulse(ChannelFit& fit, int first, int last) const;
+
+  /// \brief build the fit results from the (eventually done) peak fit
+  /// \throw RawFitterError_t::FIT_ERROR in case the amplitude is below the cut
+  CaloFitResults finaliseFit(ChannelFit& fit) const;
+
+  PulseFitter mPulseFitter;                //! Gamma-n response fitter
+  std::vector<ChannelFit> mChannelFits;    //! work space for the evaluation of several channels
+  std::vector<PulseFitter::Pulse> mPulses; //! peak fits of several channels, done in batches
+  std::vector<int> mPulseChannels;         //! channels of the peak fits
+
+  ClassDefNV(CaloRawFitterLM, 1);
+}; // End of CaloRawFitterLM
+
+} // namespace emcal
+
+} // namespace o2
+#endif
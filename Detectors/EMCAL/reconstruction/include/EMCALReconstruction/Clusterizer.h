@@ -15,6 +15,7 @@
 #define ALICEO2_EMCAL_CLUSTERIZER_H
 
 #include <array>
+#include <vector>
 #include <gsl/span>
 #include "Rtypes.h"
 #include "DataFormatsEMCAL/Cluster.h"
@@ -31,6 +32,8 @@ namespace emcal
 // Define numbers rows/columns for topological representation of cells
 constexpr unsigned int NROWS = (24 + 1) * (6 + 4); // 10x supermodule rows (6 for EMCAL, 4 for DCAL). +1 accounts for topological gap between two supermodules
 constexpr unsigned int NCOLS = 48 * 2 + 1;         // 2x  supermodule columns + 1 empty space in between for DCAL (not used for EMCAL)
+constexpr unsigned int NROWSSM = 24 + 1;           // supermodule rows + topological gap
+constexpr unsigned int NSMROWS = 6 + 4;            // rows of supermodules in phi (6 for EMCAL, 4 for DCAL)
 
 using ClusterIndex = int;
 
@@ -41,6 +44,10 @@ using ClusterIndex = int;
 ///
 ///  Implementation of same algorithm version as in AliEMCALClusterizerv2,
 ///  but optimized.
+///
+///  The rows of supermodules in phi are separated by an empty topological row, no cluster
+///  can extend over two of them: they are clustered independently, in parallel if several
+///  threads are requested, and the clusters are merged in the order of the seed energies.
 
 template <class InputType>
 class Clusterizer
@@ -59,10 +66,33 @@ class Clusterizer
   };
 
   struct InputwithIndex {
-    InputType* mInput;
+    const InputType* mInput;
     ClusterIndex mIndex;
   };
 
+  /// cell/digit of the neighbour search, with the next direction to look at
+  struct NeighbourSearch {
+    int mRow;
+    int mColumn;
+    int mDirection;
+  };
+
+  /// clustering of a row of supermodules
+  struct ClusterRegion {
+    std::vector<int> mSeeds;                 ///< positions of the seeds in the seed list, by descending energy
+    std::vector<int> mClusterSeeds;          ///< position of the seed of each cluster in the seed list
+    std::vector<Cluster> mClusters;          ///< clusters, with cell/digit ranges wrt. mInputIndices
+    std::vector<ClusterIndex> mInputIndices; ///< cell/digit indices, ordered by cluster
+    std::vector<NeighbourSearch> mStack;     ///< work stack of the neighbour search
+    void clear()
+    {
+      mSeeds.clear();
+      mClusterSeeds.clear();
+      mClusters.clear();
+      mInputIndices.clear();
+    }
+  };
+
  public:
   Clusterizer(double timeCut, double timeMin, double timeMax, double gradientCut, bool doEnergyGradientCut, double thresholdSeedE, double thresholdCellE);
   Clusterizer();
@@ -79,14 +109,20 @@ class Clusterizer
   const std::vector<ClusterIndex>* getFoundClustersInputIndices() const { return &mInputIndices; }
   void setGeometry(Geometry* geometry) { mEMCALGeometry = geometry; }
   Geometry* getGeometry() { return mEMCALGeometry; }
+  void setNThreads(int n) { mNThreads = n > 0 ? n : 1; }
+  int getNThreads() const { return mNThreads; }
 
  private:
-  void getClusterFromNeighbours(std::vector<InputwithIndex>& clusterUnputs, int row, int column);
+  void clusterizeRegion(ClusterRegion& region);
+  void getClusterFromNeighbours(ClusterRegion& region, int row, int column);
   void getTopologicalRowColumn(const InputType& input, int& row, int& column);
   Geometry* mEMCALGeometry = nullptr;                             //!<! pointer to geometry for utilities
   std::array<cellWithE, NROWS * NCOLS> mSeedList;                 //!<! seed array
   std::array<std::array<InputwithIndex, NCOLS>, NROWS> mInputMap; //!<! topology arrays
   std::array<std::array<bool, NCOLS>, NROWS> mCellMask;           //!<! topology arrays
+  int mNCells = 0;                                                //!<! number of cells/digits in the topology arrays
+  std::array<ClusterRegion, NSMROWS> mRegions;                    //!<! clustering of each row of supermodules
+  int mNThreads = 1;                                              //!<! number of threads clustering the rows of supermodules
 
   std::vector<Cluster> mFoundClusters;     ///<  vector of cluster objects
   std::vector<ClusterIndex> mInputIndices; ///<  vector of associated cell/digit tower ID, ordered by cluster
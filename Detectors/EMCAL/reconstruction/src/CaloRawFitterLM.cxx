@@ -0,0 +1,188 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file CaloRawFitterLM.cxx
+
+#include "FairLogger.h"
+#include <random>
+
+// ROOT sytem
+#include "TMath.h"
+
+#include "EMCALReconstruction/Bunch.h"
+#include "EMCALReconstruction/CaloFitResults.h"
+#include "DataFormatsEMCAL/Constants.h"
+
+#include "EMCALReconstruction/CaloRawFitterLM.h"
+
+using namespace o2::emcal;
+
+CaloRawFitterLM::CaloRawFitterLM() : CaloRawFitter("Chi Square ( Levenberg-Marquardt )", "LM"), mPulseFitter(constants::TAU, constants::ORDER)
+{
+  mAlgo = FitAlgorithm::LevenbergMarquardt;
+}
+
+CaloFitResults CaloRawFitterLM::evaluate(const gsl::span<const Bunch> bunchlist,
+                                         std::optional<unsigned int> altrocfg1, std::optional<unsigned int> altrocfg2)
+{
+  ChannelFit fit;
+  prepareFit(bunchlist, altrocfg1, altrocfg2, fit);
+  if (fit.doFit) {
+    mPulseFitter.fit(fit.pulse);
+  }
+  return finaliseFit(fit);
+}
+
+std::vector<std::variant<CaloFitResults, CaloRawFitter::RawFitterError_t>> CaloRawFitterLM::evaluate(const gsl::span<const gsl::span<const Bunch>> channels,
+                                                                                                     std::optional<unsigned int> altrocfg1, std::optional<unsigned int> altrocfg2)
+{
+  std::vector<std::variant<CaloFitResults, RawFitterError_t>> results(channels.size());
+  mChannelFits.resize(channels.size());
+  mPulses.clear();
+  mPulseChannels.clear();
+  for (size_t ich = 0; ich < channels.size(); ich++) {
+    try {
+      prepareFit(channels[ich], altrocfg1, altrocfg2, mChannelFits[ich]);
+    } catch (RawFitterError_t& e) {
+      results[ich] = e;
+      continue;
+    }
+    if (mChannelFits[ich].doFit) {
+      mPulses.push_back(mChannelFits[ich].pulse);
+      mPulseChannels.push_back(ich);
+    }
+  }
+  // the samples are stored in mChannelFits, which is not modified anymore
+  for (size_t ipulse = 0; ipulse < mPulses.size(); ipulse++) {
+    mPulses[ipulse].samples = mChannelFits[mPulseChannels[ipulse]].samples.data() + mChannelFits[mPulseChannels[ipulse]].first;
+  }
+  mPulseFitter.fit(mPulses.data(), mPulses.size());
+  for (size_t ipulse = 0; ipulse < mPulses.size(); ipulse++) {
+    mChannelFits[mPulseChannels[ipulse]].pulse = mPulses[ipulse];
+  }
+  for (size_t ich = 0; ich < channels.size(); ich++) {
+    if (std::holds_alternative<RawFitterError_t>(results[ich])) {
+      continue;
+    }
+    try {
+      results[ich] = finaliseFit(mChannelFits[ich]);
+    } catch (RawFitterError_t& e) {
+      results[ich] = e;
+    }
+  }
+  return results;
+}
+
+void CaloRawFitterLM::prepareFit(const gsl::span<const Bunch> bunchlist, std::optional<unsigned int> altrocfg1, std::optional<unsigned int> altrocfg2, ChannelFit& fit)
+{
+  auto [nsamples, bunchIndex, ampEstimate,
+        maxADC, timeEstimate, pedEstimate, first, last] = preFitEvaluateSamples(bunchlist, altrocfg1, altrocfg2, mAmpCut);
+
+  fit.nsamples = nsamples;
+  fit.ampEstimate = ampEstimate;
+  fit.timeEstimate = timeEstimate;
+  fit.maxADC = maxADC;
+  fit.pedEstimate = pedEstimate;
+  fit.selected = bunchIndex >= 0 && ampEstimate >= mAmpCut;
+  fit.doFit = false;
+  if (fit.selected) {
+    fit.timebinOffset = bunchlist[bunchIndex].getStartTime() - (bunchlist[bunchIndex].getBunchLength() - 1);
+    if (nsamples > 2 && maxADC < constants::OVERFLOWCUT) {
+      std::copy(mReversed.begin(), mReversed.end(), fit.samples.begin());
+      setPulse(fit, first, last);
+      fit.doFit = true;
+    }
+  }
+}
+
+void CaloRawFitterLM::setPulse(ChannelFit& fit, int first, int last) const
+{
+  auto& pulse = fit.pulse;
+  fit.first = first;
+  pulse = PulseFitter::Pulse{};
+  pulse.samples = fit.samples.data() + first;
+  pulse.nSamples = last - first + 1;
+  pulse.amp = fit.ampEstimate;
+  pulse.ampMin = 0.5 * fit.ampEstimate;
+  pulse.ampMax = 2 * fit.ampEstimate;
+  pulse.time = fit.timeEstimate - first;
+  pulse.timeMin = pulse.time - 4;
+  pulse.timeMax = pulse.time + 4;
+}
+
+CaloFitResults CaloRawFitterLM::finaliseFit(ChannelFit& fit) const
+{
+  float time = 0;
+  float amp = 0;
+  float chi2 = 0;
+  int ndf = 0;
+  bool fitDone = false;
+  float timeEstimate = fit.timeEstimate;
+
+  if (fit.selected) {
+    time = timeEstimate;
+    amp = fit.ampEstimate;
+
+    if (fit.doFit) {
+      if (fit.pulse.converged) {
+        amp = fit.pulse.amp;
+        time = fit.pulse.time + fit.first;
+        chi2 = fit.pulse.chi2;
+        fitDone = true;
+      } else {
+        // Fit has failed, keep the estimates
+        chi2 = 1.e9;
+      }
+      time += fit.timebinOffset;
+      timeEstimate += fit.timebinOffset;
+      ndf = fit.nsamples - 2;
+    }
+  }
+  if (fitDone) {
+    float ampAsymm = (amp - fit.ampEstimate) / (amp + fit.ampEstimate);
+    float timeDiff = time - timeEstimate;
+
+    if ((TMath::Abs(ampAsymm) > 0.1) || (TMath::Abs(timeDiff) > 2)) {
+      amp = fit.ampEstimate;
+      time = timeEstimate;
+      fitDone = false;
+    }
+  }
+  if (amp >= mAmpCut) {
+    if (!fitDone) {
+      std::default_random_engine generator;
+      std::uniform_real_distribution<float> distribution(0.0, 1.0);
+      amp += (0.5 - distribution(generator));
+    }
+    time = time * constants::EMCAL_TIMESAMPLE;
+    time -= mL1Phase;
+
+    return CaloFitResults(fit.maxADC, fit.pedEstimate, mAlgo, amp, time, (int)time, chi2, ndf);
+  }
+  throw RawFitterError_t::FIT_ERROR;
+}
+
+std::tuple<float, float, float> CaloRawFitterLM::fitRaw(int firstTimeBin, int lastTimeBin, float ampEstimate, float timeEstimate) const
+{
+  int nsamples = lastTimeBin - firstTimeBin + 1;
+  if (nsamples < 3) {
+    throw RawFitterError_t::FIT_ERROR;
+  }
+  ChannelFit fit;
+  fit.ampEstimate = ampEstimate;
+  fit.timeEstimate = timeEstimate;
+  std::copy(mReversed.begin(), mReversed.end(), fit.samples.begin());
+  setPulse(fit, firstTimeBin, lastTimeBin);
+  if (!mPulseFitter.fit(fit.pulse)) {
+    throw RawFitterError_t::FIT_ERROR;
+  }
+  return std::make_tuple(fit.pulse.amp, fit.pulse.time + firstTimeBin, fit.pulse.chi2);
+}
@@ -11,11 +11,16 @@
 
 /// \file Clusterizer.cxx
 /// \brief Implementation of the EMCAL clusterizer
+#include <algorithm>
 #include <cstring>
 #include <gsl/span>
 #include "FairLogger.h" // for LOG
 #include "EMCALReconstruction/Clusterizer.h"
 
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
 using namespace o2::emcal;
 
 ///
@@ -50,38 +55,49 @@ void Clusterizer<InputType>::initialize(double timeCut, double timeMin, double t
 }
 
 ///
-/// Recursively search for neighbours (EMCAL)
+/// Search for neighbours (EMCAL), depth-first with an explicit stack
 //____________________________________________________________________________
 template <class InputType>
-void Clusterizer<InputType>::getClusterFromNeighbours(std::vector<InputwithIndex>& clusterInputs, int row, int column)
+void Clusterizer<InputType>::getClusterFromNeighbours(ClusterRegion& region, int row, int column)
 {
-  // Recursion 0, add seed cell/digit to cluster
-  if (!clusterInputs.size()) {
-    clusterInputs.emplace_back(mInputMap[row][column]);
-  }
-
-  // Mark the current cell as clustered
+  // Add seed cell/digit to cluster and mark it as clustered
+  region.mInputIndices.emplace_back(mInputMap[row][column].mIndex);
   mCellMask[row][column] = kTRUE;
 
-  // Now go recursively to the next 4 neighbours and add them to the cluster if they fulfill the conditions
+  // Go to the next 4 neighbours and add them to the cluster if they fulfill the conditions,
+  // then to their own neighbours. As for a recursive search, a cell/digit is added to the
+  // cluster after all the cells/digits reached through it.
   constexpr int rowDiffs[4] = {-1, 0, 0, 1};
   constexpr int colDiffs[4] = {0, -1, 1, 0};
-  for (int dir = 0; dir < 4; dir++) {
-    if ((row + rowDiffs[dir] < 0) || (row + rowDiffs[dir] >= NROWS)) {
+  auto& stack = region.mStack;
+  stack.clear();
+  stack.push_back({row, column, 0});
+  while (!stack.empty()) {
+    auto& current = stack.back();
+    if (current.mDirection == 4) {
+      if (stack.size() > 1) {
+        // Add the cell/digit to the current cluster -- if we end up here, the selected cluster fulfills the condition
+        region.mInputIndices.emplace_back(mInputMap[current.mRow][current.mColumn].mIndex);
+      }
+      stack.pop_back();
       continue;
     }
-    if ((column + colDiffs[dir] < 0) || (column + colDiffs[dir] >= NCOLS)) {
+    int dir = current.mDirection++;
+    int nextRow = current.mRow + rowDiffs[dir], nextColumn = current.mColumn + colDiffs[dir];
+    if ((nextRow < 0) || (nextRow >= NROWS)) {
+      continue;
+    }
+    if ((nextColumn < 0) || (nextColumn >= NCOLS)) {
       continue;
     }
 
-    if (mInputMap[row + rowDiffs[dir]][column + colDiffs[dir]].mInput) {
-      if (!mCellMask[row + rowDiffs[dir]][column + colDiffs[dir]]) {
-        if (mDoEnergyGradientCut && not(mInputMap[row + rowDiffs[dir]][column + colDiffs[dir]].mInput->getEnergy() > mInputMap[row][column].mInput->getEnergy() + mGradientCut)) {
-          if (not(TMath::Abs(mInputMap[row + rowDiffs[dir]][column + colDiffs[dir]].mInput->getTimeStamp() - mInputMap[row][column].mInput->getTimeStamp()) > mTimeCut)) {
-            getClusterFromNeighbours(clusterInputs, row + rowDiffs[dir], column + colDiffs[dir]);
-            // Add the cell/digit to the current cluster -- if we end up here, the selected cluster fulfills the condition
-            clusterInputs.emplace_back(mInputMap[row + rowDiffs[dir]][column + colDiffs[dir]]);
-          }
+    auto& input = mInputMap[current.mRow][current.mColumn];
+    auto& neighbour = mInputMap[nextRow][nextColumn];
+    if (neighbour.mInput && !mCellMask[nextRow][nextColumn]) {
+      if (mDoEnergyGradientCut && not(neighbour.mInput->getEnergy() > input.mInput->getEnergy() + mGradientCut)) {
+        if (not(TMath::Abs(neighbour.mInput->getTimeStamp() - input.mInput->getTimeStamp()) > mTimeCut)) {
+          mCellMask[nextRow][nextColumn] = kTRUE;
+          stack.push_back({nextRow, nextColumn, 0}); // invalidates current
         }
       }
     }
@@ -133,26 +149,29 @@ void Clusterizer<InputType>::findClusters(const gsl::span<InputType const>& inpu
   // - Create 2D bitmap (cell/digit is already clustered or not)
   // - Sort struct arrays with descending energy
   //
-  // - Loop over arrays:
+  // - Distribute the seeds to the rows of supermodules
+  //
+  // - Loop over arrays (for each row of supermodules, in parallel):
   // --> Check 2D bitmap (don't use cell/digit which are already clustered)
   // --> Take valid cell/digit with highest energy as seed (they are already sorted)
-  // --> Recursive to neighboughs and create cluster
+  // --> Go to neighboughs and create cluster
   // --> Seed cell and all neighbours belonging to cluster will be put in 2D bitmap
+  //
+  // - Merge the clusters of all rows of supermodules by seed energy
 
-  // Reset cell/digit maps and cell masks
-  // Loop over one array dim, then reset each array
-  for (auto iArr = 0; iArr < NROWS; iArr++) {
-    mCellMask[iArr].fill(kFALSE);
-    mInputMap[iArr].fill({nullptr, -1});
+  // Reset the cell/digit maps and cell masks filled in the previous event
+  for (int i = 0; i < mNCells; i++) {
+    mCellMask[mSeedList[i].row][mSeedList[i].column] = kFALSE;
+    mInputMap[mSeedList[i].row][mSeedList[i].column] = {nullptr, -1};
   }
+  mNCells = 0;
 
   // Calibrate cells/digits and fill the maps/arrays
   int nCells = 0;
   double ehs = 0.0;
-  //for (auto dig : inputArray) {
   for (int iIndex = 0; iIndex < inputArray.size(); iIndex++) {
 
-    auto dig = inputArray[iIndex];
+    const auto& dig = inputArray[iIndex];
 
     Float_t inputEnergy = dig.getEnergy();
     Float_t time = dig.getTimeStamp();
@@ -175,37 +194,77 @@ void Clusterizer<InputType>::findClusters(const gsl::span<InputType const>& inpu
     mSeedList[nCells].column = column;
     nCells++;
   }
+  mNCells = nCells;
 
   // Sort struct arrays with ascending energy
   std::sort(mSeedList.begin(), std::next(std::begin(mSeedList), nCells));
 
-  // Take next valid cell/digit in calorimeter as seed (in descending energy order)
+  // Distribute the cells/digits fulfilling the seed energy constraint to the rows of supermodules
+  // (in descending energy order)
+  for (auto& region : mRegions) {
+    region.clear();
+  }
   for (int i = nCells; i--;) {
-    int row = mSeedList[i].row, column = mSeedList[i].column;
-    // Continue if the cell is already masked (i.e. was already clustered)
-    if (mCellMask[row][column]) {
-      continue;
-    }
-    // Continue if energy constraints are not fulfilled
     if (mSeedList[i].energy <= mThresholdSeedEnergy) {
-      continue;
+      break;
     }
+    mRegions[mSeedList[i].row / NROWSSM].mSeeds.emplace_back(i);
+  }
+
+  // Form the clusters of each row of supermodules, the rows being separated by a
+  // topological gap they share no cell/digit and can be processed concurrently
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+  for (int iRegion = 0; iRegion < NSMROWS; iRegion++) {
+    clusterizeRegion(mRegions[iRegion]);
+  }
 
-    // Seed is found, form cluster recursively
-    std::vector<InputwithIndex> clusterInputs;
-    getClusterFromNeighbours(clusterInputs, row, column);
+  // Merge the clusters in descending energy order of their seeds, as if formed in a single pass
+  std::array<size_t, NSMROWS> nextCluster{};
+  while (true) {
+    int nextRegion = -1;
+    for (int iRegion = 0; iRegion < NSMROWS; iRegion++) {
+      auto& region = mRegions[iRegion];
+      if (nextCluster[iRegion] < region.mClusters.size() &&
+          (nextRegion < 0 || region.mClusterSeeds[nextCluster[iRegion]] > mRegions[nextRegion].mClusterSeeds[nextCluster[nextRegion]])) {
+        nextRegion = iRegion;
+      }
+    }
+    if (nextRegion < 0) {
+      break;
+    }
+    auto& region = mRegions[nextRegion];
+    auto& cluster = mFoundClusters.emplace_back(region.mClusters[nextCluster[nextRegion]++]);
+    auto inputIndexStart = region.mInputIndices.begin() + cluster.getCellIndexFirst();
+    cluster.setCellIndexFirst(mInputIndices.size());
+    mInputIndices.insert(mInputIndices.end(), inputIndexStart, inputIndexStart + cluster.getNCells());
+  }
+  LOG(DEBUG) << mFoundClusters.size() << "clusters found from " << nCells << " cells/digits (total=" << inputArray.size() << ")-> ehs " << ehs << " (minE " << mThresholdCellEnergy << ")";
+}
 
-    // Add cells/digits for current cluster to cell/digit index vector
-    int inputIndexStart = mInputIndices.size();
-    for (auto dig : clusterInputs) {
-      mInputIndices.emplace_back(dig.mIndex);
+///
+/// Form the clusters of a row of supermodules. Take next valid cell/digit as seed (in descending energy order)
+//____________________________________________________________________________
+template <class InputType>
+void Clusterizer<InputType>::clusterizeRegion(ClusterRegion& region)
+{
+  for (auto iSeed : region.mSeeds) {
+    int row = mSeedList[iSeed].row, column = mSeedList[iSeed].column;
+    // Continue if the cell is already masked (i.e. was already clustered)
+    if (mCellMask[row][column]) {
+      continue;
     }
-    int inputIndexSize = mInputIndices.size() - inputIndexStart;
+
+    // Seed is found, form cluster from the neighbours
+    int inputIndexStart = region.mInputIndices.size();
+    getClusterFromNeighbours(region, row, column);
+    int inputIndexSize = region.mInputIndices.size() - inputIndexStart;
 
     // Now form cluster object from cells/digits
-    mFoundClusters.emplace_back(mInputMap[row][column].mInput->getTimeStamp(), inputIndexStart, inputIndexSize); // Cluster object initialized w/ time of seed cell, start + size of associated cells
+    region.mClusters.emplace_back(mInputMap[row][column].mInput->getTimeStamp(), inputIndexStart, inputIndexSize); // Cluster object initialized w/ time of seed cell, start + size of associated cells
+    region.mClusterSeeds.emplace_back(iSeed);
   }
-  LOG(DEBUG) << mFoundClusters.size() << "clusters found from " << nCells << " cells/digits (total=" << inputArray.size() << ")-> ehs " << ehs << " (minE " << mThresholdCellEnergy << ")";
 }
 
 template class o2::emcal::Clusterizer<o2::emcal::Cell>;
@@ -40,6 +40,7 @@ void ClusterizerSpec<InputType>::init(framework::InitContext& ctx)
   // Initialize clusterizer and link geometry
   mClusterizer.initialize(timeCut, timeMin, timeMax, gradientCut, doEnergyGradientCut, thresholdSeedEnergy, thresholdCellEnergy);
   mClusterizer.setGeometry(mGeometry);
+  mClusterizer.setNThreads(ctx.options().get<int>("nthreads"));
 
   mOutputClusters = new std::vector<o2::emcal::Cluster>();
   mOutputCellDigitIndices = new std::vector<o2::emcal::ClusterIndex>();
@@ -137,11 +138,13 @@ o2::framework::DataProcessorSpec o2::emcal::reco_workflow::getClusterizerSpec(bo
     return o2::framework::DataProcessorSpec{"EMCALClusterizerSpec",
                                             inputs,
                                             outputs,
-                                            o2::framework::adaptFromTask<o2::emcal::reco_workflow::ClusterizerSpec<o2::emcal::Digit>>()};
+                                            o2::framework::adaptFromTask<o2::emcal::reco_workflow::ClusterizerSpec<o2::emcal::Digit>>(),
+                                            o2::framework::Options{{"nthreads", o2::framework::VariantType::Int, 1, {"number of threads clustering the rows of supermodules in parallel"}}}};
   } else {
     return o2::framework::DataProcessorSpec{"EMCALClusterizerSpec",
                                             inputs,
                                             outputs,
-                                            o2::framework::adaptFromTask<o2::emcal::reco_workflow::ClusterizerSpec<o2::emcal::Cell>>()};
+                                            o2::framework::adaptFromTask<o2::emcal::reco_workflow::ClusterizerSpec<o2::emcal::Cell>>(),
+                                            o2::framework::Options{{"nthreads", o2::framework::VariantType::Int, 1, {"number of threads clustering the rows of supermodules in parallel"}}}};
   }
 }
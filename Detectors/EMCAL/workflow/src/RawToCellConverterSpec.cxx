@@ -27,6 +27,7 @@
 #include "EMCALReconstruction/Bunch.h"
 #include "EMCALReconstruction/CaloRawFitterStandard.h"
 #include "EMCALReconstruction/CaloRawFitterGamma2.h"
+#include "EMCALReconstruction/CaloRawFitterLM.h"
 #include "EMCALReconstruction/AltroDecoder.h"
 #include "EMCALWorkflow/RawToCellConverterSpec.h"
 #include "SimulationDataFormat/MCCompLabel.h"
@@ -64,6 +65,9 @@ void RawToCellConverterSpec::init(framework::InitContext& ctx)
     mRawFitter = std::unique_ptr<CaloRawFitter>(new o2::emcal::CaloRawFitterStandard);
   } else if (fitmethod == "gamma2") {
     mRawFitter = std::unique_ptr<CaloRawFitter>(new o2::emcal::CaloRawFitterGamma2);
+  } else if (fitmethod == "lm") {
+    LOG(INFO) << "Using standard raw fitter with Levenberg-Marquardt minimisation";
+    mRawFitter = std::unique_ptr<CaloRawFitter>(new o2::emcal::CaloRawFitterLM);
   }
 
   mMaxErrorMessages = ctx.options().get<int>("maxmessage");
@@ -264,6 +268,6 @@ o2::framework::DataProcessorSpec o2::emcal::reco_workflow::getRawToCellConverter
                                           outputs,
                                           o2::framework::adaptFromTask<o2::emcal::reco_workflow::RawToCellConverterSpec>(),
                                           o2::framework::Options{
-                                            {"fitmethod", o2::framework::VariantType::String, "standard", {"Fit method (standard or gamma2)"}},
+                                            {"fitmethod", o2::framework::VariantType::String, "standard", {"Fit method (standard, gamma2 or lm)"}},
                                             {"maxmessage", o2::framework::VariantType::Int, 100, {"Max. amout of error messages to be displayed"}}}};
 }
@@ -94,6 +94,10 @@ class MatchTOF
 
   void setHighPurity(bool value = true) { mSetHighPurity = value; }
 
+  ///< set the number of threads used to match the sectors concurrently
+  void setNThreads(int n);
+  int getNThreads() const { return mNThreads; }
+
   ///< print settings
   void print() const;
   void printCandidatesTOF() const;
@@ -186,6 +190,8 @@ class MatchTOF
   //  void addTPCTRDSeed(const o2::track::TrackParCov& _tr, o2::dataformats::GlobalTrackID srcGID, int tpcID);
   //  void addITSTPCTRDSeed(const o2::track::TrackParCov& _tr, o2::dataformats::GlobalTrackID srcGID, int tpcID);
   bool prepareTOFClusters();
+  int findFirstTOFCluster(int sec, double minTime) const;
+  void selectTOFClusters(int sec, const int* strips, int nStrips, double minTime, double maxTime, std::vector<int>& positions) const;
 
   void doMatching(int sec);
   void doMatchingForTPC(int sec);
@@ -231,6 +237,7 @@ class MatchTOF
   bool mIsTPCTRDused = false;
   bool mIsITSTPCTRDused = false;
   bool mSetHighPurity = false;
+  int mNThreads = 1; ///< number of threads matching the sectors
 
   // from ruben
   gsl::span<const o2::tpc::TrackTPC> mTPCTracksArray; ///< input TPC tracks span
@@ -269,9 +276,13 @@ class MatchTOF
   std::array<std::vector<int>, o2::constants::math::NSectors> mTracksSectIndexCache[trkType::SIZE];
   ///< per sector indices of TOF cluster entry in mTOFClusWork
   std::array<std::vector<int>, o2::constants::math::NSectors> mTOFClusSectIndexCache;
+  ///< per sector and per strip positions of the TOF clusters in mTOFClusSectIndexCache (hence ordered in time)
+  std::array<std::array<std::vector<int>, Geo::NSTRIPXSECTOR>, o2::constants::math::NSectors> mTOFClusSectStripIndex;
 
   ///<array of track-TOFCluster pairs from the matching
   std::vector<o2::dataformats::MatchInfoTOFReco> mMatchedTracksPairs;
+  ///<per sector arrays of track-TOFCluster pairs, filled concurrently by the matching of the sectors
+  std::array<std::vector<o2::dataformats::MatchInfoTOFReco>, o2::constants::math::NSectors> mMatchedTracksPairsSec;
 
   ///<array of TOFChannel calibration info
   std::vector<o2::dataformats::CalibInfoTOF> mCalibInfoTOF;
@@ -44,6 +44,10 @@
 #include "DataFormatsGlobalTracking/RecoContainer.h"
 #include "DataFormatsGlobalTracking/RecoContainerCreateTracksVariadic.h"
 
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
 using namespace o2::globaltracking;
 using evGIdx = o2::dataformats::EvIndex<int, o2::dataformats::GlobalTrackID>;
 using evIdx = o2::dataformats::EvIndex<int, int>;
@@ -85,8 +89,19 @@ void MatchTOF::run(const o2::globaltracking::RecoContainer& inp)
   LOGF(INFO, "Timing prepare tracks: Cpu: %.3e s Real: %.3e s in %d slots", mTimerTot.CpuTime(), mTimerTot.RealTime(), mTimerTot.Counter() - 1);
   mTimerTot.Start();
 
-  for (int sec = o2::constants::math::NSectors; sec--;) {
-    mMatchedTracksPairs.clear(); // new sector
+  // the sectors are matched independently (each track and each cluster belongs to a single sector),
+  // the candidates are then selected sector by sector in the same order as the sequential matching
+  Geo::Init(); // the lazy initialization of the TOF geometry is not thread safe
+  int nThreads = mNThreads;
+  if (nThreads > 1 && !o2::base::Propagator::Instance()->getMatLUT()) {
+    LOG(WARNING) << "Material LUT is not available, TGeo material corrections cannot be used concurrently: matching sectors sequentially";
+    nThreads = 1;
+  }
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nThreads)
+#endif
+  for (int sec = 0; sec < o2::constants::math::NSectors; sec++) {
+    mMatchedTracksPairsSec[sec].clear(); // new sector
     LOG(INFO) << "Doing matching for sector " << sec << "...";
     if (mIsITSTPCused || mIsTPCTRDused || mIsITSTPCTRDused) {
       doMatching(sec);
@@ -94,7 +109,10 @@ void MatchTOF::run(const o2::globaltracking::RecoContainer& inp)
     if (mIsTPCused) {
       doMatchingForTPC(sec);
     }
-    LOG(INFO) << "...done. Now check the best matches";
+  }
+  for (int sec = o2::constants::math::NSectors; sec--;) {
+    LOG(INFO) << "Check the best matches for sector " << sec;
+    mMatchedTracksPairs.swap(mMatchedTracksPairsSec[sec]);
     selectBestMatches();
   }
 
@@ -373,6 +391,10 @@ bool MatchTOF::prepareTOFClusters()
   // sort clusters in each sector according to their time (increasing in time)
   for (int sec = o2::constants::math::NSectors; sec--;) {
     auto& indexCache = mTOFClusSectIndexCache[sec];
+    auto& stripIndex = mTOFClusSectStripIndex[sec];
+    for (auto& stripClusters : stripIndex) {
+      stripClusters.clear();
+    }
     LOG(INFO) << "Sorting sector" << sec << " | " << indexCache.size() << " TOF clusters";
     if (!indexCache.size()) {
       continue;
@@ -382,6 +404,10 @@ bool MatchTOF::prepareTOFClusters()
       auto& clB = mTOFClusWork[b];
       return (clA.getTime() - clB.getTime()) < 0.;
     });
+    // index the clusters per strip, keeping the time ordering
+    for (int pos = 0; pos < indexCache.size(); pos++) {
+      stripIndex[mTOFClusWork[indexCache[pos]].getPadInSector() / Geo::NPADS].push_back(pos);
+    }
   } // loop over TOF clusters of single sector
 
   if (mMatchedClustersIndex) {
@@ -393,6 +419,33 @@ bool MatchTOF::prepareTOFClusters()
   return true;
 }
 //______________________________________________
+int MatchTOF::findFirstTOFCluster(int sec, double minTime) const
+{
+  ///< position in mTOFClusSectIndexCache[sec] of the first cluster with time >= minTime
+  const auto& cacheTOF = mTOFClusSectIndexCache[sec];
+  auto it = std::lower_bound(cacheTOF.begin(), cacheTOF.end(), minTime, [this](int icl, double t) { return mTOFClusWork[icl].getTime() < t; });
+  return std::distance(cacheTOF.begin(), it);
+}
+//______________________________________________
+void MatchTOF::selectTOFClusters(int sec, const int* strips, int nStrips, double minTime, double maxTime, std::vector<int>& positions) const
+{
+  ///< positions in mTOFClusSectIndexCache[sec] of the clusters belonging to the strips (numbered in the sector)
+  ///< with time in [minTime, maxTime], in increasing time order
+  const auto& cacheTOF = mTOFClusSectIndexCache[sec];
+  positions.clear();
+  for (int is = 0; is < nStrips; is++) {
+    const auto& stripClusters = mTOFClusSectStripIndex[sec][strips[is]];
+    auto it = std::lower_bound(stripClusters.begin(), stripClusters.end(), minTime, [this, &cacheTOF](int pos, double t) { return mTOFClusWork[cacheTOF[pos]].getTime() < t; });
+    auto nPrevious = positions.size();
+    for (; it != stripClusters.end() && !(mTOFClusWork[cacheTOF[*it]].getTime() > maxTime); ++it) {
+      positions.push_back(*it);
+    }
+    if (nPrevious) {
+      std::inplace_merge(positions.begin(), positions.begin() + nPrevious, positions.end());
+    }
+  }
+}
+//______________________________________________
 void MatchTOF::doMatching(int sec)
 {
   trkType type = trkType::CONSTR;
@@ -405,7 +458,8 @@ void MatchTOF::doMatching(int sec)
   if (!nTracks || !nTOFCls) {
     return;
   }
-  int itof0 = 0;                          // starting index in TOF clusters for matching of the track
+  std::vector<int> tofCandidates;         // positions in cacheTOF of the clusters which can be matched to the track
+  int crossedStrips[2];                   // strips (numbered in the sector) crossed by the track in this sector
   int detId[2][5];                        // at maximum one track can fall in 2 strips during the propagation; the second dimention of the array is the TOF det index
   float deltaPos[2][3];                   // at maximum one track can fall in 2 strips during the propagation; the second dimention of the array is the residuals
   o2::track::TrackLTIntegral trkLTInt[2]; // Here we store the integrated track length and time for the (max 2) matched strips
@@ -541,21 +595,17 @@ void MatchTOF::doMatching(int sec)
     if (nStripsCrossedInPropagation == 0) {
       continue; // the track never hit a TOF strip during the propagation
     }
+    // only the clusters of the strips crossed in this sector and in the time window of the track can be matched
+    int nCrossedStrips = 0;
+    for (int iPropagation = 0; iPropagation < nStripsCrossedInPropagation; iPropagation++) {
+      if (detId[iPropagation][0] == sec) {
+        crossedStrips[nCrossedStrips++] = Geo::getStripNumberPerSM(detId[iPropagation][1], detId[iPropagation][2]);
+      }
+    }
+    selectTOFClusters(sec, crossedStrips, nCrossedStrips, minTrkTime, maxTrkTime, tofCandidates);
     bool foundCluster = false;
-    for (auto itof = itof0; itof < nTOFCls; itof++) {
-      //      printf("itof = %d\n", itof);
+    for (auto itof : tofCandidates) {
       auto& trefTOF = mTOFClusWork[cacheTOF[itof]];
-      // compare the times of the track and the TOF clusters - remember that they both are ordered in time!
-      //Printf("trefTOF.getTime() = %f, maxTrkTime = %f, minTrkTime = %f", trefTOF.getTime(), maxTrkTime, minTrkTime);
-
-      if (trefTOF.getTime() < minTrkTime) { // this cluster has a time that is too small for the current track, we will get to the next one
-        //Printf("In trefTOF.getTime() < minTrkTime");
-        itof0 = itof + 1; // but for the next track that we will check, we will ignore this cluster (the time is anyway too small)
-        continue;
-      }
-      if (trefTOF.getTime() > maxTrkTime) { // no more TOF clusters can be matched to this track
-        break;
-      }
 
       int mainChannel = trefTOF.getMainContributingChannel();
       int indices[5];
@@ -626,7 +676,7 @@ void MatchTOF::doMatching(int sec)
           // set event indexes (to be checked)
           evIdx eventIndexTOFCluster(trefTOF.getEntryInTree(), mTOFClusSectIndexCache[indices[0]][itof]);
           evGIdx eventIndexTracks(mCurrTracksTreeEntry, {uint32_t(mTracksSectIndexCache[type][indices[0]][itrk]), o2::dataformats::GlobalTrackID::ITSTPC});
-          mMatchedTracksPairs.emplace_back(eventIndexTOFCluster, chi2, trkLTInt[iPropagation], eventIndexTracks, type); // TODO: check if this is correct!
+          mMatchedTracksPairsSec[sec].emplace_back(eventIndexTOFCluster, chi2, trkLTInt[iPropagation], eventIndexTracks, type); // TODO: check if this is correct!
         }
       }
     }
@@ -653,7 +703,9 @@ void MatchTOF::doMatchingForTPC(int sec)
   if (!nTracks || !nTOFCls) {
     return;
   }
-  int itof0 = 0; // starting index in TOF clusters for matching of the track
+  int itof0 = 0;              // starting index in TOF clusters for matching of the track
+  std::vector<int> tofCandidates; // positions in cacheTOF of the clusters which can be matched to the track
+  int crossedStrips[2];           // strips (numbered in the sector) crossed by the track in this sector
   float deltaPosTemp[3];
   std::array<float, 3> pos;
   std::array<float, 3> posBeforeProp;
@@ -681,9 +733,9 @@ void MatchTOF::doMatchingForTPC(int sec)
 
     int side = mSideTPC[cacheTrk[itrk]];
     // look at BC candidates for the track
-    itof0 = 0;
     double minTrkTime = (trackWork.second.getTimeStamp() - trackWork.second.getTimeStampError()) * 1.E6; // minimum time in ps
     minTrkTime = int(minTrkTime / BCgranularity) * BCgranularity;                                        // align min to a BC
+    itof0 = findFirstTOFCluster(sec, minTrkTime);
     double maxTrkTime = (trackWork.second.getTimeStamp() + mExtraTPCFwdTime[cacheTrk[itrk]]) * 1.E6;     // maximum time in ps
 
     if (mIsCosmics) {
@@ -729,13 +781,13 @@ void MatchTOF::doMatchingForTPC(int sec)
     }
 
     detId.clear();
-    detId.reserve(BCcand.size());
+    detId.resize(BCcand.size());
     trkLTInt.clear();
-    trkLTInt.reserve(BCcand.size());
+    trkLTInt.resize(BCcand.size());
     deltaPos.clear();
-    deltaPos.reserve(BCcand.size());
+    deltaPos.resize(BCcand.size());
     nStepsInsideSameStrip.clear();
-    nStepsInsideSameStrip.reserve(BCcand.size());
+    nStepsInsideSameStrip.resize(BCcand.size());
 
     //    Printf("intLT (before doing anything): length = %f, time (Pion) = %f", intLT.getL(), intLT.getTOF(o2::track::PID::Pion));
     int istep = 1;    // number of steps
@@ -848,20 +900,18 @@ void MatchTOF::doMatchingForTPC(int sec)
         continue; // the track never hit a TOF strip during the propagation
       }
 
+      // only the clusters of the strips crossed in this sector and in the time window of the BC candidate can be matched
+      int nCrossedStrips = 0;
+      for (int iPropagation = 0; iPropagation < nStripsCrossedInPropagation[ibc]; iPropagation++) {
+        if (detId[ibc][iPropagation][0] == sec) {
+          crossedStrips[nCrossedStrips++] = Geo::getStripNumberPerSM(detId[ibc][iPropagation][1], detId[ibc][iPropagation][2]);
+        }
+      }
+      selectTOFClusters(sec, crossedStrips, nCrossedStrips, minTime, maxTime, tofCandidates);
+
       bool foundCluster = false;
-      itof0 = 0;
-      for (auto itof = itof0; itof < nTOFCls; itof++) {
-        //      printf("itof = %d\n", itof);
+      for (auto itof : tofCandidates) {
         auto& trefTOF = mTOFClusWork[cacheTOF[itof]];
-        // compare the times of the track and the TOF clusters - remember that they both are ordered in time!
-
-        if (trefTOF.getTime() < minTime) { // this cluster has a time that is too small for the current track, we will get to the next one
-          itof0 = itof + 1;                // but for the next track that we will check, we will ignore this cluster (the time is anyway too small)
-          continue;
-        }
-        if (trefTOF.getTime() > maxTime) { // no more TOF clusters can be matched to this track
-          break;
-        }
         unsigned long bcClus = trefTOF.getTime() * Geo::BC_TIME_INPS_INV;
 
         int mainChannel = trefTOF.getMainContributingChannel();
@@ -939,7 +989,7 @@ void MatchTOF::doMatchingForTPC(int sec)
             // set event indexes (to be checked)
             evIdx eventIndexTOFCluster(trefTOF.getEntryInTree(), mTOFClusSectIndexCache[indices[0]][itof]);
             evGIdx eventIndexTracks(mCurrTracksTreeEntry, {uint32_t(mTracksSectIndexCache[trkType::UNCONS][indices[0]][itrk]), o2::dataformats::GlobalTrackID::TPC});
-            mMatchedTracksPairs.emplace_back(eventIndexTOFCluster, chi2, trkLTInt[ibc][iPropagation], eventIndexTracks, trkType::UNCONS, resZ / vdrift * side, trefTOF.getZ()); // TODO: check if this is correct!
+            mMatchedTracksPairsSec[sec].emplace_back(eventIndexTOFCluster, chi2, trkLTInt[ibc][iPropagation], eventIndexTracks, trkType::UNCONS, resZ / vdrift * side, trefTOF.getZ()); // TODO: check if this is correct!
           }
         }
       }
@@ -1199,6 +1249,16 @@ bool MatchTOF::propagateToRefXWithoutCov(o2::track::TrackParCov& trc, float xRef
   return refReached && std::abs(trcNoCov.getSnp()) < 0.95 && TMath::Abs(trcNoCov.getZ()) < Geo::MAXHZTOF; // Here we need to put MAXSNP
 }
 
+//______________________________________________
+void MatchTOF::setNThreads(int n)
+{
+#ifdef WITH_OPENMP
+  mNThreads = n > 0 ? n : 1;
+#else
+  mNThreads = 1;
+#endif
+}
+
 //______________________________________________
 void MatchTOF::setDebugFlag(UInt_t flag, bool on)
 {
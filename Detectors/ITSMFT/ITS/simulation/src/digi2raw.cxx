@@ -43,6 +43,7 @@ constexpr int DefRDHVersion = o2::raw::RDHUtils::getVersion<o2::header::RAWDataH
 void setupLinks(o2::itsmft::MC2RawEncoder<MAP>& m2r, std::string_view outDir, std::string_view outPrefix, std::string_view fileFor);
 void digi2raw(std::string_view inpName, std::string_view outDir, std::string_view fileFor, int verbosity,
               uint32_t rdhV = DefRDHVersion, bool noEmptyHBF = false,
+              int nThreads = 1, int asyncPages = 0,
               int superPageSizeInB = 1024 * 1024);
 
 int main(int argc, char** argv)
@@ -63,6 +64,8 @@ int main(int argc, char** argv)
     add_option("output-dir,o", bpo::value<std::string>()->default_value("./"), "output directory for raw data");
     add_option("rdh-version,r", bpo::value<uint32_t>()->default_value(DefRDHVersion), "RDH version to use");
     add_option("no-empty-hbf,e", bpo::value<bool>()->default_value(false)->implicit_value(true), "do not create empty HBF pages (except for HBF starting TF)");
+    add_option("nthreads,j", bpo::value<int>()->default_value(1), "number of threads to convert RUs (needs OpenMP)");
+    add_option("async-write", bpo::value<int>()->default_value(0), "if > 0, write superpages in separate thread keeping at most N pending");
     add_option("hbfutils-config,u", bpo::value<std::string>()->default_value(std::string(o2::base::NameConf::DIGITIZATIONCONFIGFILE)), "config file for HBFUtils (or none)");
     add_option("configKeyValues", bpo::value<std::string>()->default_value(""), "comma-separated configKeyValues");
 
@@ -95,7 +98,9 @@ int main(int argc, char** argv)
            vm["file-for"].as<std::string>(),
            vm["verbosity"].as<uint32_t>(),
            vm["rdh-version"].as<uint32_t>(),
-           vm["no-empty-hbf"].as<bool>());
+           vm["no-empty-hbf"].as<bool>(),
+           vm["nthreads"].as<int>(),
+           vm["async-write"].as<int>());
   LOG(INFO) << "HBFUtils settings used for conversion:";
 
   o2::raw::HBFUtils::Instance().print();
@@ -103,7 +108,7 @@ int main(int argc, char** argv)
   return 0;
 }
 
-void digi2raw(std::string_view inpName, std::string_view outDir, std::string_view fileFor, int verbosity, uint32_t rdhV, bool noEmptyHBF, int superPageSizeInB)
+void digi2raw(std::string_view inpName, std::string_view outDir, std::string_view fileFor, int verbosity, uint32_t rdhV, bool noEmptyHBF, int nThreads, int asyncPages, int superPageSizeInB)
 {
   TStopwatch swTot;
   swTot.Start();
@@ -155,6 +160,10 @@ void digi2raw(std::string_view inpName, std::string_view outDir, std::string_vie
   m2r.getWriter().setSuperPageSize(superPageSizeInB);
   m2r.getWriter().useRDHVersion(rdhV);
   m2r.getWriter().setDontFillEmptyHBF(noEmptyHBF);
+  m2r.setNThreads(nThreads);
+  if (asyncPages > 0) {
+    m2r.getWriter().useAsyncWriting(asyncPages);
+  }
 
   m2r.setVerbosity(verbosity);
   setupLinks(m2r, outDir, MAP::getName(), fileFor);
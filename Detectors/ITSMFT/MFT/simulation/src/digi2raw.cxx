@@ -40,6 +40,7 @@ namespace bpo = boost::program_options;
 
 void setupLinks(o2::itsmft::MC2RawEncoder<MAP>& m2r, std::string_view outDir, std::string_view outPrefix, std::string_view fileFor);
 void digi2raw(std::string_view inpName, std::string_view outDir, std::string_view fileFor, int verbosity, uint32_t rdhV = 4, bool noEmptyHBF = false,
+              int nThreads = 1, int asyncPages = 0,
               int superPageSizeInB = 1024 * 1024);
 
 int main(int argc, char** argv)
@@ -61,6 +62,8 @@ int main(int argc, char** argv)
     uint32_t defRDH = o2::raw::RDHUtils::getVersion<o2::header::RAWDataHeader>();
     add_option("rdh-version,r", bpo::value<uint32_t>()->default_value(defRDH), "RDH version to use");
     add_option("no-empty-hbf,e", bpo::value<bool>()->default_value(false)->implicit_value(true), "do not create empty HBF pages (except for HBF starting TF)");
+    add_option("nthreads,j", bpo::value<int>()->default_value(1), "number of threads to convert RUs (needs OpenMP)");
+    add_option("async-write", bpo::value<int>()->default_value(0), "if > 0, write superpages in separate thread keeping at most N pending");
     add_option("hbfutils-config,u", bpo::value<std::string>()->default_value(std::string(o2::base::NameConf::DIGITIZATIONCONFIGFILE)), "config file for HBFUtils (or none)");
     add_option("configKeyValues", bpo::value<std::string>()->default_value(""), "comma-separated configKeyValues");
 
@@ -93,7 +96,9 @@ int main(int argc, char** argv)
            vm["file-for"].as<std::string>(),
            vm["verbosity"].as<uint32_t>(),
            vm["rdh-version"].as<uint32_t>(),
-           vm["no-empty-hbf"].as<bool>());
+           vm["no-empty-hbf"].as<bool>(),
+           vm["nthreads"].as<int>(),
+           vm["async-write"].as<int>());
   LOG(INFO) << "HBFUtils settings used for conversion:";
 
   o2::raw::HBFUtils::Instance().print();
@@ -101,7 +106,7 @@ int main(int argc, char** argv)
   return 0;
 }
 
-void digi2raw(std::string_view inpName, std::string_view outDir, std::string_view fileFor, int verbosity, uint32_t rdhV, bool noEmptyHBF, int superPageSizeInB)
+void digi2raw(std::string_view inpName, std::string_view outDir, std::string_view fileFor, int verbosity, uint32_t rdhV, bool noEmptyHBF, int nThreads, int asyncPages, int superPageSizeInB)
 {
   TStopwatch swTot;
   swTot.Start();
@@ -153,6 +158,10 @@ void digi2raw(std::string_view inpName, std::string_view outDir, std::string_vie
   m2r.getWriter().setSuperPageSize(superPageSizeInB);
   m2r.getWriter().useRDHVersion(rdhV);
   m2r.getWriter().setDontFillEmptyHBF(noEmptyHBF);
+  m2r.setNThreads(nThreads);
+  if (asyncPages > 0) {
+    m2r.getWriter().useAsyncWriting(asyncPages);
+  }
 
   m2r.setVerbosity(verbosity);
   setupLinks(m2r, outDir, MAP::getName(), fileFor);
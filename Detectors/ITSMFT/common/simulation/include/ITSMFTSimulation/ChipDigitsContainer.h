@@ -20,7 +20,7 @@
 #include "SimulationDataFormat/MCCompLabel.h"
 #include "ITSMFTBase/SegmentationAlpide.h"
 #include "ITSMFTSimulation/PreDigit.h"
-#include <map>
+#include <cstddef>
 #include <vector>
 
 namespace o2
@@ -31,6 +31,10 @@ class DigiParams;
 
 /// @class ChipDigitsContainer
 /// @brief Container for similated points connected to a given chip
+///
+/// The fired pixels are stored in a flat vector, unordered, and found by their ordering key
+/// in an open-addressing hash table. They are sorted by key only when flushed to the output.
+/// The extra contributions to the pixels are pooled in the container itself.
 
 class ChipDigitsContainer
 {
@@ -41,7 +45,7 @@ class ChipDigitsContainer
   /// Destructor
   ~ChipDigitsContainer() = default;
 
-  std::map<ULong64_t, o2::itsmft::PreDigit>& getPreDigits() { return mDigits; }
+  std::vector<o2::itsmft::PreDigit>& getPreDigits() { return mDigits; }
   bool isEmpty() const { return mDigits.empty(); }
 
   void setChipIndex(UShort_t ind) { mChipIndex = ind; }
@@ -51,6 +55,18 @@ class ChipDigitsContainer
   void addDigit(ULong64_t key, UInt_t roframe, UShort_t row, UShort_t col, int charge, o2::MCCompLabel lbl);
   void addNoise(UInt_t rofMin, UInt_t rofMax, const o2::itsmft::DigiParams* params, int maxRows = o2::itsmft::SegmentationAlpide::NRows, int maxCols = o2::itsmft::SegmentationAlpide::NCols);
 
+  /// add an extra contributor to the digit, unless its label is already registered
+  void addLabel(o2::itsmft::PreDigit& digit, const o2::MCCompLabel& lbl);
+  /// extra contributor of a digit, the first one is pointed by the labelRef.next of the digit
+  const o2::itsmft::PreDigitLabelRef& getExtraLabel(int i) const { return mExtraLabels[i]; }
+
+  /// move the digits with ordering key up to maxKey to the beginning of the digits vector, sorted
+  /// by key, and return their number. Must be followed by removePreDigits to update the look-up table.
+  size_t sortPreDigits(ULong64_t maxKey);
+  /// remove the n first digits
+  void removePreDigits(size_t n);
+  void clear();
+
   /// Get global ordering key made of readout frame, column and row
   static ULong64_t getOrderingKey(UInt_t roframe, UShort_t row, UShort_t col)
   {
@@ -64,25 +80,64 @@ class ChipDigitsContainer
   }
 
  protected:
-  UShort_t mChipIndex = 0;                           ///< chip index
-  std::map<ULong64_t, o2::itsmft::PreDigit> mDigits; ///< Map of fired pixels, possibly in multiple frames
-
-  ClassDefNV(ChipDigitsContainer, 1);
+  /// entry of the look-up table
+  struct Slot {
+    ULong64_t key = 0; ///< ordering key of the digit
+    int index = -1;    ///< position of the digit in mDigits, -1 if the slot is free
+  };
+
+  static ULong64_t getOrderingKey(const o2::itsmft::PreDigit& digit) { return getOrderingKey(digit.roFrame, digit.row, digit.col); }
+  size_t getSlot(ULong64_t key) const { return (key * 0x9E3779B97F4A7C15ULL) >> mHashShift; }
+  void insertSlot(ULong64_t key, int index);
+  void rebuildSlots(size_t nSlots);
+  void compactExtraLabels();
+
+  UShort_t mChipIndex = 0;                                ///< chip index
+  std::vector<o2::itsmft::PreDigit> mDigits;              ///< fired pixels, possibly in multiple frames
+  std::vector<o2::itsmft::PreDigitLabelRef> mExtraLabels; ///< extra contributions to the fired pixels
+  std::vector<Slot> mSlots;                               //! look-up table of the digits by ordering key
+  int mHashShift = 64;                                    //! 64 - log2 of the number of slots
+
+  ClassDefNV(ChipDigitsContainer, 2);
 };
 
 //_______________________________________________________________________
 inline o2::itsmft::PreDigit* ChipDigitsContainer::findDigit(ULong64_t key)
 {
   // finds the digit corresponding to global key
-  auto digitentry = mDigits.find(key);
-  return digitentry != mDigits.end() ? &(digitentry->second) : nullptr;
+  if (mSlots.empty()) {
+    return nullptr;
+  }
+  for (size_t slot = getSlot(key);; slot = (slot + 1) & (mSlots.size() - 1)) {
+    if (mSlots[slot].index < 0) {
+      return nullptr;
+    }
+    if (mSlots[slot].key == key) {
+      return &mDigits[mSlots[slot].index];
+    }
+  }
 }
 
 //_______________________________________________________________________
 inline void ChipDigitsContainer::addDigit(ULong64_t key, UInt_t roframe, UShort_t row, UShort_t col,
                                           int charge, o2::MCCompLabel lbl)
 {
-  mDigits.emplace(std::make_pair(key, o2::itsmft::PreDigit(roframe, row, col, charge, lbl)));
+  if (2 * (mDigits.size() + 1) > mSlots.size()) { // keep the load factor below 1/2
+    rebuildSlots(mSlots.empty() ? 16 : 2 * mSlots.size());
+  }
+  insertSlot(key, mDigits.size());
+  mDigits.emplace_back(roframe, row, col, charge, lbl);
+}
+
+//_______________________________________________________________________
+inline void ChipDigitsContainer::insertSlot(ULong64_t key, int index)
+{
+  size_t slot = getSlot(key);
+  while (mSlots[slot].index >= 0) {
+    slot = (slot + 1) & (mSlots.size() - 1);
+  }
+  mSlots[slot].key = key;
+  mSlots[slot].index = index;
 }
 } // namespace itsmft
 } // namespace o2
@@ -41,6 +41,7 @@ struct DPLDigitizerParam : public o2::conf::ConfigurableParamHelper<DPLDigitizer
   int minChargeToAccount = 15;            ///< minimum charge contribution to account
   int nSimSteps = 7;                      ///< number of steps in response simulation
   float energyToNElectrons = 1. / 3.6e-9; // conversion of eloss to Nelectrons
+  int nThreads = 1;                       ///< number of threads digitizing the chips of an event concurrently
 
   // boilerplate stuff + make principal key
   O2ParamDef(DPLDigitizerParam, getParamName().data());
@@ -15,11 +15,11 @@
 #define ALICEO2_ITSMFT_DIGITIZER_H
 
 #include <vector>
-#include <deque>
 #include <memory>
 
 #include "Rtypes.h" // for Digitizer::Class
 #include "TObject.h" // for TObject
+#include "TRandom3.h"
 
 #include "ITSMFTSimulation/ChipDigitsContainer.h"
 #include "ITSMFTSimulation/AlpideSimResponse.h"
@@ -44,8 +44,6 @@ namespace itsmft
 {
 class Digitizer : public TObject
 {
-  using ExtraDig = std::vector<PreDigitLabelRef>; ///< container for extra contributions to PreDigits
-
  public:
   Digitizer() = default;
   ~Digitizer() override = default;
@@ -70,6 +68,11 @@ class Digitizer : public TObject
     return mParams.getROFrameLength() * (mROFrameMax + 1) + mParams.getTimeOffset();
   }
 
+  /// with more than 1 thread the chips are digitized concurrently, each one with its own random
+  /// sequence: the result depends on the seed of gRandom but not on the number of threads
+  void setNThreads(int n) { mNThreads = n > 0 ? n : 1; }
+  int getNThreads() const { return mNThreads; }
+
   void setContinuous(bool v) { mParams.setContinuous(v); }
   bool isContinuous() const { return mParams.isContinuous(); }
   void fillOutputContainer(uint32_t maxFrame = 0xffffffff);
@@ -89,22 +92,19 @@ class Digitizer : public TObject
   }
 
  private:
-  void processHit(const o2::itsmft::Hit& hit, uint32_t& maxFr, int evID, int srcID);
-  void registerDigits(ChipDigitsContainer& chip, uint32_t roFrame, float tInROF, int nROF,
+  /// state of the digitization of a group of hits, owned by the thread processing them
+  struct HitsContext {
+    TRandom* rndm = nullptr;               ///< generator of the charge fluctuations
+    uint32_t roFrameMax = 0;               ///< highest RO frame of the digits
+    uint32_t eventROFrameMin = 0xffffffff; ///< lowest RO frame of the event digits
+    uint32_t eventROFrameMax = 0;          ///< highest RO frame of the event digits
+  };
+
+  void processChips(const std::vector<Hit>& hits, const std::vector<int>& hitIdx, int evID, int srcID);
+  void processHit(const o2::itsmft::Hit& hit, HitsContext& context, int evID, int srcID);
+  void registerDigits(ChipDigitsContainer& chip, HitsContext& context, uint32_t roFrame, float tInROF, int nROF,
                       uint16_t row, uint16_t col, int nEle, o2::MCCompLabel& lbl);
 
-  ExtraDig* getExtraDigBuffer(uint32_t roFrame)
-  {
-    if (mROFrameMin > roFrame) {
-      return nullptr; // nothing to do
-    }
-    int ind = roFrame - mROFrameMin;
-    while (ind >= int(mExtraBuff.size())) {
-      mExtraBuff.emplace_back(std::make_unique<ExtraDig>());
-    }
-    return mExtraBuff[ind].get();
-  }
-
   static constexpr float sec2ns = 1e9;
 
   o2::itsmft::DigiParams mParams; ///< digitization parameters
@@ -123,13 +123,15 @@ class Digitizer : public TObject
   const o2::itsmft::GeometryTGeo* mGeometry = nullptr; ///< ITS OR MFT upgrade geometry
 
   std::vector<o2::itsmft::ChipDigitsContainer> mChips; ///< Array of chips digits containers
-  std::deque<std::unique_ptr<ExtraDig>> mExtraBuff;    ///< burrer (per roFrame) for extra digits
+
+  int mNThreads = 1;                  ///< number of threads digitizing the chips
+  std::vector<TRandom3> mThreadRndms; //! generators of the threads
 
   std::vector<o2::itsmft::Digit>* mDigits = nullptr;                       //! output digits
   std::vector<o2::itsmft::ROFRecord>* mROFRecords = nullptr;               //! output ROF records
   o2::dataformats::MCTruthContainer<o2::MCCompLabel>* mMCLabels = nullptr; //! output labels
 
-  ClassDefOverride(Digitizer, 2);
+  ClassDefOverride(Digitizer, 3);
 };
 } // namespace itsmft
 } // namespace o2
@@ -78,6 +78,10 @@ class MC2RawEncoder
 
   o2::raw::RawFileWriter& getWriter() { return mWriter; }
 
+  /// number of threads to convert the readout units in parallel (effective only with OpenMP)
+  void setNThreads(int n) { mNThreads = n > 0 ? n : 1; }
+  int getNThreads() const { return mNThreads; }
+
   std::string getDefaultSinkName() const { return mDefaultSinkName; }
   void setDefaultSinkName(const std::string& nm)
   {
@@ -104,8 +108,9 @@ class MC2RawEncoder
   const GBTLink* getGBTLink(int i) const { return i < 0 ? nullptr : &mGBTLinks[i]; }
 
  private:
-  void convertEmptyChips(int fromChip, int uptoChip, RUDecodeData& ru);
-  void convertChip(ChipPixelData& chipData, RUDecodeData& ru);
+  void convertRU(RUDecodeData& ru, Coder& coder);
+  void convertEmptyChips(int fromChip, int uptoChip, RUDecodeData& ru, Coder& coder);
+  void convertChip(ChipPixelData& chipData, RUDecodeData& ru, Coder& coder);
   void fillGBTLinks(RUDecodeData& ru);
 
   enum RoMode_t { NotSet,
@@ -115,8 +120,9 @@ class MC2RawEncoder
   o2::raw::RawFileWriter mWriter{Mapping::getOrigin()}; // set origin of data
   std::string mDefaultSinkName = "dataSink.raw";
   Mapping mMAP;
-  Coder mCoder;
+  std::vector<Coder> mCoders;                                //! coder per thread
   int mVerbosity = 0;                                        //! verbosity level
+  int mNThreads = 1;                                         //! number of threads for RUs conversion
   uint8_t mRUSWMin = 0;                                      ///< min RU (SW) to convert
   uint8_t mRUSWMax = 0xff;                                   ///< max RU (SW) to convert
   int mNRUs = 0;                                             /// total number of RUs seen
@@ -17,6 +17,7 @@
 #include "ITSMFTSimulation/ChipDigitsContainer.h"
 #include "ITSMFTSimulation/DigiParams.h"
 #include <TRandom.h>
+#include <algorithm>
 
 using namespace o2::itsmft;
 using Segmentation = o2::itsmft::SegmentationAlpide;
@@ -47,3 +48,92 @@ void ChipDigitsContainer::addNoise(UInt_t rofMin, UInt_t rofMax, const o2::itsmf
     }
   }
 }
+
+//______________________________________________________________________
+void ChipDigitsContainer::addLabel(PreDigit& digit, const o2::MCCompLabel& lbl)
+{
+  // register an extra contribution to the digit, at the end of its chain of labels
+  if (digit.labelRef.label == lbl) { // don't store the same label twice
+    return;
+  }
+  int* next = &digit.labelRef.next;
+  while (*next >= 0) {
+    if (mExtraLabels[*next].label == lbl) { // don't store the same label twice
+      return;
+    }
+    next = &mExtraLabels[*next].next;
+  }
+  *next = mExtraLabels.size();
+  mExtraLabels.emplace_back(lbl);
+}
+
+//______________________________________________________________________
+size_t ChipDigitsContainer::sortPreDigits(ULong64_t maxKey)
+{
+  auto belowMax = [maxKey](const PreDigit& digit) { return getOrderingKey(digit) <= maxKey; };
+  if (std::none_of(mDigits.begin(), mDigits.end(), belowMax)) {
+    return 0;
+  }
+  auto last = std::partition(mDigits.begin(), mDigits.end(), belowMax);
+  std::sort(mDigits.begin(), last, [](const PreDigit& lhs, const PreDigit& rhs) { return getOrderingKey(lhs) < getOrderingKey(rhs); });
+  return last - mDigits.begin();
+}
+
+//______________________________________________________________________
+void ChipDigitsContainer::removePreDigits(size_t n)
+{
+  if (!n) {
+    return;
+  }
+  if (n >= mDigits.size()) {
+    clear();
+    return;
+  }
+  mDigits.erase(mDigits.begin(), mDigits.begin() + n);
+  rebuildSlots(mSlots.size());
+  // the labels of the removed digits are not reused, compact the pool when it is mostly made of them
+  if (mExtraLabels.size() > 2 * mDigits.size() + 64) {
+    compactExtraLabels();
+  }
+}
+
+//______________________________________________________________________
+void ChipDigitsContainer::clear()
+{
+  mDigits.clear();
+  mExtraLabels.clear();
+  for (auto& slot : mSlots) {
+    slot.index = -1;
+  }
+}
+
+//______________________________________________________________________
+void ChipDigitsContainer::rebuildSlots(size_t nSlots)
+{
+  // (re)create the look-up table with nSlots (a power of 2) entries
+  mSlots.assign(nSlots, Slot{});
+  mHashShift = 64;
+  for (size_t n = nSlots; n > 1; n >>= 1) {
+    mHashShift--;
+  }
+  for (size_t i = 0; i < mDigits.size(); i++) {
+    insertSlot(getOrderingKey(mDigits[i]), i);
+  }
+}
+
+//______________________________________________________________________
+void ChipDigitsContainer::compactExtraLabels()
+{
+  std::vector<PreDigitLabelRef> labels;
+  for (auto& digit : mDigits) {
+    int* next = &digit.labelRef.next;
+    while (*next >= 0) {
+      int current = *next;
+      *next = labels.size();
+      labels.emplace_back(mExtraLabels[current].label);
+      next = &labels.back().next;
+      *next = mExtraLabels[current].next;
+    }
+  }
+  mExtraLabels.swap(labels);
+}
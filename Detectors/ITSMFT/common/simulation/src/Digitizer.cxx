@@ -20,11 +20,17 @@
 #include "DetectorsRaw/HBFUtils.h"
 
 #include <TRandom.h>
+#include <algorithm>
+#include <atomic>
 #include <climits>
 #include <vector>
 #include <numeric>
 #include "FairLogger.h" // for LOG
 
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
 using o2::itsmft::Digit;
 using o2::itsmft::Hit;
 using Segmentation = o2::itsmft::SegmentationAlpide;
@@ -72,8 +78,16 @@ void Digitizer::process(const std::vector<Hit>* hits, int evID, int srcID)
             [hits](auto lhs, auto rhs) {
               return (*hits)[lhs].GetDetectorID() < (*hits)[rhs].GetDetectorID();
             });
-  for (int i : hitIdx) {
-    processHit((*hits)[i], mROFrameMax, evID, srcID);
+  if (mNThreads > 1) {
+    processChips(*hits, hitIdx, evID, srcID);
+  } else {
+    HitsContext context{gRandom, mROFrameMax, mEventROFrameMin, mEventROFrameMax};
+    for (int i : hitIdx) {
+      processHit((*hits)[i], context, evID, srcID);
+    }
+    mROFrameMax = context.roFrameMax;
+    mEventROFrameMin = context.eventROFrameMin;
+    mEventROFrameMax = context.eventROFrameMax;
   }
   // in the triggered mode store digits after every MC event
   // TODO: in the real triggered mode this will not be needed, this is actually for the
@@ -83,6 +97,50 @@ void Digitizer::process(const std::vector<Hit>* hits, int evID, int srcID)
   }
 }
 
+//_______________________________________________________________________
+void Digitizer::processChips(const std::vector<Hit>& hits, const std::vector<int>& hitIdx, int evID, int srcID)
+{
+  // digitize the hits (sorted by chip) of every chip concurrently, the chips sharing no data.
+  // Each chip gets its own random sequence seeded from gRandom, so that the result does not
+  // depend on the number of threads nor on the assignment of the chips to the threads
+
+  std::vector<std::pair<int, int>> chipHits; // range of the hits of every chip in hitIdx
+  for (int first = 0, last = 0; first < int(hitIdx.size()); first = last) {
+    auto chipID = hits[hitIdx[first]].GetDetectorID();
+    while (last < int(hitIdx.size()) && hits[hitIdx[last]].GetDetectorID() == chipID) {
+      last++;
+    }
+    chipHits.emplace_back(first, last);
+  }
+  UInt_t seed = gRandom->Integer(UINT_MAX);
+
+  mThreadRndms.resize(mNThreads);
+  std::vector<HitsContext> contexts(mNThreads);
+  for (int i = 0; i < mNThreads; i++) {
+    contexts[i] = {&mThreadRndms[i], mROFrameMax, mEventROFrameMin, mEventROFrameMax};
+  }
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+  for (int iChip = 0; iChip < int(chipHits.size()); iChip++) {
+#ifdef WITH_OPENMP
+    auto& context = contexts[omp_get_thread_num()];
+#else
+    auto& context = contexts[0];
+#endif
+    UInt_t chipSeed = seed ^ (UInt_t(hits[hitIdx[chipHits[iChip].first]].GetDetectorID()) * 2654435761u);
+    context.rndm->SetSeed(chipSeed ? chipSeed : 1); // 0 would be a time-dependent seed
+    for (int i = chipHits[iChip].first; i < chipHits[iChip].second; i++) {
+      processHit(hits[hitIdx[i]], context, evID, srcID);
+    }
+  }
+  for (const auto& context : contexts) {
+    mROFrameMax = std::max(mROFrameMax, context.roFrameMax);
+    mEventROFrameMin = std::min(mEventROFrameMin, context.eventROFrameMin);
+    mEventROFrameMax = std::max(mEventROFrameMax, context.eventROFrameMax);
+  }
+}
+
 //_______________________________________________________________________
 void Digitizer::setEventTime(const o2::InteractionTimeRecord& irt)
 {
@@ -123,9 +181,6 @@ void Digitizer::fillOutputContainer(uint32_t frameLast)
   if (frameLast > mROFrameMax) {
     frameLast = mROFrameMax;
   }
-  // make sure all buffers for extra digits are created up to the maxFrame
-  getExtraDigBuffer(mROFrameMax);
-
   LOG(INFO) << "Filling " << mGeometry->getName() << " digits output for RO frames " << mROFrameMin << ":"
             << frameLast;
 
@@ -136,33 +191,26 @@ void Digitizer::fillOutputContainer(uint32_t frameLast)
     rcROF.setROFrame(mROFrameMin);
     rcROF.setFirstEntry(mDigits->size()); // start of current ROF in digits
 
-    auto& extra = *(mExtraBuff.front().get());
     for (auto& chip : mChips) {
       chip.addNoise(mROFrameMin, mROFrameMin, &mParams);
-      auto& buffer = chip.getPreDigits();
-      if (buffer.empty()) {
+      if (chip.isEmpty()) {
         continue;
       }
-      auto itBeg = buffer.begin();
-      auto iter = itBeg;
+      auto& buffer = chip.getPreDigits();
       ULong64_t maxKey = chip.getOrderingKey(mROFrameMin + 1, 0, 0) - 1; // fetch digits with key below that
-      for (; iter != buffer.end(); ++iter) {
-        if (iter->first > maxKey) {
-          break; // is the digit ROFrame from the key > the max requested frame
-        }
-        auto& preDig = iter->second; // preDigit
+      size_t nPreDigits = chip.sortPreDigits(maxKey);
+      for (size_t i = 0; i < nPreDigits; i++) {
+        const auto& preDig = buffer[i]; // preDigit
         if (preDig.charge >= mParams.getChargeThreshold()) {
           int digID = mDigits->size();
           mDigits->emplace_back(chip.getChipIndex(), preDig.row, preDig.col, preDig.charge);
           mMCLabels->addElement(digID, preDig.labelRef.label);
-          auto& nextRef = preDig.labelRef; // extra contributors are in extra array
-          while (nextRef.next >= 0) {
-            nextRef = extra[nextRef.next];
-            mMCLabels->addElement(digID, nextRef.label);
+          for (int next = preDig.labelRef.next; next >= 0; next = chip.getExtraLabel(next).next) { // extra contributors
+            mMCLabels->addElement(digID, chip.getExtraLabel(next).label);
           }
         }
       }
-      buffer.erase(itBeg, iter);
+      chip.removePreDigits(nPreDigits);
     }
     // finalize ROF record
     rcROF.setNEntries(mDigits->size() - rcROF.getFirstEntry()); // number of digits
@@ -174,21 +222,17 @@ void Digitizer::fillOutputContainer(uint32_t frameLast)
     if (mROFRecords) {
       mROFRecords->push_back(rcROF);
     }
-    extra.clear(); // clear container for extra digits of the mROFrameMin ROFrame
-    // and move it as a new slot in the end
-    mExtraBuff.emplace_back(mExtraBuff.front().release());
-    mExtraBuff.pop_front();
   }
 }
 
 //_______________________________________________________________________
-void Digitizer::processHit(const o2::itsmft::Hit& hit, uint32_t& maxFr, int evID, int srcID)
+void Digitizer::processHit(const o2::itsmft::Hit& hit, HitsContext& context, int evID, int srcID)
 {
   // convert single hit to digits
   float timeInROF = hit.GetTime() * sec2ns;
   if (timeInROF > 20e3) {
     const int maxWarn = 10;
-    static int warnNo = 0;
+    static std::atomic<int> warnNo{0};
     if (warnNo < maxWarn) {
       LOG(WARNING) << "Ignoring hit with time_in_event = " << timeInROF << " ns"
                    << ((++warnNo < maxWarn) ? "" : " (suppressing further warnings)");
@@ -209,8 +253,8 @@ void Digitizer::processHit(const o2::itsmft::Hit& hit, uint32_t& maxFr, int evID
   uint32_t roFrameRelMax = mParams.isContinuous() ? (timeInROF + tTot) * mParams.getROFrameLengthInv() : roFrameRel;
   int nFrames = roFrameRelMax + 1 - roFrameRel;
   uint32_t roFrameMax = mNewROFrame + roFrameRelMax;
-  if (roFrameMax > maxFr) {
-    maxFr = roFrameMax; // if signal extends beyond current maxFrame, increase the latter
+  if (roFrameMax > context.roFrameMax) {
+    context.roFrameMax = roFrameMax; // if signal extends beyond current maxFrame, increase the latter
   }
 
   // here we start stepping in the depth of the sensor to generate charge diffision
@@ -334,20 +378,20 @@ void Digitizer::processHit(const o2::itsmft::Hit& hit, uint32_t& maxFr, int evID
       if (!nEleResp) {
         continue;
       }
-      int nEle = gRandom->Poisson(nElectrons * nEleResp); // total charge in given pixel
+      int nEle = context.rndm->Poisson(nElectrons * nEleResp); // total charge in given pixel
       // ignore charge which have no chance to fire the pixel
       if (nEle < mParams.getMinChargeToAccount()) {
         continue;
       }
       uint16_t colIS = icol + colS;
       //
-      registerDigits(chip, roFrameAbs, timeInROF, nFrames, rowIS, colIS, nEle, lbl);
+      registerDigits(chip, context, roFrameAbs, timeInROF, nFrames, rowIS, colIS, nEle, lbl);
     }
   }
 }
 
 //________________________________________________________________________________
-void Digitizer::registerDigits(ChipDigitsContainer& chip, uint32_t roFrame, float tInROF, int nROF,
+void Digitizer::registerDigits(ChipDigitsContainer& chip, HitsContext& context, uint32_t roFrame, float tInROF, int nROF,
                                uint16_t row, uint16_t col, int nEle, o2::MCCompLabel& lbl)
 {
   // Register digits for given pixel, accounting for the possible signal contribution to
@@ -364,11 +408,11 @@ void Digitizer::registerDigits(ChipDigitsContainer& chip, uint32_t roFrame, floa
     if (nEleROF < mParams.getMinChargeToAccount()) {
       continue;
     }
-    if (roFr > mEventROFrameMax) {
-      mEventROFrameMax = roFr;
+    if (roFr > context.eventROFrameMax) {
+      context.eventROFrameMax = roFr;
     }
-    if (roFr < mEventROFrameMin) {
-      mEventROFrameMin = roFr;
+    if (roFr < context.eventROFrameMin) {
+      context.eventROFrameMin = roFr;
     }
     auto key = chip.getOrderingKey(roFr, row, col);
     PreDigit* pd = chip.findDigit(key);
@@ -376,25 +420,7 @@ void Digitizer::registerDigits(ChipDigitsContainer& chip, uint32_t roFrame, floa
       chip.addDigit(key, roFr, row, col, nEleROF, lbl);
     } else { // there is already a digit at this slot, account as PreDigitExtra contribution
       pd->charge += nEleROF;
-      if (pd->labelRef.label == lbl) { // don't store the same label twice
-        continue;
-      }
-      ExtraDig* extra = getExtraDigBuffer(roFr);
-      int& nxt = pd->labelRef.next;
-      bool skip = false;
-      while (nxt >= 0) {
-        if ((*extra)[nxt].label == lbl) { // don't store the same label twice
-          skip = true;
-          break;
-        }
-        nxt = (*extra)[nxt].next;
-      }
-      if (skip) {
-        continue;
-      }
-      // new predigit will be added in the end of the chain
-      nxt = extra->size();
-      extra->emplace_back(lbl);
+      chip.addLabel(*pd, lbl);
     }
   }
 }
@@ -13,6 +13,9 @@
 #include "CommonConstants/Triggers.h"
 #include "ITSMFTReconstruction/GBTLink.h"
 #include "Framework/Logger.h"
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
 
 using namespace o2::itsmft;
 using namespace o2::raw;
@@ -113,25 +116,44 @@ void MC2RawEncoder<Mapping>::digits2raw(gsl::span<const Digit> digits, const o2:
     curChipData->getData().emplace_back(&dig); // add new digit to the container
   }
 
-  // convert digits to alpide data in the per-cable buffers
+  // convert digits to alpide data in the per-cable buffers. The RUs are independent and the writer accepts
+  // concurrent addData calls for different links of the same IR
+  if (mCoders.size() != size_t(mNThreads)) {
+    mCoders.resize(mNThreads);
+  }
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
   for (int iru = int(mRUSWMin); iru <= int(mRUSWMax); iru++) {
-    auto& ru = *getRUDecode(iru);
-    uint16_t next2Proc = 0, nchTot = mMAP.getNChipsOnRUType(ru.ruInfo->ruType);
-    for (int ich = 0; ich < ru.nChipsFired; ich++) {
-      auto& chipData = ru.chipsData[ich];
-      convertEmptyChips(next2Proc, chipData.getChipID(), ru); // if needed store EmptyChip flags for the empty chips
-      next2Proc = chipData.getChipID() + 1;
-      convertChip(chipData, ru);
-      chipData.clear();
-    }
-    convertEmptyChips(next2Proc, nchTot, ru); // if needed store EmptyChip flags
-    fillGBTLinks(ru);                         // flush per-lane buffers to link buffers
+#ifdef WITH_OPENMP
+    auto& coder = mCoders[omp_get_thread_num()];
+#else
+    auto& coder = mCoders[0];
+#endif
+    convertRU(*getRUDecode(iru), coder);
+  }
+}
+
+///______________________________________________________________________
+template <class Mapping>
+void MC2RawEncoder<Mapping>::convertRU(RUDecodeData& ru, Coder& coder)
+{
+  // convert digits of single RU and flush them to the writer
+  uint16_t next2Proc = 0, nchTot = mMAP.getNChipsOnRUType(ru.ruInfo->ruType);
+  for (int ich = 0; ich < ru.nChipsFired; ich++) {
+    auto& chipData = ru.chipsData[ich];
+    convertEmptyChips(next2Proc, chipData.getChipID(), ru, coder); // if needed store EmptyChip flags for the empty chips
+    next2Proc = chipData.getChipID() + 1;
+    convertChip(chipData, ru, coder);
+    chipData.clear();
   }
+  convertEmptyChips(next2Proc, nchTot, ru, coder); // if needed store EmptyChip flags
+  fillGBTLinks(ru);                                // flush per-lane buffers to link buffers
 }
 
 //___________________________________________________________________________________
 template <class Mapping>
-void MC2RawEncoder<Mapping>::convertChip(ChipPixelData& chipData, RUDecodeData& ru)
+void MC2RawEncoder<Mapping>::convertChip(ChipPixelData& chipData, RUDecodeData& ru, Coder& coder)
 {
   ///< convert digits of single chip to Alpide format.
   const auto& chip = *mMAP.getChipOnRUInfo(ru.ruInfo->ruType, chipData.getChipID());
@@ -142,19 +164,19 @@ void MC2RawEncoder<Mapping>::convertChip(ChipPixelData& chipData, RUDecodeData&
               return (lhs.getRow() < rhs.getRow()) ? true : ((lhs.getRow() > rhs.getRow()) ? false : (lhs.getCol() < rhs.getCol()));
             });
   ru.cableData[chip.cableHWPos].ensureFreeCapacity(40 * (2 + pixels.size())); // make sure buffer has enough capacity
-  mCoder.encodeChip(ru.cableData[chip.cableHWPos], chipData, chip.chipOnModuleHW, mCurrIR.bc);
+  coder.encodeChip(ru.cableData[chip.cableHWPos], chipData, chip.chipOnModuleHW, mCurrIR.bc);
 }
 
 //______________________________________________________
 template <class Mapping>
-void MC2RawEncoder<Mapping>::convertEmptyChips(int fromChip, int uptoChip, RUDecodeData& ru)
+void MC2RawEncoder<Mapping>::convertEmptyChips(int fromChip, int uptoChip, RUDecodeData& ru, Coder& coder)
 {
   // add empty chip words to respective cable's buffers for all chips of the current RU container
   for (int chipIDSW = fromChip; chipIDSW < uptoChip; chipIDSW++) { // flag chips w/o data
     const auto& chip = *mMAP.getChipOnRUInfo(ru.ruInfo->ruType, chipIDSW);
     ru.cableHWID[chip.cableHWPos] = chip.cableHW; // register the cable HW ID
     ru.cableData[chip.cableHWPos].ensureFreeCapacity(100);
-    mCoder.addEmptyChip(ru.cableData[chip.cableHWPos], chip.chipOnModuleHW, mCurrIR.bc);
+    coder.addEmptyChip(ru.cableData[chip.cableHWPos], chip.chipOnModuleHW, mCurrIR.bc);
   }
 }
 
@@ -0,0 +1,94 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test ChipDigitsContainer
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <map>
+#include <random>
+#include <vector>
+#include "ITSMFTSimulation/ChipDigitsContainer.h"
+
+using namespace o2::itsmft;
+
+BOOST_AUTO_TEST_CASE(ChipDigitsContainer_test)
+{
+  // fill the container and a std::map with the same random pixels of 3 frames
+  ChipDigitsContainer chip(1);
+  std::map<ULong64_t, int> reference;
+  std::mt19937 gen(1234);
+  std::uniform_int_distribution<int> rowDist(0, 511), colDist(0, 1023), rofDist(10, 12), chargeDist(1, 1000);
+  for (int i = 0; i < 5000; i++) {
+    UInt_t rof = rofDist(gen);
+    UShort_t row = rowDist(gen), col = colDist(gen);
+    int charge = chargeDist(gen);
+    auto key = ChipDigitsContainer::getOrderingKey(rof, row, col);
+    auto digit = chip.findDigit(key);
+    BOOST_CHECK_EQUAL(digit != nullptr, reference.find(key) != reference.end());
+    if (digit) {
+      digit->charge += charge;
+      reference[key] += charge;
+    } else {
+      chip.addDigit(key, rof, row, col, charge, o2::MCCompLabel(i, 0, 0));
+      reference[key] = charge;
+    }
+  }
+
+  // flush the frames one by one, the digits must come in the order of the map
+  auto refIt = reference.begin();
+  for (UInt_t rof = 10; rof <= 12; rof++) {
+    auto maxKey = ChipDigitsContainer::getOrderingKey(rof + 1, 0, 0) - 1;
+    size_t nDigits = chip.sortPreDigits(maxKey);
+    auto& digits = chip.getPreDigits();
+    for (size_t i = 0; i < nDigits; i++, ++refIt) {
+      BOOST_REQUIRE(refIt != reference.end());
+      BOOST_CHECK_EQUAL(ChipDigitsContainer::getOrderingKey(digits[i].roFrame, digits[i].row, digits[i].col), refIt->first);
+      BOOST_CHECK_EQUAL(digits[i].charge, refIt->second);
+    }
+    chip.removePreDigits(nDigits);
+    // the remaining digits are still found
+    for (auto it = refIt; it != reference.end(); ++it) {
+      BOOST_CHECK(chip.findDigit(it->first));
+    }
+  }
+  BOOST_CHECK(refIt == reference.end());
+  BOOST_CHECK(chip.isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE(ChipDigitsContainerLabels_test)
+{
+  // extra contributions are chained in their order of arrival, each label once
+  ChipDigitsContainer chip(1);
+  std::vector<ULong64_t> keys;
+  for (UInt_t rof = 0; rof < 200; rof++) {
+    keys.push_back(ChipDigitsContainer::getOrderingKey(rof, 5, 7));
+    chip.addDigit(keys.back(), rof, 5, 7, 100, o2::MCCompLabel(0, rof, 0));
+    for (int track = 1; track < 4; track++) {
+      chip.addLabel(*chip.findDigit(keys.back()), o2::MCCompLabel(track, rof, 0));
+      chip.addLabel(*chip.findDigit(keys.back()), o2::MCCompLabel(track, rof, 0));
+    }
+  }
+  for (UInt_t rof = 0; rof < 200; rof++) {
+    // remove the digits one frame at a time, letting the pool of labels be compacted
+    auto nDigits = chip.sortPreDigits(keys[rof]);
+    BOOST_REQUIRE_EQUAL(nDigits, 1);
+    const auto& digit = chip.getPreDigits()[0];
+    BOOST_CHECK(digit.labelRef.label == o2::MCCompLabel(0, rof, 0));
+    int track = 1;
+    for (int next = digit.labelRef.next; next >= 0; next = chip.getExtraLabel(next).next, track++) {
+      BOOST_CHECK(chip.getExtraLabel(next).label == o2::MCCompLabel(track, rof, 0));
+    }
+    BOOST_CHECK_EQUAL(track, 4);
+    chip.removePreDigits(nDigits);
+  }
+}
@@ -25,13 +25,13 @@
 
 #include <gsl/span>
 
-#include <TH2D.h>
-
 #include "DataFormatsMCH/Digit.h"
 #include "MCHBase/ClusterBlock.h"
 #include "MCHMappingInterface/Segmentation.h"
 #include "MCHPreClustering/PreClusterFinder.h"
 
+class TRandom;
+
 namespace o2
 {
 namespace mch
@@ -40,6 +40,8 @@ namespace mch
 class PadOriginal;
 class ClusterOriginal;
 class MathiesonOriginal;
+template <typename T>
+class PixelHistogram;
 
 class ClusterFinderOriginal
 {
@@ -58,6 +60,8 @@ class ClusterFinderOriginal
 
   void findClusters(gsl::span<const Digit> digits);
 
+  void setRandomSeed(unsigned int seed);
+
   /// return the list of reconstructed clusters
   const std::vector<ClusterStruct>& getClusters() const { return mClusters; }
   /// return the list of digits used in reconstructed clusters
@@ -74,18 +78,18 @@ class ClusterFinderOriginal
   void processPreCluster();
 
   void buildPixArray();
-  void ProjectPadOverPixels(const PadOriginal& pad, TH2D& hCharges, TH2I& hEntries) const;
+  void ProjectPadOverPixels(const PadOriginal& pad, PixelHistogram<double>& hCharges, PixelHistogram<int>& hEntries) const;
 
-  void findLocalMaxima(std::unique_ptr<TH2D>& histAnode, std::multimap<double, std::pair<int, int>, std::greater<>>& localMaxima);
-  void flagLocalMaxima(const TH2D& histAnode, int i0, int j0, std::vector<std::vector<int>>& isLocalMax) const;
-  void restrictPreCluster(const TH2D& histAnode, int i0, int j0);
+  void findLocalMaxima(PixelHistogram<double>& histAnode, std::multimap<double, std::pair<int, int>, std::greater<>>& localMaxima);
+  void flagLocalMaxima(const PixelHistogram<double>& histAnode, int i0, int j0, std::vector<std::vector<int>>& isLocalMax) const;
+  void restrictPreCluster(const PixelHistogram<double>& histAnode, int i0, int j0);
 
   void processSimple();
   void process();
   void addVirtualPad();
   void computeCoefficients(std::vector<double>& coef, std::vector<double>& prob) const;
   double mlem(const std::vector<double>& coef, const std::vector<double>& prob, int nIter);
-  void findCOG(const TH2D& histMLEM, double xy[2]) const;
+  void findCOG(const PixelHistogram<double>& histMLEM, double xy[2]) const;
   void refinePixelArray(const double xyCOG[2], size_t nPixMax, double& xMin, double& xMax, double& yMin, double& yMax);
   void cleanPixelArray(double threshold, std::vector<double>& prob);
 
@@ -96,8 +100,8 @@ class ClusterFinderOriginal
   void param2ChargeFraction(const double param[SNFitParamMax], int nParamUsed, double fraction[SNFitClustersMax]) const;
   float chargeIntegration(double x, double y, const PadOriginal& pad) const;
 
-  void split(const TH2D& histMLEM, const std::vector<double>& coef);
-  void addPixel(const TH2D& histMLEM, int i0, int j0, std::vector<int>& pixels, std::vector<std::vector<bool>>& isUsed);
+  void split(const PixelHistogram<double>& histMLEM, const std::vector<double>& coef);
+  void addPixel(const PixelHistogram<double>& histMLEM, int i0, int j0, std::vector<int>& pixels, std::vector<std::vector<bool>>& isUsed);
   void addCluster(int iCluster, std::vector<int>& coupledClusters, std::vector<bool>& isClUsed,
                   const std::vector<std::vector<double>>& couplingClCl) const;
   void extractLeastCoupledClusters(std::vector<int>& coupledClusters, std::vector<int>& clustersForFit,
@@ -123,6 +127,13 @@ class ClusterFinderOriginal
   std::unique_ptr<ClusterOriginal> mPreCluster; ///< precluster currently processed
   std::vector<PadOriginal> mPixels;             ///< list of pixels for the current precluster
 
+  std::unique_ptr<PixelHistogram<double>> mHistCharges; ///< pixel charges used to build the pixel array
+  std::unique_ptr<PixelHistogram<int>> mHistEntries;    ///< pixel entries used to build the pixel array
+  std::unique_ptr<PixelHistogram<double>> mHistAnode;   ///< pixel array used to find local maxima
+  std::unique_ptr<PixelHistogram<double>> mHistMLEM;    ///< pixel array used in the MLEM procedure
+
+  std::unique_ptr<TRandom> mRandom{}; ///< random generator used in the fit (gRandom if not set)
+
   const mapping::Segmentation* mSegmentation = nullptr; ///< pointer to the DE segmentation for the current precluster
 
   std::vector<ClusterStruct> mClusters{}; ///< list of reconstructed clusters
@@ -42,6 +42,14 @@ class MathiesonOriginal
 
   float integrate(float xMin, float yMin, float xMax, float yMax) const;
 
+  /// The integral over an area factorizes in x and y. The partial integrals can be computed separately,
+  /// for instance to be reused for several areas sharing the same limits in one direction,
+  /// then combined with integrate(integralX, integralY) to give the same result as above
+  double integrateX(float xMin, float xMax) const;
+  double integrateY(float yMin, float yMax) const;
+  /// combine the partial integrals in x and y directions
+  float integrate(double integralX, double integralY) const { return static_cast<float>(integralX * mKy4 * integralY); }
+
  private:
   float mSqrtKx3 = 0.;      ///< Mathieson Sqrt(Kx3)
   float mKx2 = 0.;          ///< Mathieson Kx2
@@ -0,0 +1,148 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file PixelHistogram.h
+/// \brief Definition of the 2D array of pixels used by the original cluster finder algorithm
+///
+/// \author Philippe Pillot, Subatech
+
+#ifndef ALICEO2_MCH_PIXELHISTOGRAM_H_
+#define ALICEO2_MCH_PIXELHISTOGRAM_H_
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace o2
+{
+namespace mch
+{
+
+/// lightweight replacement of the ROOT 2D histograms with fixed bins, for internal use.
+/// The binning conventions are the ones of ROOT (bins numbered from 1 to nBins, underflow in bin 0
+/// and overflow in bin nBins+1, same arithmetic to find a bin or compute its center) so that it can be
+/// used as a drop-in replacement. The storage is a flat vector reused from one booking to the next,
+/// without any registration in a global directory, so it can be used concurrently in several threads.
+template <typename T>
+class PixelHistogram
+{
+ public:
+  PixelHistogram() = default;
+  ~PixelHistogram() = default;
+
+  PixelHistogram(const PixelHistogram&) = delete;
+  PixelHistogram& operator=(const PixelHistogram&) = delete;
+  PixelHistogram(PixelHistogram&&) = default;
+  PixelHistogram& operator=(PixelHistogram&&) = default;
+
+  /// define the binning and reset the content, reusing the memory already allocated
+  void reset(int nBinsX, double xMin, double xMax, int nBinsY, double yMin, double yMax)
+  {
+    mNBinsX = nBinsX;
+    mXMin = xMin;
+    mXMax = xMax;
+    mNBinsY = nBinsY;
+    mYMin = yMin;
+    mYMax = yMax;
+    mContent.assign((nBinsX + 2) * (nBinsY + 2), T(0));
+  }
+
+  /// return the number of bins in x direction
+  int nBinsX() const { return mNBinsX; }
+  /// return the number of bins in y direction
+  int nBinsY() const { return mNBinsY; }
+
+  /// return the lower limit of the histogram in x direction
+  double xMin() const { return mXMin; }
+  /// return the upper limit of the histogram in x direction
+  double xMax() const { return mXMax; }
+  /// return the lower limit of the histogram in y direction
+  double yMin() const { return mYMin; }
+  /// return the upper limit of the histogram in y direction
+  double yMax() const { return mYMax; }
+
+  /// return the width of the bins in x direction
+  double binWidthX() const { return (mXMax - mXMin) / static_cast<double>(mNBinsX); }
+  /// return the width of the bins in y direction
+  double binWidthY() const { return (mYMax - mYMin) / static_cast<double>(mNBinsY); }
+
+  /// return the center of the bin i in x direction
+  double binCenterX(int i) const { return mXMin + (static_cast<double>(i) - 0.5) * binWidthX(); }
+  /// return the center of the bin j in y direction
+  double binCenterY(int j) const { return mYMin + (static_cast<double>(j) - 0.5) * binWidthY(); }
+
+  /// return the bin containing x (0 = underflow, nBinsX+1 = overflow)
+  int findBinX(double x) const { return findBin(x, mNBinsX, mXMin, mXMax); }
+  /// return the bin containing y (0 = underflow, nBinsY+1 = overflow)
+  int findBinY(double y) const { return findBin(y, mNBinsY, mYMin, mYMax); }
+
+  /// return the content of the bin (i,j)
+  T content(int i, int j) const { return mContent[index(i, j)]; }
+  /// set the content of the bin (i,j)
+  void setContent(int i, int j, T content) { mContent[index(i, j)] = content; }
+  /// add w to the content of the bin containing (x,y)
+  void fill(double x, double y, T w) { mContent[index(findBinX(x), findBinY(y))] += w; }
+
+  /// return the maximum content of the bins, excluding underflows and overflows
+  T maximum() const
+  {
+    int i(0), j(0);
+    return maximumBin(i, j);
+  }
+
+  /// return the maximum content of the bins, excluding underflows and overflows, and set the indices of
+  /// the corresponding bin. In case of several bins with the same maximum content, the first one found
+  /// when scanning the bins along x then along y is returned
+  T maximumBin(int& i0, int& j0) const
+  {
+    T max = std::numeric_limits<T>::lowest();
+    i0 = j0 = 0;
+    for (int j = 1; j <= mNBinsY; ++j) {
+      for (int i = 1; i <= mNBinsX; ++i) {
+        T content = mContent[index(i, j)];
+        if (content > max) {
+          max = content;
+          i0 = i;
+          j0 = j;
+        }
+      }
+    }
+    return max;
+  }
+
+ private:
+  /// return the index of the bin (i,j) in the flat storage
+  int index(int i, int j) const { return i + (mNBinsX + 2) * j; }
+
+  /// return the bin containing x in an axis made of nBins between min and max
+  static int findBin(double x, int nBins, double min, double max)
+  {
+    if (x < min) {
+      return 0;
+    } else if (!(x < max)) {
+      return nBins + 1;
+    }
+    return 1 + static_cast<int>(nBins * (x - min) / (max - min));
+  }
+
+  int mNBinsX = 0;         ///< number of bins in x direction
+  double mXMin = 0.;       ///< lower limit in x direction
+  double mXMax = 0.;       ///< upper limit in x direction
+  int mNBinsY = 0;         ///< number of bins in y direction
+  double mYMin = 0.;       ///< lower limit in y direction
+  double mYMax = 0.;       ///< upper limit in y direction
+  std::vector<T> mContent; ///< bin contents, including underflows and overflows
+};
+
+} // namespace mch
+} // namespace o2
+
+#endif // ALICEO2_MCH_PIXELHISTOGRAM_H_
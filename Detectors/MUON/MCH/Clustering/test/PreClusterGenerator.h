@@ -0,0 +1,113 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file PreClusterGenerator.h
+/// \brief Generation of preclusters with Mathieson distributed charges for the clustering benchmark
+///
+/// The digits are encoded with the run2 convention (calibrated charge stored as a float in the ADC word),
+/// so they must be clusterized with ClusterFinderOriginal::init(true)
+
+#ifndef ALICEO2_MCH_PRECLUSTERGENERATOR_H_
+#define ALICEO2_MCH_PRECLUSTERGENERATOR_H_
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "DataFormatsMCH/Digit.h"
+#include "MCHMappingInterface/Segmentation.h"
+#include "../src/MathiesonOriginal.h"
+
+namespace o2
+{
+namespace mch
+{
+namespace test
+{
+
+/// return the Mathieson function used with the run2 configuration for the given DE
+inline MathiesonOriginal run2Mathieson(int deId)
+{
+  MathiesonOriginal mathieson{};
+  if (deId < 300) {
+    mathieson.setPitch(0.21);
+    mathieson.setSqrtKx3AndDeriveKx2Kx4(0.7000);
+    mathieson.setSqrtKy3AndDeriveKy2Ky4(0.7550);
+  } else {
+    mathieson.setPitch(0.25);
+    mathieson.setSqrtKx3AndDeriveKx2Kx4(0.7131);
+    mathieson.setSqrtKy3AndDeriveKy2Ky4(0.7642);
+  }
+  return mathieson;
+}
+
+/// generate the digits of one precluster made of nHits Mathieson showers at less than 1.5 cm
+/// from each other in the detection element deId, with a total charge between 100 and 1000 each
+inline std::vector<Digit> generatePreCluster(int deId, int nHits, std::mt19937& gen)
+{
+  static constexpr float LowestPadCharge = 4.f * 0.22875f;
+  static constexpr double Area = 5.;
+
+  const auto& segmentation = mapping::segmentation(deId);
+  auto mathieson = run2Mathieson(deId);
+  std::uniform_real_distribution<double> offset(-1.5, 1.5);
+  std::uniform_real_distribution<double> charge(100., 1000.);
+
+  // pick the position of the first hit at the center of a random pad of the bending plane
+  std::vector<int> bendingPads{};
+  segmentation.forEachPad([&segmentation, &bendingPads](int padId) {
+    if (segmentation.isBendingPad(padId)) {
+      bendingPads.emplace_back(padId);
+    }
+  });
+  std::uniform_int_distribution<size_t> pad(0, bendingPads.size() - 1);
+  int firstPad = bendingPads[pad(gen)];
+  double x0 = segmentation.padPositionX(firstPad);
+  double y0 = segmentation.padPositionY(firstPad);
+
+  // accumulate the charge induced on every pad by the hits located on both cathodes
+  std::map<int, float> charges{};
+  for (int iHit = 0; iHit < nHits; ++iHit) {
+    double x = x0 + ((iHit > 0) ? offset(gen) : 0.);
+    double y = y0 + ((iHit > 0) ? offset(gen) : 0.);
+    int bPad(-1), nbPad(-1);
+    if (!segmentation.findPadPairByPosition(x, y, bPad, nbPad)) {
+      continue;
+    }
+    double q = charge(gen);
+    segmentation.forEachPadInArea(x - Area, y - Area, x + Area, y + Area, [&](int padId) {
+      double dx = segmentation.padSizeX(padId) / 2.;
+      double dy = segmentation.padSizeY(padId) / 2.;
+      double xPad = segmentation.padPositionX(padId) - x;
+      double yPad = segmentation.padPositionY(padId) - y;
+      charges[padId] += q * mathieson.integrate(xPad - dx, yPad - dy, xPad + dx, yPad + dy);
+    });
+  }
+
+  std::vector<Digit> digits{};
+  for (const auto& [padId, q] : charges) {
+    if (q > LowestPadCharge) {
+      uint32_t adc(0);
+      std::memcpy(&adc, &q, sizeof(q));
+      digits.emplace_back(deId, padId, adc, 0);
+    }
+  }
+
+  return digits;
+}
+
+} // namespace test
+} // namespace mch
+} // namespace o2
+
+#endif // ALICEO2_MCH_PRECLUSTERGENERATOR_H_
@@ -0,0 +1,65 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file bench_ClusterFinderOriginal.cxx
+/// \brief Benchmark of ClusterFinderOriginal on preclusters made of one or several Mathieson showers
+
+#include "benchmark/benchmark.h"
+
+#include <random>
+#include <vector>
+
+#include <TRandom.h>
+
+#include "MCHClustering/ClusterFinderOriginal.h"
+#include "PreClusterGenerator.h"
+
+using namespace o2::mch;
+
+/// clusterize the same preclusters made of state.range(1) hits in the DE state.range(0)
+static void BM_ClusterFinderOriginal(benchmark::State& state)
+{
+  ClusterFinderOriginal clusterFinder{};
+  clusterFinder.init(true);
+
+  std::mt19937 gen(12345);
+  std::vector<std::vector<Digit>> preClusters{};
+  for (int i = 0; i < 100; ++i) {
+    preClusters.emplace_back(test::generatePreCluster(state.range(0), state.range(1), gen));
+  }
+
+  gRandom->SetSeed(1);
+  double nClusters = 0.;
+  for (auto _ : state) {
+    for (const auto& digits : preClusters) {
+      clusterFinder.reset();
+      clusterFinder.findClusters(digits);
+      nClusters += clusterFinder.getClusters().size();
+    }
+  }
+  state.counters["clusters/precluster"] = nClusters / (state.iterations() * preClusters.size());
+  state.SetItemsProcessed(state.iterations() * preClusters.size());
+
+  clusterFinder.deinit();
+}
+
+static void CustomArguments(benchmark::internal::Benchmark* bench)
+{
+  for (int deId : {100, 819}) {
+    for (int nHits : {1, 2, 3}) {
+      bench->Args({deId, nHits});
+    }
+  }
+}
+
+BENCHMARK(BM_ClusterFinderOriginal)->Apply(CustomArguments)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
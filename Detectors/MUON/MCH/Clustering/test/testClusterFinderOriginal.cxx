@@ -0,0 +1,144 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testClusterFinderOriginal.cxx
+/// \brief Check that ClusterFinderOriginal reproduces the clusters found by its former TH2 based version
+
+#define BOOST_TEST_MODULE Test MCHClustering ClusterFinderOriginal
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <TRandom.h>
+
+#include "DataFormatsMCH/Digit.h"
+#include "MCHBase/ClusterBlock.h"
+#include "MCHClustering/ClusterFinderOriginal.h"
+
+using namespace o2::mch;
+
+// maximum difference between the cluster positions and resolutions and the reference ones (cm)
+constexpr float Precision = 1.e-3f;
+
+/// precluster with the clusters and associated digits found by the TH2 based version
+struct ReferencePreCluster {
+  unsigned int seed = 0;
+  std::vector<Digit> digits{};
+  std::vector<ClusterStruct> clusters{};
+  std::vector<Digit> usedDigits{};
+};
+
+/// read the digit on the current line, encoded with the run2 convention (charge stored in the ADC word)
+Digit readDigit(std::istringstream& line)
+{
+  std::string tag{};
+  int deId(0), padId(0);
+  float charge(0.f);
+  line >> tag >> deId >> padId >> charge;
+  BOOST_TEST_REQUIRE(tag == "digit");
+  uint32_t adc(0);
+  std::memcpy(&adc, &charge, sizeof(charge));
+  return Digit(deId, padId, adc, 0);
+}
+
+/// read the reference preclusters from the file given as argument of the test
+const std::vector<ReferencePreCluster>& referencePreClusters()
+{
+  static std::vector<ReferencePreCluster> preClusters{};
+
+  if (preClusters.empty()) {
+    BOOST_TEST_REQUIRE(boost::unit_test::framework::master_test_suite().argc == 2);
+    std::ifstream in(boost::unit_test::framework::master_test_suite().argv[1]);
+    BOOST_TEST_REQUIRE(in.is_open());
+
+    auto nextLine = [&in](std::istringstream& line) {
+      std::string buffer{};
+      while (std::getline(in, buffer) && (buffer.empty() || buffer[0] == '#')) {
+      }
+      line.clear();
+      line.str(buffer);
+      return !buffer.empty();
+    };
+
+    std::istringstream line{};
+    while (nextLine(line)) {
+      std::string tag{};
+      size_t nDigits(0), nClusters(0), nUsedDigits(0);
+      auto& preCluster = preClusters.emplace_back();
+      line >> tag >> preCluster.seed >> nDigits >> nClusters >> nUsedDigits;
+      BOOST_TEST_REQUIRE(tag == "precluster");
+      for (size_t i = 0; i < nDigits; ++i) {
+        BOOST_TEST_REQUIRE(nextLine(line));
+        preCluster.digits.emplace_back(readDigit(line));
+      }
+      for (size_t i = 0; i < nClusters; ++i) {
+        BOOST_TEST_REQUIRE(nextLine(line));
+        auto& cluster = preCluster.clusters.emplace_back();
+        line >> tag >> cluster.x >> cluster.y >> cluster.z >> cluster.ex >> cluster.ey >> cluster.uid >> cluster.firstDigit >> cluster.nDigits;
+        BOOST_TEST_REQUIRE(tag == "cluster");
+      }
+      for (size_t i = 0; i < nUsedDigits; ++i) {
+        BOOST_TEST_REQUIRE(nextLine(line));
+        preCluster.usedDigits.emplace_back(readDigit(line));
+      }
+    }
+  }
+
+  return preClusters;
+}
+
+BOOST_AUTO_TEST_CASE(ClusterFinderOriginalMatchesTH2Version)
+{
+  const auto& preClusters = referencePreClusters();
+  BOOST_TEST_REQUIRE(!preClusters.empty());
+
+  ClusterFinderOriginal clusterFinder{};
+  clusterFinder.init(true);
+
+  for (const auto& preCluster : preClusters) {
+
+    // the random shifts of the fit are drawn from gRandom, seeded as when the reference was produced
+    clusterFinder.reset();
+    gRandom->SetSeed(preCluster.seed);
+    clusterFinder.findClusters(preCluster.digits);
+
+    const auto& clusters = clusterFinder.getClusters();
+    BOOST_TEST_REQUIRE(clusters.size() == preCluster.clusters.size());
+    for (size_t iCl = 0; iCl < clusters.size(); ++iCl) {
+      const auto& reference = preCluster.clusters[iCl];
+      BOOST_TEST(clusters[iCl].uid == reference.uid);
+      BOOST_CHECK_SMALL(clusters[iCl].x - reference.x, Precision);
+      BOOST_CHECK_SMALL(clusters[iCl].y - reference.y, Precision);
+      BOOST_CHECK_SMALL(clusters[iCl].ex - reference.ex, Precision);
+      BOOST_CHECK_SMALL(clusters[iCl].ey - reference.ey, Precision);
+      BOOST_TEST(clusters[iCl].firstDigit == reference.firstDigit);
+      BOOST_TEST(clusters[iCl].nDigits == reference.nDigits);
+    }
+
+    const auto& usedDigits = clusterFinder.getUsedDigits();
+    BOOST_TEST_REQUIRE(usedDigits.size() == preCluster.usedDigits.size());
+    for (size_t iDigit = 0; iDigit < usedDigits.size(); ++iDigit) {
+      BOOST_TEST(usedDigits[iDigit].getDetID() == preCluster.usedDigits[iDigit].getDetID());
+      BOOST_TEST(usedDigits[iDigit].getPadID() == preCluster.usedDigits[iDigit].getPadID());
+      BOOST_TEST(usedDigits[iDigit].getADC() == preCluster.usedDigits[iDigit].getADC());
+    }
+  }
+
+  clusterFinder.deinit();
+}
@@ -19,12 +19,15 @@
 
 #include <chrono>
 #include <unordered_map>
-#include <unordered_set>
 #include <list>
 #include <array>
+#include <memory>
 #include <vector>
 #include <utility>
 
+#include <gsl/span>
+
+#include "MCHBase/ClusterBlock.h"
 #include "MCHTracking/Cluster.h"
 #include "MCHTracking/Track.h"
 #include "MCHTracking/TrackFitter.h"
@@ -49,6 +52,12 @@ class TrackFinder
   void init(float l3Current, float dipoleCurrent);
 
   const std::list<Track>& findTracks(const std::unordered_map<int, std::list<Cluster>>& clusters);
+  const std::list<Track>& findTracks(gsl::span<const ClusterStruct> clusters);
+
+  /// set the number of threads used to follow the track candidates (to be called before init)
+  void setNThreads(int n) { mNThreads = n > 0 ? n : 1; }
+  /// get the number of threads used to follow the track candidates
+  int getNThreads() const { return mNThreads; }
 
   /// set the debug level defining the verbosity
   void debug(int debugLevel) { mDebugLevel = debugLevel; }
@@ -57,6 +66,12 @@ class TrackFinder
   void printTimers() const;
 
  private:
+  /// list of unique IDs of the clusters to exclude when following a track candidate
+  using ExcludedClusters = std::vector<uint32_t>;
+
+  void setClusters(gsl::span<const Cluster> clusters);
+  const std::list<Track>& findTracks();
+
   void findTrackCandidates();
   void findTrackCandidatesInSt5();
   void findTrackCandidatesInSt4();
@@ -66,13 +81,13 @@ class TrackFinder
   std::list<Track>::iterator followTrackInOverlapDE(const std::list<Track>::iterator& itTrack, int currentDE, int plane);
   std::list<Track>::iterator followTrackInChamber(std::list<Track>::iterator& itTrack,
                                                   int chamber, int lastChamber, bool canSkip,
-                                                  std::unordered_map<int, std::unordered_set<uint32_t>>& excludedClusters);
+                                                  ExcludedClusters& excludedClusters);
   std::list<Track>::iterator followTrackInChamber(std::list<Track>::iterator& itTrack,
                                                   int plane1, int plane2, int lastChamber,
-                                                  std::unordered_map<int, std::unordered_set<uint32_t>>& excludedClusters);
+                                                  ExcludedClusters& excludedClusters);
   std::list<Track>::iterator addClustersAndFollowTrack(std::list<Track>::iterator& itTrack, const TrackParam& paramAtCluster1,
                                                        const TrackParam* paramAtCluster2, int nextChamber, int lastChamber,
-                                                       std::unordered_map<int, std::unordered_set<uint32_t>>& excludedClusters);
+                                                       ExcludedClusters& excludedClusters);
 
   void improveTracks();
 
@@ -93,9 +108,14 @@ class TrackFinder
 
   bool areUsed(const Cluster& cl1, const Cluster& cl2, const std::list<Track>::iterator& itFirstTrack, const std::list<Track>::iterator& itLastTrack);
   void excludeClustersFromIdenticalTracks(const std::list<Track>::iterator& itTrack,
-                                          std::unordered_map<int, std::unordered_set<uint32_t>>& excludedClusters,
+                                          ExcludedClusters& excludedClusters,
                                           const std::list<Track>::iterator& itEndTrack);
-  void moveClusters(std::unordered_map<int, std::unordered_set<uint32_t>>& source, std::unordered_map<int, std::unordered_set<uint32_t>>& destination);
+  void moveClusters(ExcludedClusters& source, ExcludedClusters& destination);
+  static bool isExcluded(const ExcludedClusters& excludedClusters, uint32_t clusterId);
+  static void exclude(ExcludedClusters& excludedClusters, uint32_t clusterId);
+
+  void followTrackCandidates();
+  void followTrackCandidate(std::list<Track>& tracks);
 
   bool isCompatible(const TrackParam& param, const Cluster& cluster, TrackParam& paramAtCluster);
   bool tryOneClusterFast(const TrackParam& param, const Cluster& cluster);
@@ -128,7 +148,8 @@ class TrackFinder
 
   TrackFitter mTrackFitter{}; /// track fitter
 
-  std::array<std::vector<std::pair<const int, const std::list<Cluster>*>>, 32> mClusters{}; ///< array of pointers to the lists of clusters per DE
+  std::vector<Cluster> mClusterStore{};                                                   ///< clusters of the current event sorted per DE
+  std::array<std::vector<std::pair<const int, gsl::span<const Cluster>>>, 32> mClusters{}; ///< array of clusters per DE grouped per plane
 
   std::list<Track> mTracks{}; ///< list of reconstructed tracks
 
@@ -142,6 +163,9 @@ class TrackFinder
 
   int mDebugLevel = 0; ///< debug level defining the verbosity
 
+  int mNThreads = 1;                                    ///< number of threads used to follow the track candidates
+  std::vector<std::unique_ptr<TrackFinder>> mWorkers{}; ///< track finders following the candidates in parallel (1 per thread)
+
   std::size_t mNCandidates = 0;            ///< counter
   std::size_t mNCallTryOneCluster = 0;     ///< counter
   std::size_t mNCallTryOneClusterFast = 0; ///< counter
@@ -35,8 +35,8 @@ namespace mch
 bool TrackExtrap::sExtrapV2 = false;
 double TrackExtrap::sSimpleBValue = 0.;
 bool TrackExtrap::sFieldON = false;
-std::size_t TrackExtrap::sNCallExtrapToZCov = 0;
-std::size_t TrackExtrap::sNCallField = 0;
+std::atomic<std::size_t> TrackExtrap::sNCallExtrapToZCov{0};
+std::atomic<std::size_t> TrackExtrap::sNCallField{0};
 
 //__________________________________________________________________________
 void TrackExtrap::setField()
@@ -162,7 +162,7 @@ bool TrackExtrap::extrapToZCov(TrackParam* trackParam, double zEnd, bool updateP
   /// Track parameters and their covariances extrapolated to the plane at "zEnd".
   /// On return, results from the extrapolation are updated in trackParam.
 
-  ++sNCallExtrapToZCov;
+  sNCallExtrapToZCov.fetch_add(1, std::memory_order_relaxed);
 
   if (trackParam->getZ() == zEnd) {
     return true; // nothing to be done if same z
@@ -1041,7 +1041,7 @@ bool TrackExtrap::extrapOneStepRungekutta(double charge, double step, const doub
     }
     // cmodif: call gufld(vout,f) changed into:
     TGeoGlobalMagField::Instance()->Field(vout, f);
-    ++sNCallField;
+    sNCallField.fetch_add(1, std::memory_order_relaxed);
 
     // *
     // *             start of integration
@@ -1090,7 +1090,7 @@ bool TrackExtrap::extrapOneStepRungekutta(double charge, double step, const doub
 
     // cmodif: call gufld(xyzt,f) changed into:
     TGeoGlobalMagField::Instance()->Field(xyzt, f);
-    ++sNCallField;
+    sNCallField.fetch_add(1, std::memory_order_relaxed);
 
     at = a + secxs[0];
     bt = b + secys[0];
@@ -1130,7 +1130,7 @@ bool TrackExtrap::extrapOneStepRungekutta(double charge, double step, const doub
 
     // cmodif: call gufld(xyzt,f) changed into:
     TGeoGlobalMagField::Instance()->Field(xyzt, f);
-    ++sNCallField;
+    sNCallField.fetch_add(1, std::memory_order_relaxed);
 
     z = z + (c + (seczs[0] + seczs[1] + seczs[2]) * kthird) * h;
     y = y + (b + (secys[0] + secys[1] + secys[2]) * kthird) * h;
@@ -1233,8 +1233,8 @@ bool TrackExtrap::extrapOneStepRungekutta(double charge, double step, const doub
 void TrackExtrap::printNCalls()
 {
   /// Print the number of times some methods are called
-  LOG(INFO) << "number of times extrapToZCov() is called = " << sNCallExtrapToZCov;
-  LOG(INFO) << "number of times Field() is called = " << sNCallField;
+  LOG(INFO) << "number of times extrapToZCov() is called = " << sNCallExtrapToZCov.load();
+  LOG(INFO) << "number of times Field() is called = " << sNCallField.load();
 }
 
 } // namespace mch
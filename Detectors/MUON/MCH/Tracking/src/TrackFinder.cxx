@@ -16,10 +16,16 @@
 
 #include "MCHTracking/TrackFinder.h"
 
+#include <algorithm>
 #include <cassert>
+#include <exception>
 #include <iostream>
 #include <stdexcept>
 
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
 #include <TGeoGlobalMagField.h>
 #include <TMatrixD.h>
 #include <TMath.h>
@@ -75,89 +81,146 @@ void TrackFinder::init(float l3Current, float dipoleCurrent)
   // grouping DEs in z-planes (2 for chambers 1-4 and 4 for chambers 5-10)
   for (int iCh = 0; iCh < 4; ++iCh) {
     mClusters[2 * iCh].reserve(2);
-    mClusters[2 * iCh].emplace_back(100 * (iCh + 1) + 1, nullptr);
-    mClusters[2 * iCh].emplace_back(100 * (iCh + 1) + 3, nullptr);
+    mClusters[2 * iCh].emplace_back(100 * (iCh + 1) + 1, gsl::span<const Cluster>{});
+    mClusters[2 * iCh].emplace_back(100 * (iCh + 1) + 3, gsl::span<const Cluster>{});
     mClusters[2 * iCh + 1].reserve(2);
-    mClusters[2 * iCh + 1].emplace_back(100 * (iCh + 1), nullptr);
-    mClusters[2 * iCh + 1].emplace_back(100 * (iCh + 1) + 2, nullptr);
+    mClusters[2 * iCh + 1].emplace_back(100 * (iCh + 1), gsl::span<const Cluster>{});
+    mClusters[2 * iCh + 1].emplace_back(100 * (iCh + 1) + 2, gsl::span<const Cluster>{});
   }
   for (int iCh = 4; iCh < 6; ++iCh) {
     mClusters[8 + 4 * (iCh - 4)].reserve(5);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1), nullptr);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 2, nullptr);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 4, nullptr);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 14, nullptr);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 16, nullptr);
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1), gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 2, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 4, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 14, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 16, gsl::span<const Cluster>{});
     mClusters[8 + 4 * (iCh - 4) + 1].reserve(4);
-    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 1, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 3, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 15, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 17, nullptr);
+    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 1, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 3, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 15, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 17, gsl::span<const Cluster>{});
     mClusters[8 + 4 * (iCh - 4) + 2].reserve(4);
-    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 6, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 8, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 10, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 12, nullptr);
+    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 6, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 8, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 10, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 12, gsl::span<const Cluster>{});
     mClusters[8 + 4 * (iCh - 4) + 3].reserve(5);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 5, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 7, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 9, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 11, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 13, nullptr);
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 5, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 7, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 9, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 11, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 13, gsl::span<const Cluster>{});
   }
   for (int iCh = 6; iCh < 10; ++iCh) {
     mClusters[8 + 4 * (iCh - 4)].reserve(7);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1), nullptr);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 2, nullptr);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 4, nullptr);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 6, nullptr);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 20, nullptr);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 22, nullptr);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 24, nullptr);
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1), gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 2, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 4, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 6, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 20, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 22, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 24, gsl::span<const Cluster>{});
     mClusters[8 + 4 * (iCh - 4) + 1].reserve(6);
-    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 1, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 3, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 5, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 21, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 23, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 25, nullptr);
+    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 1, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 3, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 5, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 21, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 23, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 25, gsl::span<const Cluster>{});
     mClusters[8 + 4 * (iCh - 4) + 2].reserve(6);
-    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 8, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 10, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 12, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 14, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 16, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 18, nullptr);
+    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 8, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 10, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 12, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 14, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 16, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 18, gsl::span<const Cluster>{});
     mClusters[8 + 4 * (iCh - 4) + 3].reserve(7);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 7, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 9, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 11, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 13, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 15, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 17, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 19, nullptr);
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 7, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 9, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 11, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 13, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 15, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 17, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 19, gsl::span<const Cluster>{});
+  }
+
+  // prepare the track finders used to follow the track candidates in parallel
+#ifndef WITH_OPENMP
+  if (mNThreads > 1) {
+    LOG(WARNING) << "OpenMP is not available, the track candidates will be followed in 1 thread";
+    mNThreads = 1;
+  }
+#endif
+  mWorkers.clear();
+  if (mNThreads > 1) {
+    for (int i = 0; i < mNThreads; ++i) {
+      mWorkers.emplace_back(std::make_unique<TrackFinder>());
+      mWorkers.back()->init(l3Current, dipoleCurrent);
+    }
   }
 }
 
 //_________________________________________________________________________________________________
 const std::list<Track>& TrackFinder::findTracks(const std::unordered_map<int, std::list<Cluster>>& clusters)
 {
-  /// Run the track finder algorithm
+  /// Run the track finder algorithm on the lists of clusters per DE
+  /// The clusters are copied in the internal storage, to which the tracks will point to
 
-  mTracks.clear();
+  mClusterStore.clear();
+  for (const auto& de : clusters) {
+    mClusterStore.insert(mClusterStore.end(), de.second.begin(), de.second.end());
+  }
+  std::stable_sort(mClusterStore.begin(), mClusterStore.end(), [](const Cluster& cl1, const Cluster& cl2) {
+    return cl1.getDEId() < cl2.getDEId();
+  });
+  setClusters(mClusterStore);
+
+  return findTracks();
+}
+
+//_________________________________________________________________________________________________
+const std::list<Track>& TrackFinder::findTracks(gsl::span<const ClusterStruct> clusters)
+{
+  /// Run the track finder algorithm on the list of clusters of one event
+  /// The clusters are copied in the internal storage, to which the tracks will point to
+  /// Within each DE, the clusters are considered in the order of the input list
+
+  mClusterStore.assign(clusters.begin(), clusters.end());
+  std::stable_sort(mClusterStore.begin(), mClusterStore.end(), [](const Cluster& cl1, const Cluster& cl2) {
+    return cl1.getDEId() < cl2.getDEId();
+  });
+  setClusters(mClusterStore);
+
+  return findTracks();
+}
+
+//_________________________________________________________________________________________________
+void TrackFinder::setClusters(gsl::span<const Cluster> clusters)
+{
+  /// fill the internal array of clusters per DE from the list of clusters sorted per DE
 
-  // fill the internal array of pointers to the list of clusters per DE
   for (auto& plane : mClusters) {
     for (auto& de : plane) {
-      auto itDE = clusters.find(de.first);
-      if (itDE == clusters.end()) {
-        de.second = nullptr;
-      } else {
-        de.second = &(itDE->second);
-      }
+      auto itFirst = std::lower_bound(clusters.begin(), clusters.end(), de.first,
+                                      [](const Cluster& cluster, int deId) { return cluster.getDEId() < deId; });
+      auto itLast = std::upper_bound(itFirst, clusters.end(), de.first,
+                                     [](int deId, const Cluster& cluster) { return deId < cluster.getDEId(); });
+      de.second = clusters.subspan(std::distance(clusters.begin(), itFirst), std::distance(itFirst, itLast));
     }
   }
 
+  for (auto& worker : mWorkers) {
+    worker->setClusters(clusters);
+  }
+}
+
+//_________________________________________________________________________________________________
+const std::list<Track>& TrackFinder::findTracks()
+{
+  /// Run the track finder algorithm on the clusters stored internally
+
+  mTracks.clear();
+
   // use the chamber resolution when fitting the tracks during the tracking
   mTrackFitter.useChamberResolution();
 
@@ -178,12 +241,7 @@ const std::list<Track>& TrackFinder::findTracks(const std::unordered_map<int, st
 
   // track each candidate down to chamber 1 and remove it
   tStart = std::chrono::high_resolution_clock::now();
-  for (auto itTrack = mTracks.begin(); itTrack != mTracks.end();) {
-    std::unordered_map<int, std::unordered_set<uint32_t>> excludedClusters{};
-    followTrackInChamber(itTrack, 5, 0, false, excludedClusters);
-    print("findTracks: removing candidate at position #", getTrackIndex(itTrack));
-    itTrack = mTracks.erase(itTrack);
-  }
+  followTrackCandidates();
   tEnd = std::chrono::high_resolution_clock::now();
   mTimeFollowTracks += tEnd - tStart;
   print("------ list of tracks before improvement and cleaning ------");
@@ -233,7 +291,7 @@ void TrackFinder::findTrackCandidates()
     }
 
     // look for compatible clusters on station 4
-    std::unordered_map<int, std::unordered_set<uint32_t>> excludedClusters{};
+    ExcludedClusters excludedClusters{};
     auto itNewTrack = followTrackInChamber(itTrack, 7, 6, false, excludedClusters);
 
     // keep the current candidate only if no compatible cluster is found and the station is not requested
@@ -271,7 +329,7 @@ void TrackFinder::findTrackCandidates()
     // look for compatible clusters on each chamber of station 5 separately,
     // exluding those already attached to an identical candidate on station 4
     // (cases where both chambers of station 5 are fired should have been found in the first step)
-    std::unordered_map<int, std::unordered_set<uint32_t>> excludedClusters{};
+    ExcludedClusters excludedClusters{};
     if (itLastCandidateFromSt5 != mTracks.end()) {
       excludeClustersFromIdenticalTracks(itTrack, excludedClusters, std::next(itLastCandidateFromSt5));
     }
@@ -622,22 +680,22 @@ std::list<Track>::iterator TrackFinder::findTrackCandidates(int plane1, int plan
   for (auto& de1 : mClusters[plane1]) {
 
     // skip DE without cluster
-    if (de1.second == nullptr) {
+    if (de1.second.empty()) {
       continue;
     }
 
-    for (const auto& cluster1 : *de1.second) {
+    for (const auto& cluster1 : de1.second) {
 
       double z1 = cluster1.getZ();
 
       for (auto& de2 : mClusters[plane2]) {
 
         // skip DE without cluster
-        if (de2.second == nullptr) {
+        if (de2.second.empty()) {
           continue;
         }
 
-        for (const auto& cluster2 : *de2.second) {
+        for (const auto& cluster2 : de2.second) {
 
           // skip combinations of clusters already part of a track if requested
           if (skipUsedPairs && itTrack != mTracks.end() && areUsed(cluster1, cluster2, itFirstTrack, std::next(itTrack))) {
@@ -710,7 +768,7 @@ std::list<Track>::iterator TrackFinder::followTrackInOverlapDE(const std::list<T
   for (auto& de : mClusters[plane]) {
 
     // skip DE without cluster
-    if (de.second == nullptr) {
+    if (de.second.empty()) {
       continue;
     }
 
@@ -720,7 +778,7 @@ std::list<Track>::iterator TrackFinder::followTrackInOverlapDE(const std::list<T
     }
 
     // look for cluster candidate in this DE
-    for (const auto& cluster : *de.second) {
+    for (const auto& cluster : de.second) {
 
       // try to add the current cluster
       if (!isCompatible(currentParam, cluster, paramAtCluster)) {
@@ -745,7 +803,7 @@ std::list<Track>::iterator TrackFinder::followTrackInOverlapDE(const std::list<T
 //_________________________________________________________________________________________________
 std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::iterator& itTrack,
                                                              int chamber, int lastChamber, bool canSkip,
-                                                             std::unordered_map<int, std::unordered_set<uint32_t>>& excludedClusters)
+                                                             ExcludedClusters& excludedClusters)
 {
   /// Follow the track candidate pointed to by "itTrack" to the given "chamber"
   /// The tracking starts from the current parameters, which must have already been set
@@ -837,7 +895,7 @@ std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::i
 //_________________________________________________________________________________________________
 std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::iterator& itTrack,
                                                              int plane1, int plane2, int lastChamber,
-                                                             std::unordered_map<int, std::unordered_set<uint32_t>>& excludedClusters)
+                                                             ExcludedClusters& excludedClusters)
 {
   /// Follow the track candidate pointed to by "itTrack" to the (half)chamber formed by "plane1" and "plane2"
   /// The tracking starts from the current parameters, which must have already been set
@@ -888,23 +946,19 @@ std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::i
   TrackParam paramAtCluster1{};
   TrackParam currentParamAtCluster1{};
   TrackParam paramAtCluster2{};
-  std::unordered_map<int, std::unordered_set<uint32_t>> newExcludedClusters{};
+  ExcludedClusters newExcludedClusters{};
   for (auto& de1 : mClusters[plane1]) {
 
     // skip DE without cluster
-    if (de1.second == nullptr) {
+    if (de1.second.empty()) {
       continue;
     }
 
-    // get the list of excluded clusters for the DE
-    auto itExcludedClusters = excludedClusters.find(de1.first);
-    bool hasExcludedClusters = (itExcludedClusters != excludedClusters.end());
-
     // look for cluster candidate in this DE
-    for (const auto& cluster1 : *de1.second) {
+    for (const auto& cluster1 : de1.second) {
 
       // skip excluded clusters
-      if (hasExcludedClusters && itExcludedClusters->second.count(cluster1.getUniqueId()) > 0) {
+      if (isExcluded(excludedClusters, cluster1.getUniqueId())) {
         continue;
       }
 
@@ -914,7 +968,7 @@ std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::i
       }
 
       // add it to the list of excluded clusters for this candidate
-      excludedClusters[de1.first].emplace(cluster1.getUniqueId());
+      exclude(excludedClusters, cluster1.getUniqueId());
 
       // skip tracks out of limits, but after checking for overlaps
       bool isAcceptableAtCluster1 = isAcceptable(paramAtCluster1);
@@ -929,7 +983,7 @@ std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::i
       for (auto& de2 : mClusters[plane2]) {
 
         // skip DE without cluster
-        if (de2.second == nullptr) {
+        if (de2.second.empty()) {
           continue;
         }
 
@@ -939,7 +993,7 @@ std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::i
         }
 
         // look for cluster candidate in this DE
-        for (const auto& cluster2 : *de2.second) {
+        for (const auto& cluster2 : de2.second) {
 
           // try to add the current cluster
           if (!isCompatible(currentParamAtCluster1, cluster2, paramAtCluster2)) {
@@ -949,7 +1003,7 @@ std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::i
           cluster2Found = true;
 
           // add it to the list of excluded clusters for this candidate
-          excludedClusters[de2.first].emplace(cluster2.getUniqueId());
+          exclude(excludedClusters, cluster2.getUniqueId());
 
           // skip tracks out of limits
           if (!isAcceptableAtCluster1 || !isAcceptable(paramAtCluster2)) {
@@ -985,19 +1039,15 @@ std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::i
   for (auto& de2 : mClusters[plane2]) {
 
     // skip DE without cluster
-    if (de2.second == nullptr) {
+    if (de2.second.empty()) {
       continue;
     }
 
-    // get the list of excluded clusters for the DE
-    auto itExcludedClusters = excludedClusters.find(de2.first);
-    bool hasExcludedClusters = (itExcludedClusters != excludedClusters.end());
-
     // look for cluster candidate in this DE
-    for (const auto& cluster2 : *de2.second) {
+    for (const auto& cluster2 : de2.second) {
 
       // skip excluded clusters (in particular the ones already attached together with a cluster on plane1)
-      if (hasExcludedClusters && itExcludedClusters->second.count(cluster2.getUniqueId()) > 0) {
+      if (isExcluded(excludedClusters, cluster2.getUniqueId())) {
         continue;
       }
 
@@ -1007,7 +1057,7 @@ std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::i
       }
 
       // add it to the list of excluded clusters for this candidate
-      excludedClusters[de2.first].emplace(cluster2.getUniqueId());
+      exclude(excludedClusters, cluster2.getUniqueId());
 
       // skip tracks out of limits
       if (!isAcceptable(paramAtCluster2)) {
@@ -1036,7 +1086,7 @@ std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::i
 //_________________________________________________________________________________________________
 std::list<Track>::iterator TrackFinder::addClustersAndFollowTrack(std::list<Track>::iterator& itTrack, const TrackParam& paramAtCluster1,
                                                                   const TrackParam* paramAtCluster2, int nextChamber, int lastChamber,
-                                                                  std::unordered_map<int, std::unordered_set<uint32_t>>& excludedClusters)
+                                                                  ExcludedClusters& excludedClusters)
 {
   /// If "nextChamber" >= 0: continue the tracking of "itTrack" up to "lastChamber", attach the two clusters
   /// to every new tracks found and return an iterator to the first of them (or mTracks.end() if none is found)
@@ -1101,6 +1151,81 @@ std::list<Track>::iterator TrackFinder::addClustersAndFollowTrack(std::list<Trac
   return itFirstNewTrack;
 }
 
+//_________________________________________________________________________________________________
+void TrackFinder::followTrackCandidates()
+{
+  /// Track each candidate down to chamber 1 and replace it by the tracks found in the process
+  /// With several threads, the candidates are distributed among the worker track finders and the new tracks
+  /// are put back in the order of the candidates they come from, so the result does not depend on the
+  /// number of threads. The sequential processing is used in debug mode to keep the printout meaningful
+  /// The workers share the magnetic field map, whose evaluation uses per-thread scratch buffers
+
+  if (mWorkers.empty() || mDebugLevel > 0) {
+    for (auto itTrack = mTracks.begin(); itTrack != mTracks.end();) {
+      ExcludedClusters excludedClusters{};
+      followTrackInChamber(itTrack, 5, 0, false, excludedClusters);
+      print("findTracks: removing candidate at position #", getTrackIndex(itTrack));
+      itTrack = mTracks.erase(itTrack);
+    }
+    return;
+  }
+
+  // move every candidate in its own list, where it will be replaced by the tracks found from it
+  std::vector<std::list<Track>> tracks(mTracks.size());
+  for (auto& candidateTracks : tracks) {
+    candidateTracks.splice(candidateTracks.end(), mTracks, mTracks.begin());
+  }
+
+  for (auto& worker : mWorkers) {
+    worker->mTrackFitter.useChamberResolution();
+  }
+
+  std::exception_ptr error{};
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mWorkers.size())
+#endif
+  for (int iCandidate = 0; iCandidate < tracks.size(); ++iCandidate) {
+#ifdef WITH_OPENMP
+    auto& worker = *mWorkers[omp_get_thread_num()];
+#else
+    auto& worker = *mWorkers.front();
+#endif
+    try {
+      worker.followTrackCandidate(tracks[iCandidate]);
+    } catch (...) {
+#ifdef WITH_OPENMP
+#pragma omp critical
+#endif
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+
+  // put back the new tracks in the order of the candidates
+  for (auto& candidateTracks : tracks) {
+    mTracks.splice(mTracks.end(), candidateTracks);
+  }
+}
+
+//_________________________________________________________________________________________________
+void TrackFinder::followTrackCandidate(std::list<Track>& tracks)
+{
+  /// Track the candidate, which must be the only element of the list, down to chamber 1
+  /// and replace it by the tracks found in the process
+
+  mTracks.swap(tracks);
+  auto itTrack = mTracks.begin();
+  ExcludedClusters excludedClusters{};
+  followTrackInChamber(itTrack, 5, 0, false, excludedClusters);
+  mTracks.erase(itTrack);
+  mTracks.swap(tracks);
+}
+
 //_________________________________________________________________________________________________
 void TrackFinder::improveTracks()
 {
@@ -1455,7 +1580,7 @@ bool TrackFinder::areUsed(const Cluster& cl1, const Cluster& cl2, const std::lis
 
 //_________________________________________________________________________________________________
 void TrackFinder::excludeClustersFromIdenticalTracks(const std::list<Track>::iterator& itTrack,
-                                                     std::unordered_map<int, std::unordered_set<uint32_t>>& excludedClusters,
+                                                     ExcludedClusters& excludedClusters,
                                                      const std::list<Track>::iterator& itEndTrack)
 {
   /// Find tracks in the range [mTracks.begin(), itEndTrack[ that contain all the clusters of itTrack
@@ -1465,7 +1590,7 @@ void TrackFinder::excludeClustersFromIdenticalTracks(const std::list<Track>::ite
       for (auto itParam = itTrack2->rbegin(); itParam != itTrack2->rend(); ++itParam) {
         const Cluster* cluster = itParam->getClusterPtr();
         if (cluster->getChamberId() > 7) {
-          excludedClusters[cluster->getDEId()].emplace(cluster->getUniqueId());
+          exclude(excludedClusters, cluster->getUniqueId());
         } else {
           break;
         }
@@ -1475,15 +1600,32 @@ void TrackFinder::excludeClustersFromIdenticalTracks(const std::list<Track>::ite
 }
 
 //_________________________________________________________________________________________________
-void TrackFinder::moveClusters(std::unordered_map<int, std::unordered_set<uint32_t>>& source, std::unordered_map<int, std::unordered_set<uint32_t>>& destination)
+void TrackFinder::moveClusters(ExcludedClusters& source, ExcludedClusters& destination)
 {
   /// Move cluster Ids listed in source into destination then clear source
-  for (auto& sourceDE : source) {
-    destination[sourceDE.first].insert(sourceDE.second.begin(), sourceDE.second.end());
+  for (auto clusterId : source) {
+    exclude(destination, clusterId);
   }
   source.clear();
 }
 
+//_________________________________________________________________________________________________
+bool TrackFinder::isExcluded(const ExcludedClusters& excludedClusters, uint32_t clusterId)
+{
+  /// Return true if the cluster Id is listed in excludedClusters
+  /// The list is small enough for a linear search to be faster than any associative container
+  return std::find(excludedClusters.begin(), excludedClusters.end(), clusterId) != excludedClusters.end();
+}
+
+//_________________________________________________________________________________________________
+void TrackFinder::exclude(ExcludedClusters& excludedClusters, uint32_t clusterId)
+{
+  /// Add the cluster Id to the list of excluded clusters if not already there
+  if (!isExcluded(excludedClusters, clusterId)) {
+    excludedClusters.push_back(clusterId);
+  }
+}
+
 //_________________________________________________________________________________________________
 bool TrackFinder::isCompatible(const TrackParam& param, const Cluster& cluster, TrackParam& paramAtCluster)
 {
@@ -1661,8 +1803,14 @@ void TrackFinder::printStats() const
   /// print the timers
   LOG(INFO) << "number of candidates tracked = " << mNCandidates;
   TrackExtrap::printNCalls();
-  LOG(INFO) << "number of times tryOneClusterFast() is called = " << mNCallTryOneClusterFast;
-  LOG(INFO) << "number of times tryOneCluster() is called = " << mNCallTryOneCluster;
+  std::size_t nCallTryOneClusterFast(mNCallTryOneClusterFast);
+  std::size_t nCallTryOneCluster(mNCallTryOneCluster);
+  for (const auto& worker : mWorkers) {
+    nCallTryOneClusterFast += worker->mNCallTryOneClusterFast;
+    nCallTryOneCluster += worker->mNCallTryOneCluster;
+  }
+  LOG(INFO) << "number of times tryOneClusterFast() is called = " << nCallTryOneClusterFast;
+  LOG(INFO) << "number of times tryOneCluster() is called = " << nCallTryOneCluster;
 }
 
 //_________________________________________________________________________________________________
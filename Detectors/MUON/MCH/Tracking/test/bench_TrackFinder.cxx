@@ -0,0 +1,133 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file bench_TrackFinder.cxx
+/// \brief Benchmark of the MCH track finder as a function of the number of threads
+///
+/// The clusters are obtained by extrapolating random muon tracks from the vertex to each chamber
+/// in the magnetic field, to which uniformly distributed noise clusters are added
+
+#include "benchmark/benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <TMath.h>
+
+#include "MCHBase/ClusterBlock.h"
+#include "MCHTracking/TrackExtrap.h"
+#include "MCHTracking/TrackFinder.h"
+#include "MCHTracking/TrackParam.h"
+
+using namespace o2::mch;
+
+namespace
+{
+constexpr double ChamberZ[10] = {-526.16, -545.24, -676.4, -695.4, -967.5,
+                                 -998.5, -1276.5, -1307.5, -1406.6, -1437.6};
+
+/// return the ID of the DE containing the point (x, y) of the given chamber, roughly following the MCH layout
+int getDEId(int chamberId, double x, double y)
+{
+  if (chamberId < 4) {
+    int quadrant = (x > 0.) ? ((y > 0.) ? 0 : 3) : ((y > 0.) ? 1 : 2);
+    return 100 * (chamberId + 1) + quadrant;
+  }
+  int nDEs = (chamberId < 6) ? 18 : 26;
+  int iy = std::max(-nDEs / 4, std::min(nDEs / 4, static_cast<int>(std::round(y / 40.))));
+  int de = (x > 0.) ? ((iy >= 0) ? iy : nDEs + iy) : nDEs / 2 - iy;
+  return 100 * (chamberId + 1) + de;
+}
+
+/// generate the clusters of one event with nTracks muon tracks and nNoise noise clusters per chamber
+std::vector<ClusterStruct> generateClusters(int nTracks, int nNoise, std::mt19937& gen)
+{
+  std::uniform_real_distribution<double> theta(2. * TMath::DegToRad(), 9. * TMath::DegToRad());
+  std::uniform_real_distribution<double> phi(0., TMath::TwoPi());
+  std::uniform_real_distribution<double> p(5., 50.);
+  std::uniform_real_distribution<double> noise(-250., 250.);
+  std::normal_distribution<double> resolution(0., 0.02);
+
+  std::vector<ClusterStruct> clusters{};
+  std::vector<int> nClustersPerDE(1100, 0);
+  auto addCluster = [&clusters, &nClustersPerDE](int chamberId, double x, double y) {
+    int deId = getDEId(chamberId, x, y);
+    auto uid = ClusterStruct::buildUniqueId(chamberId, deId, nClustersPerDE[deId]++);
+    clusters.push_back({static_cast<float>(x), static_cast<float>(y), static_cast<float>(ChamberZ[chamberId]),
+                        0.2f, 0.2f, uid, 0, 0});
+  };
+
+  for (int iTrack = 0; iTrack < nTracks; ++iTrack) {
+    TrackParam param{};
+    double th = theta(gen);
+    double ph = phi(gen);
+    double slopeX = std::tan(th) * std::cos(ph);
+    double slopeY = std::tan(th) * std::sin(ph);
+    param.setZ(0.);
+    param.setNonBendingSlope(slopeX);
+    param.setBendingSlope(slopeY);
+    double pYZ = p(gen) * std::sqrt(1. + slopeY * slopeY) / std::sqrt(1. + slopeX * slopeX + slopeY * slopeY);
+    param.setInverseBendingMomentum(((iTrack % 2) ? 1. : -1.) / pYZ);
+    for (int iCh = 0; iCh < 10; ++iCh) {
+      if (!TrackExtrap::extrapToZ(&param, ChamberZ[iCh])) {
+        break;
+      }
+      addCluster(iCh, param.getNonBendingCoor() + resolution(gen), param.getBendingCoor() + resolution(gen));
+    }
+  }
+
+  for (int iCh = 0; iCh < 10; ++iCh) {
+    for (int i = 0; i < nNoise; ++i) {
+      addCluster(iCh, noise(gen), noise(gen));
+    }
+  }
+
+  return clusters;
+}
+} // namespace
+
+/// find the tracks of the same events with state.range(0) tracks each, using state.range(1) threads
+static void BM_TrackFinder(benchmark::State& state)
+{
+  TrackFinder trackFinder{};
+  trackFinder.setNThreads(state.range(1));
+  trackFinder.init(-30000., -6000.);
+
+  std::mt19937 gen(12345);
+  std::vector<std::vector<ClusterStruct>> events{};
+  for (int i = 0; i < 10; ++i) {
+    events.emplace_back(generateClusters(state.range(0), 10, gen));
+  }
+
+  double nTracks = 0.;
+  for (auto _ : state) {
+    for (const auto& clusters : events) {
+      nTracks += trackFinder.findTracks(clusters).size();
+    }
+  }
+  state.counters["tracks/event"] = nTracks / (state.iterations() * events.size());
+  state.SetItemsProcessed(state.iterations() * events.size());
+}
+
+static void CustomArguments(benchmark::internal::Benchmark* bench)
+{
+  for (int nTracks : {5, 20, 50}) {
+    for (int nThreads : {1, 2, 4, 8}) {
+      bench->Args({nTracks, nThreads});
+    }
+  }
+}
+
+BENCHMARK(BM_TrackFinder)->Apply(CustomArguments)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
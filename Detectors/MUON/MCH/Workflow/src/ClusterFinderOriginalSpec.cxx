@@ -18,11 +18,18 @@
 
 #include <iostream>
 #include <fstream>
+#include <algorithm>
 #include <chrono>
 #include <vector>
+#include <memory>
+#include <exception>
 #include <stdexcept>
 #include <string>
 
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
 #include <gsl/span>
 
 #include "Framework/CallbackService.h"
@@ -63,12 +70,29 @@ class ClusterFinderOriginalTask
       o2::conf::ConfigurableParam::updateFromFile(config, "MCHClustering", true);
     }
     bool run2Config = ic.options().get<bool>("run2-config");
-    mClusterFinder.init(run2Config);
+    int nThreads = std::max(1, ic.options().get<int>("nthreads"));
+#ifndef WITH_OPENMP
+    if (nThreads > 1) {
+      LOG(WARNING) << "OpenMP is not available, the clustering will run in 1 thread";
+      nThreads = 1;
+    }
+#endif
+    // one cluster finder per thread, each of them with its own random generator when running in parallel
+    for (int i = 0; i < nThreads; ++i) {
+      mClusterFinders.emplace_back(std::make_unique<ClusterFinderOriginal>());
+      mClusterFinders.back()->init(run2Config);
+      if (nThreads > 1) {
+        mClusterFinders.back()->setRandomSeed(i + 1);
+      }
+    }
+    LOG(INFO) << "clustering will run in " << nThreads << " thread(s)";
 
     /// Print the timer and clear the clusterizer when the processing is over
     ic.services().get<CallbackService>().set(CallbackService::Id::Stop, [this]() {
       LOG(INFO) << "cluster finder duration = " << mTimeClusterFinder.count() << " s";
-      this->mClusterFinder.deinit();
+      for (auto& clusterFinder : this->mClusterFinders) {
+        clusterFinder->deinit();
+      }
     });
   }
 
@@ -96,20 +120,113 @@ class ClusterFinderOriginalTask
 
       // clusterize every preclusters
       auto tStart = std::chrono::high_resolution_clock::now();
-      mClusterFinder.reset();
-      for (const auto& preCluster : preClusters.subspan(preClusterROF.getFirstIdx(), preClusterROF.getNEntries())) {
-        mClusterFinder.findClusters(digits.subspan(preCluster.firstDigit, preCluster.nDigits));
+      auto preClustersInROF = preClusters.subspan(preClusterROF.getFirstIdx(), preClusterROF.getNEntries());
+      if (mClusterFinders.size() == 1) {
+        auto& clusterFinder = *mClusterFinders.front();
+        clusterFinder.reset();
+        for (const auto& preCluster : preClustersInROF) {
+          clusterFinder.findClusters(digits.subspan(preCluster.firstDigit, preCluster.nDigits));
+        }
+      } else {
+        findClustersParallel(preClustersInROF, digits);
       }
       auto tEnd = std::chrono::high_resolution_clock::now();
       mTimeClusterFinder += tEnd - tStart;
 
       // fill the ouput messages
-      clusterROFs.emplace_back(preClusterROF.getBCData(), clusters.size(), mClusterFinder.getClusters().size());
-      writeClusters(clusters, usedDigits);
+      auto firstClusterIdx = clusters.size();
+      if (mClusterFinders.size() == 1) {
+        writeClusters(clusters, usedDigits);
+      } else {
+        writeClustersParallel(clusters, usedDigits);
+      }
+      clusterROFs.emplace_back(preClusterROF.getBCData(), firstClusterIdx, clusters.size() - firstClusterIdx);
     }
   }
 
  private:
+  //_________________________________________________________________________________________________
+  /// location of the clusters and associated digits reconstructed from one precluster by one of the cluster finders
+  struct PreClusterResult {
+    int clusterFinder = 0; ///< index of the cluster finder
+    int firstCluster = 0;  ///< index of the first cluster in the list of this cluster finder
+    int nClusters = 0;     ///< number of clusters
+    int firstDigit = 0;    ///< index of the first associated digit in the list of this cluster finder
+    int nDigits = 0;       ///< number of associated digits
+  };
+
+  //_________________________________________________________________________________________________
+  void findClustersParallel(gsl::span<const PreCluster> preClusters, gsl::span<const Digit> digits)
+  {
+    /// clusterize the preclusters of the current event in parallel, using one cluster finder per thread,
+    /// and keep track of where the results of every precluster are stored
+
+    for (auto& clusterFinder : mClusterFinders) {
+      clusterFinder->reset();
+    }
+    mPreClusterResults.assign(preClusters.size(), PreClusterResult{});
+    std::exception_ptr error{};
+
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mClusterFinders.size())
+#endif
+    for (int iPreCluster = 0; iPreCluster < preClusters.size(); ++iPreCluster) {
+#ifdef WITH_OPENMP
+      int iThread = omp_get_thread_num();
+#else
+      int iThread = 0;
+#endif
+      auto& clusterFinder = *mClusterFinders[iThread];
+      auto& result = mPreClusterResults[iPreCluster];
+      result.clusterFinder = iThread;
+      result.firstCluster = clusterFinder.getClusters().size();
+      result.firstDigit = clusterFinder.getUsedDigits().size();
+      try {
+        const auto& preCluster = preClusters[iPreCluster];
+        clusterFinder.findClusters(digits.subspan(preCluster.firstDigit, preCluster.nDigits));
+      } catch (...) {
+#ifdef WITH_OPENMP
+#pragma omp critical
+#endif
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+      result.nClusters = clusterFinder.getClusters().size() - result.firstCluster;
+      result.nDigits = clusterFinder.getUsedDigits().size() - result.firstDigit;
+    }
+
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  //_________________________________________________________________________________________________
+  void writeClustersParallel(std::vector<ClusterStruct, o2::pmr::polymorphic_allocator<ClusterStruct>>& clusters,
+                             std::vector<Digit, o2::pmr::polymorphic_allocator<Digit>>& usedDigits) const
+  {
+    /// fill the output messages with clusters and attached digits of the current event, in the order of the preclusters
+    /// modify the references to the attached digits according to their position in the global vector and
+    /// the cluster indices in their unique IDs according to their position in the event, as in sequential processing
+
+    auto clusterOffset = clusters.size();
+    for (const auto& result : mPreClusterResults) {
+
+      const auto& clusterFinder = *mClusterFinders[result.clusterFinder];
+      auto itFirstCluster = clusterFinder.getClusters().begin() + result.firstCluster;
+      auto itFirstDigit = clusterFinder.getUsedDigits().begin() + result.firstDigit;
+      auto digitOffset = usedDigits.size();
+
+      for (auto itCluster = itFirstCluster; itCluster < itFirstCluster + result.nClusters; ++itCluster) {
+        auto& cluster = clusters.emplace_back(*itCluster);
+        cluster.uid = ClusterStruct::buildUniqueId(cluster.getChamberId(), cluster.getDEId(), clusters.size() - 1 - clusterOffset);
+        cluster.firstDigit = cluster.firstDigit - result.firstDigit + digitOffset;
+      }
+
+      usedDigits.insert(usedDigits.end(), itFirstDigit, itFirstDigit + result.nDigits);
+    }
+  }
+
   //_________________________________________________________________________________________________
   void writeClusters(std::vector<ClusterStruct, o2::pmr::polymorphic_allocator<ClusterStruct>>& clusters,
                      std::vector<Digit, o2::pmr::polymorphic_allocator<Digit>>& usedDigits) const
@@ -117,18 +234,21 @@ class ClusterFinderOriginalTask
     /// fill the output messages with clusters and attached digits of the current event
     /// modify the references to the attached digits according to their position in the global vector
 
+    const auto& clusterFinder = *mClusterFinders.front();
+
     auto clusterOffset = clusters.size();
-    clusters.insert(clusters.end(), mClusterFinder.getClusters().begin(), mClusterFinder.getClusters().end());
+    clusters.insert(clusters.end(), clusterFinder.getClusters().begin(), clusterFinder.getClusters().end());
 
     auto digitOffset = usedDigits.size();
-    usedDigits.insert(usedDigits.end(), mClusterFinder.getUsedDigits().begin(), mClusterFinder.getUsedDigits().end());
+    usedDigits.insert(usedDigits.end(), clusterFinder.getUsedDigits().begin(), clusterFinder.getUsedDigits().end());
 
     for (auto itCluster = clusters.begin() + clusterOffset; itCluster < clusters.end(); ++itCluster) {
       itCluster->firstDigit += digitOffset;
     }
   }
 
-  ClusterFinderOriginal mClusterFinder{};             ///< clusterizer
+  std::vector<std::unique_ptr<ClusterFinderOriginal>> mClusterFinders{}; ///< clusterizers (one per thread)
+  std::vector<PreClusterResult> mPreClusterResults{};                    ///< results of every precluster of the current event
   std::chrono::duration<double> mTimeClusterFinder{}; ///< timer
 };
 
@@ -145,7 +265,8 @@ o2::framework::DataProcessorSpec getClusterFinderOriginalSpec()
             OutputSpec{{"clusterdigits"}, "MCH", "CLUSTERDIGITS", 0, Lifetime::Timeframe}},
     AlgorithmSpec{adaptFromTask<ClusterFinderOriginalTask>()},
     Options{{"config", VariantType::String, "", {"JSON or INI file with clustering parameters"}},
-            {"run2-config", VariantType::Bool, false, {"setup for run2 data"}}}};
+            {"run2-config", VariantType::Bool, false, {"setup for run2 data"}},
+            {"nthreads", VariantType::Int, 1, {"number of threads used to clusterize the preclusters of each event in parallel"}}}};
 }
 
 } // end namespace mch
@@ -17,7 +17,6 @@
 #include "TrackFinderSpec.h"
 
 #include <chrono>
-#include <unordered_map>
 #include <list>
 #include <stdexcept>
 #include <string>
@@ -83,6 +82,7 @@ class TrackFinderTask
     if (!config.empty()) {
       o2::conf::ConfigurableParam::updateFromFile(config, "MCHTracking", true);
     }
+    mTrackFinder.setNThreads(ic.options().get<int>("nthreads"));
     mTrackFinder.init(l3Current, dipoleCurrent);
 
     auto debugLevel = ic.options().get<int>("debug");
@@ -117,15 +117,9 @@ class TrackFinderTask
 
       //LOG(INFO) << "processing interaction: " << clusterROF.getBCData() << "...";
 
-      // get the input clusters of the current event
-      std::unordered_map<int, std::list<Cluster>> clusters{};
-      for (const auto& cluster : clustersIn.subspan(clusterROF.getFirstIdx(), clusterROF.getNEntries())) {
-        clusters[cluster.getDEId()].emplace_back(cluster);
-      }
-
-      // run the track finder
+      // run the track finder on the input clusters of the current event
       auto tStart = std::chrono::high_resolution_clock::now();
-      const auto& tracks = mTrackFinder.findTracks(clusters);
+      const auto& tracks = mTrackFinder.findTracks(clustersIn.subspan(clusterROF.getFirstIdx(), clusterROF.getNEntries()));
       auto tEnd = std::chrono::high_resolution_clock::now();
       mElapsedTime += tEnd - tStart;
 
@@ -174,7 +168,8 @@ o2::framework::DataProcessorSpec getTrackFinderSpec()
             {"dipoleCurrent", VariantType::Float, -6000.0f, {"Dipole current"}},
             {"grp-file", VariantType::String, o2::base::NameConf::getGRPFileName(), {"Name of the grp file"}},
             {"config", VariantType::String, "", {"JSON or INI file with tracking parameters"}},
-            {"debug", VariantType::Int, 0, {"debug level"}}}};
+            {"debug", VariantType::Int, 0, {"debug level"}},
+            {"nthreads", VariantType::Int, 1, {"number of threads used to follow the track candidates"}}}};
 }
 
 } // namespace mch
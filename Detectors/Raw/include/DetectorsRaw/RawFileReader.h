@@ -48,6 +48,9 @@ struct ReaderInp {
   uint32_t maxTF = 0xffffffff;
   bool partPerSP = true;
   bool cache = false;
+  bool mapFiles = false;
+  int nThreads = 1;
+  int prefetchTF = 0;
   bool autodetectTF0 = false;
   bool preferCalcTF = false;
 };
@@ -202,6 +205,7 @@ class RawFileReader
     size_t readNextHBF(char* buff);
     size_t readNextTF(char* buff);
     size_t readNextSuperPage(char* buff, const PartStat* pstat = nullptr);
+    const char* mapNextSuperPage(size_t& sz, const PartStat* pstat = nullptr);
     size_t skipNextHBF();
     size_t skipNextTF();
 
@@ -210,6 +214,9 @@ class RawFileReader
     std::string describe() const;
 
    private:
+    size_t getNextSuperPageRange(int& iblEnd, const PartStat* pstat) const;
+    bool readBlock(char* buff, size_t offset, size_t sz, int fileID) const;
+
     RawFileReader* reader = nullptr; //!
   };
 
@@ -264,6 +271,12 @@ class RawFileReader
   bool getCacheData() const { return mCacheData; }
   void setCacheData(bool v) { mCacheData = v; }
 
+  /// memory-map input files after preprocessing: reading of different links becomes thread-safe
+  /// and the super-pages can be accessed in place via LinkData::mapNextSuperPage
+  bool getMapFiles() const { return mMapFiles; }
+  void setMapFiles(bool v) { mMapFiles = v; }
+  bool isMapped(int fileID) const { return fileID < int(mMappedFiles.size()) && mMappedFiles[fileID].first != nullptr; }
+
   o2::header::DataOrigin getDefaultDataOrigin() const { return mDefDataOrigin; }
   o2::header::DataDescription getDefaultDataSpecification() const { return mDefDataDescription; }
   ReadoutCardType getDefaultReadoutCardType() const { return mDefCardType; }
@@ -284,6 +297,8 @@ class RawFileReader
  private:
   int getLinkLocalID(const RDHAny& rdh, int fileID);
   bool preprocessFile(int ifl);
+  void mapFiles();
+  void unmapFiles();
   static LinkSpec_t createSpec(o2::header::DataOrigin orig, LinkSubSpec_t ss) { return (LinkSpec_t(orig) << 32) | ss; }
 
   static constexpr o2::header::DataOrigin DEFDataOrigin = o2::header::gDataOriginFLP;
@@ -295,6 +310,7 @@ class RawFileReader
   std::vector<std::string> mFileNames;                                  //! input file names
   std::vector<FILE*> mFiles;                                            //! input file handlers
   std::vector<std::unique_ptr<char[]>> mFileBuffers;                    //! buffers for input files
+  std::vector<std::pair<char*, size_t>> mMappedFiles;                   //! memory-mapped input files
   std::vector<OrigDescCard> mDataSpecs;                                 //! data origin and description for every input file + readout card type
   bool mInitDone = false;
   bool mEmpty = true;
@@ -312,6 +328,7 @@ class RawFileReader
   long int mPosInFile = 0;                                          //! current position in the file
   bool mMultiLinkFile = false;                                      //! was > than 1 link seen in the file?
   bool mCacheData = false;                                          //! cache data to block after 1st scan (may require excessive memory, use with care)
+  bool mMapFiles = false;                                           //! memory-map input files after preprocessing
   uint32_t mCheckErrors = 0;                                        //! mask for errors to check
   FirstTFDetection mFirstTFAutodetect = FirstTFDetection::Disabled; //!
   bool mPreferCalculatedTFStart = false;                            //! prefer TFstart calculated via HBFUtils
@@ -24,6 +24,8 @@
 #include <string_view>
 #include <functional>
 #include <mutex>
+#include <thread>
+#include <memory>
 
 #include <Rtypes.h>
 #include <TTree.h>
@@ -33,6 +35,7 @@
 #include "Headers/DAQID.h"
 #include "DetectorsRaw/HBFUtils.h"
 #include "DetectorsRaw/RDHUtils.h"
+#include "CommonUtils/BoundedQueue.h"
 
 namespace o2
 {
@@ -68,6 +71,12 @@ class RawFileWriter
     void write(const char* data, size_t size);
   };
   ///=====================================================================================
+  /// superpage waiting to be written by the asynchronous writer thread
+  struct PendingPage {
+    OutputFile* file = nullptr;
+    std::vector<char> data;
+  };
+  ///=====================================================================================
   struct PayloadCache {
     bool preformatted = false;
     uint32_t trigger = 0;
@@ -173,6 +182,8 @@ class RawFileWriter
   }
   ~RawFileWriter();
   void useCaching();
+  void useAsyncWriting(size_t maxPendingPages = 16);
+  bool isAsyncWriting() const { return mWriteQueue != nullptr; }
   void doLazinessCheck(bool v) { mDoLazinessCheck = v; }
   void writeConfFile(std::string_view origin = "FLP", std::string_view description = "RAWDATA", std::string_view cfgname = "raw.cfg", bool fullPath = true) const;
   void close();
@@ -386,6 +397,9 @@ class RawFileWriter
 
  private:
   void fillFromCache();
+  void stopAsyncWriting();
+  void queuePage(OutputFile& file, std::vector<char>& buffer, size_t size);
+  std::vector<char> getFreePage();
 
   enum RoMode_t { NotSet,
                   Continuous,
@@ -418,6 +432,14 @@ class RawFileWriter
   std::map<IR, CacheEntry> mCacheMap;
   //<< caching -------------
 
+  //>> asynchronous writing --------------
+  std::mutex mAddDataMtx;                                            //! protects the writer-level part of addData
+  std::unique_ptr<o2::utils::BoundedQueue<PendingPage>> mWriteQueue; //! superpages to be written
+  std::thread mWriterThread;                                         //! thread writing the queued superpages
+  std::mutex mFreePagesMtx;                                          //!
+  std::vector<std::vector<char>> mFreePages;                         //! recycled superpage buffers
+  //<< asynchronous writing -------------
+
   TStopwatch mTimer;
   RoMode_t mROMode = NotSet;
   IR mFirstIRAdded; // 1st IR seen
@@ -14,6 +14,7 @@
 /// @brief  Reader for (multiple) raw data files
 
 #include <algorithm>
+#include <cerrno>
 #include <cstring>
 #include <iostream>
 #include <iomanip>
@@ -30,6 +31,9 @@
 #include <Common/Configuration.h>
 #include <TStopwatch.h>
 #include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 using namespace o2::raw;
 namespace o2h = o2::header;
@@ -134,8 +138,7 @@ size_t RawFileReader::LinkData::readNextHBF(char* buff)
     if (blc.dataCache) {
       memcpy(buff + sz, blc.dataCache.get(), blc.size);
     } else {
-      auto fl = reader->mFiles[blc.fileID];
-      if (fseek(fl, blc.offset, SEEK_SET) || fread(buff + sz, 1, blc.size, fl) != blc.size) {
+      if (!readBlock(buff + sz, blc.offset, blc.size, blc.fileID)) {
         LOGF(ERROR, "Failed to read for the %s a bloc:", describe());
         blc.print();
         error = true;
@@ -258,16 +261,11 @@ int RawFileReader::LinkData::getNHBFinTF() const
 }
 
 //____________________________________________
-size_t RawFileReader::LinkData::readNextSuperPage(char* buff, const RawFileReader::PartStat* pstat)
+size_t RawFileReader::LinkData::getNextSuperPageRange(int& iblEnd, const RawFileReader::PartStat* pstat) const
 {
-  // read data of the next complete HB, buffer of getNextHBFSize() must be allocated in advance
+  // size of the next superpage, iblEnd is set to the 1st block after it
   size_t sz = 0;
-  if (nextBlock2Read < 0) { // negative nextBlock2Read signals absence of data
-    return sz;
-  }
   int ibl = nextBlock2Read, nbl = blocks.size();
-  auto tfID = blocks[nextBlock2Read].tfID;
-  bool error = false;
   if (pstat) { // info is provided, use it derictly
     sz = pstat->size;
     ibl += pstat->nBlocks;
@@ -284,12 +282,26 @@ size_t RawFileReader::LinkData::readNextSuperPage(char* buff, const RawFileReade
       sz += blc.size;
     }
   }
+  iblEnd = ibl;
+  return sz;
+}
+
+//____________________________________________
+size_t RawFileReader::LinkData::readNextSuperPage(char* buff, const RawFileReader::PartStat* pstat)
+{
+  // read data of the next complete HB, buffer of getNextHBFSize() must be allocated in advance
+  size_t sz = 0;
+  if (nextBlock2Read < 0) { // negative nextBlock2Read signals absence of data
+    return sz;
+  }
+  int ibl = nextBlock2Read;
+  bool error = false;
+  sz = getNextSuperPageRange(ibl, pstat);
   if (sz) {
     if (reader->mCacheData && blocks[nextBlock2Read].dataCache) {
       memcpy(buff, blocks[nextBlock2Read].dataCache.get(), sz);
     } else {
-      auto fl = reader->mFiles[blocks[nextBlock2Read].fileID];
-      if (fseek(fl, blocks[nextBlock2Read].offset, SEEK_SET) || fread(buff, 1, sz, fl) != sz) {
+      if (!readBlock(buff, blocks[nextBlock2Read].offset, sz, blocks[nextBlock2Read].fileID)) {
         LOGF(ERROR, "Failed to read for the %s a bloc:", describe());
         blocks[nextBlock2Read].print();
         error = true;
@@ -303,6 +315,58 @@ size_t RawFileReader::LinkData::readNextSuperPage(char* buff, const RawFileReade
   return error ? 0 : sz; // in case of the error we ignore the data
 }
 
+//____________________________________________
+const char* RawFileReader::LinkData::mapNextSuperPage(size_t& sz, const RawFileReader::PartStat* pstat)
+{
+  // provide pointer on the next superpage in the mapped file (or in the cache) w/o copying it, sz is set to its size
+  sz = 0;
+  if (nextBlock2Read < 0) { // negative nextBlock2Read signals absence of data
+    return nullptr;
+  }
+  const auto& blc = blocks[nextBlock2Read];
+  const char* ptr = nullptr;
+  if (reader->mCacheData && blc.dataCache) {
+    ptr = blc.dataCache.get();
+  } else if (reader->isMapped(blc.fileID)) {
+    ptr = reader->mMappedFiles[blc.fileID].first + blc.offset;
+  } else {
+    return nullptr; // the data must be read
+  }
+  int ibl = nextBlock2Read;
+  sz = getNextSuperPageRange(ibl, pstat);
+  nextBlock2Read = ibl;
+  return ptr;
+}
+
+//____________________________________________
+bool RawFileReader::LinkData::readBlock(char* buff, size_t offset, size_t sz, int fileID) const
+{
+  // read contiguous piece of data from the file. This is thread-safe: the mapped file is copied, otherwise pread is used
+  // on the descriptor of the shared FILE*, since it does not move the file position as fseek + fread would
+  if (reader->isMapped(fileID)) {
+    const auto& mf = reader->mMappedFiles[fileID];
+    if (offset + sz > mf.second) {
+      return false;
+    }
+    memcpy(buff, mf.first + offset, sz);
+    return true;
+  }
+  int fd = fileno(reader->mFiles[fileID]);
+  while (sz) {
+    auto nr = pread(fd, buff, sz, offset);
+    if (nr < 0 && errno == EINTR) {
+      continue;
+    }
+    if (nr <= 0) {
+      return false;
+    }
+    buff += nr;
+    offset += nr;
+    sz -= nr;
+  }
+  return true;
+}
+
 //____________________________________________
 size_t RawFileReader::LinkData::getLargestSuperPage() const
 {
@@ -636,6 +700,7 @@ void RawFileReader::printStat(bool verbose) const
 //_____________________________________________________________________
 void RawFileReader::clear()
 {
+  unmapFiles();
   mLinkEntries.clear();
   mOrderedIDs.clear();
   mLinksData.clear();
@@ -756,11 +821,47 @@ bool RawFileReader::init()
   if (!mCheckErrors) {
     LOGF(INFO, "Detailed data format check was disabled");
   }
+  if (mMapFiles) {
+    mapFiles();
+  }
   mInitDone = true;
 
   return !mEmpty;
 }
 
+//_____________________________________________________________________
+void RawFileReader::mapFiles()
+{
+  // map input files to memory, on failure the file will be read via its FILE handler
+  mMappedFiles.resize(mFiles.size(), {nullptr, 0});
+  for (int i = 0; i < int(mFiles.size()); i++) {
+    int fd = fileno(mFiles[i]);
+    struct stat st;
+    if (fstat(fd, &st) || st.st_size == 0) {
+      LOGF(WARNING, "Failed to get size of %s, will not map it", mFileNames[i]);
+      continue;
+    }
+    void* ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED) {
+      LOGF(WARNING, "Failed to map %s, will read it via file handler", mFileNames[i]);
+      continue;
+    }
+    madvise(ptr, st.st_size, MADV_SEQUENTIAL);
+    mMappedFiles[i] = {reinterpret_cast<char*>(ptr), size_t(st.st_size)};
+  }
+}
+
+//_____________________________________________________________________
+void RawFileReader::unmapFiles()
+{
+  for (auto& mf : mMappedFiles) {
+    if (mf.first) {
+      munmap(mf.first, mf.second);
+    }
+  }
+  mMappedFiles.clear();
+}
+
 //_____________________________________________________________________
 o2h::DataOrigin RawFileReader::getDataOrigin(const std::string& ors)
 {
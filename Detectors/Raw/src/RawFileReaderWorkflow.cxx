@@ -26,6 +26,7 @@
 #include "DetectorsCommonDataFormats/DetID.h"
 #include "Headers/DataHeader.h"
 #include "Headers/Stack.h"
+#include "CommonUtils/BoundedQueue.h"
 
 #include "RawFileReaderWorkflow.h" // not installed
 #include <TStopwatch.h>
@@ -38,6 +39,8 @@
 #include <string>
 #include <climits>
 #include <regex>
+#include <thread>
+#include <exception>
 
 using namespace o2::raw;
 
@@ -54,6 +57,7 @@ class RawReaderSpecs : public o2f::Task
     std::uint32_t mRunNumber = 0;
   };
   explicit RawReaderSpecs(const ReaderInp& rinp);
+  ~RawReaderSpecs() override { stopPrefetchThread(); }
   void init(o2f::InitContext& ic) final;
   void run(o2f::ProcessingContext& ctx) final;
 
@@ -66,7 +70,25 @@ class RawReaderSpecs : public o2f::Task
   }
 
  private:
+  struct TFParts { // all messages of the TF, ready to be sent
+    uint32_t tfCounter = 0;
+    uint32_t tfID = 0;
+    size_t size = 0;
+    size_t nParts = 0;
+    std::unordered_map<std::string, std::unique_ptr<FairMQParts>> messagesPerRoute;
+  };
+  struct LinkParts { // messages of single link for the TF
+    std::string channel;
+    uint32_t firstOrbit = 0;
+    std::vector<FairMQMessagePtr> messages; // header and payload pairs
+  };
+
   void processDropTF(const std::string& drops);
+  std::string findOutputChannel(const o2h::DataHeader& h) const;
+  bool assembleTF(TFParts& tf, FairMQDevice* device);
+  void readLinkTF(int il, uint32_t tfID, FairMQDevice* device, LinkParts& lp);
+  void startPrefetchThread(FairMQDevice* device);
+  void stopPrefetchThread();
 
   int mLoop = 0;                  // once last TF reached, loop while mLoop>=0
   uint32_t mTFCounter = 0;        // TFId accumulator (accounts for looping)
@@ -76,10 +98,16 @@ class RawReaderSpecs : public o2f::Task
   size_t mLoopsDone = 0;
   size_t mSentSize = 0;
   size_t mSentMessages = 0;
+  int mNThreads = 1;                                               // number of threads to read the links of the TF
+  int mPrefetchTF = 0;                                             // if > 0, assemble TFs in the dedicated thread, at most this number ahead
   bool mPartPerSP = true;                                          // fill part per superpage
   std::string mRawChannelName = "";                                // name of optional non-DPL channel
   std::unique_ptr<o2::raw::RawFileReader> mReader;                 // matching engine
   std::unordered_map<std::string, std::pair<int, int>> mDropTFMap; // allows to drop certain fraction of TFs
+  std::vector<o2f::OutputRoute> mOutputRoutes;                     // DPL output routes
+  std::unique_ptr<o2::utils::BoundedQueue<TFParts>> mQueue;        // TFs assembled by the prefetching thread
+  std::thread mPrefetchThread;
+  std::exception_ptr mPrefetchError;
   enum TimerIDs { TimerInit,
                   TimerTotal,
                   TimerIO,
@@ -96,10 +124,26 @@ RawReaderSpecs::RawReaderSpecs(const ReaderInp& rinp)
   mReader->setMaxTFToRead(rinp.maxTF);
   mReader->setNominalSPageSize(rinp.spSize);
   mReader->setCacheData(rinp.cache);
+  mReader->setMapFiles(rinp.mapFiles);
   mReader->setTFAutodetect(rinp.autodetectTF0 ? RawFileReader::FirstTFDetection::Pending : RawFileReader::FirstTFDetection::Disabled);
   mReader->setPreferCalculatedTFStart(rinp.preferCalcTF);
+  mNThreads = rinp.nThreads > 1 ? rinp.nThreads : 1;
+  if (mNThreads > 1 && !rinp.mapFiles) {
+    LOG(WARNING) << "Parallel reading of links requires mapping of input files, will use single thread";
+    mNThreads = 1;
+  }
+#ifndef WITH_OPENMP
+  mNThreads = 1;
+#endif
+  mPrefetchTF = rinp.prefetchTF;
   LOG(INFO) << "Will preprocess files with buffer size of " << rinp.bufferSize << " bytes";
   LOG(INFO) << "Number of loops over whole data requested: " << mLoop;
+  if (rinp.mapFiles) {
+    LOG(INFO) << "Input files will be memory-mapped, links read by " << mNThreads << " threads";
+  }
+  if (mPrefetchTF > 0) {
+    LOG(INFO) << "TFs will be assembled in the background, at most " << mPrefetchTF << " TFs ahead";
+  }
   for (int i = NTimers; i--;) {
     mTimer[i].Stop();
     mTimer[i].Reset();
@@ -148,6 +192,25 @@ void RawReaderSpecs::init(o2f::InitContext& ic)
   if (mMaxTFID >= mReader->getNTimeFrames()) {
     mMaxTFID = mReader->getNTimeFrames() ? mReader->getNTimeFrames() - 1 : 0;
   }
+  mOutputRoutes = ic.services().get<o2f::RawDeviceService>().spec().outputs;
+}
+
+//___________________________________________________________
+std::string RawReaderSpecs::findOutputChannel(const o2h::DataHeader& h) const
+{
+  if (!mRawChannelName.empty()) {
+    return std::string{mRawChannelName};
+  } else {
+    for (auto& oroute : mOutputRoutes) {
+      LOG(DEBUG) << "comparing with matcher to route " << oroute.matcher << " TSlice:" << oroute.timeslice;
+      if (o2f::DataSpecUtils::match(oroute.matcher, h.dataOrigin, h.dataDescription, h.subSpecification) && ((h.tfCounter % oroute.maxTimeslices) == oroute.timeslice)) {
+        LOG(DEBUG) << "picking the route:" << o2f::DataSpecUtils::describe(oroute.matcher) << " channel " << oroute.channel;
+        return std::string{oroute.channel};
+      }
+    }
+  }
+  LOGP(ERROR, "Failed to find output channel for {}/{}/{} @ timeslice {}", h.dataOrigin.str, h.dataDescription.str, h.subSpecification, h.tfCounter);
+  return std::string{};
 }
 
 //___________________________________________________________
@@ -159,35 +222,63 @@ void RawReaderSpecs::run(o2f::ProcessingContext& ctx)
   auto device = ctx.services().get<o2f::RawDeviceService>().device();
   assert(device);
 
-  auto findOutputChannel = [&ctx, this](o2h::DataHeader& h) {
-    if (!this->mRawChannelName.empty()) {
-      return std::string{this->mRawChannelName};
-    } else {
-      auto outputRoutes = ctx.services().get<o2f::RawDeviceService>().spec().outputs;
-      for (auto& oroute : outputRoutes) {
-        LOG(DEBUG) << "comparing with matcher to route " << oroute.matcher << " TSlice:" << oroute.timeslice;
-        if (o2f::DataSpecUtils::match(oroute.matcher, h.dataOrigin, h.dataDescription, h.subSpecification) && ((h.tfCounter % oroute.maxTimeslices) == oroute.timeslice)) {
-          LOG(DEBUG) << "picking the route:" << o2f::DataSpecUtils::describe(oroute.matcher) << " channel " << oroute.channel;
-          return std::string{oroute.channel};
-        }
+  TFParts tf;
+  bool haveTF = false;
+  if (mPrefetchTF > 0) {
+    if (!mQueue) {
+      startPrefetchThread(device);
+    }
+    haveTF = mQueue->pop(tf);
+    if (!haveTF) {
+      stopPrefetchThread();
+      if (mPrefetchError) {
+        std::rethrow_exception(mPrefetchError);
       }
     }
-    LOGP(ERROR, "Failed to find output channel for {}/{}/{} @ timeslice {}", h.dataOrigin.str, h.dataDescription.str, h.subSpecification, h.tfCounter);
-    return std::string{};
-  };
+  } else {
+    haveTF = assembleTF(tf, device);
+  }
 
-  size_t tfNParts = 0, tfSize = 0;
-  std::unordered_map<std::string, std::unique_ptr<FairMQParts>> messagesPerRoute;
+  if (!haveTF) {
+    mTimer[TimerTotal].Stop();
+    LOGF(INFO, "Finished: payload of %zu bytes in %zu messages sent for %d TFs", mSentSize, mSentMessages, mTFCounter);
+    for (int i = 0; i < NTimers; i++) {
+      LOGF(INFO, "Timing for %15s: Cpu: %.3e Real: %.3e s in %d slots", TimerName[i], mTimer[i].CpuTime(), mTimer[i].RealTime(), mTimer[i].Counter() - 1);
+    }
+    ctx.services().get<o2f::ControlService>().endOfStream();
+    ctx.services().get<o2f::ControlService>().readyToQuit(o2f::QuitRequest::Me);
+    return;
+  }
 
-  auto addPart = [&messagesPerRoute, &tfNParts, &tfSize](FairMQMessagePtr hd, FairMQMessagePtr pl, const std::string& fairMQChannel) {
+  if (tf.tfCounter) { // delay sending
+    usleep(mDelayUSec);
+  }
+  for (auto& msgIt : tf.messagesPerRoute) {
+    LOG(INFO) << "Sending " << msgIt.second->Size() / 2 << " parts to channel " << msgIt.first;
+    device->Send(*msgIt.second.get(), msgIt.first);
+  }
+  mTimer[TimerTotal].Stop();
+
+  LOGF(INFO, "Sent payload of %zu bytes in %zu parts in %zu messages for TF %d | Timing (total/IO): %.3e / %.3e", tf.size, tf.nParts,
+       tf.messagesPerRoute.size(), tf.tfCounter, mTimer[TimerTotal].CpuTime() - tTotStart, mTimer[TimerIO].CpuTime() - tIOStart);
+
+  mSentSize += tf.size;
+  mSentMessages += tf.nParts;
+}
+
+//___________________________________________________________
+bool RawReaderSpecs::assembleTF(TFParts& tf, FairMQDevice* device)
+{
+  // read next TF of all links and prepare the messages, return false if there is nothing to read anymore
+  auto addPart = [&tf](FairMQMessagePtr hd, FairMQMessagePtr pl, const std::string& fairMQChannel) {
     FairMQParts* parts = nullptr;
-    parts = messagesPerRoute[fairMQChannel].get(); // FairMQParts*
+    parts = tf.messagesPerRoute[fairMQChannel].get(); // FairMQParts*
     if (!parts) {
-      messagesPerRoute[fairMQChannel] = std::make_unique<FairMQParts>();
-      parts = messagesPerRoute[fairMQChannel].get();
+      tf.messagesPerRoute[fairMQChannel] = std::make_unique<FairMQParts>();
+      parts = tf.messagesPerRoute[fairMQChannel].get();
     }
-    tfSize += pl->GetSize();
-    tfNParts++;
+    tf.size += pl->GetSize();
+    tf.nParts++;
     parts->AddPart(std::move(hd));
     parts->AddPart(std::move(pl));
   };
@@ -202,14 +293,7 @@ void RawReaderSpecs::run(o2f::ProcessingContext& ctx)
       tfID = 0;
       LOG(INFO) << "Starting new loop " << mLoopsDone << " from the beginning of data";
     } else {
-      mTimer[TimerTotal].Stop();
-      LOGF(INFO, "Finished: payload of %zu bytes in %zu messages sent for %d TFs", mSentSize, mSentMessages, mTFCounter);
-      for (int i = 0; i < NTimers; i++) {
-        LOGF(INFO, "Timing for %15s: Cpu: %.3e Real: %.3e s in %d slots", TimerName[i], mTimer[i].CpuTime(), mTimer[i].RealTime(), mTimer[i].Counter() - 1);
-      }
-      ctx.services().get<o2f::ControlService>().endOfStream();
-      ctx.services().get<o2f::ControlService>().readyToQuit(o2f::QuitRequest::Me);
-      return;
+      return false;
     }
   }
 
@@ -217,69 +301,36 @@ void RawReaderSpecs::run(o2f::ProcessingContext& ctx)
     tfID = mMinTFID;
   }
   mReader->setNextTFToRead(tfID);
-  std::vector<RawFileReader::PartStat> partsSP;
-  const auto& hbfU = HBFUtils::Instance();
+  tf.tfCounter = mTFCounter;
+  tf.tfID = tfID;
 
   // read next time frame
   LOG(INFO) << "Reading TF#" << mTFCounter << " (" << tfID << " at iteration " << mLoopsDone << ')';
-  o2::header::Stack dummyStack{o2h::DataHeader{}, o2::framework::DataProcessingHeader{0}}; // dummy stack to just to get stack size
-  auto hstackSize = dummyStack.size();
-
-  uint32_t firstOrbit = 0;
+  std::vector<LinkParts> linksParts(nlinks);
+  mTimer[TimerIO].Start(false);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
   for (int il = 0; il < nlinks; il++) {
-    auto& link = mReader->getLink(il);
-
-    if (!mDropTFMap.empty()) { // some TFs should be dropped
-      auto res = mDropTFMap.find(link.origin.str);
-      if (res != mDropTFMap.end() && (mTFCounter % res->second.first) == res->second.second) {
-        LOG(INFO) << "Droppint " << mTFCounter << " for " << link.origin.str << "/" << link.description.str << "/" << link.subspec;
-        continue; // drop the data
-      }
-    }
-    if (!link.rewindToTF(tfID)) {
-      continue; // this link has no data for wanted TF
-    }
-
-    o2h::DataHeader hdrTmpl(link.description, link.origin, link.subspec); // template with 0 size
-    int nParts = mPartPerSP ? link.getNextTFSuperPagesStat(partsSP) : link.getNHBFinTF();
-    hdrTmpl.payloadSerializationMethod = o2h::gSerializationMethodNone;
-    hdrTmpl.splitPayloadParts = nParts;
-    hdrTmpl.tfCounter = mTFCounter;
+    readLinkTF(il, tfID, device, linksParts[il]);
+  }
+  mTimer[TimerIO].Stop();
 
-    const auto fmqChannel = findOutputChannel(hdrTmpl);
-    if (fmqChannel.empty()) { // no output channel
+  // add the parts in the links order
+  uint32_t firstOrbit = 0;
+  for (auto& lp : linksParts) {
+    if (lp.messages.empty()) {
       continue;
     }
-
-    auto fmqFactory = device->GetChannel(fmqChannel, 0).Transport();
-    while (hdrTmpl.splitPayloadIndex < hdrTmpl.splitPayloadParts) {
-      hdrTmpl.payloadSize = mPartPerSP ? partsSP[hdrTmpl.splitPayloadIndex].size : link.getNextHBFSize();
-      auto hdMessage = fmqFactory->CreateMessage(hstackSize, fair::mq::Alignment{64});
-      auto plMessage = fmqFactory->CreateMessage(hdrTmpl.payloadSize, fair::mq::Alignment{64});
-      mTimer[TimerIO].Start(false);
-      auto bread = mPartPerSP ? link.readNextSuperPage(reinterpret_cast<char*>(plMessage->GetData()), &partsSP[hdrTmpl.splitPayloadIndex]) : link.readNextHBF(reinterpret_cast<char*>(plMessage->GetData()));
-      if (bread != hdrTmpl.payloadSize) {
-        LOG(ERROR) << "Link " << il << " read " << bread << " bytes instead of " << hdrTmpl.payloadSize
-                   << " expected in TF=" << mTFCounter << " part=" << hdrTmpl.splitPayloadIndex;
-      }
-      mTimer[TimerIO].Stop();
-      // check if the RDH to send corresponds to expected orbit
-      if (hdrTmpl.splitPayloadIndex == 0) {
-        auto ir = o2::raw::RDHUtils::getHeartBeatIR(plMessage->GetData());
-        auto tfid = hbfU.getTF(ir);
-        firstOrbit = hdrTmpl.firstTForbit = hbfU.getIRTF(tfid).orbit; // will be picked for the following parts
-      }
-      o2::header::Stack headerStack{hdrTmpl, o2::framework::DataProcessingHeader{mTFCounter}};
-      memcpy(hdMessage->GetData(), headerStack.data(), headerStack.size());
-      hdrTmpl.splitPayloadIndex++; // prepare for next
-
-      addPart(std::move(hdMessage), std::move(plMessage), fmqChannel);
+    firstOrbit = lp.firstOrbit;
+    for (size_t im = 0; im < lp.messages.size(); im += 2) {
+      addPart(std::move(lp.messages[im]), std::move(lp.messages[im + 1]), lp.channel);
     }
-    LOGF(DEBUG, "Added %d parts for TF#%d(%d in iteration %d) of %s/%s/0x%u", hdrTmpl.splitPayloadParts, mTFCounter, tfID,
-         mLoopsDone, link.origin.as<std::string>(), link.description.as<std::string>(), link.subspec);
   }
 
   // send sTF acknowledge message
+  o2::header::Stack dummyStack{o2h::DataHeader{}, o2::framework::DataProcessingHeader{0}}; // dummy stack to just to get stack size
+  auto hstackSize = dummyStack.size();
   {
     STFHeader stfHeader{mTFCounter, firstOrbit, 0};
     o2::header::DataHeader stfDistDataHeader(gDataDescSubTimeFrame, o2::header::gDataOriginFLP, 0, sizeof(STFHeader), 0, 1);
@@ -298,23 +349,109 @@ void RawReaderSpecs::run(o2f::ProcessingContext& ctx)
     }
   }
 
-  if (mTFCounter) { // delay sending
-    usleep(mDelayUSec);
+  mReader->setNextTFToRead(++tfID);
+  ++mTFCounter;
+  return true;
+}
+
+//___________________________________________________________
+void RawReaderSpecs::readLinkTF(int il, uint32_t tfID, FairMQDevice* device, LinkParts& lp)
+{
+  // read TF of single link to the messages, may be called concurrently for different links if the files are mapped
+  auto& link = mReader->getLink(il);
+
+  if (!mDropTFMap.empty()) { // some TFs should be dropped
+    auto res = mDropTFMap.find(link.origin.str);
+    if (res != mDropTFMap.end() && (mTFCounter % res->second.first) == res->second.second) {
+      LOG(INFO) << "Droppint " << mTFCounter << " for " << link.origin.str << "/" << link.description.str << "/" << link.subspec;
+      return; // drop the data
+    }
   }
-  for (auto& msgIt : messagesPerRoute) {
-    LOG(INFO) << "Sending " << msgIt.second->Size() / 2 << " parts to channel " << msgIt.first;
-    device->Send(*msgIt.second.get(), msgIt.first);
+  if (!link.rewindToTF(tfID)) {
+    return; // this link has no data for wanted TF
   }
-  mTimer[TimerTotal].Stop();
 
-  LOGF(INFO, "Sent payload of %zu bytes in %zu parts in %zu messages for TF %d | Timing (total/IO): %.3e / %.3e", tfSize, tfNParts,
-       messagesPerRoute.size(), mTFCounter, mTimer[TimerTotal].CpuTime() - tTotStart, mTimer[TimerIO].CpuTime() - tIOStart);
+  std::vector<RawFileReader::PartStat> partsSP;
+  const auto& hbfU = HBFUtils::Instance();
+  o2::header::Stack dummyStack{o2h::DataHeader{}, o2::framework::DataProcessingHeader{0}}; // dummy stack to just to get stack size
+  auto hstackSize = dummyStack.size();
 
-  mSentSize += tfSize;
-  mSentMessages += tfNParts;
+  o2h::DataHeader hdrTmpl(link.description, link.origin, link.subspec); // template with 0 size
+  int nParts = mPartPerSP ? link.getNextTFSuperPagesStat(partsSP) : link.getNHBFinTF();
+  hdrTmpl.payloadSerializationMethod = o2h::gSerializationMethodNone;
+  hdrTmpl.splitPayloadParts = nParts;
+  hdrTmpl.tfCounter = mTFCounter;
 
-  mReader->setNextTFToRead(++tfID);
-  ++mTFCounter;
+  lp.channel = findOutputChannel(hdrTmpl);
+  if (lp.channel.empty()) { // no output channel
+    return;
+  }
+
+  auto fmqFactory = device->GetChannel(lp.channel, 0).Transport();
+  lp.messages.reserve(2 * nParts);
+  while (hdrTmpl.splitPayloadIndex < hdrTmpl.splitPayloadParts) {
+    hdrTmpl.payloadSize = mPartPerSP ? partsSP[hdrTmpl.splitPayloadIndex].size : link.getNextHBFSize();
+    auto hdMessage = fmqFactory->CreateMessage(hstackSize, fair::mq::Alignment{64});
+    FairMQMessagePtr plMessage;
+    size_t bread = 0;
+    const char* mapped = nullptr;
+    if (mPartPerSP && (mapped = link.mapNextSuperPage(bread, &partsSP[hdrTmpl.splitPayloadIndex]))) {
+      // wrap the super-page in the mapped file (or cache), the transport will copy it only if it cannot use external memory
+      plMessage = fmqFactory->CreateMessage(const_cast<char*>(mapped), bread, [](void*, void*) {}, nullptr);
+    } else {
+      plMessage = fmqFactory->CreateMessage(hdrTmpl.payloadSize, fair::mq::Alignment{64});
+      bread = mPartPerSP ? link.readNextSuperPage(reinterpret_cast<char*>(plMessage->GetData()), &partsSP[hdrTmpl.splitPayloadIndex]) : link.readNextHBF(reinterpret_cast<char*>(plMessage->GetData()));
+    }
+    if (bread != hdrTmpl.payloadSize) {
+      LOG(ERROR) << "Link " << il << " read " << bread << " bytes instead of " << hdrTmpl.payloadSize
+                 << " expected in TF=" << mTFCounter << " part=" << hdrTmpl.splitPayloadIndex;
+    }
+    // check if the RDH to send corresponds to expected orbit
+    if (hdrTmpl.splitPayloadIndex == 0) {
+      auto ir = o2::raw::RDHUtils::getHeartBeatIR(plMessage->GetData());
+      auto tfid = hbfU.getTF(ir);
+      lp.firstOrbit = hdrTmpl.firstTForbit = hbfU.getIRTF(tfid).orbit; // will be picked for the following parts
+    }
+    o2::header::Stack headerStack{hdrTmpl, o2::framework::DataProcessingHeader{mTFCounter}};
+    memcpy(hdMessage->GetData(), headerStack.data(), headerStack.size());
+    hdrTmpl.splitPayloadIndex++; // prepare for next
+
+    lp.messages.emplace_back(std::move(hdMessage));
+    lp.messages.emplace_back(std::move(plMessage));
+  }
+  LOGF(DEBUG, "Added %d parts for TF#%d(%d in iteration %d) of %s/%s/0x%u", hdrTmpl.splitPayloadParts, mTFCounter, tfID,
+       mLoopsDone, link.origin.as<std::string>(), link.description.as<std::string>(), link.subspec);
+}
+
+//___________________________________________________________
+void RawReaderSpecs::startPrefetchThread(FairMQDevice* device)
+{
+  mQueue = std::make_unique<o2::utils::BoundedQueue<TFParts>>(mPrefetchTF);
+  mPrefetchThread = std::thread([this, device]() {
+    try {
+      TFParts tf;
+      while (assembleTF(tf, device)) {
+        if (!mQueue->push(std::move(tf))) {
+          break; // reading was interrupted
+        }
+        tf = TFParts{};
+      }
+    } catch (...) {
+      mPrefetchError = std::current_exception();
+    }
+    mQueue->close();
+  });
+}
+
+//___________________________________________________________
+void RawReaderSpecs::stopPrefetchThread()
+{
+  if (mQueue) {
+    mQueue->close();
+  }
+  if (mPrefetchThread.joinable()) {
+    mPrefetchThread.join();
+  }
 }
 
 //_________________________________________________________
@@ -39,6 +39,7 @@ void RawFileWriter::close()
 {
   // finalize all links
   if (mFName2File.empty()) {
+    stopAsyncWriting();
     return;
   }
   if (mCachingStage) {
@@ -61,6 +62,7 @@ void RawFileWriter::close()
       lnk.second.print();
     }
   }
+  stopAsyncWriting(); // make sure all pending superpages are written
   //
   // close all files
   for (auto& flh : mFName2File) {
@@ -197,13 +199,18 @@ void RawFileWriter::addData(uint16_t feeid, uint16_t cru, uint8_t lnk, uint8_t e
     }
     return;
   }
-  if (ir < mFirstIRAdded) {
-    mHBFUtils.checkConsistency(); // done only once
-    mFirstIRAdded = ir;
-  }
-  if (mDoLazinessCheck && !mCachingStage) {
-    mDetLazyCheck.completeLinks(this, ir); // make sure that all links for previously called IR got their addData call
-    mDetLazyCheck.acknowledge(sspec, ir, preformatted, trigger, detField);
+  {
+    // writer-level bookkeeping is serialized, the link data are then added under the link's own lock, so that
+    // different links may be filled concurrently for the same IR
+    std::lock_guard<std::mutex> lock(mAddDataMtx);
+    if (ir < mFirstIRAdded) {
+      mHBFUtils.checkConsistency(); // done only once
+      mFirstIRAdded = ir;
+    }
+    if (mDoLazinessCheck && !mCachingStage) {
+      mDetLazyCheck.completeLinks(this, ir); // make sure that all links for previously called IR got their addData call
+      mDetLazyCheck.acknowledge(sspec, ir, preformatted, trigger, detField);
+    }
   }
   link.addData(ir, data, preformatted, trigger, detField);
 }
@@ -277,6 +284,73 @@ void RawFileWriter::useCaching()
   LOG(INFO) << "Switched caching ON";
 }
 
+//___________________________________________________________________________________
+void RawFileWriter::useAsyncWriting(size_t maxPendingPages)
+{
+  // delegate writing of the flushed superpages to the dedicated thread, at most maxPendingPages are kept in memory
+  if (!mFirstIRAdded.isDummy()) {
+    throw std::runtime_error("asynchronous writing must be requested before feeding the data");
+  }
+  if (mWriteQueue) {
+    return; // already done
+  }
+  mWriteQueue = std::make_unique<o2::utils::BoundedQueue<PendingPage>>(maxPendingPages);
+  mWriterThread = std::thread([this]() {
+    PendingPage page;
+    while (mWriteQueue->pop(page)) {
+      page.file->write(page.data.data(), page.data.size());
+      std::lock_guard<std::mutex> lock(mFreePagesMtx);
+      mFreePages.emplace_back(std::move(page.data));
+    }
+  });
+  LOG(INFO) << "Switched asynchronous writing ON with at most " << maxPendingPages << " pending superpages";
+}
+
+//___________________________________________________________________________________
+void RawFileWriter::stopAsyncWriting()
+{
+  if (!mWriteQueue) {
+    return;
+  }
+  mWriteQueue->close(); // pending pages will still be written
+  if (mWriterThread.joinable()) {
+    mWriterThread.join();
+  }
+  mWriteQueue.reset();
+  mFreePages.clear();
+}
+
+//___________________________________________________________________________________
+std::vector<char> RawFileWriter::getFreePage()
+{
+  // get recycled superpage buffer if any, otherwise a new one
+  std::vector<char> page;
+  {
+    std::lock_guard<std::mutex> lock(mFreePagesMtx);
+    if (!mFreePages.empty()) {
+      page = std::move(mFreePages.back());
+      mFreePages.pop_back();
+    }
+  }
+  page.clear();
+  page.reserve(mSuperPageSize);
+  return page;
+}
+
+//___________________________________________________________________________________
+void RawFileWriter::queuePage(OutputFile& file, std::vector<char>& buffer, size_t size)
+{
+  // hand over the first size bytes of the buffer to the writer thread, the rest is moved to a fresh buffer
+  if (!size) {
+    return;
+  }
+  auto page = getFreePage();
+  page.insert(page.end(), buffer.begin() + size, buffer.end());
+  std::swap(page, buffer);
+  page.resize(size);
+  mWriteQueue->push(PendingPage{&file, std::move(page)});
+}
+
 //===================================================================================
 
 //___________________________________________________________________________________
@@ -583,7 +657,13 @@ void RawFileWriter::LinkData::flushSuperPage(bool keepLastPage)
   if (writer->mVerbosity) {
     LOGF(INFO, "Flushing super page of %u bytes for %s", pgSize, describe());
   }
-  writer->mFName2File.find(fileName)->second.write(buffer.data(), pgSize);
+  auto& file = writer->mFName2File.find(fileName)->second;
+  if (writer->isAsyncWriting()) { // the superpage is written by the writer thread, the buffer is replaced by a new one
+    writer->queuePage(file, buffer, pgSize);
+    lastRDHoffset = buffer.empty() ? -1 : lastRDHoffset - pgSize;
+    return;
+  }
+  file.write(buffer.data(), pgSize);
   auto toMove = buffer.size() - pgSize;
   if (toMove) { // is there something left in the buffer, move it to the beginning of the buffer
     if (toMove > pgSize) {
@@ -59,15 +59,19 @@ struct TestRawWriter { // simple class to create detector payload for multiple l
 
   RawFileWriter writer{"TST"};
   std::string configName = "rawConf.cfg";
+  size_t asyncPages = 0; // if > 0, write superpages in the separate thread
 
   //_________________________________________________________________
-  TestRawWriter(o2::header::DataOrigin origin = "TST", bool isCRU = true, const std::string& cfg = "rawConf.cfg") : writer(origin, isCRU), configName(cfg) {}
+  TestRawWriter(o2::header::DataOrigin origin = "TST", bool isCRU = true, const std::string& cfg = "rawConf.cfg", size_t async = 0) : writer(origin, isCRU), configName(cfg), asyncPages(async) {}
 
   //_________________________________________________________________
   void init()
   {
     // init writer
     writer.useRDHVersion(6);
+    if (asyncPages) {
+      writer.useAsyncWriting(asyncPages);
+    }
     int feeIDShift = writer.isCRUDetector() ? 8 : 9;
     // register links
     for (int icru = 0; icru < NCRU; icru++) {
@@ -351,6 +355,17 @@ BOOST_AUTO_TEST_CASE(RawReaderWriter_CRU)
   }
 }
 
+BOOST_AUTO_TEST_CASE(RawReaderWriter_CRU_Async)
+{
+  TestRawWriter dw{"TST", true, "test_raw_conf_GBT_async.cfg", 4}; // CRU detector writing superpages in the separate thread
+  dw.init();
+  dw.run(); // write output
+  //
+  TestRawReader dr{"TST", "test_raw_conf_GBT_async.cfg"};
+  dr.init();
+  dr.run(); // read back and check
+}
+
 BOOST_AUTO_TEST_CASE(RawReaderWriter_RORC)
 {
   TestRawWriter dw{"TST", false, "test_raw_conf_DDL.cfg"}; // this is RORC detector with origin TST
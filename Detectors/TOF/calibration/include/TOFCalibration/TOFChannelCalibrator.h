@@ -145,7 +145,7 @@ class TOFChannelCalibrator final : public o2::calibration::TimeSlotCalibration<T
 
   TOFChannelCalibrator(int minEnt = 500, int nb = 1000, float r = 24400) : mMinEntries(minEnt), mNBins(nb), mRange(r){};
 
-  ~TOFChannelCalibrator() final = default;
+  ~TOFChannelCalibrator() final { this->stopFinalization(); } // finalizeSlot must not run once this object is gone
 
   bool hasEnoughData(const Slot& slot) const final
   {
@@ -166,12 +166,18 @@ class TOFChannelCalibrator final : public o2::calibration::TimeSlotCalibration<T
 
   void finalizeSlot(Slot& slot) final
   {
+    // the range can be enlarged by the device while the slot is finalized asynchronously
+    float range;
+    {
+      auto lock = this->lockOutput();
+      range = mRange;
+    }
     // here we simply decide which finalize to call: for the use case with Tracks or cosmics
-    mCalibWithCosmics ? finalizeSlotWithCosmics(slot) : finalizeSlotWithTracks(slot);
+    mCalibWithCosmics ? finalizeSlotWithCosmics(slot, range) : finalizeSlotWithTracks(slot, range);
     return;
   }
 
-  void finalizeSlotWithCosmics(Slot& slot)
+  void finalizeSlotWithCosmics(Slot& slot, float range)
   {
     // Extract results for the single slot
     o2::tof::TOFChannelData* c = slot.getContainer();
@@ -183,7 +189,7 @@ class TOFChannelCalibrator final : public o2::calibration::TimeSlotCalibration<T
       for (int ichLocal = 0; ichLocal < Geo::NPADS; ichLocal++) {
         if (ichLocal == 24) {
           continue; //already fixed
-          mFuncDeltaOffset->SetParLimits(ichLocal, -mRange, mRange);
+          mFuncDeltaOffset->SetParLimits(ichLocal, -range, range);
         }
       }
     }
@@ -250,17 +256,17 @@ class TOFChannelCalibrator final : public o2::calibration::TimeSlotCalibration<T
           float intmin = fitValues[1] - 5 * fitValues[2]; // mean - 5*sigma
           float intmax = fitValues[1] + 5 * fitValues[2]; // mean + 5*sigma
 
-          if (intmin < -mRange) {
-            intmin = -mRange;
+          if (intmin < -range) {
+            intmin = -range;
           }
-          if (intmax < -mRange) {
-            intmax = -mRange;
+          if (intmax < -range) {
+            intmax = -range;
           }
-          if (intmin > mRange) {
-            intmin = mRange;
+          if (intmin > range) {
+            intmin = range;
           }
-          if (intmax > mRange) {
-            intmax = mRange;
+          if (intmax > range) {
+            intmax = range;
           }
 
           xp[goodpoints] = ipair + 0.5;      // pair index
@@ -302,11 +308,12 @@ class TOFChannelCalibrator final : public o2::calibration::TimeSlotCalibration<T
 
     auto clName = o2::utils::MemFileHelper::getClassName(ts);
     auto flName = o2::ccdb::CcdbApi::generateFileName(clName);
+    auto lock = this->lockOutput(); // the output might be read by the device meanwhile
     mInfoVector.emplace_back("TOF/ChannelCalib", clName, flName, md, slot.getTFStart(), 99999999999999);
     mTimeSlewingVector.emplace_back(ts);
   }
 
-  void finalizeSlotWithTracks(Slot& slot)
+  void finalizeSlotWithTracks(Slot& slot, float range)
   {
     // Extract results for the single slot
     o2::tof::TOFChannelData* c = slot.getContainer();
@@ -365,17 +372,17 @@ class TOFChannelCalibrator final : public o2::calibration::TimeSlotCalibration<T
       float intmin = fitValues[1] - 5 * fitValues[2]; // mean - 5*sigma
       float intmax = fitValues[1] + 5 * fitValues[2]; // mean + 5*sigma
 
-      if (intmin < -mRange) {
-        intmin = -mRange;
+      if (intmin < -range) {
+        intmin = -range;
       }
-      if (intmax < -mRange) {
-        intmax = -mRange;
+      if (intmax < -range) {
+        intmax = -range;
       }
-      if (intmin > mRange) {
-        intmin = mRange;
+      if (intmin > range) {
+        intmin = range;
       }
-      if (intmax > mRange) {
-        intmax = mRange;
+      if (intmax > range) {
+        intmax = range;
       }
 
       fractionUnderPeak = entriesInChannel > 0 ? c->integral(ich, intmin, intmax) / entriesInChannel : 0;
@@ -386,6 +393,7 @@ class TOFChannelCalibrator final : public o2::calibration::TimeSlotCalibration<T
     }
     auto clName = o2::utils::MemFileHelper::getClassName(ts);
     auto flName = o2::ccdb::CcdbApi::generateFileName(clName);
+    auto lock = this->lockOutput(); // the output might be read by the device meanwhile
     mInfoVector.emplace_back("TOF/ChannelCalib", clName, flName, md, slot.getTFStart(), 99999999999999);
     mTimeSlewingVector.emplace_back(ts);
   }
@@ -56,6 +56,8 @@ class TOFChannelCalibDevice : public o2::framework::Task
     int64_t delay = ic.options().get<int64_t>("max-delay");
     int updateInterval = ic.options().get<int64_t>("update-interval");
     int deltaUpdateInterval = ic.options().get<int64_t>("delta-update-interval");
+    int nThreadsFill = ic.options().get<int>("nthreads-fill");
+    int asyncFinalize = ic.options().get<int>("async-finalize");
     mCalibrator = std::make_unique<o2::tof::TOFChannelCalibrator<T>>(minEnt, nb, range);
 
     // default behaviour is to have only 1 slot at a time, accepting everything for it till the
@@ -68,6 +70,10 @@ class TOFChannelCalibDevice : public o2::framework::Task
     mCalibrator->setCheckIntervalInfiniteSlot(updateInterval);
     mCalibrator->setCheckDeltaIntervalInfiniteSlot(deltaUpdateInterval);
     mCalibrator->setMaxSlotsDelay(delay);
+    mCalibrator->setNThreadsFill(nThreadsFill);
+    if (asyncFinalize > 0) {
+      mCalibrator->setAsyncFinalization(asyncFinalize);
+    }
 
     if (updateAtEORonly) { // has priority over other settings
       mCalibrator->setUpdateAtTheEndOfRunOnly();
@@ -149,6 +155,7 @@ class TOFChannelCalibDevice : public o2::framework::Task
 
     if ((tfcounter - startTimeChCalib) > 60480000) { // number of TF in 1 week: 7*24*3600/10e-3 - with TF = 10 ms
       LOG(INFO) << "Enlarging the range of the booked histogram since the latest CCDB entry is too old";
+      auto lock = mCalibrator->lockOutput();               // the range is also used by the asynchronous finalization
       mCalibrator->setRange(mCalibrator->getRange() * 10); // we enlarge the range for the calibration in case the last valid object is too old (older than 1 week)
     }
 
@@ -187,6 +194,7 @@ class TOFChannelCalibDevice : public o2::framework::Task
     // extract CCDB infos and calibration objects, convert it to TMemFile and send them to the output
     // TODO in principle, this routine is generic, can be moved to Utils.h
     using clbUtils = o2::calibration::Utils;
+    auto lock = mCalibrator->lockOutput(); // the output might be filled by the asynchronous finalization
     const auto& payloadVec = mCalibrator->getTimeSlewingVector();
     auto& infoVec = mCalibrator->getTimeSlewingInfoVector(); // use non-const version as we update it
     assert(payloadVec.size() == infoVec.size());
@@ -251,7 +259,9 @@ DataProcessorSpec getTOFChannelCalibDeviceSpec(bool useCCDB, bool attachChannelO
       {"tf-per-slot", VariantType::Int64, INFINITE_TF_int64, {"number of TFs per calibration time slot"}},
       {"max-delay", VariantType::Int64, 0ll, {"number of slots in past to consider"}},
       {"update-interval", VariantType::Int64, 10ll, {"number of TF after which to try to finalize calibration"}},
-      {"delta-update-interval", VariantType::Int64, 10ll, {"number of TF after which to try to finalize calibration, if previous attempt failed"}}}};
+      {"delta-update-interval", VariantType::Int64, 10ll, {"number of TF after which to try to finalize calibration, if previous attempt failed"}},
+      {"nthreads-fill", VariantType::Int, 1, {"number of threads to fill the calibration slot"}},
+      {"async-finalize", VariantType::Int, 0, {"if > 0, finalize slots in separate thread with at most this number of slots pending"}}}};
 }
 
 } // namespace framework
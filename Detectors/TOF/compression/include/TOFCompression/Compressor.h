@@ -68,6 +68,8 @@ class Compressor
 
   void checkSummary();
   void resetCounters();
+  /// add the counters of another compressor, e.g. to summarise the work of several threads
+  void addCounters(const Compressor& other);
 
   void setDecoderCONET(bool val)
   {
@@ -101,6 +103,7 @@ class Compressor
   /** decoder private functions and data members **/
 
   bool decoderParanoid();
+  bool decoderHitPairs(int ichain);
   inline void decoderRewind() { mDecoderPointer = reinterpret_cast<const uint32_t*>(mDecoderBuffer); };
   inline void decoderNext()
   {
@@ -53,6 +53,7 @@
 #define IS_TDC_ERROR(x) ((x & 0xF0000000) == 0x60000000)
 #define IS_FILLER(x) ((x & 0xFFFFFFFF) == 0x70000000)
 #define IS_TDC_HIT(x) ((x & 0x80000000) == 0x80000000)
+#define IS_TDC_HIT_PAIR(x) ((x & 0x8000000080000000) == 0x8000000080000000)
 #define IS_TDC_HIT_LEADING(x) ((x & 0xA0000000) == 0xA0000000)
 #define IS_TDC_HIT_TRAILING(x) ((x & 0xC0000000) == 0xC0000000)
 #define IS_DRM_TEST_WORD(x) ((x & 0xF000000F) == 0xE000000F)
@@ -689,6 +690,15 @@ bool Compressor<RDH, verbose, paranoid>::processTRMchain(int itrm, int ichain)
     /** TDC hit detected **/
     if (IS_TDC_HIT(*mDecoderPointer)) {
       mDecoderSummary.hasHits[itrm][ichain] = true;
+      /** hits come in long runs, consume them two words at a time **/
+      if (!verbose) {
+        if (decoderHitPairs(ichain)) {
+          return true;
+        }
+        if (!IS_TDC_HIT(*mDecoderPointer)) {
+          continue;
+        }
+      }
       auto itdc = GET_TRMDATAHIT_TDCID(*mDecoderPointer);
       auto ihit = mDecoderSummary.trmDataHits[ichain][itdc];
       mDecoderSummary.trmDataHit[ichain][itdc][ihit] = mDecoderPointer;
@@ -758,6 +768,35 @@ bool Compressor<RDH, verbose, paranoid>::processTRMchain(int itrm, int ichain)
   return false;
 }
 
+template <typename RDH, bool verbose, bool paranoid>
+bool Compressor<RDH, verbose, paranoid>::decoderHitPairs(int ichain)
+{
+  /** decoder hit pairs **/
+
+  /** when the pointer is on the first word of a GBT word (or anywhere in CONET mode)
+      the next decoded word is the adjacent one: classify both words with a single
+      64-bit test and store the hits without going through the other word types **/
+  auto& trmDataHit = mDecoderSummary.trmDataHit[ichain];
+  auto& trmDataHits = mDecoderSummary.trmDataHits[ichain];
+  while (mDecoderNextWord == 1 && mDecoderPointer + 1 < mDecoderPointerMax) {
+    uint64_t pair;
+    std::memcpy(&pair, mDecoderPointer, sizeof(pair));
+    if (!IS_TDC_HIT_PAIR(pair)) {
+      break;
+    }
+    auto itdc = GET_TRMDATAHIT_TDCID(*mDecoderPointer);
+    trmDataHit[itdc][trmDataHits[itdc]++] = mDecoderPointer;
+    decoderNext();
+    itdc = GET_TRMDATAHIT_TDCID(*mDecoderPointer);
+    trmDataHit[itdc][trmDataHits[itdc]++] = mDecoderPointer;
+    decoderNext();
+    if (paranoid && decoderParanoid()) {
+      return true;
+    }
+  }
+  return false;
+}
+
 template <typename RDH, bool verbose, bool paranoid>
 bool Compressor<RDH, verbose, paranoid>::decoderParanoid()
 {
@@ -1338,6 +1377,33 @@ void Compressor<RDH, verbose, paranoid>::resetCounters()
   }
 }
 
+template <typename RDH, bool verbose, bool paranoid>
+void Compressor<RDH, verbose, paranoid>::addCounters(const Compressor& other)
+{
+  mEventCounter += other.mEventCounter;
+  mFatalCounter += other.mFatalCounter;
+  mErrorCounter += other.mErrorCounter;
+  mDRMCounters.Headers += other.mDRMCounters.Headers;
+  mDRMCounters.EventWordsMismatch += other.mDRMCounters.EventWordsMismatch;
+  mDRMCounters.clockStatus += other.mDRMCounters.clockStatus;
+  mDRMCounters.Fault += other.mDRMCounters.Fault;
+  mDRMCounters.RTOBit += other.mDRMCounters.RTOBit;
+  for (int itrm = 0; itrm < 10; ++itrm) {
+    mTRMCounters[itrm].Headers += other.mTRMCounters[itrm].Headers;
+    mTRMCounters[itrm].Empty += other.mTRMCounters[itrm].Empty;
+    mTRMCounters[itrm].EventCounterMismatch += other.mTRMCounters[itrm].EventCounterMismatch;
+    mTRMCounters[itrm].EventWordsMismatch += other.mTRMCounters[itrm].EventWordsMismatch;
+    mTRMCounters[itrm].EBit += other.mTRMCounters[itrm].EBit;
+    for (int ichain = 0; ichain < 2; ++ichain) {
+      mTRMChainCounters[itrm][ichain].Headers += other.mTRMChainCounters[itrm][ichain].Headers;
+      mTRMChainCounters[itrm][ichain].EventCounterMismatch += other.mTRMChainCounters[itrm][ichain].EventCounterMismatch;
+      mTRMChainCounters[itrm][ichain].BadStatus += other.mTRMChainCounters[itrm][ichain].BadStatus;
+      mTRMChainCounters[itrm][ichain].BunchIDMismatch += other.mTRMChainCounters[itrm][ichain].BunchIDMismatch;
+      mTRMChainCounters[itrm][ichain].TDCerror += other.mTRMChainCounters[itrm][ichain].TDCerror;
+    }
+  }
+}
+
 template <typename RDH, bool verbose, bool paranoid>
 void Compressor<RDH, verbose, paranoid>::checkSummary()
 {
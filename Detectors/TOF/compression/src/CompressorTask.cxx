@@ -22,6 +22,11 @@
 #include "Framework/DataSpecUtils.h"
 
 #include <fairmq/FairMQDevice.h>
+#include <algorithm>
+
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
 
 using namespace o2::framework;
 
@@ -40,14 +45,30 @@ void CompressorTask<RDH, verbose, paranoid>::init(InitContext& ic)
   auto encoderVerbose = ic.options().get<bool>("tof-compressor-encoder-verbose");
   auto checkerVerbose = ic.options().get<bool>("tof-compressor-checker-verbose");
   mOutputBufferSize = ic.options().get<int>("tof-compressor-output-buffer-size");
-
-  mCompressor.setDecoderCONET(decoderCONET);
-  mCompressor.setDecoderVerbose(decoderVerbose);
-  mCompressor.setEncoderVerbose(encoderVerbose);
-  mCompressor.setCheckerVerbose(checkerVerbose);
+  mNThreads = std::max(1, ic.options().get<int>("tof-compressor-nthreads"));
+#ifndef WITH_OPENMP
+  if (mNThreads > 1) {
+    LOG(WARNING) << "OpenMP is not available, the compressor will run with 1 thread";
+    mNThreads = 1;
+  }
+#endif
+
+  mCompressors.clear();
+  for (int i = 0; i < mNThreads; ++i) {
+    auto& compressor = mCompressors.emplace_back(std::make_unique<CompressorType>());
+    compressor->setDecoderCONET(decoderCONET);
+    compressor->setDecoderVerbose(decoderVerbose);
+    compressor->setEncoderVerbose(encoderVerbose);
+    compressor->setCheckerVerbose(checkerVerbose);
+    compressor->resetCounters();
+  }
 
   auto finishFunction = [this]() {
-    mCompressor.checkSummary();
+    for (int i = 1; i < mCompressors.size(); ++i) {
+      mCompressors[0]->addCounters(*mCompressors[i]);
+      mCompressors[i]->resetCounters();
+    }
+    mCompressors[0]->checkSummary();
   };
 
   ic.services().get<CallbackService>().set(CallbackService::Id::Stop, finishFunction);
@@ -89,11 +110,23 @@ void CompressorTask<RDH, verbose, paranoid>::run(ProcessingContext& pc)
     }
   }
 
+  /** the subspecs (i.e. the links) are independent: prepare one output message per subspec,
+      compress them concurrently, each thread with its own compressor, and send them in order **/
+  struct SubspecOutput {
+    std::vector<o2::framework::DataRef>* parts;
+    o2::header::DataHeader headerOut;
+    o2::framework::DataProcessingHeader dataProcessingHeaderOut;
+    FairMQMessagePtr payloadMessage;
+    long bufferSize;
+  };
+  std::vector<SubspecOutput> subspecOutputs;
+  subspecOutputs.reserve(subspecPartMap.size());
+
   /** loop over subspecs **/
   for (auto& subspecPartEntry : subspecPartMap) {
 
     auto subspec = subspecPartEntry.first;
-    auto parts = subspecPartEntry.second;
+    auto& parts = subspecPartEntry.second;
     auto& firstPart = parts.at(0);
 
     /** use the first part to define output headers **/
@@ -105,41 +138,56 @@ void CompressorTask<RDH, verbose, paranoid>::run(ProcessingContext& pc)
 
     /** initialise output message **/
     auto bufferSize = mOutputBufferSize >= 0 ? mOutputBufferSize + subspecBufferSize[subspec] : std::abs(mOutputBufferSize);
-    auto payloadMessage = device->NewMessage(bufferSize);
-    auto bufferPointer = (char*)payloadMessage->GetData();
+    subspecOutputs.push_back({&parts, headerOut, dataProcessingHeaderOut, device->NewMessage(bufferSize), bufferSize});
+  }
+
+  /** loop over subspec outputs **/
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+  for (int isubspec = 0; isubspec < subspecOutputs.size(); ++isubspec) {
+#ifdef WITH_OPENMP
+    auto& compressor = *mCompressors[omp_get_thread_num()];
+#else
+    auto& compressor = *mCompressors[0];
+#endif
+    auto& output = subspecOutputs[isubspec];
+    auto bufferPointer = (char*)output.payloadMessage->GetData();
+    auto bufferSize = output.bufferSize;
 
     /** loop over subspec parts **/
-    for (const auto& ref : parts) {
+    for (const auto& ref : *output.parts) {
 
       /** input **/
       auto headerIn = DataRefUtils::getHeader<o2::header::DataHeader*>(ref);
-      auto dataProcessingHeaderIn = DataRefUtils::getHeader<o2::framework::DataProcessingHeader*>(ref);
       auto payloadIn = ref.payload;
       auto payloadInSize = headerIn->payloadSize;
 
       /** prepare compressor **/
-      mCompressor.setDecoderBuffer(payloadIn);
-      mCompressor.setDecoderBufferSize(payloadInSize);
-      mCompressor.setEncoderBuffer(bufferPointer);
-      mCompressor.setEncoderBufferSize(bufferSize);
+      compressor.setDecoderBuffer(payloadIn);
+      compressor.setDecoderBufferSize(payloadInSize);
+      compressor.setEncoderBuffer(bufferPointer);
+      compressor.setEncoderBufferSize(bufferSize);
 
       /** run **/
-      mCompressor.run();
-      auto payloadOutSize = mCompressor.getEncoderByteCounter();
+      compressor.run();
+      auto payloadOutSize = compressor.getEncoderByteCounter();
       bufferPointer += payloadOutSize;
       bufferSize -= payloadOutSize;
-      headerOut.payloadSize += payloadOutSize;
+      output.headerOut.payloadSize += payloadOutSize;
     }
+  }
 
-    /** finalise output message **/
-    payloadMessage->SetUsedSize(headerOut.payloadSize);
-    o2::header::Stack headerStack{headerOut, dataProcessingHeaderOut};
+  /** finalise output messages in subspec order **/
+  for (auto& output : subspecOutputs) {
+    output.payloadMessage->SetUsedSize(output.headerOut.payloadSize);
+    o2::header::Stack headerStack{output.headerOut, output.dataProcessingHeaderOut};
     auto headerMessage = device->NewMessage(headerStack.size());
     std::memcpy(headerMessage->GetData(), headerStack.data(), headerStack.size());
 
     /** add parts **/
     partsOut.AddPart(std::move(headerMessage));
-    partsOut.AddPart(std::move(payloadMessage));
+    partsOut.AddPart(std::move(output.payloadMessage));
   }
 
   /** send message **/
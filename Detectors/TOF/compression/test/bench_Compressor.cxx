@@ -0,0 +1,136 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   bench_Compressor.cxx
+/// @brief  Benchmark of the TOF raw data compressor on recorded raw data
+///
+/// The raw data file (or the raw reader configuration file) is taken from the
+/// TOF_COMPRESSOR_BENCH_INPUT environment variable, the data of every link and
+/// TF are compressed as in the compressor workflow.
+
+#include "benchmark/benchmark.h"
+#include "TOFCompression/Compressor.h"
+#include "DetectorsRaw/RawFileReader.h"
+#include "Framework/Logger.h"
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using CompressorType = o2::tof::Compressor<o2::header::RAWDataHeaderV6, false, false>;
+
+/// raw data of every link and TF found in the input
+const std::vector<std::vector<char>>& getInputData()
+{
+  static std::vector<std::vector<char>> data;
+  static bool loaded = false;
+  if (loaded) {
+    return data;
+  }
+  loaded = true;
+  auto input = std::getenv("TOF_COMPRESSOR_BENCH_INPUT");
+  if (!input) {
+    return data;
+  }
+  std::string inputName(input);
+  bool isConfig = inputName.size() > 4 && inputName.compare(inputName.size() - 4, 4, ".cfg") == 0;
+  o2::raw::RawFileReader reader(isConfig ? inputName : "");
+  if (!isConfig) {
+    reader.addFile(inputName, o2::header::gDataOriginTOF, o2::header::gDataDescriptionRawData);
+  }
+  reader.init();
+  for (uint32_t itf = 0; itf < reader.getNTimeFrames(); ++itf) {
+    reader.setNextTFToRead(itf);
+    for (int ilink = 0; ilink < reader.getNLinks(); ++ilink) {
+      auto& link = reader.getLink(ilink);
+      auto tfsz = link.getNextTFSize();
+      if (!tfsz) {
+        continue;
+      }
+      auto& buffer = data.emplace_back(tfsz);
+      link.readNextTF(buffer.data());
+    }
+  }
+  return data;
+}
+
+/// compress the link buffers ilink, ilink + step, ilink + 2 * step, ... and return the input bytes
+size_t compressLinks(CompressorType& compressor, const std::vector<std::vector<char>>& data, std::vector<char>& output, size_t ilink, size_t step)
+{
+  size_t bytes = 0;
+  for (; ilink < data.size(); ilink += step) {
+    auto& input = data[ilink];
+    if (output.size() < input.size()) {
+      output.resize(input.size());
+    }
+    compressor.setDecoderBuffer(input.data());
+    compressor.setDecoderBufferSize(input.size());
+    compressor.setEncoderBuffer(output.data());
+    compressor.setEncoderBufferSize(output.size());
+    compressor.run();
+    bytes += input.size();
+  }
+  return bytes;
+}
+
+static void BM_Compressor(benchmark::State& state)
+{
+  auto& data = getInputData();
+  if (data.empty()) {
+    state.SkipWithError("no input, set TOF_COMPRESSOR_BENCH_INPUT to a TOF raw data file");
+    return;
+  }
+  auto compressor = std::make_unique<CompressorType>();
+  compressor->resetCounters();
+  std::vector<char> output;
+  size_t bytes = 0;
+  for (auto _ : state) {
+    bytes += compressLinks(*compressor, data, output, 0, 1);
+  }
+  state.SetBytesProcessed(bytes);
+}
+
+static void BM_CompressorMultiLink(benchmark::State& state)
+{
+  auto& data = getInputData();
+  if (data.empty()) {
+    state.SkipWithError("no input, set TOF_COMPRESSOR_BENCH_INPUT to a TOF raw data file");
+    return;
+  }
+  // one compressor per thread, the links are shared among the threads as in the compressor task
+  size_t nThreads = state.range(0);
+  std::vector<std::unique_ptr<CompressorType>> compressors;
+  std::vector<std::vector<char>> outputs(nThreads);
+  for (size_t i = 0; i < nThreads; ++i) {
+    compressors.emplace_back(std::make_unique<CompressorType>())->resetCounters();
+  }
+  std::vector<size_t> bytes(nThreads, 0);
+  for (auto _ : state) {
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < nThreads; ++i) {
+      threads.emplace_back([&, i]() { bytes[i] += compressLinks(*compressors[i], data, outputs[i], i, nThreads); });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+  size_t totalBytes = 0;
+  for (auto b : bytes) {
+    totalBytes += b;
+  }
+  state.SetBytesProcessed(totalBytes);
+}
+
+BENCHMARK(BM_Compressor)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CompressorMultiLink)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
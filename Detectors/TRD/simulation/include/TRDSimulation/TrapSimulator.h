@@ -379,6 +379,17 @@ class TrapSimulator
   unsigned int addUintClipping(unsigned int a, unsigned int b, unsigned int nbits) const;
   // Add a and b (unsigned) with clipping to the maximum value representable by nbits
  private:
+  struct FitWindows { // timebin ranges [start, end) of the charge and fit windows, as configured in the TRAP
+    int mQ0Start;
+    int mQ0End;
+    int mQ1Start;
+    int mQ1End;
+    int mFitStart;
+    int mFitEnd;
+  };
+  FitWindows getFitWindows();
+  void addHitToFitreg(int adc, unsigned short timebin, unsigned short qtot, short ypos, const FitWindows& windows);
+
   TrapSimulator(const TrapSimulator& m);            // not implemented
   TrapSimulator& operator=(const TrapSimulator& m); // not implemented
 
@@ -51,6 +51,7 @@
 #include <ostream>
 #include <fstream>
 #include <numeric>
+#include <algorithm>
 
 using namespace o2::trd;
 using namespace std;
@@ -110,13 +111,11 @@ void TrapSimulator::reset()
   std::fill(mADCF.begin(), mADCF.end(), 0);
   std::fill(mADCDigitIndices.begin(), mADCDigitIndices.end(), -1);
 
-  for (auto filterreg : mInternalFilterRegisters) {
+  for (auto& filterreg : mInternalFilterRegisters) {
     filterreg.ClearReg();
   }
-  // clear the tracklet detail information.
-  for (auto trackletdetail : mTrackletDetails) {
-    trackletdetail.clear();
-  }
+  // clear the tracklet detail information, the simulator can be reused for other MCMs
+  mTrackletDetails.clear();
   // Default unread, low active bit mask
   std::fill(mZSMap.begin(), mZSMap.end(), 0);
   std::fill(mMCMT.begin(), mMCMT.end(), 0);
@@ -1181,16 +1180,41 @@ void TrapSimulator::filterPedestal()
   // It has only an effect if previous samples have been fed to
   // find the pedestal. Currently, the simulation assumes that
   // the input has been stable for a sufficiently long time.
-  // LOG(debug) << "BEGIN: " << __FILE__ << ":" << __func__ << ":" << __LINE__ ;
-
-  for (int iTimeBin = 0; iTimeBin < mNTimeBin; iTimeBin++) {
-    for (int iAdc = 0; iAdc < NADCMCM; iAdc++) {
-      int oldadc = mADCF[iAdc * mNTimeBin + iTimeBin];
-      mADCF[iAdc * mNTimeBin + iTimeBin] = filterPedestalNextSample(iAdc, iTimeBin, mADCR[iAdc * mNTimeBin + iTimeBin]);
-      //    LOG(debug) << "mADCF : time : " << iTimeBin << " adc : " << iAdc << " change : " << oldadc << " -> " << mADCF[iAdc * mNTimeBin + iTimeBin];
+  //
+  // The result is identical to feeding the samples one by one to
+  // filterPedestalNextSample(), but the configuration is read only once.
+  // The channels are independent and the accumulator is only updated in
+  // timebin 0, so each channel is processed with a constant accumulator
+  // over the remaining timebins, which the compiler can vectorise.
+
+  const unsigned short fpnp = mTrapConfig->getTrapReg(TrapConfig::kFPNP, mDetector, mRobPos, mMcmPos); // 0..511 -> 0..127.75, pedestal at the output
+  const unsigned short fptc = mTrapConfig->getTrapReg(TrapConfig::kFPTC, mDetector, mRobPos, mMcmPos); // 0..3, 0 - fastest, 3 - slowest
+  const bool bypass = mTrapConfig->getTrapReg(TrapConfig::kFPBY, mDetector, mRobPos, mMcmPos) == 0;   // 0..1 bypass, active low
+  const unsigned short shift = mgkFPshifts[fptc];
+
+  if (mNTimeBin == 0) {
+    return;
+  }
+  for (int iAdc = 0; iAdc < NADCMCM; iAdc++) {
+    const int* raw = &mADCR[iAdc * mNTimeBin];
+    int* filtered = &mADCF[iAdc * mNTimeBin];
+    auto& pedAcc = mInternalFilterRegisters[iAdc].mPedAcc;
+    unsigned short accumulatorShifted = (pedAcc >> shift) & 0x3FF; // 10 bits
+    auto nextSample = [&](int iTimeBin) {
+      unsigned short value = raw[iTimeBin];
+      unsigned short inpAdd = value + fpnp;
+      unsigned short out = inpAdd <= accumulatorShifted ? 0 : std::min(inpAdd - accumulatorShifted, 0xFFF);
+      filtered[iTimeBin] = bypass ? value : out;
+    };
+    nextSample(0);
+    // the accumulator is disabled in the drift time
+    int correction = ((unsigned short)raw[0] & 0x3FF) - accumulatorShifted;
+    pedAcc = (pedAcc + correction) & 0x7FFFFFFF; // 31 bits
+    accumulatorShifted = (pedAcc >> shift) & 0x3FF;
+    for (int iTimeBin = 1; iTimeBin < mNTimeBin; iTimeBin++) {
+      nextSample(iTimeBin);
     }
   }
-  // LOG(debug) << "BEGIN: " << __FILE__ << ":" << __func__ << ":" << __LINE__ ;
 }
 
 void TrapSimulator::filterGainInit()
@@ -1364,12 +1388,51 @@ unsigned short TrapSimulator::filterTailNextSample(int adc, unsigned short value
 void TrapSimulator::filterTail()
 {
   // Apply tail cancellation filter to all data.
+  //
+  // The result is identical to feeding the samples one by one to
+  // filterTailNextSample(). The configuration is read only once and the
+  // filter is applied to all channels of a timebin in one go, the
+  // registers of the channels being kept in local arrays, so that the
+  // channel loop can be vectorised.
+
+  const unsigned int alphaLong = 0x3ff & mTrapConfig->getTrapReg(TrapConfig::kFTAL, mDetector, mRobPos, mMcmPos);                            // the weight of the long component
+  const unsigned int lambdaLong = (1 << 10) | (1 << 9) | (mTrapConfig->getTrapReg(TrapConfig::kFTLL, mDetector, mRobPos, mMcmPos) & 0x1FF);  // the multiplier of the long component
+  const unsigned int lambdaShort = (0 << 10) | (1 << 9) | (mTrapConfig->getTrapReg(TrapConfig::kFTLS, mDetector, mRobPos, mMcmPos) & 0x1FF); // the multiplier of the short component
+  const bool bypass = mTrapConfig->getTrapReg(TrapConfig::kFTBY, mDetector, mRobPos, mMcmPos) == 0;                                          // bypass mode, active low
+
+  std::array<unsigned int, NADCMCM> amplLong, amplShort, values;
+  for (int iAdc = 0; iAdc < NADCMCM; iAdc++) {
+    amplLong[iAdc] = mInternalFilterRegisters[iAdc].mTailAmplLong;
+    amplShort[iAdc] = mInternalFilterRegisters[iAdc].mTailAmplShort;
+  }
 
   for (int iTimeBin = 0; iTimeBin < mNTimeBin; iTimeBin++) {
     for (int iAdc = 0; iAdc < NADCMCM; iAdc++) {
-      mADCF[iAdc * mNTimeBin + iTimeBin] = filterTailNextSample(iAdc, mADCF[iAdc * mNTimeBin + iTimeBin]);
+      values[iAdc] = (unsigned short)mADCF[iAdc * mNTimeBin + iTimeBin];
+    }
+    for (int iAdc = 0; iAdc < NADCMCM; iAdc++) {
+      unsigned int inpVolt = values[iAdc] & 0xFFF; // 12 bits
+      // add the present generator outputs
+      unsigned int aQ = std::min(amplLong[iAdc] + amplShort[iAdc], 0xFFFu);
+      // calculate the difference between the input and the generated signal
+      unsigned int aDiff = inpVolt > aQ ? inpVolt - aQ : 0;
+      // the inputs to the two generators, weighted
+      unsigned int alInpv = (aDiff * alphaLong) >> 11;
+      // the new values of the registers, used next time
+      amplLong[iAdc] = ((std::min(amplLong[iAdc] + alInpv, 0xFFFu) * lambdaLong) >> 11) & 0xFFF;
+      amplShort[iAdc] = ((std::min(amplShort[iAdc] + aDiff - alInpv, 0xFFFu) * lambdaShort) >> 11) & 0xFFF;
+      // the output of the filter
+      values[iAdc] = bypass ? values[iAdc] : aDiff;
+    }
+    for (int iAdc = 0; iAdc < NADCMCM; iAdc++) {
+      mADCF[iAdc * mNTimeBin + iTimeBin] = values[iAdc];
     }
   }
+
+  for (int iAdc = 0; iAdc < NADCMCM; iAdc++) {
+    mInternalFilterRegisters[iAdc].mTailAmplLong = amplLong[iAdc];
+    mInternalFilterRegisters[iAdc].mTailAmplShort = amplShort[iAdc];
+  }
 }
 
 void TrapSimulator::zeroSupressionMapping()
@@ -1466,18 +1529,34 @@ void TrapSimulator::addHitToFitreg(int adc, unsigned short timebin, unsigned sho
   // the tracklet calculation.
   // In addition to the fit sums in the fit register
   //
+  addHitToFitreg(adc, timebin, qtot, ypos, getFitWindows());
+}
+
+TrapSimulator::FitWindows TrapSimulator::getFitWindows()
+{
+  // read the limits of the charge and fit windows from the configuration
+  FitWindows windows;
+  windows.mQ0Start = mTrapConfig->getTrapReg(TrapConfig::kTPQS0, mDetector, mRobPos, mMcmPos);
+  windows.mQ0End = mTrapConfig->getTrapReg(TrapConfig::kTPQE0, mDetector, mRobPos, mMcmPos);
+  windows.mQ1Start = mTrapConfig->getTrapReg(TrapConfig::kTPQS1, mDetector, mRobPos, mMcmPos);
+  windows.mQ1End = mTrapConfig->getTrapReg(TrapConfig::kTPQE1, mDetector, mRobPos, mMcmPos);
+  windows.mFitStart = mTrapConfig->getTrapReg(TrapConfig::kTPFS, mDetector, mRobPos, mMcmPos);
+  windows.mFitEnd = mTrapConfig->getTrapReg(TrapConfig::kTPFE, mDetector, mRobPos, mMcmPos);
+  return windows;
+}
+
+void TrapSimulator::addHitToFitreg(int adc, unsigned short timebin, unsigned short qtot, short ypos, const FitWindows& windows)
+{
   LOG(debug) << __func__ << " adc : " << adc << " timebin: " << timebin << " qtot: " << qtot << " ypos:" << ypos;
   if (adc > 24) {
     LOG(error) << " adc channel into addHitToFitReg is out of bounds for mFitReg : " << adc;
   }
 
-  if ((timebin >= mTrapConfig->getTrapReg(TrapConfig::kTPQS0, mDetector, mRobPos, mMcmPos)) &&
-      (timebin < mTrapConfig->getTrapReg(TrapConfig::kTPQE0, mDetector, mRobPos, mMcmPos))) {
+  if ((timebin >= windows.mQ0Start) && (timebin < windows.mQ0End)) {
     mFitReg[adc].mQ0 += qtot;
   }
 
-  if ((timebin >= mTrapConfig->getTrapReg(TrapConfig::kTPQS1, mDetector, mRobPos, mMcmPos)) &&
-      (timebin < mTrapConfig->getTrapReg(TrapConfig::kTPQE1, mDetector, mRobPos, mMcmPos))) {
+  if ((timebin >= windows.mQ1Start) && (timebin < windows.mQ1End)) {
     mFitReg[adc].mQ1 += qtot;
   }
   // Q2 is simply the addition of times from 3 to 5, for now consts in the header file till they come from a config.
@@ -1485,8 +1564,7 @@ void TrapSimulator::addHitToFitreg(int adc, unsigned short timebin, unsigned sho
     mFitReg[adc].mQ2 += qtot;
   }
 
-  if ((timebin >= mTrapConfig->getTrapReg(TrapConfig::kTPFS, mDetector, mRobPos, mMcmPos)) &&
-      (timebin < mTrapConfig->getTrapReg(TrapConfig::kTPFE, mDetector, mRobPos, mMcmPos))) {
+  if ((timebin >= windows.mFitStart) && (timebin < windows.mFitEnd)) {
     mFitReg[adc].mSumX += timebin;
     mFitReg[adc].mSumX2 += timebin * timebin;
     mFitReg[adc].mNhits++;
@@ -1522,37 +1600,29 @@ void TrapSimulator::calcFitreg()
   // has to be called before even if all filters are bypassed.
   //??? to be clarified:
   LOG(debug) << "ENTERING : " << __FILE__ << ":" << __func__ << ":" << __LINE__ << " :: " << getDetector() << ":" << getRobPos() << ":" << getMcmPos() << " -------------------- mNHits : " << mNHits;
-  unsigned int adcMask = 0xffffffff;
 
-  bool hitQual;
   int adcLeft, adcCentral, adcRight;
-  unsigned short timebin, adcch, timebin1, timebin2, qtotTemp;
+  unsigned short timebin, adcch, timebin1, timebin2;
   short ypos, fromLeft, fromRight, found;
   std::array<unsigned short, 20> qTotal{}; //[19 + 1]; // the last is dummy
   std::array<unsigned short, 6> marked{}, qMarked{};
   unsigned short worse1, worse2;
 
+  // the configuration does not change while processing the MCM, read it once
+  const FitWindows windows = getFitWindows();
+  const bool bypassVerification = mTrapConfig->getTrapReg(TrapConfig::kTPVBY, mDetector, mRobPos, mMcmPos) == 0;
+  const int regTPVT = mTrapConfig->getTrapReg(TrapConfig::kTPVT, mDetector, mRobPos, mMcmPos);
+  const int regTPHT = mTrapConfig->getTrapReg(TrapConfig::kTPHT, mDetector, mRobPos, mMcmPos);
+  const int regTPFP = mTrapConfig->getTrapReg(TrapConfig::kTPFP, mDetector, mRobPos, mMcmPos);
+
   if (mgStoreClusters) {
     timebin1 = 0;
     timebin2 = mNTimeBin;
   } else {
     // find first timebin to be looked at
-    timebin1 = mTrapConfig->getTrapReg(TrapConfig::kTPFS, mDetector, mRobPos, mMcmPos);
-    if (mTrapConfig->getTrapReg(TrapConfig::kTPQS0, mDetector, mRobPos, mMcmPos) < timebin1) {
-      timebin1 = mTrapConfig->getTrapReg(TrapConfig::kTPQS0, mDetector, mRobPos, mMcmPos);
-    }
-    if (mTrapConfig->getTrapReg(TrapConfig::kTPQS1, mDetector, mRobPos, mMcmPos) < timebin1) {
-      timebin1 = mTrapConfig->getTrapReg(TrapConfig::kTPQS1, mDetector, mRobPos, mMcmPos);
-    }
-
+    timebin1 = std::min({windows.mFitStart, windows.mQ0Start, windows.mQ1Start});
     // find last timebin to be looked at
-    timebin2 = mTrapConfig->getTrapReg(TrapConfig::kTPFE, mDetector, mRobPos, mMcmPos);
-    if (mTrapConfig->getTrapReg(TrapConfig::kTPQE0, mDetector, mRobPos, mMcmPos) > timebin2) {
-      timebin2 = mTrapConfig->getTrapReg(TrapConfig::kTPQE0, mDetector, mRobPos, mMcmPos);
-    }
-    if (mTrapConfig->getTrapReg(TrapConfig::kTPQE1, mDetector, mRobPos, mMcmPos) > timebin2) {
-      timebin2 = mTrapConfig->getTrapReg(TrapConfig::kTPQE1, mDetector, mRobPos, mMcmPos);
-    }
+    timebin2 = std::max({windows.mFitEnd, windows.mQ0End, windows.mQ1End});
   }
 
   // reset the fit registers
@@ -1565,53 +1635,22 @@ void TrapSimulator::calcFitreg()
   }
   mNHits = 0;
 
+  std::array<int, NADCMCM> adcTimebin; // filtered ADC values of all channels for the current timebin
   for (timebin = timebin1; timebin < timebin2; timebin++) {
     // first find the hit candidates and store the total cluster charge in qTotal array
     // in case of not hit store 0 there.
-    for (adcch = 0; adcch < NADCMCM - 2; adcch++) {
-      if (((adcMask >> adcch) & 7) == 7) //??? all 3 channels are present in case of ZS
-      {
-        adcLeft = mADCF[adcch * mNTimeBin + timebin];
-        adcCentral = mADCF[(adcch + 1) * mNTimeBin + timebin];
-        adcRight = mADCF[(adcch + 2) * mNTimeBin + timebin];
-
-        if (mTrapConfig->getTrapReg(TrapConfig::kTPVBY, mDetector, mRobPos, mMcmPos) == 0) {
-          // bypass the cluster verification
-          hitQual = true;
-        } else {
-          hitQual = ((adcLeft * adcRight) <
-                     ((mTrapConfig->getTrapReg(TrapConfig::kTPVT, mDetector, mRobPos, mMcmPos) * adcCentral * adcCentral) >> 10));
-          if (hitQual) {
-            LOG(debug) << "cluster quality cut passed with " << adcLeft << ", " << adcCentral << ", "
-                       << adcRight << " - threshold " << mTrapConfig->getTrapReg(TrapConfig::kTPVT, mDetector, mRobPos, mMcmPos)
-                       << " -> " << mTrapConfig->getTrapReg(TrapConfig::kTPVT, mDetector, mRobPos, mMcmPos) * adcCentral * adcCentral;
-          }
-        }
-
-        // The accumulated charge is with the pedestal!!!
-        qtotTemp = adcLeft + adcCentral + adcRight;
-        if ((qtotTemp > 130)) {
-          LOG(debug) << "qtotTemp>130 "
-                     << "qtot=" << qtotTemp
-                     << " qleft=" << adcLeft
-                     << " qcent=" << adcCentral
-                     << " qright=" << adcRight
-                     << " for " << mDetector << ":" << mRobPos << ":" << mMcmPos << ":adcleft:" << adcch << ":t" << timebin;
-        }
-
-        if ((hitQual) &&
-            (qtotTemp >= mTrapConfig->getTrapReg(TrapConfig::kTPHT, mDetector, mRobPos, mMcmPos)) &&
-            (adcLeft <= adcCentral) &&
-            (adcCentral > adcRight)) {
-          qTotal[adcch] = qtotTemp;
-        } else {
-          qTotal[adcch] = 0;
-        }
-      } else {
-        qTotal[adcch] = 0; //jkl
-      }
-      //     if (qTotal[adcch] != 0)
-      //     LOG(debug) << "ch " << setw(2) << adcch << "   qTotal " << qTotal[adcch];
+    // All channels are present (no zero suppression), the candidates are searched
+    // for all channels at once in a branch-free loop.
+    for (adcch = 0; adcch < NADCMCM; adcch++) {
+      adcTimebin[adcch] = mADCF[adcch * mNTimeBin + timebin];
+    }
+    for (int ch = 0; ch < NADCMCM - 2; ch++) {
+      int left = adcTimebin[ch], central = adcTimebin[ch + 1], right = adcTimebin[ch + 2];
+      // bypass or apply the cluster verification
+      bool qual = bypassVerification || ((left * right) < ((regTPVT * central * central) >> 10));
+      // The accumulated charge is with the pedestal!!!
+      unsigned short qtot = left + central + right;
+      qTotal[ch] = (qual && (qtot >= regTPHT) && (left <= central) && (central > right)) ? qtot : 0;
     }
 
     fromLeft = -1;
@@ -1688,16 +1727,15 @@ void TrapSimulator::calcFitreg()
     for (adcch = 0; adcch < 19; adcch++) {
       if (qTotal[adcch] > 0) // the channel is marked for processing
       {
-        adcLeft = getDataFiltered(adcch, timebin);
-        adcCentral = getDataFiltered(adcch + 1, timebin);
-        adcRight = getDataFiltered(adcch + 2, timebin);
+        adcLeft = adcTimebin[adcch];
+        adcCentral = adcTimebin[adcch + 1];
+        adcRight = adcTimebin[adcch + 2];
         // hit detected, in TRAP we have 4 units and a hit-selection, here we proceed all channels!
         // subtract the pedestal TPFP, clipping instead of wrapping
 
-        int regTPFP = mTrapConfig->getTrapReg(TrapConfig::kTPFP, mDetector, mRobPos, mMcmPos); //TODO put this together with the others as members of trapsim, which is initiliased by det,rob,mcm.
         LOG(debug) << "Hit found, time=" << timebin << ", adcch=" << adcch << "/" << adcch + 1 << "/"
                    << adcch + 2 << ", adc values=" << adcLeft << "/" << adcCentral << "/"
-                   << adcRight << ", regTPFP=" << regTPFP << ", TPHT=" << mTrapConfig->getTrapReg(TrapConfig::kTPHT, mDetector, mRobPos, mMcmPos);
+                   << adcRight << ", regTPFP=" << regTPFP << ", TPHT=" << regTPHT;
         if (adcLeft < regTPFP) {
           adcLeft = 0;
         } else {
@@ -1740,7 +1778,7 @@ void TrapSimulator::calcFitreg()
         //      LOG(debug) << "calling addHitToFitreg with :" << adcch << " :: " << timebin << " :: " << hex << qTotal[adcch] << dec << " :: shifted bits  :" << 2 << " :: " << ypos;
         //  addHitToFitreg(adcch, timebin, qTotal[adcch] >> 2, ypos);
         LOG(debug) << __func__ << "ADDING HIT with adcch of " << adcch << " qtot : " << qTotal[adcch] << " timebin :" << timebin << " and ypos:" << ypos;
-        addHitToFitreg(adcch, timebin, qTotal[adcch] >> mgkAddDigits, ypos);
+        addHitToFitreg(adcch, timebin, qTotal[adcch] >> mgkAddDigits, ypos, windows);
       }
     }
   }
@@ -1765,10 +1803,12 @@ void TrapSimulator::trackletSelection()
   std::array<unsigned short, 18> trackletCandch{};   // store the adcch for all tracklet candidates
   std::array<unsigned short, 18> trackletCandhits{}; // store the number of hits for all tracklet candidates
 
+  const int regTPCL = mTrapConfig->getTrapReg(TrapConfig::kTPCL, mDetector, mRobPos, mMcmPos);
+  const int regTPCT = mTrapConfig->getTrapReg(TrapConfig::kTPCT, mDetector, mRobPos, mMcmPos);
   ntracks = 0;
   for (adcIdx = 0; adcIdx < 18; adcIdx++) { // ADCs
-    if ((mFitReg[adcIdx].mNhits >= mTrapConfig->getTrapReg(TrapConfig::kTPCL, mDetector, mRobPos, mMcmPos)) &&
-        (mFitReg[adcIdx].mNhits + mFitReg[adcIdx + 1].mNhits >= mTrapConfig->getTrapReg(TrapConfig::kTPCT, mDetector, mRobPos, mMcmPos))) {
+    if ((mFitReg[adcIdx].mNhits >= regTPCL) &&
+        (mFitReg[adcIdx].mNhits + mFitReg[adcIdx + 1].mNhits >= regTPCT)) {
       trackletCandch[ntracks] = adcIdx;
       trackletCandhits[ntracks] = mFitReg[adcIdx].mNhits + mFitReg[adcIdx + 1].mNhits;
       //   LOG(debug) << ntracks << " " << trackletCandch[ntracks] << " " << trackletCandhits[ntracks];
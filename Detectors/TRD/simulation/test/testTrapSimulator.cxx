@@ -0,0 +1,89 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test TRD TrapSimulator
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "DataFormatsTRD/Constants.h"
+#include "DataFormatsTRD/Digit.h"
+#include "TRDSimulation/TrapConfig.h"
+#include "TRDSimulation/TrapSimulator.h"
+
+#include <random>
+#include <vector>
+
+namespace o2
+{
+namespace trd
+{
+
+void fillMCM(TrapSimulator& trap, std::mt19937& gen)
+{
+  // baseline of 10 ADC counts with some noise and a few signals
+  std::uniform_int_distribution<int> noise(7, 13), signal(0, 1000);
+  for (int adc = 0; adc < constants::NADCMCM; ++adc) {
+    ArrayADC data;
+    for (int tb = 0; tb < constants::TIMEBINS; ++tb) {
+      data[tb] = noise(gen);
+    }
+    if (adc % 4 == 1) {
+      for (int tb = 5; tb < 20; ++tb) {
+        data[tb] += signal(gen);
+      }
+    }
+    trap.setData(adc, data, adc);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TRDTrapSimulatorFilter_test)
+{
+  // check that the filter chain applied to all channels at once gives the same
+  // result as feeding the samples one by one to the individual filters
+  const int det = 0, rob = 0, mcm = 0;
+  TrapConfig config;
+  config.setTrapReg(TrapConfig::kC13CPUA, constants::TIMEBINS, det, rob, mcm);
+  config.setTrapReg(TrapConfig::kFPBY, 1, det, rob, mcm); // enable the pedestal filter
+  config.setTrapReg(TrapConfig::kFTBY, 1, det, rob, mcm); // enable the tail filter
+
+  std::mt19937 gen(12345);
+  TrapSimulator trap, reference;
+  for (int iMCM = 0; iMCM < 3; ++iMCM) {
+    // the simulators are reused, as in the TRAP simulator workflow
+    trap.init(&config, det, rob, mcm);
+    reference.init(&config, det, rob, mcm);
+    auto seed = gen();
+    std::mt19937 gen1(seed), gen2(seed);
+    fillMCM(trap, gen1);
+    fillMCM(reference, gen2);
+
+    trap.filter();
+
+    std::vector<int> expected(constants::NADCMCM * constants::TIMEBINS);
+    for (int tb = 0; tb < constants::TIMEBINS; ++tb) {
+      for (int adc = 0; adc < constants::NADCMCM; ++adc) {
+        unsigned short value = reference.filterPedestalNextSample(adc, tb, reference.getDataRaw(adc, tb));
+        expected[adc * constants::TIMEBINS + tb] = reference.filterTailNextSample(adc, value);
+      }
+    }
+    for (int adc = 0; adc < constants::NADCMCM; ++adc) {
+      for (int tb = 0; tb < constants::TIMEBINS; ++tb) {
+        BOOST_CHECK_EQUAL(trap.getDataFiltered(adc, tb), expected[adc * constants::TIMEBINS + tb]);
+      }
+    }
+    trap.reset();
+    reference.reset();
+  }
+}
+
+} // namespace trd
+} // namespace o2
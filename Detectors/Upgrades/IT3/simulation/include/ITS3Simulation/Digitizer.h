@@ -15,7 +15,6 @@
 #define ALICEO2_ITS3_DIGITIZER_H
 
 #include <vector>
-#include <deque>
 #include <memory>
 
 #include "Rtypes.h"  // for Digitizer::Class
@@ -45,8 +44,6 @@ namespace its3
 {
 class Digitizer : public TObject
 {
-  using ExtraDig = std::vector<itsmft::PreDigitLabelRef>; ///< container for extra contributions to PreDigits
-
  public:
   Digitizer() = default;
   ~Digitizer() override = default;
@@ -94,18 +91,6 @@ class Digitizer : public TObject
   void registerDigits(o2::itsmft::ChipDigitsContainer& chip, uint32_t roFrame, float tInROF, int nROF,
                       uint16_t row, uint16_t col, int nEle, o2::MCCompLabel& lbl);
 
-  ExtraDig* getExtraDigBuffer(uint32_t roFrame)
-  {
-    if (mROFrameMin > roFrame) {
-      return nullptr; // nothing to do
-    }
-    int ind = roFrame - mROFrameMin;
-    while (ind >= int(mExtraBuff.size())) {
-      mExtraBuff.emplace_back(std::make_unique<ExtraDig>());
-    }
-    return mExtraBuff[ind].get();
-  }
-
   std::vector<SegmentationSuperAlpide> mSuperSegmentations;
   static constexpr float sec2ns = 1e9;
 
@@ -125,13 +110,12 @@ class Digitizer : public TObject
   const o2::its3::GeometryTGeo* mGeometry = nullptr; ///< ITS OR MFT upgrade geometry
 
   std::vector<o2::itsmft::ChipDigitsContainer> mChips; ///< Array of chips digits containers
-  std::deque<std::unique_ptr<ExtraDig>> mExtraBuff;    ///< burrer (per roFrame) for extra digits
 
   std::vector<o2::itsmft::Digit>* mDigits = nullptr;                       //! output digits
   std::vector<o2::itsmft::ROFRecord>* mROFRecords = nullptr;               //! output ROF records
   o2::dataformats::MCTruthContainer<o2::MCCompLabel>* mMCLabels = nullptr; //! output labels
 
-  ClassDefOverride(Digitizer, 2);
+  ClassDefOverride(Digitizer, 3);
 };
 } // namespace its3
 } // namespace o2
@@ -126,9 +126,6 @@ void Digitizer::fillOutputContainer(uint32_t frameLast)
   if (frameLast > mROFrameMax) {
     frameLast = mROFrameMax;
   }
-  // make sure all buffers for extra digits are created up to the maxFrame
-  getExtraDigBuffer(mROFrameMax);
-
   LOG(INFO) << "Filling " << mGeometry->getName() << " digits output for RO frames " << mROFrameMin << ":"
             << frameLast;
 
@@ -139,7 +136,6 @@ void Digitizer::fillOutputContainer(uint32_t frameLast)
     rcROF.setROFrame(mROFrameMin);
     rcROF.setFirstEntry(mDigits->size()); // start of current ROF in digits
 
-    auto& extra = *(mExtraBuff.front().get());
     for (int iChip{0}; iChip < mChips.size(); ++iChip) {
       auto& chip = mChips[iChip];
       if (iChip < SegmentationSuperAlpide::NLayers) {
@@ -147,30 +143,24 @@ void Digitizer::fillOutputContainer(uint32_t frameLast)
       } else {
         chip.addNoise(mROFrameMin, mROFrameMin, &mParams);
       }
-      auto& buffer = chip.getPreDigits();
-      if (buffer.empty()) {
+      if (chip.isEmpty()) {
         continue;
       }
-      auto itBeg = buffer.begin();
-      auto iter = itBeg;
+      auto& buffer = chip.getPreDigits();
       ULong64_t maxKey = chip.getOrderingKey(mROFrameMin + 1, 0, 0) - 1; // fetch digits with key below that
-      for (; iter != buffer.end(); ++iter) {
-        if (iter->first > maxKey) {
-          break; // is the digit ROFrame from the key > the max requested frame
-        }
-        auto& preDig = iter->second; // preDigit
+      size_t nPreDigits = chip.sortPreDigits(maxKey);
+      for (size_t i = 0; i < nPreDigits; i++) {
+        const auto& preDig = buffer[i]; // preDigit
         if (preDig.charge >= mParams.getChargeThreshold()) {
           int digID = mDigits->size();
           mDigits->emplace_back(chip.getChipIndex(), preDig.row, preDig.col, preDig.charge);
           mMCLabels->addElement(digID, preDig.labelRef.label);
-          auto& nextRef = preDig.labelRef; // extra contributors are in extra array
-          while (nextRef.next >= 0) {
-            nextRef = extra[nextRef.next];
-            mMCLabels->addElement(digID, nextRef.label);
+          for (int next = preDig.labelRef.next; next >= 0; next = chip.getExtraLabel(next).next) { // extra contributors
+            mMCLabels->addElement(digID, chip.getExtraLabel(next).label);
           }
         }
       }
-      buffer.erase(itBeg, iter);
+      chip.removePreDigits(nPreDigits);
     }
     // finalize ROF record
     rcROF.setNEntries(mDigits->size() - rcROF.getFirstEntry()); // number of digits
@@ -182,10 +172,6 @@ void Digitizer::fillOutputContainer(uint32_t frameLast)
     if (mROFRecords) {
       mROFRecords->push_back(rcROF);
     }
-    extra.clear(); // clear container for extra digits of the mROFrameMin ROFrame
-    // and move it as a new slot in the end
-    mExtraBuff.emplace_back(mExtraBuff.front().release());
-    mExtraBuff.pop_front();
   }
 }
 
@@ -423,25 +409,7 @@ void Digitizer::registerDigits(o2::itsmft::ChipDigitsContainer& chip, uint32_t r
       chip.addDigit(key, roFr, row, col, nEleROF, lbl);
     } else { // there is already a digit at this slot, account as PreDigitExtra contribution
       pd->charge += nEleROF;
-      if (pd->labelRef.label == lbl) { // don't store the same label twice
-        continue;
-      }
-      ExtraDig* extra = getExtraDigBuffer(roFr);
-      int& nxt = pd->labelRef.next;
-      bool skip = false;
-      while (nxt >= 0) {
-        if ((*extra)[nxt].label == lbl) { // don't store the same label twice
-          skip = true;
-          break;
-        }
-        nxt = (*extra)[nxt].next;
-      }
-      if (skip) {
-        continue;
-      }
-      // new predigit will be added in the end of the chain
-      nxt = extra->size();
-      extra->emplace_back(lbl);
+      chip.addLabel(*pd, lbl);
     }
   }
 }
@@ -179,6 +179,7 @@ class DCAFitterN
   float getMaxDXYIni() const { return mMaxDXYIni; }
   float getMaxChi2() const { return mMaxChi2; }
   float getMinParamChange() const { return mMinParamChange; }
+  float getMinRelChi2Change() const { return mMinRelChi2Change; }
   float getBz() const { return mBz; }
   float getMaxDistance2ToMerge() const { return mMaxDist2ToMergeSeeds; }
   bool getUseAbsDCA() const { return mUseAbsDCA; }
@@ -186,9 +187,14 @@ class DCAFitterN
 
   template <class... Tr>
   int process(const Tr&... args);
+  ///< same as process(args...) with the helix circles of the tracks precomputed for the Bz of the fitter,
+  ///< e.g. once per track when testing all combinations of a set of tracks
+  template <class... Tr>
+  int process(const std::array<const TrackAuxPar*, N>& aux, const Tr&... args);
   void print() const;
 
  protected:
+  int fitCrossings();
   bool calcPCACoefs();
   bool calcInverseWeight();
   void calcResidDerivatives();
@@ -315,6 +321,29 @@ int DCAFitterN<N, Args...>::process(const Tr&... args)
   for (int i = 0; i < N; i++) {
     mTrAux[i].set(*mOrigTrPtr[i], mBz);
   }
+  return fitCrossings();
+}
+
+///_________________________________________________________________________
+template <int N, typename... Args>
+template <class... Tr>
+int DCAFitterN<N, Args...>::process(const std::array<const TrackAuxPar*, N>& aux, const Tr&... args)
+{
+  // fit PCA of N tracks with precalculated helix circles
+  static_assert(sizeof...(args) == N, "incorrect number of input tracks");
+  assign(0, args...);
+  clear();
+  for (int i = 0; i < N; i++) {
+    mTrAux[i] = *aux[i];
+  }
+  return fitCrossings();
+}
+
+///_________________________________________________________________________
+template <int N, typename... Args>
+int DCAFitterN<N, Args...>::fitCrossings()
+{
+  // find the crossings of the helix circles of the tracks and fit the PCA from each acceptable one
   if (!mCrossings.set(mTrAux[0], *mOrigTrPtr[0], mTrAux[1], *mOrigTrPtr[1], mMaxDXYIni)) { // even for N>2 it should be enough to test just 1 loop
     return 0;                                                                  // no crossing
   }
@@ -0,0 +1,839 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file DCAFitterNBatch.h
+/// \brief Batched N-prongs secondary vertex fit, many candidates being minimized in lockstep
+
+#ifndef _ALICEO2_DCA_FITTERN_BATCH_
+#define _ALICEO2_DCA_FITTERN_BATCH_
+
+#include "DetectorsVertexing/DCAFitterN.h"
+#include <algorithm>
+#include <vector>
+
+namespace o2
+{
+namespace vertexing
+{
+
+/// Fitter of the PCA of many N-prong candidates, giving the same results as DCAFitterN<N>::process
+/// called for each of them (up to the precision of value_T).
+///
+/// The seeding (crossing of the helices, propagation of the tracks to the seed, inverse covariances,
+/// track derivatives) and the final propagation to the PCA are done per candidate, exactly as in
+/// DCAFitterN. The Newton iterations of NLanes vertex hypotheses are then performed in lockstep: the
+/// residuals, the chi2 derivatives and the solution of the N x N system are stored as structures of
+/// arrays over the lanes, so that the loops over the lanes can be vectorised by the compiler.
+/// A lane whose hypothesis converged (or failed) is frozen until all the lanes of its batch are done.
+///
+/// Usage:
+///   DCAFitterNBatch<2> ft;
+///   ft.setFrom(scalarFitter);  // or the same setters as DCAFitterN
+///   std::vector<DCAFitterNBatch<2>::Candidate> cands; // {&trackPos, &trackNeg} pairs
+///   std::vector<DCAFitterNBatch<2>::Result> res;
+///   ft.process(cands, res);
+template <int N, typename value_T = float, int NLanes = 8>
+class DCAFitterNBatch
+{
+  static constexpr int NMin = 2;
+  static constexpr int NMax = 4;
+  static constexpr double NInv = 1. / N;
+  static constexpr int MAXHYP = 2;
+  static constexpr float XerrFactor = 5.; // factor for conversion of track covYY to dummy covXX
+  static constexpr int CandBlock = 16 * NLanes; // number of candidates seeded together
+  using Track = o2::track::TrackParCov;
+  using TrackAuxPar = o2::track::TrackAuxPar;
+  using CrossInfo = o2::track::CrossInfo;
+  using MatSym3D = ROOT::Math::SMatrix<double, 3, 3, ROOT::Math::MatRepSym<double, 3>>;
+  using MatStd3D = ROOT::Math::SMatrix<double, 3, 3, ROOT::Math::MatRepStd<double, 3>>;
+
+ public:
+  using value_t = value_T;
+  static constexpr int getNProngs() { return N; }
+  static constexpr int getNLanes() { return NLanes; }
+
+  ///< N-prong candidate to fit
+  struct Candidate {
+    std::array<const Track*, N> tracks{};
+  };
+
+  ///< vertex candidates found for an N-prong candidate, ordered in quality as for DCAFitterN
+  struct Result {
+    int nCand = 0;                                         // number of vertex candidates
+    std::array<std::array<double, 3>, MAXHYP> pca{};       // PCA of each vertex candidate
+    std::array<float, MAXHYP> chi2{};                      // chi2 at PCA candidate
+    std::array<int, MAXHYP> nIters{};                      // number of iterations of the minimization
+    std::array<std::array<float, 6>, MAXHYP> pcaCov{};     // PCA covariance {xx, yx, yy, zx, zy, zz}
+    std::array<std::array<Track, N>, MAXHYP> tracks;       // prongs at the PCA if propagated to it, at the seed otherwise
+    std::array<bool, MAXHYP> trPropDone{};                 // flag that the tracks are propagated to the PCA
+
+    int getNCandidates() const { return nCand; }
+    std::array<float, 3> getPCACandidatePos(int cand = 0) const { return {float(pca[cand][0]), float(pca[cand][1]), float(pca[cand][2])}; }
+    float getChi2AtPCACandidate(int cand = 0) const { return chi2[cand]; }
+    int getNIterations(int cand = 0) const { return nIters[cand]; }
+    const Track& getTrack(int i, int cand = 0) const { return tracks[cand][i]; }
+  };
+
+  DCAFitterNBatch()
+  {
+    static_assert(N >= NMin && N <= NMax, "N prongs outside of allowed range");
+  }
+  DCAFitterNBatch(float bz, bool useAbsDCA, bool prop2DCA) : DCAFitterNBatch()
+  {
+    mBz = bz;
+    mUseAbsDCA = useAbsDCA;
+    mPropagateToPCA = prop2DCA;
+  }
+
+  ///< take over the settings of a scalar fitter
+  template <typename... Args>
+  void setFrom(const DCAFitterN<N, Args...>& ft)
+  {
+    setBz(ft.getBz());
+    setUseAbsDCA(ft.getUseAbsDCA());
+    setPropagateToPCA(ft.getPropagateToPCA());
+    setMaxIter(ft.getMaxIter());
+    setMaxR(ft.getMaxR());
+    setMaxDZIni(ft.getMaxDZIni());
+    setMaxDXYIni(ft.getMaxDXYIni());
+    setMaxChi2(ft.getMaxChi2());
+    setMinParamChange(ft.getMinParamChange());
+    setMinRelChi2Change(ft.getMinRelChi2Change());
+    setMaxDistance2ToMerge(ft.getMaxDistance2ToMerge());
+  }
+
+  void setPropagateToPCA(bool v = true) { mPropagateToPCA = v; }
+  void setMaxIter(int n = 20) { mMaxIter = n > 2 ? n : 2; }
+  void setMaxR(float r = 200.) { mMaxR2 = r * r; }
+  void setMaxDZIni(float d = 4.) { mMaxDZIni = d; }
+  void setMaxDXYIni(float d = 4.) { mMaxDXYIni = d > 0 ? d : 1e9; }
+  void setMaxChi2(float chi2 = 999.) { mMaxChi2 = chi2; }
+  void setBz(float bz) { mBz = std::abs(bz) > o2::constants::math::Almost0 ? bz : 0.f; }
+  void setMinParamChange(float x = 1e-3) { mMinParamChange = x > 1e-4 ? x : 1.e-4; }
+  void setMinRelChi2Change(float r = 0.9) { mMinRelChi2Change = r > 0.1 ? r : 999.; }
+  void setUseAbsDCA(bool v) { mUseAbsDCA = v; }
+  void setMaxDistance2ToMerge(float v) { mMaxDist2ToMergeSeeds = v; }
+
+  int getMaxIter() const { return mMaxIter; }
+  float getMaxR() const { return std::sqrt(mMaxR2); }
+  float getMaxDZIni() const { return mMaxDZIni; }
+  float getMaxDXYIni() const { return mMaxDXYIni; }
+  float getMaxChi2() const { return mMaxChi2; }
+  float getMinParamChange() const { return mMinParamChange; }
+  float getMinRelChi2Change() const { return mMinRelChi2Change; }
+  float getBz() const { return mBz; }
+  float getMaxDistance2ToMerge() const { return mMaxDist2ToMergeSeeds; }
+  bool getUseAbsDCA() const { return mUseAbsDCA; }
+  bool getPropagateToPCA() const { return mPropagateToPCA; }
+
+  ///< fit n candidates, filling n results; return the total number of vertex candidates found
+  int process(const Candidate* cands, Result* results, size_t n);
+
+  int process(const std::vector<Candidate>& cands, std::vector<Result>& results)
+  {
+    results.resize(cands.size());
+    return process(cands.data(), results.data(), cands.size());
+  }
+
+  void print() const;
+
+ private:
+  enum LaneStatus : int { Active,
+                          Converged,
+                          InversionFailed,
+                          AltPreferred };
+
+  ///< seeding information of a candidate
+  struct CandState {
+    std::array<TrackAuxPar, N> aux; // Aux track info
+    CrossInfo crossings;            // info on track crossing
+    bool allowAltPreference = true; // if the fit converges to alternative PCA seed, abandon the current one
+  };
+
+  ///< hypotheses being minimized, stored as structure of arrays over the lanes
+  struct Lanes {
+    value_t c[N][NLanes], s[N][NLanes];                               // cos and sin of track alpha
+    value_t sxx[N][NLanes], syy[N][NLanes], syz[N][NLanes], szz[N][NLanes]; // inverse cov.matrices of tracks at the seed
+    value_t tcf[N][3][3][NLanes];                                     // TrackCoefVtx matrices
+    value_t dydx[N][NLanes], dzdx[N][NLanes], d2ydx2[N][NLanes], d2zdx2[N][NLanes]; // track derivatives over X
+    value_t dr1[N][N][3][NLanes];                                     // 1st derivatives of residual i over X of track j
+    value_t dr2[N][N][3][NLanes];                                     // 2nd derivatives of residual i over X of track j
+    value_t pos[N][3][NLanes];                                        // track positions
+    value_t res[N][3][NLanes];                                        // track residuals
+    value_t pca[3][NLanes];                                           // current PCA
+    value_t dchi1[N][NLanes];                                         // 1st derivatives of chi2
+    value_t dchi2[N][N][NLanes];                                      // 2nd derivatives of chi2 (lower triangle)
+    value_t dx[N][NLanes];                                            // Newton corrections of X params
+    value_t xCur[NLanes], yCur[NLanes], xAlt[NLanes], yAlt[NLanes];   // current and alternative seeds
+    float chi2[NLanes], chi2Upd[NLanes];
+    int nIters[NLanes];
+    int status[NLanes];
+    bool hasAlt[NLanes];
+  };
+
+  void seedCandidate(const Candidate& cand, CandState& st, Result& res);
+  bool stageHypothesis(int lane, const Candidate& cand, const CandState& st, int ic);
+  void fitLanes(int nLanes);
+  void finalizeLane(int lane, const Candidate& cand, CandState& st, Result& res);
+  void calcResidDerivatives();
+  void calcResidDerivativesNoErr();
+  void calcChi2Derivatives();
+  void calcChi2DerivativesNoErr();
+  void solve(bool (&ok)[NLanes]);
+  void correctTracks();
+  void calcPCA();
+  void calcPCANoErr();
+  void calcTrackResiduals();
+  void calcChi2();
+  void calcChi2NoErr();
+
+  Lanes mLanes{};
+  std::array<std::array<Track, N>, NLanes> mLaneTracks; // tracks at the seed of each lane
+  std::array<size_t, NLanes> mLaneCand{};               // candidate (in the current block) of each lane
+  std::vector<CandState> mCandStates;                    // seeding info of the current block of candidates
+
+  bool mUseAbsDCA = false;          // use abs. distance minimization rather than chi2
+  bool mPropagateToPCA = true;      // create tracks version propagated to PCA
+  int mMaxIter = 20;                // max number of iterations
+  float mBz = 0;                    // bz field, to be set by user
+  float mMaxR2 = 200. * 200.;       // reject PCA's above this radius
+  float mMaxDZIni = 4.;             // reject (if>0) PCA candidate if tracks DZ exceeds threshold
+  float mMaxDXYIni = 4.;            // reject (if>0) PCA candidate if tracks dXY exceeds threshold
+  float mMinParamChange = 1e-3;     // stop iterations if largest change of any X is smaller than this
+  float mMinRelChi2Change = 0.9;    // stop iterations is chi2/chi2old > this
+  float mMaxChi2 = 100;             // abs cut on chi2 or abs distance
+  float mMaxDist2ToMergeSeeds = 1.; // merge 2 seeds to their average if their distance^2 is below the threshold
+};
+
+///_________________________________________________________________________
+template <int N, typename value_T, int NLanes>
+int DCAFitterNBatch<N, value_T, NLanes>::process(const Candidate* cands, Result* results, size_t n)
+{
+  // This is a main entry point: fit PCA of n candidates of N tracks
+  int nFound = 0;
+  mCandStates.resize(CandBlock);
+  for (size_t first = 0; first < n; first += CandBlock) {
+    size_t nBlock = std::min(n - first, size_t(CandBlock));
+    const auto* bcands = cands + first;
+    auto* bresults = results + first;
+    for (size_t k = 0; k < nBlock; k++) {
+      seedCandidate(bcands[k], mCandStates[k], bresults[k]);
+    }
+    // the 2nd seeds are processed after all 1st ones, since their alternative preference depends on them
+    for (int ic = 0; ic < MAXHYP; ic++) {
+      int nLanes = 0;
+      for (size_t k = 0; k <= nBlock; k++) {
+        if (k < nBlock && stageHypothesis(nLanes, bcands[k], mCandStates[k], ic)) {
+          mLaneCand[nLanes++] = k;
+        }
+        if (nLanes == NLanes || (k == nBlock && nLanes)) {
+          fitLanes(nLanes);
+          for (int l = 0; l < nLanes; l++) {
+            auto kc = mLaneCand[l];
+            finalizeLane(l, bcands[kc], mCandStates[kc], bresults[kc]);
+          }
+          nLanes = 0;
+        }
+      }
+    }
+    for (size_t k = 0; k < nBlock; k++) { // order in quality
+      auto& res = bresults[k];
+      if (res.nCand == MAXHYP && res.chi2[1] < res.chi2[0]) {
+        std::swap(res.pca[0], res.pca[1]);
+        std::swap(res.chi2[0], res.chi2[1]);
+        std::swap(res.nIters[0], res.nIters[1]);
+        std::swap(res.pcaCov[0], res.pcaCov[1]);
+        std::swap(res.tracks[0], res.tracks[1]);
+        std::swap(res.trPropDone[0], res.trPropDone[1]);
+      }
+      nFound += res.nCand;
+    }
+  }
+  return nFound;
+}
+
+//__________________________________________________________________________
+template <int N, typename value_T, int NLanes>
+void DCAFitterNBatch<N, value_T, NLanes>::seedCandidate(const Candidate& cand, CandState& st, Result& res)
+{
+  // find the seeds of the candidate, as in DCAFitterN::process
+  res.nCand = 0;
+  st.allowAltPreference = true;
+  st.crossings.nDCA = 0;
+  for (int i = 0; i < N; i++) {
+    st.aux[i].set(*cand.tracks[i], mBz);
+  }
+  if (!st.crossings.set(st.aux[0], *cand.tracks[0], st.aux[1], *cand.tracks[1], mMaxDXYIni)) {
+    st.crossings.nDCA = 0; // no crossing
+    return;
+  }
+  auto& cr = st.crossings;
+  if (cr.nDCA == MAXHYP) { // if there are 2 candidates and they are too close, chose their mean as a starting point
+    auto dst2 = (cr.xDCA[0] - cr.xDCA[1]) * (cr.xDCA[0] - cr.xDCA[1]) + (cr.yDCA[0] - cr.yDCA[1]) * (cr.yDCA[0] - cr.yDCA[1]);
+    if (dst2 < mMaxDist2ToMergeSeeds) {
+      cr.nDCA = 1;
+      cr.xDCA[0] = 0.5 * (cr.xDCA[0] + cr.xDCA[1]);
+      cr.yDCA[0] = 0.5 * (cr.yDCA[0] + cr.yDCA[1]);
+    }
+  }
+}
+
+//__________________________________________________________________________
+template <int N, typename value_T, int NLanes>
+bool DCAFitterNBatch<N, value_T, NLanes>::stageHypothesis(int l, const Candidate& cand, const CandState& st, int ic)
+{
+  // prepare the minimization of the seed ic of the candidate in the lane l
+  const auto& cr = st.crossings;
+  if (ic >= cr.nDCA || cr.xDCA[ic] * cr.xDCA[ic] + cr.yDCA[ic] * cr.yDCA[ic] > mMaxR2) {
+    return false;
+  }
+  auto& ln = mLanes;
+  auto& trcs = mLaneTracks[l];
+  for (int i = N; i--;) {
+    const auto& taux = st.aux[i];
+    trcs[i] = *cand.tracks[i];
+    auto x = taux.c * cr.xDCA[ic] + taux.s * cr.yDCA[ic]; // X of PCA in the track frame
+    if (!(mUseAbsDCA ? trcs[i].propagateParamTo(x, mBz) : trcs[i].propagateTo(x, mBz))) {
+      return false;
+    }
+  }
+  if (mMaxDZIni > 0) { // apply rough cut on tracks Z difference
+    for (int i = N; i--;) {
+      for (int j = i; j--;) {
+        if (std::abs(trcs[i].getZ() - trcs[j].getZ()) > mMaxDZIni) {
+          return false;
+        }
+      }
+    }
+  }
+  for (int i = N; i--;) {
+    TrackDeriv der(trcs[i], mBz);
+    ln.c[i][l] = st.aux[i].c;
+    ln.s[i][l] = st.aux[i].s;
+    ln.pos[i][0][l] = trcs[i].getX();
+    ln.pos[i][1][l] = trcs[i].getY();
+    ln.pos[i][2][l] = trcs[i].getZ();
+    ln.dydx[i][l] = der.dydx;
+    ln.dzdx[i][l] = der.dzdx;
+    ln.d2ydx2[i][l] = der.d2ydx2;
+    ln.d2zdx2[i][l] = der.d2zdx2;
+  }
+  if (!mUseAbsDCA) {
+    // inverse cov.matrices at starting point and Ti matrices for global vertex decomposition, see EQ.T in the ref
+    std::array<TrackCovI, N> covI;
+    MatSym3D weightInv;
+    for (int i = N; i--;) {
+      const auto& taux = st.aux[i];
+      auto& tcov = covI[i];
+      tcov.set(trcs[i], XerrFactor);
+      weightInv(0, 0) += taux.cc * tcov.sxx + taux.ss * tcov.syy;
+      weightInv(1, 0) += taux.cs * (tcov.sxx - tcov.syy);
+      weightInv(2, 0) += -taux.s * tcov.syz;
+      weightInv(1, 1) += taux.cc * tcov.syy + taux.ss * tcov.sxx;
+      weightInv(2, 1) += taux.c * tcov.syz;
+      weightInv(2, 2) += tcov.szz;
+      ln.sxx[i][l] = tcov.sxx;
+      ln.syy[i][l] = tcov.syy;
+      ln.syz[i][l] = tcov.syz;
+      ln.szz[i][l] = tcov.szz;
+    }
+    if (!weightInv.Invert()) {
+      return false;
+    }
+    for (int i = N; i--;) {
+      const auto& taux = st.aux[i];
+      const auto& tcov = covI[i];
+      MatStd3D miei;
+      miei[0][0] = taux.c * tcov.sxx;
+      miei[0][1] = -taux.s * tcov.syy;
+      miei[0][2] = -taux.s * tcov.syz;
+      miei[1][0] = taux.s * tcov.sxx;
+      miei[1][1] = taux.c * tcov.syy;
+      miei[1][2] = taux.c * tcov.syz;
+      miei[2][1] = tcov.syz;
+      miei[2][2] = tcov.szz;
+      MatStd3D tcf = weightInv * miei;
+      for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) {
+          ln.tcf[i][r][c][l] = tcf(r, c);
+        }
+      }
+    }
+  }
+  int icAlt = (cr.nDCA == 2 && st.allowAltPreference) ? 1 - ic : -1; // works for max 2 crossings
+  ln.xCur[l] = cr.xDCA[ic];
+  ln.yCur[l] = cr.yDCA[ic];
+  ln.hasAlt[l] = icAlt >= 0;
+  ln.xAlt[l] = icAlt >= 0 ? cr.xDCA[icAlt] : 0.f;
+  ln.yAlt[l] = icAlt >= 0 ? cr.yDCA[icAlt] : 0.f;
+  ln.nIters[l] = 0;
+  ln.status[l] = Active;
+  return true;
+}
+
+//__________________________________________________________________________
+template <int N, typename value_T, int NLanes>
+void DCAFitterNBatch<N, value_T, NLanes>::fitLanes(int nLanes)
+{
+  // minimize the chi2 (weighted or absolute DCA) of all staged hypotheses in lockstep,
+  // with the same stopping conditions as DCAFitterN::minimizeChi2
+  auto& ln = mLanes;
+  for (int l = nLanes; l < NLanes; l++) {
+    ln.status[l] = Converged; // unused lanes are frozen from the start
+  }
+  // the track derivatives are taken at the seed, hence the residual derivatives are constant
+  if (mUseAbsDCA) {
+    calcResidDerivativesNoErr();
+    calcPCANoErr();
+  } else {
+    calcResidDerivatives();
+    calcPCA();
+  }
+  calcTrackResiduals();
+  mUseAbsDCA ? calcChi2NoErr() : calcChi2();
+  for (int l = 0; l < NLanes; l++) {
+    ln.chi2[l] = ln.chi2Upd[l];
+  }
+
+  bool anyActive = nLanes > 0;
+  while (anyActive) {
+    // do Newton-Rapson iteration with corrections = - dchi2/d{x0..xN} * [ d^2chi2/d{x0..xN}^2 ]^-1
+    mUseAbsDCA ? calcChi2DerivativesNoErr() : calcChi2Derivatives();
+    bool ok[NLanes];
+    solve(ok);
+    for (int l = 0; l < NLanes; l++) {
+      if (ln.status[l] == Active && !ok[l]) {
+        ln.status[l] = InversionFailed;
+      }
+      bool keep = ln.status[l] == Active; // frozen lanes are not moved
+      for (int i = 0; i < N; i++) {
+        ln.dx[i][l] = keep ? ln.dx[i][l] : value_t(0);
+      }
+    }
+    correctTracks();
+    mUseAbsDCA ? calcPCANoErr() : calcPCA(); // updated PCA
+    for (int l = 0; l < NLanes; l++) {
+      if (ln.status[l] == Active && ln.hasAlt[l]) { // check if the PCA is closer to the alternative seed
+        auto dxCur = ln.pca[0][l] - ln.xCur[l], dyCur = ln.pca[1][l] - ln.yCur[l];
+        auto dxAlt = ln.pca[0][l] - ln.xAlt[l], dyAlt = ln.pca[1][l] - ln.yAlt[l];
+        if (dxCur * dxCur + dyCur * dyCur > dxAlt * dxAlt + dyAlt * dyAlt) {
+          ln.status[l] = AltPreferred;
+        }
+      }
+    }
+    calcTrackResiduals();                      // updated residuals
+    mUseAbsDCA ? calcChi2NoErr() : calcChi2(); // updated chi2
+    anyActive = false;
+    for (int l = 0; l < NLanes; l++) {
+      if (ln.status[l] != Active) {
+        continue;
+      }
+      value_t dxMax = -1;
+      for (int i = N; i--;) {
+        dxMax = std::max(dxMax, std::abs(ln.dx[i][l]));
+      }
+      bool converged = dxMax < mMinParamChange || ln.chi2Upd[l] > ln.chi2[l] * mMinRelChi2Change;
+      ln.chi2[l] = ln.chi2Upd[l];
+      if (converged || ++ln.nIters[l] >= mMaxIter) {
+        ln.status[l] = Converged;
+      } else {
+        anyActive = true;
+      }
+    }
+  }
+}
+
+//__________________________________________________________________________
+template <int N, typename value_T, int NLanes>
+void DCAFitterNBatch<N, value_T, NLanes>::finalizeLane(int l, const Candidate& cand, CandState& st, Result& res)
+{
+  // apply the chi2 cut to the minimized hypothesis and store it as a vertex candidate
+  const auto& ln = mLanes;
+  if (ln.status[l] == InversionFailed) {
+    LOG(ERROR) << "InversionFailed";
+    return;
+  }
+  if (ln.status[l] == AltPreferred) {
+    st.allowAltPreference = false;
+    return;
+  }
+  float chi2 = ln.chi2[l] * NInv;
+  if (!(chi2 < mMaxChi2)) {
+    return;
+  }
+  int ih = res.nCand;
+  auto& pca = res.pca[ih];
+  auto& trcs = res.tracks[ih];
+  for (int k = 0; k < 3; k++) {
+    pca[k] = ln.pca[k][l];
+  }
+  for (int i = N; i--;) {
+    trcs[i] = mLaneTracks[l][i];
+  }
+  if (mPropagateToPCA) {
+    for (int i = N; i--;) {
+      if (mUseAbsDCA) {
+        trcs[i] = *cand.tracks[i]; // fetch the track again, as it was propagated w/o errors
+      }
+      auto x = st.aux[i].c * pca[0] + st.aux[i].s * pca[1]; // X of PCA in the track frame
+      if (!trcs[i].propagateTo(x, mBz)) {
+        return; // discard candidate if failed to propagate to it
+      }
+    }
+  }
+  MatSym3D covm;
+  for (int i = N; i--;) {
+    MatStd3D mat;
+    if (mUseAbsDCA) { // track rotation to global frame
+      mat(2, 2) = 1;
+      mat(0, 0) = mat(1, 1) = st.aux[i].c;
+      mat(0, 1) = -st.aux[i].s;
+      mat(1, 0) = st.aux[i].s;
+    } else {
+      for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) {
+          mat(r, c) = ln.tcf[i][r][c][l];
+        }
+      }
+    }
+    MatSym3D trcov; // covariance matrix of track position, adding fake X error
+    trcov(0, 0) = trcs[i].getSigmaY2() * XerrFactor;
+    trcov(1, 1) = trcs[i].getSigmaY2();
+    trcov(2, 2) = trcs[i].getSigmaZ2();
+    trcov(2, 1) = trcs[i].getSigmaZY();
+    covm += ROOT::Math::Similarity(mat, trcov);
+  }
+  res.pcaCov[ih] = {float(covm(0, 0)), float(covm(1, 0)), float(covm(1, 1)), float(covm(2, 0)), float(covm(2, 1)), float(covm(2, 2))};
+  res.chi2[ih] = chi2;
+  res.nIters[ih] = ln.nIters[l];
+  res.trPropDone[ih] = mPropagateToPCA;
+  res.nCand++;
+}
+
+//__________________________________________________________________________
+template <int N, typename value_T, int NLanes>
+void DCAFitterNBatch<N, value_T, NLanes>::calcResidDerivatives()
+{
+  //< calculate derivatives for weighted chi2: residual i vs parameter X of track j
+  auto& ln = mLanes;
+  for (int i = N; i--;) {
+    for (int j = N; j--;) {
+      const auto& matT = ln.tcf[j];
+      auto& dr1 = ln.dr1[i][j];
+      auto& dr2 = ln.dr2[i][j];
+      for (int l = 0; l < NLanes; l++) {
+        value_t c = ln.c[i][l], s = ln.s[i][l];
+        // M_i^tr * T_j
+        value_t mt00 = c * matT[0][0][l] + s * matT[1][0][l];
+        value_t mt01 = c * matT[0][1][l] + s * matT[1][1][l];
+        value_t mt02 = c * matT[0][2][l] + s * matT[1][2][l];
+        value_t mt10 = -s * matT[0][0][l] + c * matT[1][0][l];
+        value_t mt11 = -s * matT[0][1][l] + c * matT[1][1][l];
+        value_t mt12 = -s * matT[0][2][l] + c * matT[1][2][l];
+        value_t dydx = ln.dydx[j][l], dzdx = ln.dzdx[j][l], d2ydx2 = ln.d2ydx2[j][l], d2zdx2 = ln.d2zdx2[j][l];
+        // DResid_i/Dx_j = (delta_ij - M_i^tr * T_j) * DTrack_k/Dx_k
+        dr1[0][l] = -(mt00 + mt01 * dydx + mt02 * dzdx);
+        dr1[1][l] = -(mt10 + mt11 * dydx + mt12 * dzdx);
+        dr1[2][l] = -(matT[2][0][l] + matT[2][1][l] * dydx + matT[2][2][l] * dzdx);
+        // D2Resid_I/(Dx_J Dx_K) = (delta_ijk - M_i^tr * T_j * delta_jk) * D2Track_k/dx_k^2
+        dr2[0][l] = -(mt01 * d2ydx2 + mt02 * d2zdx2);
+        dr2[1][l] = -(mt11 * d2ydx2 + mt12 * d2zdx2);
+        dr2[2][l] = -(matT[2][1][l] * d2ydx2 + matT[2][2][l] * d2zdx2);
+        if (i == j) {
+          dr1[0][l] += 1.;
+          dr1[1][l] += dydx;
+          dr1[2][l] += dzdx;
+          dr2[1][l] += d2ydx2;
+          dr2[2][l] += d2zdx2;
+        }
+      }
+    }
+  }
+}
+
+//__________________________________________________________________________
+template <int N, typename value_T, int NLanes>
+void DCAFitterNBatch<N, value_T, NLanes>::calcResidDerivativesNoErr()
+{
+  //< calculate derivatives for absolute distance chi2: residual i vs parameter X of track j
+  constexpr value_t NInv1 = 1. - NInv; // profit from Rii = I/Ninv
+  auto& ln = mLanes;
+  for (int i = N; i--;) {
+    for (int l = 0; l < NLanes; l++) {
+      ln.dr1[i][i][0][l] = NInv1;
+      ln.dr1[i][i][1][l] = NInv1 * ln.dydx[i][l];
+      ln.dr1[i][i][2][l] = NInv1 * ln.dzdx[i][l];
+      ln.dr2[i][i][0][l] = 0;
+      ln.dr2[i][i][1][l] = NInv1 * ln.d2ydx2[i][l];
+      ln.dr2[i][i][2][l] = NInv1 * ln.d2zdx2[i][l];
+    }
+    for (int j = i; j--;) {
+      for (int l = 0; l < NLanes; l++) {
+        // M_i^T*M_j / N matrices non-trivial elements = {ci*cj+si*sj , si*cj-ci*sj }, see 5 in ref.
+        value_t cij = (ln.c[i][l] * ln.c[j][l] + ln.s[i][l] * ln.s[j][l]) * value_t(NInv);
+        value_t sij = (ln.s[i][l] * ln.c[j][l] - ln.c[i][l] * ln.s[j][l]) * value_t(NInv);
+        // DResid_i/Dx_j and DResid_j/Dx_i for j<i
+        ln.dr1[i][j][0][l] = -(cij + sij * ln.dydx[j][l]);
+        ln.dr1[i][j][1][l] = -(-sij + cij * ln.dydx[j][l]);
+        ln.dr1[i][j][2][l] = -ln.dzdx[j][l] * value_t(NInv);
+        ln.dr1[j][i][0][l] = -(cij - sij * ln.dydx[i][l]);
+        ln.dr1[j][i][1][l] = -(sij + cij * ln.dydx[i][l]);
+        ln.dr1[j][i][2][l] = -ln.dzdx[i][l] * value_t(NInv);
+        // D2Resid_I/(Dx_J Dx_K) for j<i
+        ln.dr2[i][j][0][l] = -sij * ln.d2ydx2[j][l];
+        ln.dr2[i][j][1][l] = -cij * ln.d2ydx2[j][l];
+        ln.dr2[i][j][2][l] = -ln.d2zdx2[j][l] * value_t(NInv);
+        ln.dr2[j][i][0][l] = sij * ln.d2ydx2[i][l];
+        ln.dr2[j][i][1][l] = -cij * ln.d2ydx2[i][l];
+        ln.dr2[j][i][2][l] = -ln.d2zdx2[i][l] * value_t(NInv);
+      }
+    }
+  }
+}
+
+//__________________________________________________________________________
+template <int N, typename value_T, int NLanes>
+void DCAFitterNBatch<N, value_T, NLanes>::calcChi2Derivatives()
+{
+  //< calculate 1st and 2nd derivatives of wighted DCA (chi2) over track parameters X, see EQ.Chi2 in the ref
+  auto& ln = mLanes;
+  value_t cidr[N][N][3][NLanes]; // covI_j * dres_j/dx_i
+  for (int i = N; i--;) {
+    for (int l = 0; l < NLanes; l++) {
+      ln.dchi1[i][l] = 0;
+    }
+    for (int j = N; j--;) {
+      const auto& dr1 = ln.dr1[j][i];
+      const auto& res = ln.res[j];
+      for (int l = 0; l < NLanes; l++) {
+        cidr[i][j][0][l] = ln.sxx[j][l] * dr1[0][l];
+        cidr[i][j][1][l] = ln.syy[j][l] * dr1[1][l] + ln.syz[j][l] * dr1[2][l];
+        cidr[i][j][2][l] = ln.syz[j][l] * dr1[1][l] + ln.szz[j][l] * dr1[2][l];
+        ln.dchi1[i][l] += res[0][l] * cidr[i][j][0][l] + res[1][l] * cidr[i][j][1][l] + res[2][l] * cidr[i][j][2][l];
+      }
+    }
+  }
+  for (int i = N; i--;) {
+    for (int j = i + 1; j--;) { // symmetric matrix
+      const auto& res = ln.res[j];
+      const auto& dr2 = ln.dr2[j][j];
+      for (int l = 0; l < NLanes; l++) {
+        value_t dchi2 = res[0][l] * ln.sxx[j][l] * dr2[0][l] + res[1][l] * (ln.syy[j][l] * dr2[1][l] + ln.syz[j][l] * dr2[2][l]) +
+                        res[2][l] * (ln.syz[j][l] * dr2[1][l] + ln.szz[j][l] * dr2[2][l]);
+        for (int k = N; k--;) {
+          dchi2 += ln.dr1[k][j][0][l] * cidr[i][k][0][l] + ln.dr1[k][j][1][l] * cidr[i][k][1][l] + ln.dr1[k][j][2][l] * cidr[i][k][2][l];
+        }
+        ln.dchi2[i][j][l] = dchi2;
+      }
+    }
+  }
+}
+
+//__________________________________________________________________________
+template <int N, typename value_T, int NLanes>
+void DCAFitterNBatch<N, value_T, NLanes>::calcChi2DerivativesNoErr()
+{
+  //< calculate 1st and 2nd derivatives of abs DCA (chi2) over track parameters X, see (6) in the ref
+  auto& ln = mLanes;
+  for (int i = N; i--;) {
+    for (int l = 0; l < NLanes; l++) {
+      ln.dchi1[i][l] = 0;
+    }
+    for (int j = N; j--;) {
+      const auto& res = ln.res[j];
+      const auto& dr1 = ln.dr1[j][i];
+      for (int l = 0; l < NLanes; l++) {
+        ln.dchi1[i][l] += res[0][l] * dr1[0][l] + res[1][l] * dr1[1][l] + res[2][l] * dr1[2][l];
+      }
+    }
+    for (int j = i + 1; j--;) { // symmetric matrix
+      const auto& res = ln.res[i];
+      const auto& dr2 = ln.dr2[i][j];
+      for (int l = 0; l < NLanes; l++) {
+        value_t dchi2 = res[0][l] * dr2[0][l] + res[1][l] * dr2[1][l] + res[2][l] * dr2[2][l];
+        for (int k = N; k--;) {
+          dchi2 += ln.dr1[k][i][0][l] * ln.dr1[k][j][0][l] + ln.dr1[k][i][1][l] * ln.dr1[k][j][1][l] + ln.dr1[k][i][2][l] * ln.dr1[k][j][2][l];
+        }
+        ln.dchi2[i][j][l] = dchi2;
+      }
+    }
+  }
+}
+
+//__________________________________________________________________________
+template <int N, typename value_T, int NLanes>
+void DCAFitterNBatch<N, value_T, NLanes>::solve(bool (&ok)[NLanes])
+{
+  // solve d2chi2/dx2 * dx = dchi2/dx with the LDL^T decomposition of the symmetric matrix,
+  // lanes with a singular matrix are flagged
+  auto& ln = mLanes;
+  value_t mL[N][N][NLanes], dg[N][NLanes], dgInv[N][NLanes];
+  for (int l = 0; l < NLanes; l++) {
+    ok[l] = true;
+  }
+  for (int j = 0; j < N; j++) {
+    for (int l = 0; l < NLanes; l++) {
+      value_t d = ln.dchi2[j][j][l];
+      for (int k = 0; k < j; k++) {
+        d -= mL[j][k][l] * mL[j][k][l] * dg[k][l];
+      }
+      dg[j][l] = d;
+      ok[l] = ok[l] && d != 0;
+      dgInv[j][l] = d != 0 ? 1 / d : 0;
+    }
+    for (int i = j + 1; i < N; i++) {
+      for (int l = 0; l < NLanes; l++) {
+        value_t v = ln.dchi2[i][j][l];
+        for (int k = 0; k < j; k++) {
+          v -= mL[i][k][l] * mL[j][k][l] * dg[k][l];
+        }
+        mL[i][j][l] = v * dgInv[j][l];
+      }
+    }
+  }
+  for (int i = 0; i < N; i++) { // L * z = g
+    for (int l = 0; l < NLanes; l++) {
+      value_t z = ln.dchi1[i][l];
+      for (int k = 0; k < i; k++) {
+        z -= mL[i][k][l] * ln.dx[k][l];
+      }
+      ln.dx[i][l] = z;
+    }
+  }
+  for (int i = N; i--;) { // D * L^T * dx = z
+    for (int l = 0; l < NLanes; l++) {
+      value_t x = ln.dx[i][l] * dgInv[i][l];
+      for (int k = i + 1; k < N; k++) {
+        x -= mL[k][i][l] * ln.dx[k][l];
+      }
+      ln.dx[i][l] = x;
+    }
+  }
+}
+
+//___________________________________________________________________
+template <int N, typename value_T, int NLanes>
+void DCAFitterNBatch<N, value_T, NLanes>::correctTracks()
+{
+  // propagate tracks to updated X
+  auto& ln = mLanes;
+  for (int i = N; i--;) {
+    for (int l = 0; l < NLanes; l++) {
+      value_t dx = ln.dx[i][l], dx2h = value_t(0.5) * dx * dx;
+      ln.pos[i][0][l] -= dx;
+      ln.pos[i][1][l] -= ln.dydx[i][l] * dx - dx2h * ln.d2ydx2[i][l];
+      ln.pos[i][2][l] -= ln.dzdx[i][l] * dx - dx2h * ln.d2zdx2[i][l];
+    }
+  }
+}
+
+//___________________________________________________________________
+template <int N, typename value_T, int NLanes>
+void DCAFitterNBatch<N, value_T, NLanes>::calcPCA()
+{
+  // calculate point of closest approach for N prongs
+  auto& ln = mLanes;
+  for (int r = 0; r < 3; r++) {
+    for (int l = 0; l < NLanes; l++) {
+      value_t v = 0;
+      for (int i = N; i--;) {
+        v += ln.tcf[i][r][0][l] * ln.pos[i][0][l] + ln.tcf[i][r][1][l] * ln.pos[i][1][l] + ln.tcf[i][r][2][l] * ln.pos[i][2][l];
+      }
+      ln.pca[r][l] = v;
+    }
+  }
+}
+
+//___________________________________________________________________
+template <int N, typename value_T, int NLanes>
+void DCAFitterNBatch<N, value_T, NLanes>::calcPCANoErr()
+{
+  // calculate point of closest approach for N prongs w/o errors
+  auto& ln = mLanes;
+  for (int l = 0; l < NLanes; l++) {
+    value_t x = 0, y = 0, z = 0;
+    for (int i = N; i--;) { // local to global
+      x += ln.pos[i][0][l] * ln.c[i][l] - ln.pos[i][1][l] * ln.s[i][l];
+      y += ln.pos[i][0][l] * ln.s[i][l] + ln.pos[i][1][l] * ln.c[i][l];
+      z += ln.pos[i][2][l];
+    }
+    ln.pca[0][l] = x * value_t(NInv);
+    ln.pca[1][l] = y * value_t(NInv);
+    ln.pca[2][l] = z * value_t(NInv);
+  }
+}
+
+//___________________________________________________________________
+template <int N, typename value_T, int NLanes>
+void DCAFitterNBatch<N, value_T, NLanes>::calcTrackResiduals()
+{
+  // calculate residuals
+  auto& ln = mLanes;
+  for (int i = N; i--;) {
+    for (int l = 0; l < NLanes; l++) {
+      value_t c = ln.c[i][l], s = ln.s[i][l]; // glo->loc
+      ln.res[i][0][l] = ln.pos[i][0][l] - (ln.pca[0][l] * c + ln.pca[1][l] * s);
+      ln.res[i][1][l] = ln.pos[i][1][l] - (-ln.pca[0][l] * s + ln.pca[1][l] * c);
+      ln.res[i][2][l] = ln.pos[i][2][l] - ln.pca[2][l];
+    }
+  }
+}
+
+//___________________________________________________________________
+template <int N, typename value_T, int NLanes>
+void DCAFitterNBatch<N, value_T, NLanes>::calcChi2()
+{
+  // calculate current chi2
+  auto& ln = mLanes;
+  for (int l = 0; l < NLanes; l++) {
+    value_t chi2 = 0;
+    for (int i = N; i--;) {
+      const auto& res = ln.res[i];
+      chi2 += res[0][l] * res[0][l] * ln.sxx[i][l] + res[1][l] * res[1][l] * ln.syy[i][l] + res[2][l] * res[2][l] * ln.szz[i][l] +
+              2 * res[1][l] * res[2][l] * ln.syz[i][l];
+    }
+    ln.chi2Upd[l] = float(chi2);
+  }
+}
+
+//___________________________________________________________________
+template <int N, typename value_T, int NLanes>
+void DCAFitterNBatch<N, value_T, NLanes>::calcChi2NoErr()
+{
+  // calculate current chi2 of abs. distance minimization
+  auto& ln = mLanes;
+  for (int l = 0; l < NLanes; l++) {
+    value_t chi2 = 0;
+    for (int i = N; i--;) {
+      const auto& res = ln.res[i];
+      chi2 += res[0][l] * res[0][l] + res[1][l] * res[1][l] + res[2][l] * res[2][l];
+    }
+    ln.chi2Upd[l] = float(chi2);
+  }
+}
+
+//___________________________________________________________________
+template <int N, typename value_T, int NLanes>
+void DCAFitterNBatch<N, value_T, NLanes>::print() const
+{
+  LOG(INFO) << N << "-prong batched vertex fitter (" << NLanes << " lanes of " << sizeof(value_t) << " bytes) in "
+            << (mUseAbsDCA ? "abs." : "weighted") << " distance minimization mode";
+  LOG(INFO) << "Bz: " << mBz << " MaxIter: " << mMaxIter << " MaxChi2: " << mMaxChi2;
+  LOG(INFO) << "Stopping condition: Max.param change < " << mMinParamChange << " Rel.Chi2 change > " << mMinRelChi2Change;
+  LOG(INFO) << "Discard candidates for : Rvtx > " << getMaxR() << " DZ between tracks > " << mMaxDZIni;
+}
+
+using DCAFitter2Batch = DCAFitterNBatch<2>;
+using DCAFitter3Batch = DCAFitterNBatch<3>;
+
+} // namespace vertexing
+} // namespace o2
+#endif // _ALICEO2_DCA_FITTERN_BATCH_
@@ -86,6 +86,7 @@ class SVertexer
   int checkCascades(float r2v0, std::array<float, 3> pV0, float p2v0, int avoidTrackID, int posneg, int ithread);
   void setupThreads();
   void buildT2V(const o2::globaltracking::RecoContainer& recoTracks);
+  void buildSeedsGrid();
   void updateTimeDependentParams();
 
   uint64_t getPairIdx(GIndex id1, GIndex id2) const
@@ -93,11 +94,21 @@ class SVertexer
     return (uint64_t(id1) << 32) | id2;
   }
 
+  struct SeedBox { // XY bounding box of the helix circle of a seed widened by maxDXYIni, clamped to the maxRIni square
+    float xMin, xMax, yMin, yMax;
+    bool overlaps(const SeedBox& b) const { return xMin <= b.xMax && b.xMin <= xMax && yMin <= b.yMax && b.yMin <= yMax; }
+  };
+
+  int getGridBin(float v) const { return std::min(mGridNBins - 1, std::max(0, int((v - mGridMin) * mGridBinInv))); }
+
   gsl::span<const PVertex> mPVertices;
   std::vector<std::vector<V0>> mV0sTmp;
   std::vector<std::vector<Cascade>> mCascadesTmp;
   std::array<std::vector<TrackCand>, 2> mTracksPool{}; // pools of positive and negative seeds sorted in min VtxID
   std::array<std::vector<int>, 2> mVtxFirstTrack{};    // 1st pos. and neg. track of the pools for each vertex
+  std::array<std::vector<o2::track::TrackAuxPar>, 2> mTracksAux{}; // helix circles of the seeds, computed once for all their pairs
+  std::array<std::vector<SeedBox>, 2> mTracksBox{};                  // XY boxes of the helix circles of the seeds
+  std::vector<std::vector<int>> mNegSeedsGrid{};                      // negative seeds, in pool order, whose box covers each cell of the XY grid
   o2d::VertexBase mMeanVertex{{0., 0., 0.}, {0.1 * 0.1, 0., 0.1 * 0.1, 0., 0., 6. * 6.}};
   const SVertexerParams* mSVParams = nullptr;
   std::array<SVertexHypothesis, NHypV0> mV0Hyps;
@@ -106,6 +117,9 @@ class SVertexer
   std::vector<DCAFitterN<2>> mFitterV0;
   std::vector<DCAFitterN<2>> mFitterCasc;
   int mNThreads = 1;
+  int mGridNBins = 1;
+  float mGridMin = 0;
+  float mGridBinInv = 0;
   float mMinR2ToMeanVertex = 0;
   float mMaxDCAXY2ToMeanVertex = 0;
   float mMaxDCAXY2ToMeanVertexV0Casc = 0;
@@ -34,6 +34,7 @@ struct SVertexerParams : public o2::conf::ConfigurableParamHelper<SVertexerParam
   float minRelChi2Change = 0.9; ///< stop when chi2 changes by less than this value
   float maxDZIni = 5.;          ///< don't consider as a seed (circles intersection) if Z distance exceeds this
   float maxRIni = 150;          ///< don't consider as a seed (circles intersection) if its R exceeds this
+  int nBinsXYGrid = 20;         ///< number of bins per axis of the XY grid used to pre-pair the seeds by their helix circles
   bool useAbsDCA = true; ///< use abs dca minimization
   //
   float minRToMeanVertex = 0.5;           ///< min radial distance of V0 from beam line (mean vertex)
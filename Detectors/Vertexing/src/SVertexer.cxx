@@ -36,26 +36,51 @@ void SVertexer::process(const o2::globaltracking::RecoContainer& recoData) // ac
   updateTimeDependentParams(); // TODO RS: strictly speaking, one should do this only in case of the CCDB objects update
   mPVertices = recoData.getPrimaryVertices();
   buildT2V(recoData); // build track->vertex refs from vertex->track (if other workflow will need this, consider producing a message in the VertexTrackMatcher)
-  int ntrP = mTracksPool[POS].size(), ntrN = mTracksPool[NEG].size(), iThread = 0;
+  int ntrP = mTracksPool[POS].size();
+  size_t nPairs = 0, nPairsTested = 0, nPairsFitted = 0;
   mV0sTmp[0].clear();
   mCascadesTmp[0].clear();
 
+  // the work per positive seed varies a lot, hence they are distributed dynamically in small groups
 #ifdef WITH_OPENMP
   omp_set_num_threads(mNThreads);
   int dynGrp = std::min(4, std::max(1, mNThreads / 2));
-#pragma omp parallel for schedule(dynamic, dynGrp)
+#pragma omp parallel for schedule(dynamic, dynGrp) reduction(+ : nPairs, nPairsTested, nPairsFitted)
 #endif
   for (int itp = 0; itp < ntrP; itp++) {
-    auto& seedP = mTracksPool[POS][itp];
-    for (int itn = mVtxFirstTrack[NEG][seedP.vBracket.getMin()]; itn < ntrN; itn++) { // start from the 1st negative track of lowest-ID vertex of positive
-      auto& seedN = mTracksPool[NEG][itn];
-      if (seedN.vBracket > seedP.vBracket) { // all vertices compatible with seedN are in future wrt that of seedP
-        break;
-      }
+    int iThread = 0;
 #ifdef WITH_OPENMP
-      iThread = omp_get_thread_num();
+    iThread = omp_get_thread_num();
 #endif
-      checkV0(seedP, seedN, itp, itn, iThread);
+    auto& seedP = mTracksPool[POS][itp];
+    const auto& boxP = mTracksBox[POS][itp];
+    // the negative seeds are ordered in min VtxID: start from the 1st one of the lowest-ID vertex of the positive
+    // and stop at the 1st one whose compatible vertices are all in future wrt that of the positive
+    const auto& poolN = mTracksPool[NEG];
+    auto itnMin = std::lower_bound(poolN.begin(), poolN.end(), seedP.vBracket.getMin(), [](const TrackCand& t, int iv) { return t.vBracket.getMin() < iv; }) - poolN.begin();
+    nPairs += std::upper_bound(poolN.begin() + itnMin, poolN.end(), seedP.vBracket.getMax(), [](int iv, const TrackCand& t) { return iv < t.vBracket.getMin(); }) - poolN.begin() - itnMin;
+    // only the negative seeds whose XY box overlaps with that of the positive one may cross it within maxRIni,
+    // each pair being examined in the grid cell containing the lower corner of the overlap of their boxes
+    for (int iy = getGridBin(boxP.yMin), iyMax = getGridBin(boxP.yMax); iy <= iyMax; iy++) {
+      for (int ix = getGridBin(boxP.xMin), ixMax = getGridBin(boxP.xMax); ix <= ixMax; ix++) {
+        const auto& cell = mNegSeedsGrid[iy * mGridNBins + ix];
+        for (auto itc = std::lower_bound(cell.begin(), cell.end(), itnMin); itc != cell.end(); itc++) {
+          int itn = *itc;
+          auto& seedN = mTracksPool[NEG][itn];
+          if (seedN.vBracket > seedP.vBracket) { // all vertices compatible with seedN are in future wrt that of seedP
+            break;
+          }
+          const auto& boxN = mTracksBox[NEG][itn];
+          if (!boxP.overlaps(boxN) || getGridBin(std::max(boxP.xMin, boxN.xMin)) != ix || getGridBin(std::max(boxP.yMin, boxN.yMin)) != iy) {
+            continue;
+          }
+          nPairsTested++;
+          checkV0(seedP, seedN, itp, itn, iThread);
+          if (mFitterV0[iThread].getNCandidates()) {
+            nPairsFitted++;
+          }
+        }
+      }
     }
   }
 #ifdef WITH_OPENMP
@@ -69,7 +94,8 @@ void SVertexer::process(const o2::globaltracking::RecoContainer& recoData) // ac
     mCascadesTmp[i].clear();
   }
 #endif
-  LOG(INFO) << "DONE : " << mV0sTmp[0].size() << " " << mCascadesTmp[0].size();
+  LOG(INFO) << "DONE : " << mV0sTmp[0].size() << " " << mCascadesTmp[0].size() << " from " << nPairs << " time-compatible pairs, "
+            << nPairsTested << " with overlapping XY boxes tested, " << nPairsFitted << " fitted";
 }
 
 //__________________________________________________________________
@@ -188,27 +214,75 @@ void SVertexer::buildT2V(const o2::globaltracking::RecoContainer& recoData) // a
       }
     }
   }
-  // register 1st track of each charge for each vertex
-
+  // register 1st track of each charge for each vertex and the helix circles of the seeds
+  auto bz = mFitterV0[0].getBz(); // same field as in the fitter seeding
   for (int pn = 0; pn < 2; pn++) {
     auto& vtxFirstT = mVtxFirstTrack[pn];
     const auto& tracksPool = mTracksPool[pn];
+    auto& tracksAux = mTracksAux[pn];
+    tracksAux.resize(tracksPool.size());
     for (unsigned i = 0; i < tracksPool.size(); i++) {
       const auto& t = tracksPool[i];
       if (vtxFirstT[t.vBracket.getMin()] == -1) {
         vtxFirstT[t.vBracket.getMin()] = i;
       }
+      tracksAux[i].set(t, bz);
     }
   }
 
+  buildSeedsGrid();
+
   LOG(INFO) << "Collected " << mTracksPool[POS].size() << " positive and " << mTracksPool[NEG].size() << " negative seeds";
 }
 
+//__________________________________________________________________
+void SVertexer::buildSeedsGrid()
+{
+  // Book the XY boxes of the helix circles of the seeds, widened by maxDXYIni and clamped to the square of half size maxRIni.
+  // Any seed the fitter can find for a pair is either a crossing of the circles, a point at less than maxDXYIni/2 from both,
+  // or, for nested circles, a point inside the outer one, whose box then contains that of the inner one.
+  // When it is within maxRIni, the clamped boxes of both seeds therefore overlap.
+  // The negative seeds are registered in the cells of the XY grid covered by their box.
+  const auto& fitter = mFitterV0[0];
+  float maxR = fitter.getMaxR(), dxy = fitter.getMaxDXYIni();
+  mGridNBins = std::max(1, mSVParams->nBinsXYGrid);
+  mGridMin = -maxR;
+  mGridBinInv = mGridNBins / (2.f * maxR);
+  auto clamp = [maxR](float v) { return std::min(maxR, std::max(-maxR, v)); };
+  for (int pn = 0; pn < 2; pn++) {
+    const auto& tracksAux = mTracksAux[pn];
+    auto& tracksBox = mTracksBox[pn];
+    tracksBox.resize(tracksAux.size());
+    for (unsigned i = 0; i < tracksAux.size(); i++) {
+      const auto& aux = tracksAux[i];
+      if (aux.rC < o2::constants::math::Almost0) { // straight line: no constraint
+        tracksBox[i] = {-maxR, maxR, -maxR, maxR};
+        continue;
+      }
+      float hsize = aux.rC + dxy;
+      tracksBox[i] = {clamp(aux.xC - hsize), clamp(aux.xC + hsize), clamp(aux.yC - hsize), clamp(aux.yC + hsize)};
+    }
+  }
+  mNegSeedsGrid.resize(mGridNBins * mGridNBins);
+  for (auto& cell : mNegSeedsGrid) {
+    cell.clear();
+  }
+  const auto& boxesN = mTracksBox[NEG];
+  for (unsigned i = 0; i < boxesN.size(); i++) {
+    const auto& box = boxesN[i];
+    for (int iy = getGridBin(box.yMin), iyMax = getGridBin(box.yMax); iy <= iyMax; iy++) {
+      for (int ix = getGridBin(box.xMin), ixMax = getGridBin(box.xMax); ix <= ixMax; ix++) {
+        mNegSeedsGrid[iy * mGridNBins + ix].push_back(i);
+      }
+    }
+  }
+}
+
 //__________________________________________________________________
 bool SVertexer::checkV0(TrackCand& seedP, TrackCand& seedN, int iP, int iN, int ithread)
 {
   auto& fitterV0 = mFitterV0[ithread];
-  int nCand = fitterV0.process(seedP, seedN);
+  int nCand = fitterV0.process({&mTracksAux[POS][iP], &mTracksAux[NEG][iN]}, seedP, seedN); // helix circles precomputed per seed
   if (nCand == 0) { // discard this pair
     return false;
   }
@@ -323,6 +397,8 @@ int SVertexer::checkCascades(float r2v0, std::array<float, 3> pV0, float p2V0, i
   auto& fitterCasc = mFitterCasc[ithread];
   const auto& v0 = mV0sTmp[ithread].back();
   auto& tracks = mTracksPool[posneg];
+  const auto& tracksAux = mTracksAux[posneg];
+  o2::track::TrackAuxPar v0Aux(v0, fitterCasc.getBz());
   const auto& pv = mPVertices[v0.getVertexID()];
   int nCascIni = mCascadesTmp[ithread].size();
   // start from the 1st track compatible with V0's primary vertex
@@ -337,7 +413,7 @@ int SVertexer::checkCascades(float r2v0, std::array<float, 3> pV0, float p2V0, i
     if (bach.vBracket.isOutside(v0.getVertexID())) {
       LOG(ERROR) << "Incompatible bachelor: PV " << bach.vBracket.asString() << " vs V0 " << v0.getVertexID();
     }
-    int nCandC = fitterCasc.process(v0, bach);
+    int nCandC = fitterCasc.process({&v0Aux, &tracksAux[it]}, v0, bach);
     if (nCandC == 0) { // discard this pair
       continue;
     }
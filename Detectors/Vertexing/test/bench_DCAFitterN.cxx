@@ -0,0 +1,137 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   bench_DCAFitterN.cxx
+/// @brief  Candidates/s of the scalar and batched N-prong vertex fitters
+///
+/// The candidates are made of prongs emitted from random vertices at R < 20 cm,
+/// their positions smeared by 100 microns, as the combinations which are kept
+/// after the preselections of the V0 and heavy flavour finders. The combinatorial
+/// pairs of prongs measure the fitter when most of the pairs have no vertex.
+
+#include "benchmark/benchmark.h"
+#include "DetectorsVertexing/DCAFitterN.h"
+#include "DetectorsVertexing/DCAFitterNBatch.h"
+#include <TRandom3.h>
+#include <array>
+#include <tuple>
+#include <vector>
+
+using namespace o2::vertexing;
+
+constexpr float Bz = 5.;
+constexpr int NCandidates = 10000;
+
+template <int N>
+const std::vector<std::array<o2::track::TrackParCov, N>>& getProngs()
+{
+  static std::vector<std::array<o2::track::TrackParCov, N>> prongs;
+  if (!prongs.empty()) {
+    return prongs;
+  }
+  TRandom3 rnd(N);
+  std::array<float, 21> cov{};
+  for (int id : {0, 2, 5}) { // position
+    cov[id] = 1e-4;
+  }
+  for (int id : {9, 14, 20}) { // momentum
+    cov[id] = 1e-4;
+  }
+  for (int iv = 0; iv < NCandidates; iv++) {
+    float r = 0.5 + rnd.Rndm() * 19.5, phi = rnd.Rndm() * 2 * M_PI, z = (rnd.Rndm() - 0.5) * 20;
+    auto& cand = prongs.emplace_back();
+    for (int i = 0; i < N; i++) {
+      float pt = 0.2 + rnd.Rndm() * 3, phiT = phi + (rnd.Rndm() - 0.5), pz = (rnd.Rndm() - 0.5) * pt;
+      std::array<float, 3> xyz{float(r * std::cos(phi) + rnd.Gaus(0, 1e-2)), float(r * std::sin(phi) + rnd.Gaus(0, 1e-2)), float(z + rnd.Gaus(0, 1e-2))};
+      std::array<float, 3> pxpypz{pt * std::cos(phiT), pt * std::sin(phiT), pz};
+      cand[i] = o2::track::TrackParCov(xyz, pxpypz, cov, i % 2 ? -1 : 1);
+    }
+  }
+  return prongs;
+}
+
+template <int N>
+static void BM_DCAFitterScalar(benchmark::State& state)
+{
+  const auto& prongs = getProngs<N>();
+  DCAFitterN<N> ft;
+  ft.setBz(Bz);
+  ft.setUseAbsDCA(state.range(0));
+  int nFound = 0;
+  for (auto _ : state) {
+    for (const auto& cand : prongs) {
+      nFound += std::apply([&ft](const auto&... trs) { return ft.process(trs...); }, cand);
+    }
+  }
+  benchmark::DoNotOptimize(nFound);
+  state.SetItemsProcessed(state.iterations() * prongs.size());
+}
+
+template <int N, typename value_T>
+static void BM_DCAFitterBatch(benchmark::State& state)
+{
+  const auto& prongs = getProngs<N>();
+  DCAFitterNBatch<N, value_T> ft;
+  ft.setBz(Bz);
+  ft.setUseAbsDCA(state.range(0));
+  std::vector<typename DCAFitterNBatch<N, value_T>::Candidate> cands(prongs.size());
+  std::vector<typename DCAFitterNBatch<N, value_T>::Result> results;
+  for (size_t ic = 0; ic < prongs.size(); ic++) {
+    for (int i = 0; i < N; i++) {
+      cands[ic].tracks[i] = &prongs[ic][i];
+    }
+  }
+  int nFound = 0;
+  for (auto _ : state) {
+    nFound += ft.process(cands, results);
+  }
+  benchmark::DoNotOptimize(nFound);
+  state.SetItemsProcessed(state.iterations() * prongs.size());
+}
+
+// all the combinations of the positive and negative prongs of NPairSeeds candidates, as in the V0 finder,
+// with the helix circles of the prongs precomputed once (argument 1) or for each pair (argument 0)
+static void BM_DCAFitterPairs(benchmark::State& state)
+{
+  constexpr int NPairSeeds = 300;
+  const auto& prongs = getProngs<2>();
+  DCAFitterN<2> ft;
+  ft.setBz(Bz);
+  std::array<std::vector<o2::track::TrackAuxPar>, 2> aux;
+  for (int ic = 0; ic < NPairSeeds; ic++) {
+    for (int i = 0; i < 2; i++) {
+      aux[i].emplace_back(prongs[ic][i], Bz);
+    }
+  }
+  bool precomputed = state.range(0);
+  int nFound = 0;
+  for (auto _ : state) {
+    for (int ip = 0; ip < NPairSeeds; ip++) {
+      for (int in = 0; in < NPairSeeds; in++) {
+        const auto &trP = prongs[ip][0], &trN = prongs[in][1];
+        nFound += precomputed ? ft.process({&aux[0][ip], &aux[1][in]}, trP, trN) : ft.process(trP, trN);
+      }
+    }
+  }
+  benchmark::DoNotOptimize(nFound);
+  state.SetItemsProcessed(state.iterations() * NPairSeeds * NPairSeeds);
+}
+
+// argument: 1 for the absolute distance minimization, 0 for the weighted one
+BENCHMARK_TEMPLATE(BM_DCAFitterScalar, 2)->Arg(1)->Arg(0);
+BENCHMARK_TEMPLATE(BM_DCAFitterBatch, 2, float)->Arg(1)->Arg(0);
+BENCHMARK_TEMPLATE(BM_DCAFitterBatch, 2, double)->Arg(1)->Arg(0);
+BENCHMARK_TEMPLATE(BM_DCAFitterScalar, 3)->Arg(1)->Arg(0);
+BENCHMARK_TEMPLATE(BM_DCAFitterBatch, 3, float)->Arg(1)->Arg(0);
+BENCHMARK_TEMPLATE(BM_DCAFitterBatch, 3, double)->Arg(1)->Arg(0);
+BENCHMARK(BM_DCAFitterPairs)->Arg(1)->Arg(0);
+
+BENCHMARK_MAIN();
@@ -15,6 +15,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include "DetectorsVertexing/DCAFitterN.h"
+#include "DetectorsVertexing/DCAFitterNBatch.h"
 #include "CommonUtils/TreeStreamRedirector.h"
 #include <TRandom.h>
 #include <TGenPhaseSpace.h>
@@ -22,6 +23,7 @@
 #include <TStopwatch.h>
 #include <Math/SVector.h>
 #include <array>
+#include <tuple>
 
 namespace o2
 {
@@ -387,5 +389,136 @@ BOOST_AUTO_TEST_CASE(DCAFitterNProngs)
   outStream.Close();
 }
 
+template <int N, typename value_T>
+void compareBatchWithScalar(const std::vector<std::array<o2::track::TrackParCov, N>>& prongs, float bz, bool useAbsDCA,
+                            float maxMismatch, float maxMeanDist)
+{
+  o2::vertexing::DCAFitterN<N> ft;
+  ft.setBz(bz);
+  ft.setUseAbsDCA(useAbsDCA);
+  o2::vertexing::DCAFitterNBatch<N, value_T> ftb;
+  ftb.setFrom(ft);
+
+  std::vector<typename o2::vertexing::DCAFitterNBatch<N, value_T>::Candidate> cands(prongs.size());
+  std::vector<typename o2::vertexing::DCAFitterNBatch<N, value_T>::Result> results;
+  for (size_t ic = 0; ic < prongs.size(); ic++) {
+    for (int i = 0; i < N; i++) {
+      cands[ic].tracks[i] = &prongs[ic][i];
+    }
+  }
+  TStopwatch swS, swB;
+  swB.Start();
+  int nFoundB = ftb.process(cands, results);
+  swB.Stop();
+
+  int nFoundS = 0, nMismatch = 0, nCompared = 0;
+  double meanDist = 0;
+  swS.Start();
+  for (size_t ic = 0; ic < prongs.size(); ic++) {
+    int nc = std::apply([&ft](const auto&... trs) { return ft.process(trs...); }, prongs[ic]);
+    nFoundS += nc;
+    const auto& res = results[ic];
+    if (nc != res.getNCandidates()) {
+      nMismatch++;
+      continue;
+    }
+    for (int ih = 0; ih < nc; ih++) {
+      auto df = ft.getPCACandidate(ih);
+      df[0] -= res.pca[ih][0];
+      df[1] -= res.pca[ih][1];
+      df[2] -= res.pca[ih][2];
+      meanDist += TMath::Sqrt(df[0] * df[0] + df[1] * df[1] + df[2] * df[2]);
+      nCompared++;
+    }
+  }
+  swS.Stop();
+  meanDist /= nCompared ? nCompared : 1;
+  LOG(INFO) << N << "-prongs with " << (useAbsDCA ? "abs." : "wgh.") << "dist minimization, batch of " << ftb.getNLanes()
+            << " lanes of " << sizeof(value_T) << " bytes: found " << nFoundB << " vs " << nFoundS << " (scalar), mismatches: " << nMismatch
+            << " mean PCA difference: " << meanDist;
+  LOG(INFO) << "Candidates/s: scalar " << prongs.size() / std::max(swS.CpuTime(), 1e-6)
+            << " batch " << prongs.size() / std::max(swB.CpuTime(), 1e-6);
+  BOOST_CHECK(nMismatch <= maxMismatch * prongs.size());
+  BOOST_CHECK(meanDist < maxMeanDist);
+}
+
+BOOST_AUTO_TEST_CASE(DCAFitterNBatchVsScalar)
+{
+  constexpr int NTest = 10000;
+  TGenPhaseSpace genPHS;
+  constexpr double pion = 0.13957;
+  constexpr double k0 = 0.49761;
+  constexpr double kch = 0.49368;
+  constexpr double dch = 1.86965;
+  std::vector<double> k0dec = {pion, pion};
+  std::vector<double> dchdec = {pion, kch, pion};
+  std::vector<o2::track::TrackParCov> vctracks;
+  Vec3D vtxGen;
+  double bz = 5.0;
+
+  std::vector<std::array<o2::track::TrackParCov, 2>> prongs2;
+  std::vector<std::array<o2::track::TrackParCov, 3>> prongs3;
+  for (int iev = 0; iev < NTest; iev++) {
+    generate(vtxGen, vctracks, bz, genPHS, k0, k0dec, {1, 1});
+    prongs2.push_back({vctracks[0], vctracks[1]});
+    generate(vtxGen, vctracks, bz, genPHS, dch, dchdec, {1, 1, 1});
+    prongs3.push_back({vctracks[0], vctracks[1], vctracks[2]});
+  }
+  // add combinatorial pairs and triplets, most of them without a vertex
+  for (int iev = 0; iev < NTest; iev++) {
+    prongs2.push_back({prongs2[iev][0], prongs2[(iev + 1) % NTest][1]});
+    prongs3.push_back({prongs3[iev][0], prongs3[(iev + 1) % NTest][1], prongs3[(iev + 2) % NTest][2]});
+  }
+
+  for (bool useAbsDCA : {true, false}) {
+    compareBatchWithScalar<2, double>(prongs2, bz, useAbsDCA, 1e-3, 1e-4);
+    compareBatchWithScalar<2, float>(prongs2, bz, useAbsDCA, 1e-2, 2e-3);
+    compareBatchWithScalar<3, double>(prongs3, bz, useAbsDCA, 1e-3, 1e-4);
+    compareBatchWithScalar<3, float>(prongs3, bz, useAbsDCA, 1e-2, 2e-3);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(DCAFitterNPrecomputedAux)
+{
+  // fitting with the helix circles of the tracks computed once for all pairs must give the same result
+  constexpr int NTest = 1000;
+  TGenPhaseSpace genPHS;
+  constexpr double pion = 0.13957;
+  constexpr double k0 = 0.49761;
+  std::vector<double> k0dec = {pion, pion};
+  std::vector<o2::track::TrackParCov> vctracks, posTracks, negTracks;
+  Vec3D vtxGen;
+  double bz = 5.0;
+  for (int iev = 0; iev < NTest; iev++) {
+    generate(vtxGen, vctracks, bz, genPHS, k0, k0dec, {1, 1});
+    posTracks.push_back(vctracks[0]);
+    negTracks.push_back(vctracks[1]);
+  }
+
+  o2::vertexing::DCAFitterN<2> ft, ftAux;
+  ft.setBz(bz);
+  ftAux.setBz(bz);
+  std::vector<o2::track::TrackAuxPar> posAux, negAux;
+  for (int i = 0; i < NTest; i++) {
+    posAux.emplace_back(posTracks[i], bz);
+    negAux.emplace_back(negTracks[i], bz);
+  }
+  int nFound = 0;
+  for (int ip = 0; ip < NTest; ip += 10) {
+    for (int in = 0; in < NTest; in++) {
+      int nc = ft.process(posTracks[ip], negTracks[in]);
+      BOOST_REQUIRE_EQUAL(nc, ftAux.process({&posAux[ip], &negAux[in]}, posTracks[ip], negTracks[in]));
+      for (int ih = 0; ih < nc; ih++) {
+        BOOST_CHECK_EQUAL(ft.getChi2AtPCACandidate(ih), ftAux.getChi2AtPCACandidate(ih));
+        for (int i = 0; i < 3; i++) {
+          BOOST_CHECK_EQUAL(ft.getPCACandidate(ih)[i], ftAux.getPCACandidate(ih)[i]);
+        }
+      }
+      nFound += nc;
+    }
+  }
+  BOOST_CHECK(nFound >= NTest / 10);
+}
+
 } // namespace vertexing
 } // namespace o2
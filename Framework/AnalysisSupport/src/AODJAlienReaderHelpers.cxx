@@ -32,6 +32,7 @@
 #include <TGrid.h>
 #include <TFile.h>
 #include <TTreeCache.h>
+#include <TROOT.h>
 
 #include <arrow/ipc/reader.h>
 #include <arrow/ipc/writer.h>
@@ -39,6 +40,7 @@
 #include <arrow/table.h>
 #include <arrow/util/key_value_metadata.h>
 
+#include <future>
 #include <thread>
 
 using namespace o2;
@@ -132,11 +134,8 @@ static inline auto extractOriginalsTuple(framework::pack<Os...>, ProcessingConte
   return std::make_tuple(extractTypedOriginal<Os>(pc)...);
 }
 
-void AODJAlienReaderHelpers::dumpFileMetrics(Monitoring& monitoring, TFile* currentFile, uint64_t startedAt, uint64_t ioTime, int tfPerFile, int tfRead)
+std::string AODJAlienReaderHelpers::fileReadInfo(TFile* currentFile, uint64_t startedAt, uint64_t ioTime, int tfPerFile, int tfRead)
 {
-  if (currentFile == nullptr) {
-    return;
-  }
   std::string monitoringInfo(fmt::format("lfn={},size={},total_tf={},read_tf={},read_bytes={},read_calls={},io_time={:.1f},wait_time={:.1f}", currentFile->GetName(),
                                          currentFile->GetSize(), tfPerFile, tfRead, currentFile->GetBytesRead(), currentFile->GetReadCalls(),
                                          ((float)ioTime / 1e9), ((float)(uv_hrtime() - startedAt - ioTime) / 1e9)));
@@ -146,10 +145,175 @@ void AODJAlienReaderHelpers::dumpFileMetrics(Monitoring& monitoring, TFile* curr
     monitoringInfo += fmt::format(",se={},open_time={:.1f}", alienFile->GetSE(), alienFile->GetElapsed());
   }
 #endif
+  return monitoringInfo;
+}
+
+void AODJAlienReaderHelpers::sendFileReadInfo(Monitoring& monitoring, std::string const& monitoringInfo)
+{
   monitoring.send(Metric{monitoringInfo, "aod-file-read-info"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
   LOGP(INFO, "Read info: {}", monitoringInfo);
 }
 
+void AODJAlienReaderHelpers::dumpFileMetrics(Monitoring& monitoring, TFile* currentFile, uint64_t startedAt, uint64_t ioTime, int tfPerFile, int tfRead)
+{
+  if (currentFile == nullptr) {
+    return;
+  }
+  sendFileReadInfo(monitoring, fileReadInfo(currentFile, startedAt, ioTime, tfPerFile, tfRead));
+}
+
+namespace
+{
+// the tables of a time frame, as read by the TimeFrameReader
+struct TimeFrameTables {
+  bool endOfInput = false;
+  uint64_t timeFrameNumber = 0;
+  int fileCounter = 0;
+  int numTF = 0;
+  size_t totalSizeUncompressed = 0;
+  size_t totalSizeCompressed = 0;
+  std::vector<std::pair<header::DataHeader, std::shared_ptr<arrow::Table>>> tables;
+  // read info of the files which are done for reading
+  std::vector<std::string> fileReadInfos;
+};
+
+// Reads the requested tables of the time frames assigned to a reader, one time frame
+// after the other. All the ROOT I/O of the reader is done here and nothing is sent,
+// so that the next time frame can be read by a separate thread while the current
+// one is sent and processed.
+struct TimeFrameReader {
+  TimeFrameReader(std::shared_ptr<DataInputDirector> d, std::vector<OutputRoute> r, size_t id, size_t maxId)
+    : didir(std::move(d)), requestedTables(std::move(r)), inputTimesliceId(id), maxInputTimeslices(maxId)
+  {
+  }
+
+  TimeFrameTables read();
+  // the table of an AO2D in arrow format, or else the tree of a ROOT AO2D, false if there is none
+  bool open(header::DataHeader const& dh, int fcnt, int ntf, std::shared_ptr<arrow::Table>& table, TTree*& tree);
+
+  std::shared_ptr<DataInputDirector> didir;
+  std::vector<OutputRoute> requestedTables;
+  size_t inputTimesliceId;
+  size_t maxInputTimeslices;
+
+  // Each parallel reader inputTimesliceId reads the files fileCounter*maxInputTimeslices+inputTimesliceId
+  // the last TF read is numTF
+  int fileCounter = 0;
+  int numTF = -1;
+
+  size_t totalSizeUncompressed = 0;
+  size_t totalSizeCompressed = 0;
+  // needed for metrics dumping (upon next file read, or terminate due to watchdog)
+  TFile* currentFile = nullptr;
+  int tfCurrentFile = -1;
+  uint64_t currentFileStartedAt = uv_hrtime();
+  uint64_t currentFileIOTime = 0;
+};
+
+bool TimeFrameReader::open(header::DataHeader const& dh, int fcnt, int ntf, std::shared_ptr<arrow::Table>& table, TTree*& tree)
+{
+  if (didir->isArrowAOD(dh, fcnt)) {
+    table = didir->getDataTable(dh, fcnt, ntf);
+    return table != nullptr;
+  }
+  tree = didir->getDataTree(dh, fcnt, ntf);
+  return tree != nullptr;
+}
+
+TimeFrameTables TimeFrameReader::read()
+{
+  TimeFrameTables result;
+  int fcnt = (fileCounter * maxInputTimeslices) + inputTimesliceId;
+  int ntf = numTF + 1;
+  auto ioStart = uv_hrtime();
+
+  // loop over requested tables
+  bool first = true;
+  for (auto& route : requestedTables) {
+
+    // create header
+    auto concrete = DataSpecUtils::asConcreteDataMatcher(route.matcher);
+    auto dh = header::DataHeader(concrete.description, concrete.origin, concrete.subSpec);
+
+    std::shared_ptr<arrow::Table> table;
+    TTree* tr = nullptr;
+    if (!open(dh, fcnt, ntf, table, tr)) {
+      if (first) {
+        // metrics of file which is done for reading
+        if (currentFile != nullptr) {
+          result.fileReadInfos.push_back(AODJAlienReaderHelpers::fileReadInfo(currentFile, currentFileStartedAt, currentFileIOTime, tfCurrentFile, ntf));
+        }
+        currentFile = nullptr;
+        currentFileStartedAt = uv_hrtime();
+        currentFileIOTime = 0;
+
+        // check if there is a next file to read
+        fcnt += maxInputTimeslices;
+        if (didir->atEnd(fcnt)) {
+          LOGP(INFO, "No input files left to read for reader {}!", inputTimesliceId);
+          result.endOfInput = true;
+          return result;
+        }
+        // get first folder of next file
+        ntf = 0;
+        if (!open(dh, fcnt, ntf, table, tr)) {
+          LOGP(FATAL, "Can not retrieve tree for table {}: fileCounter {}, timeFrame {}", concrete.origin, fcnt, ntf);
+          throw std::runtime_error("Processing is stopped!");
+        }
+      } else {
+        LOGP(FATAL, "Can not retrieve tree for table {}: fileCounter {}, timeFrame {}", concrete.origin, fcnt, ntf);
+        throw std::runtime_error("Processing is stopped!");
+      }
+    }
+
+    if (first) {
+      result.timeFrameNumber = didir->getTimeFrameNumber(dh, fcnt, ntf);
+    }
+
+    // add branches to read
+    // fill the table
+    if (tr) {
+      TreeToTable t2t;
+      auto colnames = getColumnNames(dh);
+      if (colnames.size() == 0) {
+        totalSizeCompressed += tr->GetZipBytes();
+        totalSizeUncompressed += tr->GetTotBytes();
+        t2t.addAllColumns(tr);
+      } else {
+        for (auto& colname : colnames) {
+          TBranch* branch = tr->GetBranch(colname.c_str());
+          totalSizeCompressed += branch->GetZipBytes("*");
+          totalSizeUncompressed += branch->GetTotBytes("*");
+          t2t.addColumn(colname.c_str());
+        }
+      }
+      t2t.fill(tr);
+      delete tr;
+      table = t2t.finalize();
+    }
+    result.tables.emplace_back(dh, table);
+
+    if (currentFile == nullptr) {
+      currentFile = didir->getFileFolder(dh, fcnt, ntf).file;
+      tfCurrentFile = didir->getTimeFramesInFile(dh, fcnt);
+    }
+
+    first = false;
+  }
+
+  // save file number and time frame
+  fileCounter = (fcnt - inputTimesliceId) / maxInputTimeslices;
+  numTF = ntf;
+  currentFileIOTime += (uv_hrtime() - ioStart);
+
+  result.fileCounter = fileCounter;
+  result.numTF = numTF;
+  result.totalSizeUncompressed = totalSizeUncompressed;
+  result.totalSizeCompressed = totalSizeCompressed;
+  return result;
+}
+} // namespace
+
 AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
 {
   auto callback = AlgorithmSpec{adaptStateful([](ConfigParamRegistry const& options,
@@ -194,132 +358,65 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
       }
     }
 
-    auto fileCounter = std::make_shared<int>(0);
-    auto numTF = std::make_shared<int>(-1);
+    // the next time frame is read in the background while the current one is processed,
+    // the reading thread is then the only one doing ROOT I/O
+    assert(spec.inputTimesliceId < spec.maxInputTimeslices);
+    auto reader = std::make_shared<TimeFrameReader>(didir, requestedTables, spec.inputTimesliceId, spec.maxInputTimeslices);
+    auto prefetch = !options.get<bool>("aod-reader-no-prefetch");
+    if (prefetch) {
+      ROOT::EnableThreadSafety();
+    }
+    auto nextTimeFrame = std::make_shared<std::future<TimeFrameTables>>();
+
     return adaptStateless([TFNumberHeader,
-                           requestedTables,
-                           fileCounter,
-                           numTF,
-                           watchdog,
-                           didir](Monitoring& monitoring, DataAllocator& outputs, ControlService& control, DeviceSpec const& device) {
-      // Each parallel reader device.inputTimesliceId reads the files fileCounter*device.maxInputTimeslices+device.inputTimesliceId
-      // the TF to read is numTF
-      assert(device.inputTimesliceId < device.maxInputTimeslices);
-      uint64_t timeFrameNumber = 0;
-      int fcnt = (*fileCounter * device.maxInputTimeslices) + device.inputTimesliceId;
-      int ntf = *numTF + 1;
+                           reader,
+                           prefetch,
+                           nextTimeFrame,
+                           watchdog](Monitoring& monitoring, DataAllocator& outputs, ControlService& control, DeviceSpec const& device) {
       static int currentFileCounter = -1;
       static int filesProcessed = 0;
-      if (currentFileCounter != *fileCounter) {
-        currentFileCounter = *fileCounter;
-        monitoring.send(Metric{(uint64_t)++filesProcessed, "files-opened"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
-      }
-
-      // loop over requested tables
-      bool first = true;
-      static size_t totalSizeUncompressed = 0;
-      static size_t totalSizeCompressed = 0;
-      static TFile* currentFile = nullptr;
-      static int tfCurrentFile = -1;
-      static auto currentFileStartedAt = uv_hrtime();
-      static uint64_t currentFileIOTime = 0;
 
       // check if RuntimeLimit is reached
       if (!watchdog->update()) {
+        if (nextTimeFrame->valid()) {
+          nextTimeFrame->wait();
+        }
         LOGP(INFO, "Run time exceeds run time limit of {} seconds. Exiting gracefully...", watchdog->runTimeLimit);
         LOGP(INFO, "Stopping reader {} after time frame {}.", device.inputTimesliceId, watchdog->numberTimeFrames - 1);
-        dumpFileMetrics(monitoring, currentFile, currentFileStartedAt, currentFileIOTime, tfCurrentFile, ntf);
+        dumpFileMetrics(monitoring, reader->currentFile, reader->currentFileStartedAt, reader->currentFileIOTime, reader->tfCurrentFile, reader->numTF + 1);
         monitoring.flushBuffer();
-        didir->closeInputFiles();
+        reader->didir->closeInputFiles();
         control.endOfStream();
         control.readyToQuit(QuitRequest::Me);
         return;
       }
 
-      auto ioStart = uv_hrtime();
-
-      for (auto route : requestedTables) {
-
-        // create header
-        auto concrete = DataSpecUtils::asConcreteDataMatcher(route.matcher);
-        auto dh = header::DataHeader(concrete.description, concrete.origin, concrete.subSpec);
-
-        // create a TreeToTable object
-        TTree* tr = didir->getDataTree(dh, fcnt, ntf);
-        if (!tr) {
-          if (first) {
-            // dump metrics of file which is done for reading
-            dumpFileMetrics(monitoring, currentFile, currentFileStartedAt, currentFileIOTime, tfCurrentFile, ntf);
-            currentFile = nullptr;
-            currentFileStartedAt = uv_hrtime();
-            currentFileIOTime = 0;
-
-            // check if there is a next file to read
-            fcnt += device.maxInputTimeslices;
-            if (didir->atEnd(fcnt)) {
-              LOGP(INFO, "No input files left to read for reader {}!", device.inputTimesliceId);
-              didir->closeInputFiles();
-              control.endOfStream();
-              control.readyToQuit(QuitRequest::Me);
-              return;
-            }
-            // get first folder of next file
-            ntf = 0;
-            tr = didir->getDataTree(dh, fcnt, ntf);
-            if (!tr) {
-              LOGP(FATAL, "Can not retrieve tree for table {}: fileCounter {}, timeFrame {}", concrete.origin, fcnt, ntf);
-              throw std::runtime_error("Processing is stopped!");
-            }
-          } else {
-            LOGP(FATAL, "Can not retrieve tree for table {}: fileCounter {}, timeFrame {}", concrete.origin, fcnt, ntf);
-            throw std::runtime_error("Processing is stopped!");
-          }
-        }
-
-        if (first) {
-          timeFrameNumber = didir->getTimeFrameNumber(dh, fcnt, ntf);
-          auto o = Output(TFNumberHeader);
-          outputs.make<uint64_t>(o) = timeFrameNumber;
-        }
-
-        // create table output
-        auto o = Output(dh);
-        auto& t2t = outputs.make<TreeToTable>(o);
-
-        // add branches to read
-        // fill the table
-        auto colnames = getColumnNames(dh);
-        if (colnames.size() == 0) {
-          totalSizeCompressed += tr->GetZipBytes();
-          totalSizeUncompressed += tr->GetTotBytes();
-          t2t.addAllColumns(tr);
-        } else {
-          for (auto& colname : colnames) {
-            TBranch* branch = tr->GetBranch(colname.c_str());
-            totalSizeCompressed += branch->GetZipBytes("*");
-            totalSizeUncompressed += branch->GetTotBytes("*");
-            t2t.addColumn(colname.c_str());
-          }
-        }
-        t2t.fill(tr);
-        delete tr;
+      auto timeFrame = nextTimeFrame->valid() ? nextTimeFrame->get() : reader->read();
+      for (auto& info : timeFrame.fileReadInfos) {
+        sendFileReadInfo(monitoring, info);
+      }
+      if (timeFrame.endOfInput) {
+        reader->didir->closeInputFiles();
+        control.endOfStream();
+        control.readyToQuit(QuitRequest::Me);
+        return;
+      }
+      if (currentFileCounter != timeFrame.fileCounter) {
+        currentFileCounter = timeFrame.fileCounter;
+        monitoring.send(Metric{(uint64_t)++filesProcessed, "files-opened"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
+      }
 
-        // needed for metrics dumping (upon next file read, or terminate due to watchdog)
-        if (currentFile == nullptr) {
-          currentFile = didir->getFileFolder(dh, fcnt, ntf).file;
-          tfCurrentFile = didir->getTimeFramesInFile(dh, fcnt);
-        }
+      outputs.make<uint64_t>(Output(TFNumberHeader)) = timeFrame.timeFrameNumber;
+      for (auto& [dh, table] : timeFrame.tables) {
+        outputs.adopt(Output(dh), table);
+      }
+      monitoring.send(Metric{(uint64_t)timeFrame.numTF, "tf-sent"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
+      monitoring.send(Metric{(uint64_t)timeFrame.totalSizeUncompressed / 1000, "aod-bytes-read-uncompressed"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
+      monitoring.send(Metric{(uint64_t)timeFrame.totalSizeCompressed / 1000, "aod-bytes-read-compressed"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
 
-        first = false;
+      if (prefetch) {
+        *nextTimeFrame = std::async(std::launch::async, [reader]() { return reader->read(); });
       }
-      monitoring.send(Metric{(uint64_t)ntf, "tf-sent"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
-      monitoring.send(Metric{(uint64_t)totalSizeUncompressed / 1000, "aod-bytes-read-uncompressed"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
-      monitoring.send(Metric{(uint64_t)totalSizeCompressed / 1000, "aod-bytes-read-compressed"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
-
-      // save file number and time frame
-      *fileCounter = (fcnt - device.inputTimesliceId) / device.maxInputTimeslices;
-      *numTF = ntf;
-      currentFileIOTime += (uv_hrtime() - ioStart);
     });
   })};
 
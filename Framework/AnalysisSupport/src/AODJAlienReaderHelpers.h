@@ -23,6 +23,9 @@ namespace o2::framework::readers
 
 struct AODJAlienReaderHelpers {
   static AlgorithmSpec rootFileReaderCallback();
+  /// read info of a file, for the metric aod-file-read-info
+  static std::string fileReadInfo(TFile* currentFile, uint64_t startedAt, uint64_t ioTime, int tfPerFile, int tfRead);
+  static void sendFileReadInfo(o2::monitoring::Monitoring& monitoring, std::string const& monitoringInfo);
   static void dumpFileMetrics(o2::monitoring::Monitoring& monitoring, TFile* currentFile, uint64_t startedAt, uint64_t ioTime, int tfPerFile, int tfRead);
 };
 
@@ -17,9 +17,14 @@
 #include "Framework/RuntimeError.h"
 #include <arrow/table.h>
 
+#include <algorithm>
+#include <array>
 #include <iterator>
+#include <memory>
+#include <string>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 namespace o2::soa
 {
@@ -71,6 +76,7 @@ std::vector<std::pair<uint64_t, uint64_t>> doGroupTable(const std::shared_ptr<ar
 
   uint64_t ind = 0;
   std::vector<std::pair<uint64_t, uint64_t>> groupedIndices;
+  groupedIndices.reserve(table->num_rows());
   for (uint64_t ci = 0; ci < chunkedArray->num_chunks(); ++ci) {
     auto chunk = chunkedArray->chunk(ci);
     // Note: assuming that the table is not empty
@@ -83,20 +89,23 @@ std::vector<std::pair<uint64_t, uint64_t>> doGroupTable(const std::shared_ptr<ar
     }
   }
 
-  // Do a stable sort so that same categories entries are
-  // grouped together.
-  std::stable_sort(groupedIndices.begin(), groupedIndices.end());
+  // Sort so that same categories entries are grouped together.
+  // Row indices are unique, so this keeps the order of the rows
+  // within a category as a stable sort would.
+  std::sort(groupedIndices.begin(), groupedIndices.end());
 
   // Remove categories of too small size
   if (minCatSize > 1) {
+    auto out = groupedIndices.begin();
     auto catBegin = groupedIndices.begin();
     while (catBegin != groupedIndices.end()) {
       auto catEnd = std::upper_bound(catBegin, groupedIndices.end(), *catBegin, sameCategory);
-      if (std::distance(catBegin, catEnd) < minCatSize) {
-        catEnd = groupedIndices.erase(catBegin, catEnd);
+      if (std::distance(catBegin, catEnd) >= minCatSize) {
+        out = std::move(catBegin, catEnd, out);
       }
       catBegin = catEnd;
     }
+    groupedIndices.erase(out, groupedIndices.end());
   }
 
   return groupedIndices;
@@ -120,6 +129,18 @@ auto groupTable(const T& table, const std::string& categoryColumnName, int minCa
   if (dataType->id() == arrow::Type::INT32) {
     return doGroupTable<int32_t, arrow::Int32Array>(arrowTable, categoryColumnName, minCatSize, outsider);
   }
+  if (dataType->id() == arrow::Type::UINT16) {
+    return doGroupTable<uint16_t, arrow::UInt16Array>(arrowTable, categoryColumnName, minCatSize, outsider);
+  }
+  if (dataType->id() == arrow::Type::INT16) {
+    return doGroupTable<int16_t, arrow::Int16Array>(arrowTable, categoryColumnName, minCatSize, outsider);
+  }
+  if (dataType->id() == arrow::Type::UINT8) {
+    return doGroupTable<uint8_t, arrow::UInt8Array>(arrowTable, categoryColumnName, minCatSize, outsider);
+  }
+  if (dataType->id() == arrow::Type::INT8) {
+    return doGroupTable<int8_t, arrow::Int8Array>(arrowTable, categoryColumnName, minCatSize, outsider);
+  }
   if (dataType->id() == arrow::Type::FLOAT) {
     return doGroupTable<float, arrow::FloatArray>(arrowTable, categoryColumnName, minCatSize, outsider);
   }
@@ -127,33 +148,96 @@ auto groupTable(const T& table, const std::string& categoryColumnName, int minCa
   throw o2::framework::runtime_error("Combinations: category column must be of integral type");
 }
 
+/// Rows of a table grouped by category: the (category, row) pairs sorted by category
+/// and, for each of them, the position one past the last entry of its category, so that
+/// the combination policies never need to search for the boundaries of a category.
+struct CategoryIndex {
+  CategoryIndex(std::vector<std::pair<uint64_t, uint64_t>>&& groupedIndices) : mEntries(std::move(groupedIndices)), mCategoryEnds(mEntries.size())
+  {
+    uint64_t end = mEntries.size();
+    for (uint64_t i = mEntries.size(); i > 0; --i) {
+      if (i < mEntries.size() && mEntries[i - 1].first != mEntries[i].first) {
+        end = i;
+      }
+      mCategoryEnds[i - 1] = end;
+    }
+  }
+
+  std::pair<uint64_t, uint64_t> const& operator[](uint64_t position) const { return mEntries[position]; }
+  uint64_t size() const { return mEntries.size(); }
+  uint64_t categoryEnd(uint64_t position) const { return mCategoryEnds[position]; }
+  std::vector<std::pair<uint64_t, uint64_t>> const& entries() const { return mEntries; }
+
+ private:
+  std::vector<std::pair<uint64_t, uint64_t>> mEntries;
+  std::vector<uint64_t> mCategoryEnds;
+};
+
+/// Category index of table, built once and shared by all the combinations of the same
+/// table, binning column and parameters. The indices of the last used tables are kept
+/// for as long as the arrow tables they were built for are alive.
+template <typename T, typename T2>
+std::shared_ptr<const CategoryIndex> getCategoryIndex(const T& table, const std::string& categoryColumnName, int minCatSize, const T2& outsider)
+{
+  struct CachedIndex {
+    std::weak_ptr<arrow::Table> table;
+    std::string key;
+    std::shared_ptr<const CategoryIndex> index;
+  };
+  constexpr size_t maxCachedIndices = 16;
+  static thread_local std::vector<CachedIndex> cache;
+
+  auto arrowTable = table.asArrowTable();
+  // the outsider value enters the key with its exact bit pattern (each instantiation has its own cache)
+  auto key = categoryColumnName + "/" + std::to_string(minCatSize) + "/" + std::string(reinterpret_cast<char const*>(&outsider), sizeof(outsider));
+  cache.erase(std::remove_if(cache.begin(), cache.end(), [](CachedIndex const& cached) { return cached.table.expired(); }), cache.end());
+  for (auto& cached : cache) {
+    if (cached.table.lock() == arrowTable && cached.key == key) {
+      return cached.index;
+    }
+  }
+  if (cache.size() == maxCachedIndices) {
+    cache.erase(cache.begin());
+  }
+  auto index = std::make_shared<const CategoryIndex>(groupTable(table, categoryColumnName, minCatSize, outsider));
+  cache.push_back(CachedIndex{arrowTable, key, index});
+  return index;
+}
+
 // Synchronize categories so as groupedIndices contain elements only of categories common to all tables
 template <std::size_t K>
-void syncCategories(std::array<std::vector<std::pair<uint64_t, uint64_t>>, K>& groupedIndices)
+void syncCategories(std::array<std::shared_ptr<const CategoryIndex>, K>& groupedIndices)
 {
-  std::vector<std::pair<uint64_t, uint64_t>> firstCategories;
-  std::vector<std::pair<uint64_t, uint64_t>> commonCategories;
-  std::unique_copy(groupedIndices[0].begin(), groupedIndices[0].end(), std::back_inserter(firstCategories), diffCategory);
-
-  for (auto& cat : firstCategories) {
-    bool isCommon = true;
-    for (int i = 1; i < K; i++) {
-      if (!std::binary_search(groupedIndices[i].begin(), groupedIndices[i].end(), cat, sameCategory)) {
-        isCommon = false;
-        break;
-      }
-    }
-    if (isCommon) {
-      commonCategories.push_back(cat);
+  std::vector<uint64_t> commonCategories;
+  for (uint64_t pos = 0; pos < groupedIndices[0]->size(); pos = groupedIndices[0]->categoryEnd(pos)) {
+    commonCategories.push_back((*groupedIndices[0])[pos].first);
+  }
+  for (int i = 1; i < K; i++) {
+    std::vector<uint64_t> categories;
+    for (uint64_t pos = 0; pos < groupedIndices[i]->size(); pos = groupedIndices[i]->categoryEnd(pos)) {
+      categories.push_back((*groupedIndices[i])[pos].first);
     }
+    std::vector<uint64_t> intersection;
+    std::set_intersection(commonCategories.begin(), commonCategories.end(), categories.begin(), categories.end(), std::back_inserter(intersection));
+    commonCategories.swap(intersection);
   }
 
   for (int i = 0; i < K; i++) {
-    auto nonCatBegin = groupedIndices[i].begin();
-    for (auto& cat : commonCategories) {
-      auto nonCatEnd = std::lower_bound(nonCatBegin, groupedIndices[i].end(), cat, sameCategory);
-      nonCatEnd = groupedIndices[i].erase(nonCatBegin, nonCatEnd);
-      nonCatBegin = std::upper_bound(nonCatEnd, groupedIndices[i].end(), cat, sameCategory);
+    auto const& entries = groupedIndices[i]->entries();
+    std::vector<std::pair<uint64_t, uint64_t>> synced;
+    synced.reserve(entries.size());
+    auto cat = commonCategories.begin();
+    for (auto& entry : entries) {
+      while (cat != commonCategories.end() && *cat < entry.first) {
+        ++cat;
+      }
+      if (cat != commonCategories.end() && *cat == entry.first) {
+        synced.push_back(entry);
+      }
+    }
+    // the shared index is kept when all its categories are common
+    if (synced.size() != entries.size()) {
+      groupedIndices[i] = std::make_shared<const CategoryIndex>(std::move(synced));
     }
   }
 }
@@ -308,13 +392,13 @@ struct CombinationsBlockIndexPolicyBase : public CombinationsIndexPolicyBase<Ts.
     }
 
     int tableIndex = 0;
-    ((this->mGroupedIndices[tableIndex++] = groupTable(tables, categoryColumnName, 1, outsider)), ...);
+    ((this->mGroupedIndices[tableIndex++] = getCategoryIndex(tables, categoryColumnName, 1, outsider)), ...);
 
     // Synchronize categories across tables
     syncCategories(this->mGroupedIndices);
 
     for (int i = 0; i < k; i++) {
-      if (this->mGroupedIndices[i].size() == 0) {
+      if (this->mGroupedIndices[i]->size() == 0) {
         this->mIsEnd = true;
         return;
       }
@@ -325,7 +409,7 @@ struct CombinationsBlockIndexPolicyBase : public CombinationsIndexPolicyBase<Ts.
     });
   }
 
-  std::array<std::vector<std::pair<uint64_t, uint64_t>>, sizeof...(Ts)> mGroupedIndices;
+  std::array<std::shared_ptr<const CategoryIndex>, sizeof...(Ts)> mGroupedIndices;
   IndicesType mCurrentIndices;
   IndicesType mBeginIndices;
   uint64_t mSlidingWindowSize;
@@ -346,11 +430,10 @@ struct CombinationsBlockUpperIndexPolicy : public CombinationsBlockIndexPolicyBa
   {
     constexpr auto k = sizeof...(Ts);
     for_<k>([&, this](auto i) {
-      auto catBegin = this->mGroupedIndices[i.value].begin() + std::get<i.value>(this->mCurrentIndices);
-      auto range = std::equal_range(catBegin, this->mGroupedIndices[i.value].end(), *catBegin, sameCategory);
-      std::get<i.value>(this->mBeginIndices) = std::distance(this->mGroupedIndices[i.value].begin(), range.first);
-      std::get<i.value>(this->mCurrent).setCursor(range.first->second);
-      std::get<i.value>(this->mMaxOffset) = std::distance(this->mGroupedIndices[i.value].begin(), range.second);
+      uint64_t catBegin = std::get<i.value>(this->mCurrentIndices);
+      std::get<i.value>(this->mBeginIndices) = catBegin;
+      std::get<i.value>(this->mCurrent).setCursor((*this->mGroupedIndices[i.value])[catBegin].second);
+      std::get<i.value>(this->mMaxOffset) = this->mGroupedIndices[i.value]->categoryEnd(catBegin);
     });
   }
 
@@ -364,7 +447,7 @@ struct CombinationsBlockUpperIndexPolicy : public CombinationsBlockIndexPolicyBa
         constexpr auto curInd = k - i.value - 1;
         std::get<curInd>(this->mCurrentIndices)++;
         uint64_t curGroupedInd = std::get<curInd>(this->mCurrentIndices);
-        std::get<curInd>(this->mCurrent).setCursor(this->mGroupedIndices[curInd][curGroupedInd].second);
+        std::get<curInd>(this->mCurrent).setCursor((*this->mGroupedIndices[curInd])[curGroupedInd].second);
         uint64_t maxForWindow = std::get<curInd>(this->mBeginIndices) + this->mSlidingWindowSize;
 
         // If we remain within the same sliding window
@@ -375,7 +458,7 @@ struct CombinationsBlockUpperIndexPolicy : public CombinationsBlockIndexPolicyBa
             if (std::get<curJ - 1>(this->mCurrentIndices) < std::get<curJ>(this->mMaxOffset)) {
               std::get<curJ>(this->mCurrentIndices) = std::get<curJ - 1>(this->mCurrentIndices);
               uint64_t curGroupedJ = std::get<curJ>(this->mCurrentIndices);
-              std::get<curJ>(this->mCurrent).setCursor(this->mGroupedIndices[curJ][curGroupedJ].second);
+              std::get<curJ>(this->mCurrent).setCursor((*this->mGroupedIndices[curJ])[curGroupedJ].second);
             } else {
               modify = true;
             }
@@ -389,7 +472,7 @@ struct CombinationsBlockUpperIndexPolicy : public CombinationsBlockIndexPolicyBa
       std::get<0>(this->mCurrentIndices)++;
       std::get<0>(this->mBeginIndices)++;
       uint64_t curGroupedInd = std::get<0>(this->mCurrentIndices);
-      std::get<0>(this->mCurrent).setCursor(this->mGroupedIndices[0][curGroupedInd].second);
+      std::get<0>(this->mCurrent).setCursor((*this->mGroupedIndices[0])[curGroupedInd].second);
 
       // If we remain within the same category - slide window
       if (curGroupedInd < std::get<0>(this->mMaxOffset)) {
@@ -400,7 +483,7 @@ struct CombinationsBlockUpperIndexPolicy : public CombinationsBlockIndexPolicyBa
           if (std::get<curJ>(this->mBeginIndices) < std::get<curJ>(this->mMaxOffset)) {
             std::get<curJ>(this->mCurrentIndices) = std::get<curJ>(this->mBeginIndices);
             uint64_t curGroupedJ = std::get<curJ>(this->mCurrentIndices);
-            std::get<curJ>(this->mCurrent).setCursor(this->mGroupedIndices[curJ][curGroupedJ].second);
+            std::get<curJ>(this->mCurrent).setCursor((*this->mGroupedIndices[curJ])[curGroupedJ].second);
           } else {
             modify = true;
           }
@@ -412,7 +495,7 @@ struct CombinationsBlockUpperIndexPolicy : public CombinationsBlockIndexPolicyBa
     if (modify) {
       for_<k>([&, this](auto m) {
         std::get<m.value>(this->mCurrentIndices) = std::get<m.value>(this->mMaxOffset);
-        if (std::get<m.value>(this->mCurrentIndices) == this->mGroupedIndices[m.value].size()) {
+        if (std::get<m.value>(this->mCurrentIndices) == this->mGroupedIndices[m.value]->size()) {
           nextCatAvailable = false;
         }
       });
@@ -441,11 +524,10 @@ struct CombinationsBlockFullIndexPolicy : public CombinationsBlockIndexPolicyBas
   {
     constexpr auto k = sizeof...(Ts);
     for_<k>([&, this](auto i) {
-      auto catBegin = this->mGroupedIndices[i.value].begin() + std::get<i.value>(this->mCurrentIndices);
-      auto range = std::equal_range(catBegin, this->mGroupedIndices[i.value].end(), *catBegin, sameCategory);
-      std::get<i.value>(this->mBeginIndices) = std::distance(this->mGroupedIndices[i.value].begin(), range.first);
-      std::get<i.value>(this->mMaxOffset) = std::distance(this->mGroupedIndices[i.value].begin(), range.second);
-      std::get<i.value>(this->mCurrent).setCursor(range.first->second);
+      uint64_t catBegin = std::get<i.value>(this->mCurrentIndices);
+      std::get<i.value>(this->mBeginIndices) = catBegin;
+      std::get<i.value>(this->mMaxOffset) = this->mGroupedIndices[i.value]->categoryEnd(catBegin);
+      std::get<i.value>(this->mCurrent).setCursor((*this->mGroupedIndices[i.value])[catBegin].second);
     });
   }
 
@@ -459,7 +541,7 @@ struct CombinationsBlockFullIndexPolicy : public CombinationsBlockIndexPolicyBas
         constexpr auto curInd = k - i.value - 1;
         std::get<curInd>(this->mCurrentIndices)++;
         uint64_t curGroupedInd = std::get<curInd>(this->mCurrentIndices);
-        std::get<curInd>(this->mCurrent).setCursor(this->mGroupedIndices[curInd][curGroupedInd].second);
+        std::get<curInd>(this->mCurrent).setCursor((*this->mGroupedIndices[curInd])[curGroupedInd].second);
         uint64_t windowOffset = curInd == this->mCurrentlyFixed ? 1 : this->mSlidingWindowSize;
         uint64_t maxForWindow = std::get<curInd>(this->mBeginIndices) + windowOffset;
 
@@ -473,7 +555,7 @@ struct CombinationsBlockFullIndexPolicy : public CombinationsBlockIndexPolicyBas
               std::get<curJ>(this->mCurrentIndices) = std::get<curJ>(this->mBeginIndices);
             }
             uint64_t curGroupedJ = std::get<curJ>(this->mCurrentIndices);
-            std::get<curJ>(this->mCurrent).setCursor(this->mGroupedIndices[curJ][curGroupedJ].second);
+            std::get<curJ>(this->mCurrent).setCursor((*this->mGroupedIndices[curJ])[curGroupedJ].second);
           });
           modify = false;
         }
@@ -492,7 +574,7 @@ struct CombinationsBlockFullIndexPolicy : public CombinationsBlockIndexPolicyBas
             std::get<s.value>(this->mCurrentIndices) = std::get<s.value>(this->mBeginIndices);
           }
           uint64_t curGroupedI = std::get<s.value>(this->mCurrentIndices);
-          std::get<s.value>(this->mCurrent).setCursor(this->mGroupedIndices[s.value][curGroupedI].second);
+          std::get<s.value>(this->mCurrent).setCursor((*this->mGroupedIndices[s.value])[curGroupedI].second);
         });
         modify = false;
       } else {
@@ -500,7 +582,7 @@ struct CombinationsBlockFullIndexPolicy : public CombinationsBlockIndexPolicyBas
         std::get<0>(this->mBeginIndices)++;
         std::get<0>(this->mCurrentIndices) = std::get<0>(this->mBeginIndices);
         uint64_t curGroupedInd = std::get<0>(this->mCurrentIndices);
-        std::get<0>(this->mCurrent).setCursor(this->mGroupedIndices[0][curGroupedInd].second);
+        std::get<0>(this->mCurrent).setCursor((*this->mGroupedIndices[0])[curGroupedInd].second);
 
         // If we remain within the same category - slide window
         if (std::get<0>(this->mBeginIndices) < std::get<0>(this->mMaxOffset)) {
@@ -511,7 +593,7 @@ struct CombinationsBlockFullIndexPolicy : public CombinationsBlockIndexPolicyBas
             if (std::get<curJ>(this->mBeginIndices) < std::get<curJ>(this->mMaxOffset)) {
               std::get<curJ>(this->mCurrentIndices) = std::get<curJ>(this->mBeginIndices);
               uint64_t curGroupedJ = std::get<curJ>(this->mCurrentIndices);
-              std::get<curJ>(this->mCurrent).setCursor(this->mGroupedIndices[curJ][curGroupedJ].second);
+              std::get<curJ>(this->mCurrent).setCursor((*this->mGroupedIndices[curJ])[curGroupedJ].second);
             } else {
               modify = true;
             }
@@ -524,7 +606,7 @@ struct CombinationsBlockFullIndexPolicy : public CombinationsBlockIndexPolicyBas
     if (modify) {
       for_<k>([&, this](auto m) {
         std::get<m.value>(this->mCurrentIndices) = std::get<m.value>(this->mMaxOffset);
-        if (std::get<m.value>(this->mCurrentIndices) == this->mGroupedIndices[m.value].size()) {
+        if (std::get<m.value>(this->mCurrentIndices) == this->mGroupedIndices[m.value]->size()) {
           nextCatAvailable = false;
         }
       });
@@ -553,9 +635,9 @@ struct CombinationsBlockSameIndexPolicyBase : public CombinationsIndexPolicyBase
       return;
     }
 
-    this->mGroupedIndices = groupTable(table, categoryColumnName, minWindowSize, outsider);
+    this->mGroupedIndices = getCategoryIndex(table, categoryColumnName, minWindowSize, outsider);
 
-    if (this->mGroupedIndices.size() == 0) {
+    if (this->mGroupedIndices->size() == 0) {
       this->mIsEnd = true;
       return;
     }
@@ -563,7 +645,7 @@ struct CombinationsBlockSameIndexPolicyBase : public CombinationsIndexPolicyBase
     std::get<0>(this->mCurrentIndices) = 0;
   }
 
-  std::vector<std::pair<uint64_t, uint64_t>> mGroupedIndices;
+  std::shared_ptr<const CategoryIndex> mGroupedIndices;
   IndicesType mCurrentIndices;
   uint64_t mSlidingWindowSize;
 };
@@ -582,14 +664,13 @@ struct CombinationsBlockUpperSameIndexPolicy : public CombinationsBlockSameIndex
   void setRanges()
   {
     constexpr auto k = sizeof...(Ts) + 1;
-    auto catBegin = this->mGroupedIndices.begin() + std::get<0>(this->mCurrentIndices);
-    auto range = std::equal_range(catBegin, this->mGroupedIndices.end(), *catBegin, sameCategory);
-    uint64_t offset = std::distance(this->mGroupedIndices.begin(), range.second);
+    uint64_t catBegin = std::get<0>(this->mCurrentIndices);
+    uint64_t offset = this->mGroupedIndices->categoryEnd(catBegin);
 
     for_<k>([&, this](auto i) {
-      std::get<i.value>(this->mCurrentIndices) = std::get<0>(this->mCurrentIndices);
+      std::get<i.value>(this->mCurrentIndices) = catBegin;
       std::get<i.value>(this->mMaxOffset) = offset;
-      std::get<i.value>(this->mCurrent).setCursor(range.first->second);
+      std::get<i.value>(this->mCurrent).setCursor((*this->mGroupedIndices)[catBegin].second);
     });
   }
 
@@ -602,7 +683,7 @@ struct CombinationsBlockUpperSameIndexPolicy : public CombinationsBlockSameIndex
         constexpr auto curInd = k - i.value - 1;
         std::get<curInd>(this->mCurrentIndices)++;
         uint64_t curGroupedInd = std::get<curInd>(this->mCurrentIndices);
-        std::get<curInd>(this->mCurrent).setCursor(this->mGroupedIndices[curGroupedInd].second);
+        std::get<curInd>(this->mCurrent).setCursor((*this->mGroupedIndices)[curGroupedInd].second);
         uint64_t maxForWindow = std::get<0>(this->mCurrentIndices) + this->mSlidingWindowSize;
 
         // If we remain within the same sliding window
@@ -611,7 +692,7 @@ struct CombinationsBlockUpperSameIndexPolicy : public CombinationsBlockSameIndex
             constexpr auto curJ = k - i.value + j.value;
             std::get<curJ>(this->mCurrentIndices) = std::get<curJ - 1>(this->mCurrentIndices);
             uint64_t curGroupedJ = std::get<curJ>(this->mCurrentIndices);
-            std::get<curJ>(this->mCurrent).setCursor(this->mGroupedIndices[curGroupedJ].second);
+            std::get<curJ>(this->mCurrent).setCursor((*this->mGroupedIndices)[curGroupedJ].second);
           });
           modify = false;
         }
@@ -622,7 +703,7 @@ struct CombinationsBlockUpperSameIndexPolicy : public CombinationsBlockSameIndex
     if (modify) {
       std::get<0>(this->mCurrentIndices)++;
       uint64_t curGroupedInd = std::get<0>(this->mCurrentIndices);
-      std::get<0>(this->mCurrent).setCursor(this->mGroupedIndices[curGroupedInd].second);
+      std::get<0>(this->mCurrent).setCursor((*this->mGroupedIndices)[curGroupedInd].second);
 
       // If we remain within the same category - slide window
       if (curGroupedInd < std::get<0>(this->mMaxOffset)) {
@@ -630,14 +711,14 @@ struct CombinationsBlockUpperSameIndexPolicy : public CombinationsBlockSameIndex
           constexpr auto curJ = j.value + 1;
           std::get<curJ>(this->mCurrentIndices) = std::get<curJ - 1>(this->mCurrentIndices);
           uint64_t curGroupedJ = std::get<curJ>(this->mCurrentIndices);
-          std::get<curJ>(this->mCurrent).setCursor(this->mGroupedIndices[curGroupedJ].second);
+          std::get<curJ>(this->mCurrent).setCursor((*this->mGroupedIndices)[curGroupedJ].second);
         });
         modify = false;
       }
     }
 
     // No more combinations within this category - move to the next category, if possible
-    if (modify && std::get<0>(this->mCurrentIndices) < this->mGroupedIndices.size()) {
+    if (modify && std::get<0>(this->mCurrentIndices) < this->mGroupedIndices->size()) {
       setRanges();
       return;
     }
@@ -660,13 +741,11 @@ struct CombinationsBlockStrictlyUpperSameIndexPolicy : public CombinationsBlockS
   void setRanges()
   {
     constexpr auto k = sizeof...(Ts) + 1;
-    auto catBegin = this->mGroupedIndices.begin() + std::get<0>(this->mCurrentIndices);
-    auto lastIt = std::upper_bound(catBegin, this->mGroupedIndices.end(), *catBegin, sameCategory);
-    uint64_t lastOffset = std::distance(this->mGroupedIndices.begin(), lastIt);
+    uint64_t lastOffset = this->mGroupedIndices->categoryEnd(std::get<0>(this->mCurrentIndices));
 
     for_<k>([&, this](auto i) {
       std::get<i.value>(this->mCurrentIndices) = std::get<0>(this->mCurrentIndices) + i.value;
-      std::get<i.value>(this->mCurrent).setCursor(this->mGroupedIndices[std::get<i.value>(this->mCurrentIndices)].second);
+      std::get<i.value>(this->mCurrent).setCursor((*this->mGroupedIndices)[std::get<i.value>(this->mCurrentIndices)].second);
       std::get<i.value>(this->mMaxOffset) = lastOffset - k + i.value + 1;
     });
   }
@@ -680,7 +759,7 @@ struct CombinationsBlockStrictlyUpperSameIndexPolicy : public CombinationsBlockS
         constexpr auto curInd = k - i.value - 1;
         std::get<curInd>(this->mCurrentIndices)++;
         uint64_t curGroupedInd = std::get<curInd>(this->mCurrentIndices);
-        std::get<curInd>(this->mCurrent).setCursor(this->mGroupedIndices[curGroupedInd].second);
+        std::get<curInd>(this->mCurrent).setCursor((*this->mGroupedIndices)[curGroupedInd].second);
         uint64_t maxForWindow = std::get<0>(this->mCurrentIndices) + this->mSlidingWindowSize - i.value;
 
         // If we remain within the same sliding window
@@ -689,7 +768,7 @@ struct CombinationsBlockStrictlyUpperSameIndexPolicy : public CombinationsBlockS
             constexpr auto curJ = k - i.value + j.value;
             std::get<curJ>(this->mCurrentIndices) = std::get<curJ - 1>(this->mCurrentIndices) + 1;
             uint64_t curGroupedJ = std::get<curJ>(this->mCurrentIndices);
-            std::get<curJ>(this->mCurrent).setCursor(this->mGroupedIndices[curGroupedJ].second);
+            std::get<curJ>(this->mCurrent).setCursor((*this->mGroupedIndices)[curGroupedJ].second);
           });
           modify = false;
         }
@@ -700,7 +779,7 @@ struct CombinationsBlockStrictlyUpperSameIndexPolicy : public CombinationsBlockS
     if (modify) {
       std::get<0>(this->mCurrentIndices)++;
       uint64_t curGroupedInd = std::get<0>(this->mCurrentIndices);
-      std::get<0>(this->mCurrent).setCursor(this->mGroupedIndices[curGroupedInd].second);
+      std::get<0>(this->mCurrent).setCursor((*this->mGroupedIndices)[curGroupedInd].second);
 
       // If we remain within the same category - slide window
       if (curGroupedInd < std::get<0>(this->mMaxOffset)) {
@@ -708,14 +787,14 @@ struct CombinationsBlockStrictlyUpperSameIndexPolicy : public CombinationsBlockS
           constexpr auto curJ = j.value + 1;
           std::get<curJ>(this->mCurrentIndices) = std::get<curJ - 1>(this->mCurrentIndices) + 1;
           uint64_t curGroupedJ = std::get<curJ>(this->mCurrentIndices);
-          std::get<curJ>(this->mCurrent).setCursor(this->mGroupedIndices[curGroupedJ].second);
+          std::get<curJ>(this->mCurrent).setCursor((*this->mGroupedIndices)[curGroupedJ].second);
         });
         modify = false;
       }
     }
 
     // No more combinations within this category - move to the next category, if possible
-    if (modify && std::get<k - 1>(this->mCurrentIndices) < this->mGroupedIndices.size()) {
+    if (modify && std::get<k - 1>(this->mCurrentIndices) < this->mGroupedIndices->size()) {
       for_<k>([&, this](auto m) {
         std::get<m.value>(this->mCurrentIndices) = std::get<m.value>(this->mMaxOffset) + k - 1;
       });
@@ -741,15 +820,13 @@ struct CombinationsBlockFullSameIndexPolicy : public CombinationsBlockSameIndexP
   void setRanges()
   {
     constexpr auto k = sizeof...(Ts) + 1;
-    auto catBegin = this->mGroupedIndices.begin() + std::get<0>(this->mCurrentIndices);
-    auto range = std::equal_range(catBegin, this->mGroupedIndices.end(), *catBegin, sameCategory);
     this->mBeginIndex = std::get<0>(this->mCurrentIndices);
-    uint64_t offset = std::distance(this->mGroupedIndices.begin(), range.second);
+    uint64_t offset = this->mGroupedIndices->categoryEnd(this->mBeginIndex);
 
     for_<k>([&, this](auto i) {
       std::get<i.value>(this->mMaxOffset) = offset;
       std::get<i.value>(this->mCurrentIndices) = this->mBeginIndex;
-      std::get<i.value>(this->mCurrent).setCursor(range.first->second);
+      std::get<i.value>(this->mCurrent).setCursor((*this->mGroupedIndices)[this->mBeginIndex].second);
     });
   }
 
@@ -762,7 +839,7 @@ struct CombinationsBlockFullSameIndexPolicy : public CombinationsBlockSameIndexP
         constexpr auto curInd = k - i.value - 1;
         std::get<curInd>(this->mCurrentIndices)++;
         uint64_t curGroupedInd = std::get<curInd>(this->mCurrentIndices);
-        std::get<curInd>(this->mCurrent).setCursor(this->mGroupedIndices[curGroupedInd].second);
+        std::get<curInd>(this->mCurrent).setCursor((*this->mGroupedIndices)[curGroupedInd].second);
         uint64_t windowOffset = curInd == this->mCurrentlyFixed ? 1 : this->mSlidingWindowSize;
         uint64_t maxForWindow = this->mBeginIndex + windowOffset;
 
@@ -776,7 +853,7 @@ struct CombinationsBlockFullSameIndexPolicy : public CombinationsBlockSameIndexP
               std::get<curJ>(this->mCurrentIndices) = this->mBeginIndex;
             }
             uint64_t curGroupedJ = std::get<curJ>(this->mCurrentIndices);
-            std::get<curJ>(this->mCurrent).setCursor(this->mGroupedIndices[curGroupedJ].second);
+            std::get<curJ>(this->mCurrent).setCursor((*this->mGroupedIndices)[curGroupedJ].second);
           });
           modify = false;
         }
@@ -795,7 +872,7 @@ struct CombinationsBlockFullSameIndexPolicy : public CombinationsBlockSameIndexP
             std::get<s.value>(this->mCurrentIndices) = this->mBeginIndex;
           }
           uint64_t curGroupedI = std::get<s.value>(this->mCurrentIndices);
-          std::get<s.value>(this->mCurrent).setCursor(this->mGroupedIndices[curGroupedI].second);
+          std::get<s.value>(this->mCurrent).setCursor((*this->mGroupedIndices)[curGroupedI].second);
         });
         modify = false;
       } else {
@@ -803,7 +880,7 @@ struct CombinationsBlockFullSameIndexPolicy : public CombinationsBlockSameIndexP
         this->mBeginIndex++;
         std::get<0>(this->mCurrentIndices) = this->mBeginIndex;
         uint64_t curGroupedInd = std::get<0>(this->mCurrentIndices);
-        std::get<0>(this->mCurrent).setCursor(this->mGroupedIndices[curGroupedInd].second);
+        std::get<0>(this->mCurrent).setCursor((*this->mGroupedIndices)[curGroupedInd].second);
 
         // If we remain within the same category - slide window
         if (this->mBeginIndex < std::get<0>(this->mMaxOffset)) {
@@ -811,7 +888,7 @@ struct CombinationsBlockFullSameIndexPolicy : public CombinationsBlockSameIndexP
             constexpr auto curJ = j.value + 1;
             std::get<curJ>(this->mCurrentIndices) = this->mBeginIndex;
             uint64_t curGroupedJ = std::get<curJ>(this->mCurrentIndices);
-            std::get<curJ>(this->mCurrent).setCursor(this->mGroupedIndices[curGroupedJ].second);
+            std::get<curJ>(this->mCurrent).setCursor((*this->mGroupedIndices)[curGroupedJ].second);
           });
           modify = false;
         } else {
@@ -823,7 +900,7 @@ struct CombinationsBlockFullSameIndexPolicy : public CombinationsBlockSameIndexP
     }
 
     // No more combinations within this category - move to the next category, if possible
-    if (modify && std::get<0>(this->mCurrentIndices) < this->mGroupedIndices.size()) {
+    if (modify && std::get<0>(this->mCurrentIndices) < this->mGroupedIndices->size()) {
       setRanges();
       return;
     }
@@ -938,6 +1015,52 @@ auto selfTripleCombinations(const char* categoryColumnName, int categoryNeighbou
   return CombinationsGenerator<CombinationsBlockStrictlyUpperSameIndexPolicy<T1, T2, T2, T2>>(CombinationsBlockStrictlyUpperSameIndexPolicy(categoryColumnName, categoryNeighbours, outsider, table, table, table));
 }
 
+/// Row indices of the K-tuples of rows of table given by selfCombinations(categoryColumnName, categoryNeighbours, outsider, table, ...),
+/// in the same order. They are generated from the category index into a contiguous buffer without moving any table
+/// iterator, which is much faster when the combinations are to be processed in bulk or visited several times.
+template <std::size_t K, typename T1, typename T2>
+std::vector<std::array<uint64_t, K>> selfCombinationsIndices(const char* categoryColumnName, int categoryNeighbours, const T1& outsider, const T2& table)
+{
+  static_assert(K > 1, "Combinations of at least two rows are needed");
+  std::vector<std::array<uint64_t, K>> combinations;
+  uint64_t windowSize = categoryNeighbours + 1;
+  if (table.size() == 0 || categoryNeighbours < 0 || windowSize < K) {
+    return combinations;
+  }
+
+  auto index = getCategoryIndex(table, categoryColumnName, K, outsider);
+  auto const& grouped = *index;
+  std::array<uint64_t, K> positions;
+  for (uint64_t catBegin = 0; catBegin < grouped.size(); catBegin = grouped.categoryEnd(catBegin)) {
+    uint64_t catEnd = grouped.categoryEnd(catBegin);
+    for (uint64_t first = catBegin; first + K <= catEnd; ++first) {
+      // strictly increasing positions within the sliding window, in lexicographic order
+      uint64_t last = std::min(first + windowSize, catEnd);
+      for (std::size_t i = 0; i < K; ++i) {
+        positions[i] = first + i;
+      }
+      while (true) {
+        auto& combination = combinations.emplace_back();
+        for (std::size_t i = 0; i < K; ++i) {
+          combination[i] = grouped[positions[i]].second;
+        }
+        std::size_t i = K - 1;
+        while (i > 0 && positions[i] + K - i >= last) {
+          --i;
+        }
+        if (i == 0) {
+          break;
+        }
+        ++positions[i];
+        for (std::size_t j = i + 1; j < K; ++j) {
+          positions[j] = positions[j - 1] + 1;
+        }
+      }
+    }
+  }
+  return combinations;
+}
+
 template <typename T1, typename T2, typename... T2s>
 auto combinations(const char* categoryColumnName, int categoryNeighbours, const T1& outsider, const T2& table, const T2s&... tables)
 {
@@ -20,7 +20,11 @@
 #include "Framework/OutputObjHeader.h"
 #include "Framework/StringHelpers.h"
 #include "Framework/Output.h"
+#include "Framework/RuntimeError.h"
+#include <algorithm>
+#include <array>
 #include <string>
+#include <vector>
 #include "Framework/Logger.h"
 
 namespace o2::framework
@@ -39,17 +43,31 @@ struct WritingCursor<soa::Table<PC...>> {
   using persistent_table_t = soa::Table<PC...>;
   using cursor_t = decltype(std::declval<TableBuilder>().cursor<persistent_table_t>());
 
+  /// Copy of a row, kept when the rows are buffered
+  template <typename T>
+  using buffered_t = std::conditional_t<std::is_array_v<T>, std::array<std::remove_extent_t<T>, std::extent_v<T>>, T>;
+  using row_t = std::tuple<buffered_t<typename PC::type>...>;
+
   template <typename... T>
   void operator()(T... args)
   {
     static_assert(sizeof...(PC) == sizeof...(T), "Argument number mismatch");
     ++mCount;
+    if (O2_BUILTIN_UNLIKELY(mBuffer != nullptr)) {
+      mBuffer->emplace_back(bufferValue<typename PC::type>(extract(args))...);
+      return;
+    }
     cursor(0, extract(args)...);
   }
 
-  /// Last index inserted in the table
+  /// Last index inserted in the table. Not available while the rows are
+  /// buffered in chunks, as the position of the row in the final table is
+  /// only known once all the chunks are written.
   int64_t lastIndex()
   {
+    if (O2_BUILTIN_UNLIKELY(mChunks != nullptr)) {
+      throw runtime_error("lastIndex() cannot be used when process() is invoked from several threads, use --process-threads 1");
+    }
     return mCount;
   }
 
@@ -58,6 +76,8 @@ struct WritingCursor<soa::Table<PC...>> {
     mBuilder = &builder;
     cursor = std::move(FFL(builder.cursor<persistent_table_t>()));
     mCount = -1;
+    mBuffer = nullptr;
+    mChunks.reset();
     return true;
   }
 
@@ -65,9 +85,43 @@ struct WritingCursor<soa::Table<PC...>> {
   /// spend time reallocating the buffers.
   void reserve(int64_t size)
   {
+    if (mBuffer != nullptr) {
+      mBuffer->reserve(mBuffer->size() + size);
+      return;
+    }
     mBuilder->reserve(typename persistent_table_t::column_types{}, size);
   }
 
+  /// When process() is invoked from several threads, the rows are buffered
+  /// in nChunks chunks (shared by the copies of the cursor, each chunk being
+  /// filled by a single thread) and written to the table in the order of the
+  /// chunks by writeChunks().
+  void setChunks(int nChunks)
+  {
+    mChunks = std::make_shared<std::vector<std::vector<row_t>>>(nChunks);
+  }
+
+  /// buffer the following rows in the given chunk
+  void setChunk(int chunk)
+  {
+    mBuffer = &(*mChunks)[chunk];
+  }
+
+  /// write the rows of all the chunks to the table
+  void writeChunks()
+  {
+    if (!mChunks) {
+      return;
+    }
+    for (auto& rows : *mChunks) {
+      for (auto& row : rows) {
+        std::apply([this](auto&... values) { cursor(0, unbufferValue(values)...); }, row);
+      }
+      mCount += rows.size();
+    }
+    mChunks.reset();
+  }
+
   decltype(FFL(std::declval<cursor_t>())) cursor;
 
  private:
@@ -82,11 +136,39 @@ struct WritingCursor<soa::Table<PC...>> {
     }
   }
 
+  template <typename C, typename T>
+  static buffered_t<C> bufferValue(T const& value)
+  {
+    if constexpr (std::is_array_v<C>) {
+      buffered_t<C> copy;
+      std::copy_n(value, copy.size(), copy.begin());
+      return copy;
+    } else {
+      return value;
+    }
+  }
+
+  template <typename T>
+  static T const& unbufferValue(T const& value)
+  {
+    return value;
+  }
+
+  template <typename T, std::size_t N>
+  static T* unbufferValue(std::array<T, N>& value)
+  {
+    return value.data();
+  }
+
   /// The table builder which actually performs the
   /// construction of the table. We keep it around to be
   /// able to do all-columns methods like reserve.
   TableBuilder* mBuilder = nullptr;
   int64_t mCount = -1;
+
+  /// Rows buffered per chunk when process() is invoked from several threads
+  std::shared_ptr<std::vector<std::vector<row_t>>> mChunks;
+  std::vector<row_t>* mBuffer = nullptr;
 };
 
 template <typename T>
@@ -485,17 +567,17 @@ o2::soa::Filtered<T>* getTableFromFilter(const T& table, const expressions::Filt
 {
   auto schema = table.asArrowTable()->schema();
   expressions::Operations ops = createOperations(filter);
-  gandiva::NodePtr tree = nullptr;
-  if (isSchemaCompatible(schema, ops)) {
-    tree = createExpressionTree(ops, schema);
-  } else {
+  if (!isSchemaCompatible(schema, ops)) {
     throw std::runtime_error("Partition filter does not match declared table type");
   }
+  // partitions are usually applied to small per-group slices, for which
+  // interpreting the filter is cheaper than compiling it
+  auto selection = expressions::createSelection(table.asArrowTable(), ops);
 
   if constexpr (soa::is_soa_filtered_t<std::decay_t<T>>::value) {
-    return new o2::soa::Filtered<T>{{table}, tree};
+    return new o2::soa::Filtered<T>{{table}, selection};
   } else {
-    return new o2::soa::Filtered<T>{{table.asArrowTable()}, tree};
+    return new o2::soa::Filtered<T>{{table.asArrowTable()}, selection};
   }
 }
 
@@ -32,11 +32,17 @@
 #include <arrow/compute/kernel.h>
 #include <arrow/table.h>
 #include <gandiva/node.h>
+#include <algorithm>
+#include <functional>
 #include <type_traits>
 #include <utility>
 #include <memory>
 #include <sstream>
 #include <iomanip>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
 namespace o2::framework
 {
 /// A more familiar task API for the DPL analysis framework.
@@ -441,13 +447,13 @@ struct AnalysisDataProcessorBuilder {
   };
 
   template <typename Task, typename... T>
-  static void invokeProcessTuple(Task& task, InputRecord& inputs, std::tuple<T...> const& processTuple, std::vector<ExpressionInfo> const& infos)
+  static void invokeProcessTuple(Task& task, InputRecord& inputs, std::tuple<T...> const& processTuple, std::vector<ExpressionInfo> const& infos, int nThreads = 1)
   {
-    (invokeProcess<o2::framework::has_type_at_v<T>(pack<T...>{})>(task, inputs, std::get<T>(processTuple), infos), ...);
+    (invokeProcess<o2::framework::has_type_at_v<T>(pack<T...>{})>(task, inputs, std::get<T>(processTuple), infos, nThreads), ...);
   }
 
   template <int PI, typename Task, typename R, typename C, typename Grouping, typename... Associated>
-  static void invokeProcess(Task& task, InputRecord& inputs, R (C::*processingFunction)(Grouping, Associated...), std::vector<ExpressionInfo> const& infos)
+  static void invokeProcess(Task& task, InputRecord& inputs, R (C::*processingFunction)(Grouping, Associated...), std::vector<ExpressionInfo> const& infos, int nThreads = 1)
   {
     using G = std::decay_t<Grouping>;
     auto groupingTable = AnalysisDataProcessorBuilder::bindGroupingTable<PI>(inputs, processingFunction, infos);
@@ -481,7 +487,7 @@ struct AnalysisDataProcessorBuilder {
       static_assert(((soa::is_soa_iterator_t<std::decay_t<Associated>>::value == false) && ...),
                     "Associated arguments of process() should not be iterators");
       auto associatedTables = AnalysisDataProcessorBuilder::bindAssociatedTables<PI>(inputs, processingFunction, infos);
-      auto binder = [&](auto&& x) {
+      auto binder = [&](Task& boundTask, auto&& x) {
         x.bindExternalIndices(&groupingTable, &std::get<std::decay_t<Associated>>(associatedTables)...);
         homogeneous_apply_refs([&x](auto& t) {
           PartitionManager<std::decay_t<decltype(t)>>::setPartition(t, x);
@@ -489,26 +495,24 @@ struct AnalysisDataProcessorBuilder {
           PartitionManager<std::decay_t<decltype(t)>>::getBoundToExternalIndices(t, x);
           return true;
         },
-                               task);
+                               boundTask);
       };
       groupingTable.bindExternalIndices(&std::get<std::decay_t<Associated>>(associatedTables)...);
 
       // always pre-bind full tables to support index hierarchy
       std::apply(
         [&](auto&&... x) {
-          (binder(x), ...);
+          (binder(task, x), ...);
         },
         associatedTables);
 
       if constexpr (soa::is_soa_iterator_t<std::decay_t<G>>::value) {
         // grouping case
         auto slicer = GroupSlicer(groupingTable, associatedTables);
-        for (auto& slice : slicer) {
-          auto associatedSlices = slice.associatedTables();
-
+        auto processSlice = [&](Task& boundTask, auto& groupingElement, auto& associatedSlices) {
           std::apply(
             [&](auto&&... x) {
-              (binder(x), ...);
+              (binder(boundTask, x), ...);
             },
             associatedSlices);
 
@@ -518,9 +522,29 @@ struct AnalysisDataProcessorBuilder {
             PartitionManager<std::decay_t<decltype(x)>>::getBoundToExternalIndices(x, groupingTable);
             return true;
           },
-                                 task);
+                                 boundTask);
+
+          invokeProcessWithArgsGeneric(boundTask, processingFunction, groupingElement, associatedSlices);
+        };
 
-          invokeProcessWithArgsGeneric(task, processingFunction, slice.groupingElement(), associatedSlices);
+        if constexpr (std::is_copy_constructible_v<Task>) {
+          if (nThreads > 1) {
+            // the slices are prepared in order, as the slicing of filtered tables is incremental
+            using slice_t = std::pair<std::decay_t<decltype(slicer.begin().groupingElement())>, decltype(slicer.begin().associatedTables())>;
+            std::vector<slice_t> slices;
+            for (auto& slice : slicer) {
+              slices.emplace_back(slice.groupingElement(), slice.associatedTables());
+            }
+            invokeProcessParallel(task, nThreads, slices, [&](Task& boundTask, slice_t& slice) {
+              processSlice(boundTask, slice.first, slice.second);
+            });
+            return;
+          }
+        }
+
+        for (auto& slice : slicer) {
+          auto associatedSlices = slice.associatedTables();
+          processSlice(task, slice.groupingElement(), associatedSlices);
         }
       } else {
         // non-grouping case
@@ -538,6 +562,86 @@ struct AnalysisDataProcessorBuilder {
     }
   }
 
+  /// Process the slices with nThreads copies of the task. The chunks of
+  /// slices are handed out to the threads as they become free, the rows of
+  /// the Produces<> tables are buffered per chunk and written in the order of
+  /// the slices at the end, the HistogramRegistries are filled per thread and
+  /// the OutputObj are filled per copy and added to the ones of the task.
+  /// The other members of the copies are passed to Task::merge(), if any.
+  template <typename Task, typename S, typename F>
+  static void invokeProcessParallel(Task& task, int nThreads, std::vector<S>& slices, F&& processSlice)
+  {
+    const int nSlices = slices.size();
+    const int chunkSize = std::max(1, nSlices / (8 * nThreads));
+    const int nChunks = (nSlices + chunkSize - 1) / chunkSize;
+    homogeneous_apply_refs([nThreads, nChunks](auto& x) { return ParallelProcessManager<std::decay_t<decltype(x)>>::prepare(x, nThreads, nChunks); }, task);
+
+    std::vector<std::unique_ptr<Task>> copies;
+    std::vector<std::function<void()>> merges;
+    for (int slot = 0; slot < nThreads; ++slot) {
+      copies.emplace_back(std::make_unique<Task>(task));
+      homogeneous_apply_refs([&merges](auto& x) { return ParallelProcessManager<std::decay_t<decltype(x)>>::detach(x, merges); }, *copies.back());
+    }
+    std::atomic<int> nextChunk{0};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    auto worker = [&](int slot) {
+      HistogramRegistry::setThreadSlot(slot);
+      auto& boundTask = *copies[slot];
+      try {
+        for (int chunk = nextChunk++; chunk < nChunks; chunk = nextChunk++) {
+          homogeneous_apply_refs([chunk](auto& x) { return ParallelProcessManager<std::decay_t<decltype(x)>>::setChunk(x, chunk); }, boundTask);
+          for (int i = chunk * chunkSize; i < std::min(nSlices, (chunk + 1) * chunkSize); ++i) {
+            processSlice(boundTask, slices[i]);
+          }
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+        nextChunk = nChunks;
+      }
+    };
+    std::vector<std::thread> threads;
+    for (int slot = 1; slot < nThreads; ++slot) {
+      threads.emplace_back(worker, slot);
+    }
+    worker(0);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    homogeneous_apply_refs([](auto& x) { return ParallelProcessManager<std::decay_t<decltype(x)>>::finalize(x); }, task);
+    if (error) {
+      std::rethrow_exception(error);
+    }
+    for (auto& merge : merges) {
+      merge();
+    }
+    for (auto& copy : copies) {
+      mergeCopy(task, *copy, 0);
+    }
+  }
+
+  /// Whether process() can be invoked from several threads for this task
+  template <typename Task>
+  static bool supportsParallelProcess(Task& task)
+  {
+    auto supported = homogeneous_apply_refs([](auto& x) { return ParallelProcessManager<std::decay_t<decltype(x)>>::isSupported(x); }, task);
+    return std::all_of(supported.begin(), supported.end(), [](bool x) { return x; });
+  }
+
+  template <typename Task>
+  static auto mergeCopy(Task& task, Task& copy, int) -> decltype(task.merge(copy), void())
+  {
+    task.merge(copy);
+  }
+
+  template <typename Task>
+  static void mergeCopy(Task&, Task&, ...)
+  {
+  }
+
   template <typename C, typename T, typename G, typename... A>
   static void invokeProcessWithArgsGeneric(C& task, T processingFunction, G g, std::tuple<A...>& at)
   {
@@ -713,6 +817,10 @@ DataProcessorSpec adaptAnalysisTask(ConfigContext const& ctx, Args&&... args)
 
   homogeneous_apply_refs([&outputs, &hash](auto& x) { return OutputManager<std::decay_t<decltype(x)>>::appendOutput(outputs, x, hash); }, *task.get());
 
+  if constexpr ((std::tuple_size_v<std::decay_t<decltype(processTuple)>>) > 0) {
+    options.emplace_back(ConfigParamSpec{"process-threads", VariantType::Int, 1, {"Number of threads invoking the grouped process() functions, each with its own copy of the task"}});
+  }
+
   auto algo = AlgorithmSpec::InitCallback{[task = task, processTuple = processTuple, expressionInfos](InitContext& ic) mutable {
     homogeneous_apply_refs([&ic](auto&& x) { return OptionManager<std::decay_t<decltype(x)>>::prepare(ic, x); }, *task.get());
     homogeneous_apply_refs([&ic](auto&& x) { return ServiceManager<std::decay_t<decltype(x)>>::prepare(ic, x); }, *task.get());
@@ -744,13 +852,26 @@ DataProcessorSpec adaptAnalysisTask(ConfigContext const& ctx, Args&&... args)
       task->init(ic);
     }
 
-    return [task, processTuple, expressionInfos](ProcessingContext& pc) {
+    int nThreads = 1;
+    if constexpr ((std::tuple_size_v<std::decay_t<decltype(processTuple)>>) > 0) {
+      nThreads = ic.options().get<int>("process-threads");
+      if (nThreads > 1 && !std::is_copy_constructible_v<T>) {
+        LOGP(WARNING, "The task cannot be copied, process() is invoked from a single thread");
+        nThreads = 1;
+      }
+      if (nThreads > 1 && !AnalysisDataProcessorBuilder::supportsParallelProcess(*task.get())) {
+        LOGP(WARNING, "The task has OutputObj which cannot be merged, process() is invoked from a single thread");
+        nThreads = 1;
+      }
+    }
+
+    return [task, processTuple, expressionInfos, nThreads](ProcessingContext& pc) {
       homogeneous_apply_refs([&pc](auto&& x) { return OutputManager<std::decay_t<decltype(x)>>::prepare(pc, x); }, *task.get());
       if constexpr (has_run_v<T>) {
         task->run(pc);
       }
       if constexpr ((std::tuple_size_v<std::decay_t<decltype(processTuple)>>) > 0) {
-        AnalysisDataProcessorBuilder::invokeProcessTuple(*(task.get()), pc.inputs(), processTuple, expressionInfos);
+        AnalysisDataProcessorBuilder::invokeProcessTuple(*(task.get()), pc.inputs(), processTuple, expressionInfos, nThreads);
       }
       homogeneous_apply_refs([&pc](auto&& x) { return OutputManager<std::decay_t<decltype(x)>>::finalize(pc, x); }, *task.get());
     };
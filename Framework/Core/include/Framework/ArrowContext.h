@@ -116,6 +116,15 @@ class ArrowContext
     return mBytesSent;
   }
 
+  /// The bytes sent since the previous call, whose shared memory
+  /// has to be released from the offers.
+  size_t takeBytesSentSinceDispose()
+  {
+    auto bytes = mBytesSent - mBytesDisposed;
+    mBytesDisposed = mBytesSent;
+    return bytes;
+  }
+
   size_t bytesDestroyed()
   {
     return mBytesDestroyed;
@@ -135,6 +144,7 @@ class ArrowContext
   FairMQDeviceProxy mProxy;
   Messages mMessages;
   size_t mBytesSent = 0;
+  size_t mBytesDisposed = 0;
   size_t mBytesDestroyed = 0;
   size_t mMessagesCreated = 0;
   size_t mMessagesDestroyed = 0;
@@ -0,0 +1,92 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef O2_FRAMEWORK_ARROWFILEHELPERS_H_
+#define O2_FRAMEWORK_ARROWFILEHELPERS_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace arrow
+{
+class Schema;
+class Table;
+namespace io
+{
+class OutputStream;
+}
+namespace ipc
+{
+class RecordBatchWriter;
+}
+} // namespace arrow
+
+namespace o2::framework
+{
+
+// -----------------------------------------------------------------------------
+// An AO2D in arrow format is a directory name.arrow which mirrors the layout
+// of the ROOT AO2D files: the sub-directory DF_<n> holds the tables of the
+// time frame folder n, each table being stored in the arrow IPC file
+// <treename>.arrow as one record batch per written time frame.
+//
+// The files are memory mapped when read, the buffers of the resulting
+// arrow::Table refer to the mapped memory (unless the file is compressed)
+// and can be given as they are to a soa::Table.
+// .............................................................................
+struct ArrowFileHelpers {
+  // whether filename refers to an AO2D in arrow format
+  static bool isArrowAOD(std::string const& filename);
+
+  // sorted numbers of the time frame folders DF_<n> of an AO2D in arrow format
+  static std::vector<uint64_t> getTimeFrameNumbers(std::string const& aodname);
+
+  // name of the file holding the table treename in the folder of an AO2D in arrow format
+  static std::string getTableFileName(std::string const& aodname, std::string const& folder, std::string const& treename);
+
+  // read the table stored in an arrow IPC file
+  static std::shared_ptr<arrow::Table> readTable(std::string const& filename);
+
+  // convert an AO2D from ROOT to arrow format
+  static void convertToArrow(std::string const& rootFile, std::string const& aodname, bool compress = false);
+
+  // convert an AO2D from arrow to ROOT format
+  static void convertToRoot(std::string const& aodname, std::string const& rootFile);
+};
+
+// -----------------------------------------------------------------------------
+// ArrowTableWriter writes the record batches of tables with the same schema
+// to an arrow IPC file. The file is created when the writer is opened: the
+// tables of an already existing file are then written first, so that a file
+// which is reopened is extended and not overwritten.
+//
+// To write the tables ta1, ta2, ... to the file fn do:
+//  . ArrowTableWriter w(fn, ta1->schema(), compress);
+//  . w.write(ta1); w.write(ta2); ...
+//  . w.close();
+// .............................................................................
+class ArrowTableWriter
+{
+ public:
+  ArrowTableWriter(std::string const& filename, std::shared_ptr<arrow::Schema> schema, bool compress = false);
+  ~ArrowTableWriter();
+
+  void write(std::shared_ptr<arrow::Table> table);
+  void close();
+
+ private:
+  std::shared_ptr<arrow::io::OutputStream> mStream;
+  std::shared_ptr<arrow::ipc::RecordBatchWriter> mWriter;
+};
+
+} // namespace o2::framework
+
+#endif // O2_FRAMEWORK_ARROWFILEHELPERS_H_
@@ -60,6 +60,7 @@ namespace o2
 namespace framework
 {
 class ServiceRegistry;
+class ArrowContext;
 
 #define ERROR_STRING                                          \
   "data type T not supported by API, "                        \
@@ -87,10 +88,23 @@ class DataAllocator
     using value_type = T;
   };
 
+  /// The contexts in which the messages are created. By default those
+  /// registered as services, a device running more than one processing
+  /// stream gives each stream its own set.
+  struct OutputContexts {
+    MessageContext* message = nullptr;
+    StringContext* string = nullptr;
+    ArrowContext* arrow = nullptr;
+    RawBufferContext* rawBuffer = nullptr;
+  };
+
   DataAllocator(TimingInfo* timingInfo,
                 ServiceRegistry* contextes,
                 const AllowedOutputRoutes& routes);
 
+  /// Create the messages in @a contexts rather than in the registered ones
+  void setOutputContexts(OutputContexts const& contexts) { mOutputContexts = contexts; }
+
   DataChunk& newChunk(const Output&, size_t);
 
   inline DataChunk& newChunk(OutputRef&& ref, size_t size) { return newChunk(getOutputByBind(std::move(ref)), size); }
@@ -110,7 +124,7 @@ class DataAllocator
       // plain buffer as polymorphic spectator std::vector, which does not run constructors / destructors
       using ValueType = typename T::value_type;
       std::string const& channel = matchDataHeader(spec, mTimingInfo->timeslice);
-      auto& context = mRegistry->get<MessageContext>();
+      auto& context = messageContext();
 
       // Note: initial payload size is 0 and will be set by the context before sending
       FairMQMessagePtr headerMessage = headerMessageFromOutput(spec, channel, o2::header::gSerializationMethodNone, 0);
@@ -122,7 +136,7 @@ class DataAllocator
       // has a root dictionary, so non-serialized transmission is preferred
       using ValueType = typename T::value_type;
       std::string const& channel = matchDataHeader(spec, mTimingInfo->timeslice);
-      auto& context = mRegistry->get<MessageContext>();
+      auto& context = messageContext();
 
       // Note: initial payload size is 0 and will be set by the context before sending
       FairMQMessagePtr headerMessage = headerMessageFromOutput(spec, channel, o2::header::gSerializationMethodNone, 0);
@@ -131,7 +145,7 @@ class DataAllocator
       // Extended support for types implementing the Root ClassDef interface, both TObject
       // derived types and others
       std::string const& channel = matchDataHeader(spec, mTimingInfo->timeslice);
-      auto& context = mRegistry->get<MessageContext>();
+      auto& context = messageContext();
 
       // Note: initial payload size is 0 and will be set by the context before sending
       FairMQMessagePtr headerMessage = headerMessageFromOutput(spec, channel, o2::header::gSerializationMethodROOT, 0);
@@ -173,7 +187,7 @@ class DataAllocator
           auto [nElements] = std::make_tuple(args...);
           auto size = nElements * sizeof(T);
           std::string const& channel = matchDataHeader(spec, mTimingInfo->timeslice);
-          auto& context = mRegistry->get<MessageContext>();
+          auto& context = messageContext();
 
           FairMQMessagePtr headerMessage = headerMessageFromOutput(spec, channel, o2::header::gSerializationMethodNone, size);
           return context.add<MessageContext::SpanObject<T>>(std::move(headerMessage), channel, 0, nElements).get();
@@ -252,7 +266,7 @@ class DataAllocator
       delete tmpPtr;
     };
 
-    mRegistry->get<RawBufferContext>().addRawBuffer(std::move(header), std::move(payload), std::move(channel), std::move(lambdaSerialize), std::move(lambdaDestructor));
+    rawBufferContext().addRawBuffer(std::move(header), std::move(payload), std::move(channel), std::move(lambdaSerialize), std::move(lambdaDestructor));
   }
 
   /// Send a snapshot of an object, depending on the object type it is serialized before.
@@ -277,7 +291,7 @@ class DataAllocator
   template <typename T>
   void snapshot(const Output& spec, T const& object)
   {
-    auto proxy = mRegistry->get<MessageContext>().proxy();
+    auto proxy = messageContext().proxy();
     FairMQMessagePtr payloadMessage;
     auto serializationType = o2::header::gSerializationMethodNone;
     if constexpr (is_messageable<T>::value == true) {
@@ -402,7 +416,7 @@ class DataAllocator
   o2::pmr::FairMQMemoryResource* getMemoryResource(const Output& spec)
   {
     std::string const& channel = matchDataHeader(spec, mTimingInfo->timeslice);
-    auto& context = mRegistry->get<MessageContext>();
+    auto& context = messageContext();
     return *context.proxy().getTransport(channel);
   }
 
@@ -424,7 +438,7 @@ class DataAllocator
     // and put it in the queue to be sent at the end of the processing
     std::string const& channel = matchDataHeader(spec, mTimingInfo->timeslice);
 
-    auto& context = mRegistry->get<MessageContext>();
+    auto& context = messageContext();
     FairMQMessagePtr payloadMessage = o2::pmr::getMessage(std::forward<ContainerT>(container), *context.proxy().getTransport(channel));
 
     FairMQMessagePtr headerMessage = headerMessageFromOutput(spec, channel,                        //
@@ -451,18 +465,33 @@ class DataAllocator
 
   o2::header::DataHeader* findMessageHeader(const Output& spec)
   {
-    return mRegistry->get<MessageContext>().findMessageHeader(spec);
+    return messageContext().findMessageHeader(spec);
   }
 
   o2::header::DataHeader* findMessageHeader(OutputRef&& ref)
   {
-    return mRegistry->get<MessageContext>().findMessageHeader(getOutputByBind(std::move(ref)));
+    return messageContext().findMessageHeader(getOutputByBind(std::move(ref)));
   }
 
  private:
   AllowedOutputRoutes mAllowedOutputRoutes;
   TimingInfo* mTimingInfo;
   ServiceRegistry* mRegistry;
+  OutputContexts mOutputContexts;
+
+  MessageContext& messageContext()
+  {
+    return mOutputContexts.message ? *mOutputContexts.message : mRegistry->get<MessageContext>();
+  }
+  StringContext& stringContext()
+  {
+    return mOutputContexts.string ? *mOutputContexts.string : mRegistry->get<StringContext>();
+  }
+  RawBufferContext& rawBufferContext()
+  {
+    return mOutputContexts.rawBuffer ? *mOutputContexts.rawBuffer : mRegistry->get<RawBufferContext>();
+  }
+  ArrowContext& arrowContext();
 
   std::string const& matchDataHeader(const Output& spec, size_t timeframeId);
   FairMQMessagePtr headerMessageFromOutput(Output const& spec,                                  //
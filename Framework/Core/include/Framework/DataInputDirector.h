@@ -16,9 +16,15 @@
 
 #include "Framework/DataDescriptorMatcher.h"
 
+#include <memory>
 #include <regex>
 #include "rapidjson/fwd.h"
 
+namespace arrow
+{
+class Table;
+}
+
 namespace o2::framework
 {
 
@@ -71,6 +77,8 @@ struct DataInputDescriptor {
   uint64_t getTimeFrameNumber(int counter, int numTF);
   FileAndFolder getFileFolder(int counter, int numTF);
   int getTimeFramesInFile(int counter);
+  bool isArrowFile(int counter);
+  std::string getFileName(int counter);
 
   void closeInputFile();
   bool isAlienSupportOn() { return mAlienSupport; }
@@ -114,6 +122,9 @@ struct DataInputDirector {
 
   std::unique_ptr<TTreeReader> getTreeReader(header::DataHeader dh, int counter, int numTF, std::string treeName);
   TTree* getDataTree(header::DataHeader dh, int counter, int numTF);
+  // for an AO2D in arrow format (see ArrowFileHelpers) the tables are read directly
+  bool isArrowAOD(header::DataHeader dh, int counter);
+  std::shared_ptr<arrow::Table> getDataTable(header::DataHeader dh, int counter, int numTF);
   uint64_t getTimeFrameNumber(header::DataHeader dh, int counter, int numTF);
   FileAndFolder getFileFolder(header::DataHeader dh, int counter, int numTF);
   int getTimeFramesInFile(header::DataHeader dh, int counter);
@@ -16,9 +16,13 @@
 #include "Framework/DataSpecUtils.h"
 #include "Framework/InputSpec.h"
 #include "Framework/DataInputDirector.h"
+#include "Framework/ArrowFileHelpers.h"
 
 #include "rapidjson/fwd.h"
 
+#include <map>
+#include <set>
+
 class TFile;
 
 namespace o2::framework
@@ -75,6 +79,10 @@ struct DataOutputDirector {
   void setNumberTimeFramesToMerge(int ntfmerge) { mnumberTimeFramesToMerge = ntfmerge > 0 ? ntfmerge : 1; }
   std::string getFileMode() { return mfileMode; }
   void setFileMode(std::string filemode) { mfileMode = filemode; }
+  // root (default), arrow or arrow-lz4, see ArrowFileHelpers for the arrow format
+  std::string getFileFormat() { return mfileFormat; }
+  void setFileFormat(std::string fileformat) { mfileFormat = fileformat; }
+  bool isArrowFormat() { return mfileFormat.rfind("arrow", 0) == 0; }
 
   // get matching DataOutputDescriptors
   std::vector<DataOutputDescriptor*> getDataOutputDescriptors(header::DataHeader dh);
@@ -83,6 +91,9 @@ struct DataOutputDirector {
   // get the matching TFile
   FileAndFolder getFileFolder(DataOutputDescriptor* dodesc, uint64_t folderNumber);
 
+  // write a table to the folder DF_folderNumber of the matching AO2D in arrow format
+  void writeArrowTable(DataOutputDescriptor* dodesc, uint64_t folderNumber, std::shared_ptr<arrow::Table> table);
+
   void closeDataFiles();
 
   void setFilenameBase(std::string dfn);
@@ -99,6 +110,12 @@ struct DataOutputDirector {
   bool mdebugmode = false;
   int mnumberTimeFramesToMerge = 1;
   std::string mfileMode = "RECREATE";
+  std::string mfileFormat = "root";
+
+  // the writers of the arrow files of the current folder
+  std::map<std::string, std::unique_ptr<ArrowTableWriter>> marrowWriters;
+  uint64_t marrowFolderNumber = 0;
+  std::set<std::string> marrowAODs;
 
   std::tuple<std::string, std::string, int> readJsonDocument(Document* doc);
   const std::tuple<std::string, std::string, int> memptyanswer = std::make_tuple(std::string(""), std::string(""), -1);
@@ -12,6 +12,7 @@
 #define FRAMEWORK_DATAPROCESSING_DEVICE_H
 
 #include "Framework/AlgorithmSpec.h"
+#include "Framework/ArrowContext.h"
 #include "Framework/ComputingQuotaOffer.h"
 #include "Framework/ConfigParamRegistry.h"
 #include "Framework/DataAllocator.h"
@@ -30,6 +31,7 @@
 #include <fairmq/FairMQDevice.h>
 #include <fairmq/FairMQParts.h>
 
+#include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <uv.h>
@@ -50,6 +52,40 @@ struct ComputingQuotaEvaluator;
 /// per thread and relax the locks.
 class DataProcessingDevice;
 
+/// State shared by the processing streams of a device which runs
+/// more than one. Everything but the algorithm itself is serialised
+/// by the mutex, while the tickets given to the dispatched timeslices
+/// allow to send their outputs in dispatch order.
+struct StreamsSync {
+  std::mutex mutex;
+  /// Notified each time a stream is done with a timeslice
+  std::condition_variable done;
+  /// Number of tickets given so far
+  size_t dispatched = 0;
+  /// Number of timeslices completely processed so far
+  size_t completed = 0;
+  /// Whether the outputs have to be sent in dispatch order
+  bool ordered = true;
+};
+
+/// What each stream owns when a device runs more than one: the
+/// timing of the timeslice being processed and the contexts in which
+/// its outputs are created, so that the algorithm can run without
+/// holding the lock.
+struct StreamState {
+  bool wasActive = false;
+  TimingInfo timingInfo;
+  std::vector<DataRelayer::RecordAction> completed;
+  std::unique_ptr<MessageContext> messageContext;
+  std::unique_ptr<StringContext> stringContext;
+  std::unique_ptr<ArrowContext> arrowContext;
+  std::unique_ptr<RawBufferContext> rawBufferContext;
+  std::unique_ptr<DataAllocator> allocator;
+  /// Release the shared memory of the tables sent by this stream, once
+  /// the stream completes.
+  std::vector<ComputingQuotaConsumer> offerConsumers;
+};
+
 /// Context associated to a device. In principle
 /// multiple DataProcessors can run on a Device (even if we
 /// do not do it for now).
@@ -61,6 +97,8 @@ struct DeviceContext {
   DeviceState* state = nullptr;
   ComputingQuotaEvaluator* quotaEvaluator = nullptr;
   DataProcessingStats* stats = nullptr;
+  /// Only set when there is more than one processing stream
+  StreamsSync* streamsSync = nullptr;
 };
 
 struct DataProcessorContext {
@@ -86,6 +124,8 @@ struct DataProcessorContext {
   AlgorithmSpec::ErrorCallback* error = nullptr;
 
   std::function<void(o2::framework::RuntimeErrorRef e, InputRecord& record)>* errorHandling = nullptr;
+  /// The state owned by this stream, only set when there is more than one
+  StreamState* stream = nullptr;
 };
 
 struct TaskStreamRef {
@@ -128,6 +168,7 @@ class DataProcessingDevice : public FairMQDevice
  protected:
   void error(const char* msg);
   void fillContext(DataProcessorContext& context, DeviceContext& deviceContext);
+  void fillStreamContext(DataProcessorContext& context, StreamState& stream);
 
  private:
   DeviceContext mDeviceContext;
@@ -162,6 +203,8 @@ class DataProcessingDevice : public FairMQDevice
   std::vector<uv_work_t> mHandles;                               /// Handles to use to schedule work.
   std::vector<TaskStreamInfo> mStreams;                          /// Information about the task running in the associated mHandle.
   ComputingQuotaEvaluator& mQuotaEvaluator;                      /// The component which evaluates if the offer can be used to run a task
+  std::unique_ptr<StreamsSync> mStreamsSync;                     /// Synchronisation of the streams, if more than one.
+  std::vector<std::unique_ptr<StreamState>> mStreamStates;       /// Per stream state, if more than one stream.
 };
 
 } // namespace o2::framework
@@ -11,6 +11,9 @@
 #ifndef O2_FRAMEWORK_DATAPROCESSOR_H_
 #define O2_FRAMEWORK_DATAPROCESSOR_H_
 
+#include "Framework/ComputingQuotaOffer.h"
+#include <vector>
+
 class FairMQDevice;
 class FairMQParts;
 
@@ -30,6 +33,9 @@ struct DataProcessor {
   static void doSend(FairMQDevice&, MessageContext&, ServiceRegistry&);
   static void doSend(FairMQDevice&, StringContext&, ServiceRegistry&);
   static void doSend(FairMQDevice&, ArrowContext&, ServiceRegistry&);
+  /// Same as above, but the shared memory of the tables is released by
+  /// @a offerConsumers, e.g. those of the stream which created them.
+  static void doSend(FairMQDevice&, ArrowContext&, ServiceRegistry&, std::vector<ComputingQuotaConsumer>& offerConsumers);
   static void doSend(FairMQDevice&, RawBufferContext&, ServiceRegistry&);
   static void doSend(FairMQDevice&, FairMQParts&&, const char*, unsigned int);
 };
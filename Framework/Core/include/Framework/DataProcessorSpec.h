@@ -69,6 +69,13 @@ struct DataProcessorSpec {
   /// put, but this is actually to be handled in the actual DeviceSpec.
   size_t inputTimeSliceId = 0;
   size_t maxInputTimeslices = 1;
+  /// How many timeslices can be processed concurrently, each one by its
+  /// own stream, inside the device. Only for DataProcessors whose
+  /// algorithm is thread safe, see processingStreams().
+  size_t maxStreams = 1;
+  /// Whether the outputs of concurrent streams are sent in the same
+  /// order in which their inputs were dispatched.
+  bool orderedStreams = true;
 };
 
 } // namespace o2::framework
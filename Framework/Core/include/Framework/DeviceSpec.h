@@ -61,6 +61,10 @@ struct DeviceSpec {
   size_t inputTimesliceId;
   /// The maximum number of time pipelining for this device.
   size_t maxInputTimeslices;
+  /// The maximum number of timeslices processed concurrently by this device.
+  size_t maxStreams = 1;
+  /// Whether the outputs of the concurrent streams are sent in dispatch order.
+  bool orderedStreams = true;
   /// The completion policy to use for this device.
   CompletionPolicy completionPolicy;
   DispatchPolicy dispatchPolicy;
@@ -340,6 +340,17 @@ using Operations = std::vector<ColumnOperationSpec>;
 /// Function to create an internal operation sequence from a filter tree
 Operations createOperations(Filter const& expression);
 
+/// Function for creating selection from operation sequence, tables with at most
+/// getInterpreterMaxRows() rows are filtered with the interpreter, larger ones
+/// with a compiled gandiva filter
+Selection createSelection(std::shared_ptr<arrow::Table> table, Operations const& opSpecs);
+/// Function for creating selection by interpreting operation sequence column by column,
+/// which avoids the compilation of the gandiva filter
+Selection createSelectionInterpreted(std::shared_ptr<arrow::Table> table, Operations const& opSpecs);
+/// Largest number of rows for which createSelection uses the interpreter
+void setInterpreterMaxRows(int64_t maxRows);
+int64_t getInterpreterMaxRows();
+
 /// Function to check compatibility of a given arrow schema with operation sequence
 bool isSchemaCompatible(gandiva::SchemaPtr const& Schema, Operations const& opSpecs);
 /// Function to create gandiva expression tree from operation sequence
@@ -27,6 +27,8 @@
 #include <TDataType.h>
 
 #include <deque>
+#include <thread>
+#include <gsl/span>
 
 class TList;
 
@@ -48,6 +50,10 @@ struct HistFiller {
   template <typename... Cs, typename R, typename T>
   static void fillHistAny(std::shared_ptr<R>& hist, const T& table, const o2::framework::expressions::Filter& filter);
 
+  // fill any type of histogram with columns of values, the i-th entry of each column being the i-th fill (weights must reside in the last column)
+  template <typename T, typename... Ts>
+  static void fillHistColumns(std::shared_ptr<T>& hist, const gsl::span<Ts>&... columns);
+
   // function that returns rough estimate for the size of a histogram in MB
   template <typename T>
   static double getSize(std::shared_ptr<T>& hist, double fillFraction = 1.);
@@ -67,6 +73,13 @@ struct HistFiller {
 //**************************************************************************************************
 /**
  * HistogramRegistry for storing and filling histograms of any type.
+ *
+ * By default the registry must be filled from a single thread. With setConcurrentFill(nSlots) each of
+ * nSlots threads fills its own copy (slot) of the histograms, without any locking. The slot of a thread is
+ * set with setThreadSlot(); a thread which did not set it fills slot 0 if it configured the registry, and is
+ * refused otherwise.
+ * The slots are merged into the histograms of the registry by mergeSlots(), which is done on output and,
+ * if requested, at the end of each time frame. Slot 0 is the registry itself.
  */
 //**************************************************************************************************
 class HistogramRegistry
@@ -123,6 +136,25 @@ class HistogramRegistry
   template <typename... Cs, typename T>
   void fill(const HistName& histName, const T& table, const o2::framework::expressions::Filter& filter);
 
+  // fill hist with columns of values (one column per argument of fill), the name lookup is done once per batch
+  template <typename... Ts>
+  void fillColumns(const HistName& histName, const gsl::span<Ts>&... columns);
+
+  // fill the histograms from up to nSlots threads at the same time, each thread filling its own copy of the histograms
+  void setConcurrentFill(int nSlots, bool mergeEachTimeFrame = false);
+  int getNSlots() const { return mSlots.size() + 1; }
+
+  // set the slot filled by the current thread (for all registries), this must be below the number of slots
+  static void setThreadSlot(int slot);
+  // slot of the current thread, -1 if not set
+  static int getThreadSlot();
+
+  // add the content of the slots to the histograms of the registry and reset the slots
+  void mergeSlots();
+
+  // to be called at the end of each time frame, merges the slots if requested
+  void endOfTimeFrame();
+
   // get rough estimate for size of histogram stored in registry
   double getSize(const HistName& histName, double fillFraction = 1.);
 
@@ -177,6 +209,17 @@ class HistogramRegistry
   static constexpr uint32_t MAX_REGISTRY_SIZE{REGISTRY_BITMASK + 1};
   std::array<uint32_t, MAX_REGISTRY_SIZE> mRegistryKey{};
   std::array<HistPtr, MAX_REGISTRY_SIZE> mRegistryValue{};
+
+  // copies of the histograms filled by the threads of slot 1, 2, ... in concurrent fill mode
+  std::vector<std::array<HistPtr, MAX_REGISTRY_SIZE>> mSlots{};
+  bool mMergeEachTimeFrame{};
+  std::thread::id mOwnerThread{}; // thread which called setConcurrentFill, filling slot 0 unless it set another one
+
+  // histograms to be filled by the current thread
+  std::array<HistPtr, MAX_REGISTRY_SIZE>& fillTarget();
+
+  // helper function to create the copies of the histogram at position i for the slots
+  void createSlotCopies(uint32_t i);
 };
 
 //--------------------------------------------------------------------------------------------------
@@ -234,6 +277,21 @@ void HistFiller::fillHistAny(std::shared_ptr<R>& hist, const T& table, const o2:
   }
 }
 
+template <typename T, typename... Ts>
+void HistFiller::fillHistColumns(std::shared_ptr<T>& hist, const gsl::span<Ts>&... columns)
+{
+  static_assert(sizeof...(Ts) > 0, "At least one column is needed to fill a histogram.");
+  const std::size_t sizes[] = {columns.size()...};
+  for (auto size : sizes) {
+    if (size != sizes[0]) {
+      throw runtime_error_f("The columns used to fill histogram %s have different lengths.", hist->GetName());
+    }
+  }
+  for (std::size_t i = 0; i < sizes[0]; ++i) {
+    fillHistAny(hist, columns[i]...);
+  }
+}
+
 template <typename T>
 double HistFiller::getSize(std::shared_ptr<T>& hist, double fillFraction)
 {
@@ -355,6 +413,7 @@ void HistogramRegistry::insertClone(const HistName& histName, const std::shared_
       registerName(histName.str);
       mRegistryKey[imask(histName.idx + i)] = histName.hash;
       mRegistryValue[imask(histName.idx + i)] = std::shared_ptr<T>(static_cast<T*>(originalHist->Clone(histName.str)));
+      createSlotCopies(imask(histName.idx + i));
       lookup += i;
       return;
     }
@@ -376,16 +435,43 @@ uint32_t HistogramRegistry::getHistIndex(const T& histName)
   throw runtime_error_f(R"(Could not find histogram "%s" in HistogramRegistry "%s"!)", histName.str, mName.data());
 }
 
+inline std::array<HistPtr, HistogramRegistry::MAX_REGISTRY_SIZE>& HistogramRegistry::fillTarget()
+{
+  if (O2_BUILTIN_LIKELY(mSlots.empty())) {
+    return mRegistryValue;
+  }
+  auto slot = getThreadSlot();
+  if (slot < 0) {
+    if (std::this_thread::get_id() != mOwnerThread) {
+      LOGF(FATAL, R"(A thread without slot fills HistogramRegistry "%s" in concurrent mode, call HistogramRegistry::setThreadSlot() first.)", mName);
+    }
+    slot = 0;
+  }
+  if (slot == 0) {
+    return mRegistryValue;
+  }
+  if (slot > (int)mSlots.size()) {
+    LOGF(FATAL, R"(Thread slot %d is out of range for the %d slots of HistogramRegistry "%s".)", slot, getNSlots(), mName);
+  }
+  return mSlots[slot - 1];
+}
+
 template <typename... Ts>
 void HistogramRegistry::fill(const HistName& histName, Ts&&... positionAndWeight)
 {
-  std::visit([&positionAndWeight...](auto&& hist) { HistFiller::fillHistAny(hist, std::forward<Ts>(positionAndWeight)...); }, mRegistryValue[getHistIndex(histName)]);
+  std::visit([&positionAndWeight...](auto&& hist) { HistFiller::fillHistAny(hist, std::forward<Ts>(positionAndWeight)...); }, fillTarget()[getHistIndex(histName)]);
 }
 
 template <typename... Cs, typename T>
 void HistogramRegistry::fill(const HistName& histName, const T& table, const o2::framework::expressions::Filter& filter)
 {
-  std::visit([&table, &filter](auto&& hist) { HistFiller::fillHistAny<Cs...>(hist, table, filter); }, mRegistryValue[getHistIndex(histName)]);
+  std::visit([&table, &filter](auto&& hist) { HistFiller::fillHistAny<Cs...>(hist, table, filter); }, fillTarget()[getHistIndex(histName)]);
+}
+
+template <typename... Ts>
+void HistogramRegistry::fillColumns(const HistName& histName, const gsl::span<Ts>&... columns)
+{
+  std::visit([&columns...](auto&& hist) { HistFiller::fillHistColumns(hist, columns...); }, fillTarget()[getHistIndex(histName)]);
 }
 
 } // namespace o2::framework
@@ -17,13 +17,17 @@
 #include "TTreeReaderArray.h"
 #include "TableBuilder.h"
 
+#include <cstring>
+#include <memory>
+#include <vector>
+
 // =============================================================================
 namespace o2::framework
 {
 
 // -----------------------------------------------------------------------------
 // TableToTree allows to save the contents of a given arrow::Table to a TTree
-//  BranchIterator is used by TableToTree
+//  ColumnToBranch is used by TableToTree
 //
 // To write the contents of a table ta to a tree tr on file f do:
 //  . TableToTree t2t(ta,f,treename);
@@ -33,61 +37,49 @@ namespace o2::framework
 //  . t2t.process();
 //
 // .............................................................................
-class BranchIterator
+// ColumnToBranch copies the values of a column to the buffer of a branch, row
+// after row. The values are taken directly from the arrow buffers of the
+// column chunks, the address of the branch does not change
+class ColumnToBranch
 {
+ public:
+  ColumnToBranch(TTree* tree, std::shared_ptr<arrow::ChunkedArray> column, std::shared_ptr<arrow::Field> field);
 
- private:
-  std::string mBranchName;    // branch name
-  arrow::ArrayVector mChunks; // chunks
-  Int_t mNumberChuncs;        // number of chunks
-  Int_t mCounterChunk;        // chunk counter
-  Int_t mNumberRows;          // number of rows
-  Int_t mCounterRow;          // row counter
-
-  // data buffers for each data type
-  bool mStatus = false;
-  arrow::Field* mField;
-  arrow::Type::type mFieldType;
-  arrow::Type::type mElementType;
-  int32_t mNumberElements;
-  std::string mLeaflistString;
-
-  TBranch* mBranchPtr = nullptr;
-
-  char* mBranchBuffer = nullptr;
-  void* mValueBuffer = nullptr;
-
-  std::shared_ptr<arrow::BooleanArray> mArray_o = nullptr;
-  //bool mBoolValueHolder;
-  bool* mVariable_o = nullptr;
+  // has the branch been properly initialized
+  bool getStatus() const { return mStatus; }
 
-  uint8_t* mVariable_ub = nullptr;
-  uint16_t* mVariable_us = nullptr;
-  uint32_t* mVariable_ui = nullptr;
-  uint64_t* mVariable_ul = nullptr;
-  int8_t* mVariable_b = nullptr;
-  int16_t* mVariable_s = nullptr;
-  int32_t* mVariable_i = nullptr;
-  int64_t* mVariable_l = nullptr;
-  float* mVariable_f = nullptr;
-  double* mVariable_d = nullptr;
+  // copy the next value to the branch buffer
+  void next()
+  {
+    if (mRow == mChunkRows) {
+      nextChunk();
+    }
+    std::memcpy(mBuffer.data(), mData + mRow * mRowSize, mRowSize);
+    ++mRow;
+  }
 
+ private:
   // initialize a branch
-  bool initBranch(TTree* tree);
+  bool initBranch(TTree* tree, std::string const& name, bool isList);
 
-  // initialize chunk ib
-  bool initDataBuffer(Int_t ib);
+  // make the values of the next chunk available
+  void nextChunk();
 
- public:
-  BranchIterator(TTree* tree, std::shared_ptr<arrow::ChunkedArray> col, std::shared_ptr<arrow::Field> field);
-  ~BranchIterator();
+  bool mStatus = false;
+  arrow::ArrayVector mChunks;
+  arrow::Type::type mElementType;
+  int32_t mNumberElements = 1;
+  int32_t mRowSize = 0;
 
-  // has the iterator been properly initialized
-  bool getStatus();
+  int mCounterChunk = -1;
+  int64_t mChunkRows = 0;
+  int64_t mRow = 0;
+  const uint8_t* mData = nullptr;
 
-  // fills buffer with next value
-  // returns false if end of buffer reached
-  bool push();
+  // booleans are stored as bits by arrow and as bytes by ROOT
+  std::vector<uint8_t> mBoolValues;
+  std::vector<uint8_t> mBuffer;
+  TBranch* mBranchPtr = nullptr;
 };
 
 class TableToTree
@@ -96,8 +88,8 @@ class TableToTree
  private:
   TTree* mTreePtr;
 
-  // a list of BranchIterator
-  std::vector<BranchIterator*> mBranchIterators;
+  // a list of ColumnToBranch
+  std::vector<std::unique_ptr<ColumnToBranch>> mColumns;
 
   // table to convert
   std::shared_ptr<arrow::Table> mTable;
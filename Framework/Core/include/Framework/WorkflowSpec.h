@@ -102,6 +102,16 @@ Inputs mergeInputs(Inputs inputs,
 DataProcessorSpec timePipeline(DataProcessorSpec original,
                                size_t count);
 
+/// Let the device of @a original process up to @a count timeslices
+/// concurrently, each one in its own stream on a worker thread, rather than
+/// duplicating it in @a count processes like timePipeline does. The algorithm
+/// must be thread safe and only use the DataAllocator of its ProcessingContext
+/// to create its outputs. When @a ordered is true the outputs are sent in the
+/// same order in which the timeslices were dispatched.
+DataProcessorSpec processingStreams(DataProcessorSpec original,
+                                    size_t count,
+                                    bool ordered = true);
+
 /// The purpose of this helper is to create a query on the data via a properly formatted
 /// @a matcher string which describes data in terms of the O2 Data Model descriptor.
 ///
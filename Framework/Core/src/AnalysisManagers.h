@@ -24,6 +24,10 @@
 #include "Framework/RootConfigParamHelpers.h"
 #include "../src/ExpressionHelpers.h"
 
+#include <functional>
+#include <memory>
+#include <vector>
+
 namespace o2::framework
 {
 
@@ -176,8 +180,9 @@ struct OutputManager<HistogramRegistry> {
     return true;
   }
 
-  static bool finalize(ProcessingContext&, HistogramRegistry&)
+  static bool finalize(ProcessingContext&, HistogramRegistry& what)
   {
+    what.endOfTimeFrame();
     return true;
   }
 
@@ -424,6 +429,92 @@ struct IndexManager<Builds<IDX, P>> {
     return true;
   }
 };
+
+/// Manager template to prepare the members of a task for the invocation
+/// of process() from several threads, each with its own copy of the task
+template <typename T>
+struct ParallelProcessManager {
+  static bool isSupported(T&) { return true; };
+  static bool prepare(T&, int, int) { return false; };
+  static bool detach(T&, std::vector<std::function<void()>>&) { return false; };
+  static bool setChunk(T&, int) { return false; };
+  static bool finalize(T&) { return false; };
+};
+
+/// Produces specialization: the rows are buffered per chunk of groups and written in order at the end
+template <typename TABLE>
+struct ParallelProcessManager<Produces<TABLE>> {
+  static bool isSupported(Produces<TABLE>&) { return true; };
+  static bool prepare(Produces<TABLE>& what, int, int nChunks)
+  {
+    what.setChunks(nChunks);
+    return true;
+  }
+  static bool detach(Produces<TABLE>&, std::vector<std::function<void()>>&) { return false; };
+  static bool setChunk(Produces<TABLE>& what, int chunk)
+  {
+    what.setChunk(chunk);
+    return true;
+  }
+  static bool finalize(Produces<TABLE>& what)
+  {
+    what.writeChunks();
+    return true;
+  }
+};
+
+/// HistogramRegistry specialization: each thread fills its own slot
+template <>
+struct ParallelProcessManager<HistogramRegistry> {
+  static bool isSupported(HistogramRegistry&) { return true; };
+  static bool prepare(HistogramRegistry& what, int nSlots, int)
+  {
+    if (what.getNSlots() < nSlots) {
+      what.setConcurrentFill(nSlots);
+    }
+    return true;
+  }
+  static bool detach(HistogramRegistry&, std::vector<std::function<void()>>&) { return false; };
+  static bool setChunk(HistogramRegistry&, int) { return false; };
+  static bool finalize(HistogramRegistry&) { return false; };
+};
+
+/// OutputObj specialization: each copy of the task fills an empty clone of
+/// the object, which is added to the original one once all the groups are
+/// processed. Only objects which can be reset and added (e.g. histograms)
+/// are supported.
+template <typename T>
+struct ParallelProcessManager<OutputObj<T>> {
+  template <typename C>
+  static auto isMergeable(int) -> decltype(std::declval<C&>().Reset(), std::declval<C&>().Add(std::declval<C const*>()), std::true_type{});
+  template <typename C>
+  static std::false_type isMergeable(...);
+
+  static bool isSupported(OutputObj<T>&)
+  {
+    return decltype(isMergeable<T>(0))::value;
+  }
+  static bool prepare(OutputObj<T>&, int, int) { return false; };
+  static bool detach(OutputObj<T>& what, std::vector<std::function<void()>>& merges)
+  {
+    if constexpr (decltype(isMergeable<T>(0))::value) {
+      if (!what.object) {
+        return false;
+      }
+      auto target = what.object;
+      what.object = std::shared_ptr<T>(static_cast<T*>(target->Clone()));
+      what.object->Reset();
+      if constexpr (std::is_base_of_v<TH1, T>) {
+        what.object->SetDirectory(nullptr);
+      }
+      merges.emplace_back([target, copy = what.object]() { target->Add(copy.get()); });
+      return true;
+    }
+    return false;
+  }
+  static bool setChunk(OutputObj<T>&, int) { return false; };
+  static bool finalize(OutputObj<T>&) { return false; };
+};
 } // namespace o2::framework
 
 #endif // ANALYSISMANAGERS_H
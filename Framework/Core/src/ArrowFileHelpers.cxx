@@ -0,0 +1,219 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#include "Framework/ArrowFileHelpers.h"
+#include "Framework/TableTreeHelpers.h"
+#include "Framework/Logger.h"
+
+#include <arrow/io/file.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/ipc/writer.h>
+#include <arrow/table.h>
+#include <arrow/util/compression.h>
+#include <arrow/util/config.h>
+
+#include <TFile.h>
+#include <TKey.h>
+#include <TTree.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <regex>
+#include <stdexcept>
+
+namespace o2::framework
+{
+
+namespace
+{
+const std::string arrowExtension = ".arrow";
+const std::regex timeFrameRegex("DF_[0-9]+");
+} // namespace
+
+bool ArrowFileHelpers::isArrowAOD(std::string const& filename)
+{
+  return filename.size() > arrowExtension.size() &&
+         filename.compare(filename.size() - arrowExtension.size(), arrowExtension.size(), arrowExtension) == 0;
+}
+
+std::vector<uint64_t> ArrowFileHelpers::getTimeFrameNumbers(std::string const& aodname)
+{
+  std::vector<uint64_t> numbers;
+  if (!std::filesystem::is_directory(aodname)) {
+    throw std::runtime_error(fmt::format(R"(Couldn't open arrow AO2D "{}"!)", aodname));
+  }
+  for (auto const& entry : std::filesystem::directory_iterator(aodname)) {
+    auto folderName = entry.path().filename().string();
+    if (entry.is_directory() && std::regex_match(folderName, timeFrameRegex)) {
+      numbers.emplace_back(std::stoul(folderName.substr(3)));
+    }
+  }
+  std::sort(numbers.begin(), numbers.end());
+  return numbers;
+}
+
+std::string ArrowFileHelpers::getTableFileName(std::string const& aodname, std::string const& folder, std::string const& treename)
+{
+  return (std::filesystem::path(aodname) / folder / (treename + arrowExtension)).string();
+}
+
+std::shared_ptr<arrow::Table> ArrowFileHelpers::readTable(std::string const& filename)
+{
+  auto file = arrow::io::MemoryMappedFile::Open(filename, arrow::io::FileMode::READ);
+  if (!file.ok()) {
+    throw std::runtime_error(fmt::format(R"(Couldn't open file "{}": {})", filename, file.status().ToString()));
+  }
+  auto reader = arrow::ipc::RecordBatchFileReader::Open(file.ValueOrDie());
+  if (!reader.ok()) {
+    throw std::runtime_error(fmt::format(R"(Couldn't read arrow file "{}": {})", filename, reader.status().ToString()));
+  }
+
+  // the buffers of the batches refer to the memory map, which stays alive as long as they do
+  auto fileReader = reader.ValueOrDie();
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  for (int i = 0; i < fileReader->num_record_batches(); ++i) {
+    auto batch = fileReader->ReadRecordBatch(i);
+    if (!batch.ok()) {
+      throw std::runtime_error(fmt::format(R"(Couldn't read record batch {} of "{}": {})", i, filename, batch.status().ToString()));
+    }
+    batches.emplace_back(batch.ValueOrDie());
+  }
+  auto table = arrow::Table::FromRecordBatches(fileReader->schema(), batches);
+  if (!table.ok()) {
+    throw std::runtime_error(fmt::format(R"(Couldn't create table from "{}": {})", filename, table.status().ToString()));
+  }
+  return table.ValueOrDie();
+}
+
+void ArrowFileHelpers::convertToArrow(std::string const& rootFile, std::string const& aodname, bool compress)
+{
+  auto file = std::unique_ptr<TFile>(TFile::Open(rootFile.c_str()));
+  if (!file || file->IsZombie()) {
+    throw std::runtime_error(fmt::format(R"(Couldn't open file "{}"!)", rootFile));
+  }
+  for (auto folderKey : *file->GetListOfKeys()) {
+    std::string folderName = folderKey->GetName();
+    if (!std::regex_match(folderName, timeFrameRegex)) {
+      continue;
+    }
+    auto folder = file->GetDirectory(folderName.c_str());
+    for (auto treeKey : *folder->GetListOfKeys()) {
+      auto tree = dynamic_cast<TTree*>(static_cast<TKey*>(treeKey)->ReadObj());
+      if (!tree) {
+        continue;
+      }
+      TreeToTable t2t;
+      if (t2t.addAllColumns(tree)) {
+        t2t.fill(tree);
+        auto table = t2t.finalize();
+        ArrowTableWriter writer(getTableFileName(aodname, folderName, tree->GetName()), table->schema(), compress);
+        writer.write(table);
+      }
+      delete tree;
+    }
+  }
+}
+
+void ArrowFileHelpers::convertToRoot(std::string const& aodname, std::string const& rootFile)
+{
+  TFile file(rootFile.c_str(), "RECREATE", "", 501);
+  for (auto number : getTimeFrameNumbers(aodname)) {
+    auto folderName = "DF_" + std::to_string(number);
+    file.mkdir(folderName.c_str());
+    for (auto const& entry : std::filesystem::directory_iterator(std::filesystem::path(aodname) / folderName)) {
+      if (entry.path().extension() != arrowExtension) {
+        continue;
+      }
+      auto treename = folderName + "/" + entry.path().stem().string();
+      TableToTree ta2tr(readTable(entry.path().string()), &file, treename.c_str());
+      ta2tr.addAllBranches();
+      ta2tr.process();
+    }
+  }
+  file.Close();
+}
+
+ArrowTableWriter::ArrowTableWriter(std::string const& filename, std::shared_ptr<arrow::Schema> schema, bool compress)
+{
+  // the tables of an existing file are kept, the memory map of the removed
+  // file stays valid until they are written again
+  std::shared_ptr<arrow::Table> existing;
+  if (std::filesystem::exists(filename)) {
+    existing = ArrowFileHelpers::readTable(filename);
+    std::filesystem::remove(filename);
+  }
+
+  auto directory = std::filesystem::path(filename).parent_path();
+  if (!directory.empty()) {
+    std::filesystem::create_directories(directory);
+  }
+  auto stream = arrow::io::FileOutputStream::Open(filename);
+  if (!stream.ok()) {
+    throw std::runtime_error(fmt::format(R"(Couldn't create file "{}": {})", filename, stream.status().ToString()));
+  }
+  mStream = stream.ValueOrDie();
+
+  auto options = arrow::ipc::IpcWriteOptions::Defaults();
+  if (compress) {
+#if ARROW_VERSION_MAJOR < 2
+    options.compression = arrow::Compression::LZ4_FRAME;
+#else
+    auto codec = arrow::util::Codec::Create(arrow::Compression::LZ4_FRAME);
+    if (!codec.ok()) {
+      throw std::runtime_error(fmt::format("Unable to create the compression codec: {}", codec.status().ToString()));
+    }
+    options.codec = std::move(codec).ValueOrDie();
+#endif
+  }
+#if ARROW_VERSION_MAJOR < 3
+  auto writer = arrow::ipc::NewFileWriter(mStream.get(), schema, options);
+#else
+  auto writer = arrow::ipc::MakeFileWriter(mStream.get(), schema, options);
+#endif
+  if (!writer.ok()) {
+    throw std::runtime_error(fmt::format(R"(Unable to create the arrow writer for "{}": {})", filename, writer.status().ToString()));
+  }
+  mWriter = writer.ValueOrDie();
+
+  if (existing) {
+    write(existing);
+  }
+}
+
+ArrowTableWriter::~ArrowTableWriter()
+{
+  close();
+}
+
+void ArrowTableWriter::write(std::shared_ptr<arrow::Table> table)
+{
+  auto status = mWriter->WriteTable(*table);
+  if (!status.ok()) {
+    throw std::runtime_error(fmt::format("Unable to write table: {}", status.ToString()));
+  }
+}
+
+void ArrowTableWriter::close()
+{
+  if (!mWriter) {
+    return;
+  }
+  auto status = mWriter->Close();
+  if (status.ok()) {
+    status = mStream->Close();
+  }
+  mWriter = nullptr;
+  mStream = nullptr;
+  if (!status.ok()) {
+    LOGP(ERROR, "Unable to close arrow file: {}", status.ToString());
+  }
+}
+
+} // namespace o2::framework
@@ -42,10 +42,19 @@
 #include <ROOT/RDataFrame.hxx>
 #include <ROOT/RArrowDS.hxx>
 #include <ROOT/RVec.hxx>
+#include <TROOT.h>
+
+#include <arrow/table.h>
+
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <fstream>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 
@@ -245,6 +254,162 @@ enum FileType : int {
   DANGLING
 };
 
+namespace
+{
+// deep copy of the buffers of an array, which then do not refer to the input message anymore
+std::shared_ptr<arrow::ArrayData> copyArrayData(std::shared_ptr<arrow::ArrayData> const& data)
+{
+  auto copy = data->Copy();
+  for (auto& buffer : copy->buffers) {
+    if (buffer) {
+      buffer = buffer->CopySlice(0, buffer->size()).ValueOrDie();
+    }
+  }
+  for (auto& child : copy->child_data) {
+    child = copyArrayData(child);
+  }
+  return copy;
+}
+
+std::shared_ptr<arrow::Table> copyTable(std::shared_ptr<arrow::Table> const& table)
+{
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (auto& column : table->columns()) {
+    arrow::ArrayVector chunks;
+    for (auto& chunk : column->chunks()) {
+      chunks.push_back(arrow::MakeArray(copyArrayData(chunk->data())));
+    }
+    columns.push_back(std::make_shared<arrow::ChunkedArray>(chunks, column->type()));
+  }
+  return arrow::Table::Make(table->schema(), columns, table->num_rows());
+}
+
+// save a table with all the matching DataOutputDescriptors
+// a table can be saved in multiple ways
+// e.g. different selections of columns to different files
+void writeTable(DataOutputDirector& dod, std::vector<DataOutputDescriptor*> const& ds, uint64_t tfNumber, std::shared_ptr<arrow::Table> const& table)
+{
+  for (auto d : ds) {
+    if (dod.isArrowFormat()) {
+      auto selected = table;
+      if (d->colnames.size() > 0) {
+        std::vector<int> indices;
+        for (auto cn : d->colnames) {
+          auto idx = table->schema()->GetFieldIndex(cn);
+          if (idx != -1) {
+            indices.push_back(idx);
+          }
+        }
+        selected = table->SelectColumns(indices).ValueOrDie();
+      }
+      dod.writeArrowTable(d, tfNumber, selected);
+      continue;
+    }
+
+    auto fileAndFolder = dod.getFileFolder(d, tfNumber);
+    auto treename = fileAndFolder.folderName + d->treename;
+    TableToTree ta2tr(table,
+                      fileAndFolder.file,
+                      treename.c_str());
+
+    if (d->colnames.size() > 0) {
+      for (auto cn : d->colnames) {
+        auto idx = table->schema()->GetFieldIndex(cn);
+        if (idx != -1) {
+          ta2tr.addBranch(table->column(idx), table->schema()->field(idx));
+        }
+      }
+    } else {
+      ta2tr.addAllBranches();
+    }
+    ta2tr.process();
+  }
+}
+
+// Writes the tables in a separate thread, so that the writing of a time frame
+// overlaps with the reception of the next one. All the I/O of the writer is
+// done by this thread. At most maxPending tables wait to be written, push
+// blocks otherwise. Once a table failed to be written the thread stops and
+// the error is rethrown by every following push and finish.
+class AODWriterThread
+{
+ public:
+  AODWriterThread(size_t maxPending) : mMaxPending{std::max(maxPending, size_t{1})}, mThread{[this]() { run(); }} {}
+  // errors are reported by push and finish, the destructor only stops the thread
+  ~AODWriterThread() { stop(); }
+
+  void push(std::function<void()> task)
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mCondition.wait(lock, [this]() { return mTasks.size() < mMaxPending || mError; });
+    rethrow();
+    mTasks.push_back(std::move(task));
+    mCondition.notify_all();
+  }
+
+  // write the pending tables and stop the thread
+  void finish()
+  {
+    stop();
+    std::lock_guard<std::mutex> lock(mMutex);
+    rethrow();
+  }
+
+ private:
+  void stop()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mDone = true;
+      mCondition.notify_all();
+    }
+    if (mThread.joinable()) {
+      mThread.join();
+    }
+  }
+
+  void run()
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true) {
+      mCondition.wait(lock, [this]() { return !mTasks.empty() || mDone; });
+      if (mTasks.empty()) {
+        return;
+      }
+      auto task = std::move(mTasks.front());
+      lock.unlock();
+      try {
+        task();
+      } catch (...) {
+        lock.lock();
+        mError = std::current_exception();
+        mTasks.clear();
+        mCondition.notify_all();
+        return;
+      }
+      lock.lock();
+      mTasks.pop_front();
+      mCondition.notify_all();
+    }
+  }
+
+  void rethrow()
+  {
+    if (mError) {
+      std::rethrow_exception(mError);
+    }
+  }
+
+  size_t mMaxPending;
+  std::mutex mMutex;
+  std::condition_variable mCondition;
+  std::deque<std::function<void()>> mTasks;
+  std::exception_ptr mError;
+  bool mDone = false;
+  std::thread mThread;
+};
+} // namespace
+
 // add sink for the AODs
 DataProcessorSpec
   CommonDataProcessors::getGlobalAODSink(std::shared_ptr<DataOutputDirector> dod,
@@ -276,8 +441,18 @@ DataProcessorSpec
       };
     }
 
+    // the tables are written in the background, concurrently with the use of ROOT by this thread,
+    // using ROOT implicit multi-threading to compress the baskets of the branches in parallel if requested
+    ROOT::EnableThreadSafety();
+    auto nThreads = ic.options().get<int>("aod-writer-threads");
+    if (nThreads > 1) {
+      ROOT::EnableImplicitMT(nThreads);
+    }
+    auto writerThread = std::make_shared<AODWriterThread>(std::max(ic.options().get<int>("aod-writer-max-pending"), 1));
+
     // end of data functor is called at the end of the data stream
-    auto endofdatacb = [dod](EndOfStreamContext& context) {
+    auto endofdatacb = [dod, writerThread](EndOfStreamContext& context) {
+      writerThread->finish();
       dod->closeDataFiles();
       context.services().get<ControlService>().readyToQuit(QuitRequest::Me);
     };
@@ -289,7 +464,7 @@ DataProcessorSpec
     std::map<uint64_t, uint64_t> tfNumbers;
 
     // this functor is called once per time frame
-    return std::move([dod, tfNumbers](ProcessingContext& pc) mutable -> void {
+    return std::move([dod, writerThread, tfNumbers](ProcessingContext& pc) mutable -> void {
       LOGP(DEBUG, "======== getGlobalAODSink::processing ==========");
       LOGP(DEBUG, " processing data set with {} entries", pc.inputs().size());
 
@@ -349,30 +524,10 @@ DataProcessorSpec
           LOGP(DEBUG, "The table \"{}\" is empty but will be saved anyway!", tableName);
         }
 
-        // loop over all DataOutputDescriptors
-        // a table can be saved in multiple ways
-        // e.g. different selections of columns to different files
-        for (auto d : ds) {
-          auto fileAndFolder = dod->getFileFolder(d, tfNumber);
-          auto treename = fileAndFolder.folderName + d->treename;
-          TableToTree ta2tr(table,
-                            fileAndFolder.file,
-                            treename.c_str());
-
-          if (d->colnames.size() > 0) {
-            for (auto cn : d->colnames) {
-              auto idx = table->schema()->GetFieldIndex(cn);
-              auto col = table->column(idx);
-              auto field = table->schema()->field(idx);
-              if (idx != -1) {
-                ta2tr.addBranch(col, field);
-              }
-            }
-          } else {
-            ta2tr.addAllBranches();
-          }
-          ta2tr.process();
-        }
+        // the table refers to the input message, which is released once the time frame is processed
+        writerThread->push([dod, ds, tfNumber, table = copyTable(table)]() {
+          writeTable(*dod, ds, tfNumber, table);
+        });
       }
     });
   }; // end of writerFunction
@@ -384,7 +539,8 @@ DataProcessorSpec
     outputInputs,
     Outputs{},
     AlgorithmSpec(writerFunction),
-    {}};
+    {ConfigParamSpec{"aod-writer-threads", VariantType::Int, 0, {"Number of threads compressing the output trees, with ROOT implicit multi-threading"}},
+     ConfigParamSpec{"aod-writer-max-pending", VariantType::Int, 4, {"Maximum number of tables waiting to be written (at least 1)"}}}};
 
   return spec;
 }
@@ -119,7 +119,9 @@ bool ComputingQuotaEvaluator::selectOffer(int task, ComputingQuotaRequest const&
       stats.invalidOffers.push_back(i);
       continue;
     }
-    if (offer.user != -1 && offer.user != task) {
+    // The first offer does not hold any resource, so the concurrent
+    // streams of a device can all use it.
+    if (offer.user != -1 && offer.user != task && i != 0) {
       stats.otherUser.push_back(i);
       continue;
     }
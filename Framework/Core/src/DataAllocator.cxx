@@ -44,6 +44,11 @@ DataAllocator::DataAllocator(TimingInfo* timingInfo,
 {
 }
 
+ArrowContext& DataAllocator::arrowContext()
+{
+  return mOutputContexts.arrow ? *mOutputContexts.arrow : mRegistry->get<ArrowContext>();
+}
+
 std::string const& DataAllocator::matchDataHeader(const Output& spec, size_t timeslice)
 {
   // FIXME: we should take timeframeId into account as well.
@@ -63,7 +68,7 @@ std::string const& DataAllocator::matchDataHeader(const Output& spec, size_t tim
 DataChunk& DataAllocator::newChunk(const Output& spec, size_t size)
 {
   std::string const& channel = matchDataHeader(spec, mTimingInfo->timeslice);
-  auto& context = mRegistry->get<MessageContext>();
+  auto& context = messageContext();
 
   FairMQMessagePtr headerMessage = headerMessageFromOutput(spec, channel,                        //
                                                            o2::header::gSerializationMethodNone, //
@@ -85,7 +90,7 @@ void DataAllocator::adoptChunk(const Output& spec, char* buffer, size_t size, fa
   );
 
   // FIXME: how do we want to use subchannels? time based parallelism?
-  auto& context = mRegistry->get<MessageContext>();
+  auto& context = messageContext();
   context.add<MessageContext::TrivialObject>(std::move(headerMessage), channel, 0, buffer, size, freefn, hint);
 }
 
@@ -104,7 +109,7 @@ FairMQMessagePtr DataAllocator::headerMessageFromOutput(Output const& spec,
   dh.firstTForbit = mTimingInfo->firstTFOrbit;
 
   DataProcessingHeader dph{mTimingInfo->timeslice, 1};
-  auto& context = mRegistry->get<MessageContext>();
+  auto& context = messageContext();
 
   auto channelAlloc = o2::pmr::getTransportAllocator(context.proxy().getTransport(channel, 0));
   return o2::pmr::getMessage(o2::header::Stack{channelAlloc, dh, dph, spec.metaHeader});
@@ -121,7 +126,7 @@ void DataAllocator::addPartToContext(FairMQMessagePtr&& payloadMessage, const Ou
   const DataHeader* cdh = o2::header::get<DataHeader*>(headerMessage->GetData());
   DataHeader* dh = const_cast<DataHeader*>(cdh);
   dh->payloadSize = payloadMessage->GetSize();
-  auto& context = mRegistry->get<MessageContext>();
+  auto& context = messageContext();
   // make_scoped creates the context object inside of a scope handler, since it goes out of
   // scope immediately, the created object is scheduled and can be directly sent if the context
   // is configured with the dispatcher callback
@@ -135,7 +140,7 @@ void DataAllocator::adopt(const Output& spec, std::string* ptr)
   // the correct payload size is set later when sending the
   // StringContext, see DataProcessor::doSend
   auto header = headerMessageFromOutput(spec, channel, o2::header::gSerializationMethodNone, 0);
-  mRegistry->get<StringContext>().addString(std::move(header), std::move(payload), channel);
+  stringContext().addString(std::move(header), std::move(payload), channel);
   assert(payload.get() == nullptr);
 }
 
@@ -143,7 +148,7 @@ void DataAllocator::adopt(const Output& spec, TableBuilder* tb)
 {
   std::string const& channel = matchDataHeader(spec, mTimingInfo->timeslice);
   auto header = headerMessageFromOutput(spec, channel, o2::header::gSerializationMethodArrow, 0);
-  auto& context = mRegistry->get<ArrowContext>();
+  auto& context = arrowContext();
 
   auto creator = [device = context.proxy().getDevice()](size_t s) -> std::unique_ptr<FairMQMessage> { return device->NewMessage(s); };
   auto buffer = std::make_shared<FairMQResizableBuffer>(creator);
@@ -182,7 +187,7 @@ void DataAllocator::adopt(const Output& spec, TreeToTable* t2t)
   std::string const& channel = matchDataHeader(spec, mTimingInfo->timeslice);
 
   auto header = headerMessageFromOutput(spec, channel, o2::header::gSerializationMethodArrow, 0);
-  auto& context = mRegistry->get<ArrowContext>();
+  auto& context = arrowContext();
 
   auto creator = [device = context.proxy().getDevice()](size_t s) -> std::unique_ptr<FairMQMessage> {
     return device->NewMessage(s);
@@ -219,7 +224,7 @@ void DataAllocator::adopt(const Output& spec, std::shared_ptr<arrow::Table> ptr)
 {
   std::string const& channel = matchDataHeader(spec, mTimingInfo->timeslice);
   auto header = headerMessageFromOutput(spec, channel, o2::header::gSerializationMethodArrow, 0);
-  auto& context = mRegistry->get<ArrowContext>();
+  auto& context = arrowContext();
 
   auto creator = [device = context.proxy().getDevice()](size_t s) -> std::unique_ptr<FairMQMessage> {
     return device->NewMessage(s);
@@ -249,7 +254,7 @@ void DataAllocator::adopt(const Output& spec, std::shared_ptr<arrow::Table> ptr)
 void DataAllocator::snapshot(const Output& spec, const char* payload, size_t payloadSize,
                              o2::header::SerializationMethod serializationMethod)
 {
-  auto& proxy = mRegistry->get<MessageContext>().proxy();
+  auto& proxy = messageContext().proxy();
   FairMQMessagePtr payloadMessage(proxy.createMessage(payloadSize));
   memcpy(payloadMessage->GetData(), payload, payloadSize);
 
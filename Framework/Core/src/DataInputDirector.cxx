@@ -9,6 +9,7 @@
 // granted to it by virtue of its status as an Intergovernmental Organization
 // or submit itself to any jurisdiction.
 #include "Framework/DataInputDirector.h"
+#include "Framework/ArrowFileHelpers.h"
 #include "Framework/DataDescriptorQueryBuilder.h"
 #include "Framework/Logger.h"
 #include "AnalysisDataModelHelpers.h"
@@ -92,32 +93,42 @@ bool DataInputDescriptor::setFile(int counter)
 
   // open file
   auto filename = mfilenames[counter]->fileName;
-  if (mcurrentFile) {
-    if (mcurrentFile->GetName() != filename) {
-      closeInputFile();
+  auto isArrow = ArrowFileHelpers::isArrowAOD(filename);
+  if (isArrow) {
+    // the tables of an AO2D in arrow format are read from the files of the time frame folders
+    closeInputFile();
+  } else {
+    if (mcurrentFile) {
+      if (mcurrentFile->GetName() != filename) {
+        closeInputFile();
+        mcurrentFile = TFile::Open(filename.c_str());
+      }
+    } else {
       mcurrentFile = TFile::Open(filename.c_str());
     }
-  } else {
-    mcurrentFile = TFile::Open(filename.c_str());
-  }
-  if (!mcurrentFile) {
-    throw std::runtime_error(fmt::format("Couldn't open file \"{}\"!", filename));
+    if (!mcurrentFile) {
+      throw std::runtime_error(fmt::format("Couldn't open file \"{}\"!", filename));
+    }
+    mcurrentFile->SetReadaheadSize(50 * 1024 * 1024);
   }
-  mcurrentFile->SetReadaheadSize(50 * 1024 * 1024);
 
   // get the directory names
   if (mfilenames[counter]->numberOfTimeFrames <= 0) {
-    std::regex TFRegex = std::regex("DF_[0-9]+");
-    TList* keyList = mcurrentFile->GetListOfKeys();
-
-    // extract TF numbers and sort accordingly
-    for (auto key : *keyList) {
-      if (std::regex_match(((TObjString*)key)->GetString().Data(), TFRegex)) {
-        auto folderNumber = std::stoul(std::string(((TObjString*)key)->GetString().Data()).substr(3));
-        mfilenames[counter]->listOfTimeFrameNumbers.emplace_back(folderNumber);
+    if (isArrow) {
+      mfilenames[counter]->listOfTimeFrameNumbers = ArrowFileHelpers::getTimeFrameNumbers(filename);
+    } else {
+      std::regex TFRegex = std::regex("DF_[0-9]+");
+      TList* keyList = mcurrentFile->GetListOfKeys();
+
+      // extract TF numbers and sort accordingly
+      for (auto key : *keyList) {
+        if (std::regex_match(((TObjString*)key)->GetString().Data(), TFRegex)) {
+          auto folderNumber = std::stoul(std::string(((TObjString*)key)->GetString().Data()).substr(3));
+          mfilenames[counter]->listOfTimeFrameNumbers.emplace_back(folderNumber);
+        }
       }
+      std::sort(mfilenames[counter]->listOfTimeFrameNumbers.begin(), mfilenames[counter]->listOfTimeFrameNumbers.end());
     }
-    std::sort(mfilenames[counter]->listOfTimeFrameNumbers.begin(), mfilenames[counter]->listOfTimeFrameNumbers.end());
 
     for (auto folderNumber : mfilenames[counter]->listOfTimeFrameNumbers) {
       auto folderName = "DF_" + std::to_string(folderNumber);
@@ -165,6 +176,16 @@ FileAndFolder DataInputDescriptor::getFileFolder(int counter, int numTF)
   return fileAndFolder;
 }
 
+bool DataInputDescriptor::isArrowFile(int counter)
+{
+  return counter < getNumberInputfiles() && ArrowFileHelpers::isArrowAOD(mfilenames[counter]->fileName);
+}
+
+std::string DataInputDescriptor::getFileName(int counter)
+{
+  return mfilenames.at(counter)->fileName;
+}
+
 int DataInputDescriptor::getTimeFramesInFile(int counter)
 {
   return mfilenames.at(counter)->numberOfTimeFrames;
@@ -583,6 +604,38 @@ TTree* DataInputDirector::getDataTree(header::DataHeader dh, int counter, int nu
   return tree;
 }
 
+bool DataInputDirector::isArrowAOD(header::DataHeader dh, int counter)
+{
+  auto didesc = getDataInputDescriptor(dh);
+  // if NOT match then use defaultDataInputDescriptor
+  if (!didesc) {
+    didesc = mdefaultDataInputDescriptor;
+  }
+
+  return didesc->isArrowFile(counter);
+}
+
+std::shared_ptr<arrow::Table> DataInputDirector::getDataTable(header::DataHeader dh, int counter, int numTF)
+{
+  std::string treename;
+
+  auto didesc = getDataInputDescriptor(dh);
+  if (didesc) {
+    treename = didesc->treename;
+  } else {
+    didesc = mdefaultDataInputDescriptor;
+    treename = aod::datamodel::getTreeName(dh);
+  }
+
+  // no TF left
+  auto fileAndFolder = didesc->getFileFolder(counter, numTF);
+  if (fileAndFolder.folderName.empty()) {
+    return nullptr;
+  }
+
+  return ArrowFileHelpers::readTable(ArrowFileHelpers::getTableFileName(didesc->getFileName(counter), fileAndFolder.folderName, treename));
+}
+
 void DataInputDirector::closeInputFiles()
 {
   mdefaultDataInputDescriptor->closeInputFile();
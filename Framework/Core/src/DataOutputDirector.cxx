@@ -11,10 +11,14 @@
 #include "Framework/DataOutputDirector.h"
 #include "Framework/Logger.h"
 
+#include <arrow/table.h>
+
 #include "rapidjson/document.h"
 #include "rapidjson/prettywriter.h"
 #include "rapidjson/filereadstream.h"
 
+#include <filesystem>
+
 namespace o2
 {
 namespace framework
@@ -456,8 +460,31 @@ FileAndFolder DataOutputDirector::getFileFolder(DataOutputDescriptor* dodesc, ui
   return fileAndFolder;
 }
 
+void DataOutputDirector::writeArrowTable(DataOutputDescriptor* dodesc, uint64_t folderNumber, std::shared_ptr<arrow::Table> table)
+{
+  auto aodname = dodesc->getFilenameBase() + ".arrow";
+  if (marrowAODs.insert(aodname).second && mfileMode != "UPDATE") {
+    // as for the ROOT files, an existing AO2D is replaced unless it is updated
+    std::filesystem::remove_all(aodname);
+  }
+
+  // the files of the previous folder are closed, they are extended if the folder is written again
+  if (folderNumber != marrowFolderNumber) {
+    marrowWriters.clear();
+    marrowFolderNumber = folderNumber;
+  }
+
+  auto filename = ArrowFileHelpers::getTableFileName(aodname, "DF_" + std::to_string(folderNumber), dodesc->treename);
+  auto& writer = marrowWriters[filename];
+  if (!writer) {
+    writer = std::make_unique<ArrowTableWriter>(filename, table->schema(), mfileFormat == "arrow-lz4");
+  }
+  writer->write(table);
+}
+
 void DataOutputDirector::closeDataFiles()
 {
+  marrowWriters.clear();
   for (auto filePtr : mfilePtrs) {
     if (filePtr) {
       filePtr->Close();
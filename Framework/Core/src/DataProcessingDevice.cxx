@@ -37,6 +37,8 @@
 #include "Framework/Logger.h"
 #include "Framework/DriverClient.h"
 #include "Framework/Monitoring.h"
+#include "Framework/StringContext.h"
+#include "Framework/RawBufferContext.h"
 #include "PropertyTreeHelpers.h"
 #include "DataProcessingStatus.h"
 #include "DataProcessingHelpers.h"
@@ -124,14 +126,97 @@ DataProcessingDevice::DataProcessingDevice(RunningDeviceRef ref, ServiceRegistry
       }
     };
   }
-  // One task for now.
-  mStreams.resize(1);
-  mHandles.resize(1);
+  // One stream, unless the DataProcessor declared it can process
+  // more than one timeslice at the time.
+  mStreams.resize(std::max<size_t>(mSpec.maxStreams, 1));
+  mHandles.resize(mStreams.size());
+}
+
+/// Lock on the state shared by the processing streams of the device.
+/// Does nothing when there is only one stream.
+std::unique_lock<std::mutex> lockStreams(DataProcessorContext& context)
+{
+  auto sync = context.deviceContext->streamsSync;
+  return sync ? std::unique_lock<std::mutex>(sync->mutex) : std::unique_lock<std::mutex>();
+}
+
+/// Releases the lock taken with lockStreams while the algorithm of a
+/// stream runs, so that the other streams can go on in the meanwhile.
+struct StreamsUnlock {
+  StreamsUnlock(DataProcessorContext& context) : sync{context.deviceContext->streamsSync}
+  {
+    if (sync) {
+      sync->mutex.unlock();
+    }
+  }
+  ~StreamsUnlock()
+  {
+    if (sync) {
+      sync->mutex.lock();
+    }
+  }
+  StreamsSync* sync;
+};
+
+/// Wait, with the lock taken with lockStreams, until @a condition is true.
+template <typename C>
+void waitStreams(StreamsSync& sync, C&& condition)
+{
+  std::unique_lock<std::mutex> lock(sync.mutex, std::adopt_lock);
+  sync.done.wait(lock, condition);
+  lock.release();
+}
+
+/// Wait until all the timeslices dispatched by the streams were processed
+/// and their outputs sent, e.g. before sending the end of stream.
+void waitAllStreams(DataProcessorContext& context)
+{
+  if (auto sync = context.deviceContext->streamsSync) {
+    waitStreams(*sync, [sync]() { return sync->completed == sync->dispatched; });
+  }
+}
+
+void clearStreamOutputs(StreamState& stream)
+{
+  stream.messageContext->clear();
+  stream.stringContext->clear();
+  stream.arrowContext->clear();
+  stream.rawBufferContext->clear();
+}
+
+/// Send what was created in the output contexts of the stream.
+void sendStreamOutputs(DataProcessorContext& context)
+{
+  auto& stream = *context.stream;
+  auto& device = *context.deviceContext->device;
+  DataProcessor::doSend(device, *stream.messageContext, *context.registry);
+  DataProcessor::doSend(device, *stream.stringContext, *context.registry);
+  DataProcessor::doSend(device, *stream.arrowContext, *context.registry, stream.offerConsumers);
+  DataProcessor::doSend(device, *stream.rawBufferContext, *context.registry);
+  clearStreamOutputs(stream);
+}
+
+/// Completes the timeslice with the given @a ticket: its outputs are sent, after
+/// those of the timeslices dispatched before if the order has to be kept, unless
+/// the processing failed.
+void completeStreamTimeslice(DataProcessorContext& context, size_t ticket, bool processed)
+{
+  auto& sync = *context.deviceContext->streamsSync;
+  if (sync.ordered) {
+    waitStreams(sync, [&sync, ticket]() { return sync.completed == ticket; });
+  }
+  if (processed) {
+    sendStreamOutputs(context);
+  } else {
+    clearStreamOutputs(*context.stream);
+  }
+  sync.completed++;
+  sync.done.notify_all();
 }
 
 // Callback to execute the processing. Notice how the data is
-// is a vector of DataProcessorContext so that we can index the correct
-// one with the thread id. For the moment we simply use the first one.
+// is a vector of DataProcessorContext, one per stream, so that
+// concurrent streams do not share their per timeslice state.
 void run_callback(uv_work_t* handle)
 {
   ZoneScopedN("run_callback");
@@ -147,10 +232,12 @@ void run_completion(uv_work_t* handle, int status)
 {
   TaskStreamInfo* task = (TaskStreamInfo*)handle->data;
   DataProcessorContext& context = *task->context;
-  for (auto& consumer : context.deviceContext->state->offerConsumers) {
+  // With more than one stream, each one releases only what it sent itself.
+  auto& offerConsumers = context.stream ? context.stream->offerConsumers : context.deviceContext->state->offerConsumers;
+  for (auto& consumer : offerConsumers) {
     context.deviceContext->quotaEvaluator->consume(task->id.index, consumer);
   }
-  context.deviceContext->state->offerConsumers.clear();
+  offerConsumers.clear();
   context.deviceContext->quotaEvaluator->handleExpired();
   context.deviceContext->quotaEvaluator->dispose(task->id.index);
   task->running = false;
@@ -454,8 +541,21 @@ void DataProcessingDevice::InitTask()
   // We should be ready to run here. Therefore we copy all the
   // required parts in the DataProcessorContext. Eventually we should
   // do so on a per thread basis, with fine grained locks.
-  mDataProcessorContexes.resize(1);
+  mDataProcessorContexes.resize(mStreams.size());
   this->fillContext(mDataProcessorContexes.at(0), mDeviceContext);
+  mStreamStates.clear();
+  mStreamsSync.reset();
+  mDeviceContext.streamsSync = nullptr;
+  if (mStreams.size() > 1) {
+    mStreamsSync = std::make_unique<StreamsSync>();
+    mStreamsSync->ordered = mSpec.orderedStreams;
+    mDeviceContext.streamsSync = mStreamsSync.get();
+    for (size_t si = 0; si < mStreams.size(); ++si) {
+      auto& stream = mStreamStates.emplace_back(std::make_unique<StreamState>());
+      this->fillContext(mDataProcessorContexes.at(si), mDeviceContext);
+      this->fillStreamContext(mDataProcessorContexes.at(si), *stream);
+    }
+  }
 }
 
 void DataProcessingDevice::fillContext(DataProcessorContext& context, DeviceContext& deviceContext)
@@ -480,6 +580,29 @@ void DataProcessingDevice::fillContext(DataProcessorContext& context, DeviceCont
   context.deviceContext = &deviceContext;
   /// Callback for the error handling
   context.errorHandling = &mErrorHandling;
+  context.stream = nullptr;
+}
+
+void DataProcessingDevice::fillStreamContext(DataProcessorContext& context, StreamState& stream)
+{
+  // Each stream creates its outputs in its own contexts, which are
+  // sent once the timeslice is processed.
+  FairMQDeviceProxy proxy{this};
+  stream.messageContext = std::make_unique<MessageContext>(proxy);
+  stream.stringContext = std::make_unique<StringContext>(proxy);
+  stream.arrowContext = std::make_unique<ArrowContext>(proxy);
+  stream.rawBufferContext = std::make_unique<RawBufferContext>(proxy);
+  stream.allocator = std::make_unique<DataAllocator>(&stream.timingInfo, &mServiceRegistry, mSpec.outputs);
+  stream.allocator->setOutputContexts({stream.messageContext.get(),
+                                       stream.stringContext.get(),
+                                       stream.arrowContext.get(),
+                                       stream.rawBufferContext.get()});
+
+  context.wasActive = &stream.wasActive;
+  context.completed = &stream.completed;
+  context.timingInfo = &stream.timingInfo;
+  context.allocator = stream.allocator.get();
+  context.stream = &stream;
 }
 
 void DataProcessingDevice::PreRun()
@@ -490,6 +613,10 @@ void DataProcessingDevice::PreRun()
 
 void DataProcessingDevice::PostRun()
 {
+  // Let the streams which are still running complete.
+  while (mState.loop && std::any_of(mStreams.begin(), mStreams.end(), [](TaskStreamInfo const& stream) { return stream.running; })) {
+    uv_run(mState.loop, UV_RUN_ONCE);
+  }
   mServiceRegistry.get<CallbackService>()(CallbackService::Id::Stop);
   mServiceRegistry.preExitCallbacks();
 }
@@ -548,6 +675,11 @@ bool DataProcessingDevice::ConditionalRun()
     if (taskInfo.running) {
       continue;
     }
+    // The streams report their activity once they are done.
+    if (mStreamStates.empty() == false && mStreamStates[ti]->wasActive) {
+      mStreamStates[ti]->wasActive = false;
+      mWasActive = true;
+    }
     streamRef.index = ti;
   }
   // We have an empty stream, let's check if we have enough
@@ -567,14 +699,21 @@ bool DataProcessingDevice::ConditionalRun()
     if (enough) {
       stream.id = streamRef;
       stream.running = true;
-      stream.context = &mDataProcessorContexes.at(0);
+      stream.context = &mDataProcessorContexes.at(streamRef.index);
 #ifdef DPL_ENABLE_THREADING
-      stream.task.data = &handle;
-      uv_queue_work(mState.loop, &stream.task, run_callback, run_completion);
+      bool threaded = true;
 #else
-      run_callback(&handle);
-      run_completion(&handle, 0);
+      bool threaded = mStreams.size() > 1;
 #endif
+      if (threaded) {
+        // The stream runs on the libuv thread pool, its completion is
+        // notified on the main thread.
+        stream.task.data = &stream;
+        uv_queue_work(mState.loop, &stream.task, run_callback, run_completion);
+      } else {
+        run_callback(&handle);
+        run_completion(&handle, 0);
+      }
     } else {
       mDataProcessorContexes.at(0).deviceContext->quotaEvaluator->handleExpired();
       mWasActive = false;
@@ -591,6 +730,8 @@ bool DataProcessingDevice::ConditionalRun()
 void DataProcessingDevice::doPrepare(DataProcessorContext& context)
 {
   ZoneScopedN("DataProcessingDevice::doPrepare");
+  // Reading from the channels is serialised among the streams.
+  auto lock = lockStreams(context);
   context.registry->get<DataProcessingStats>().beginIterationTimestamp = uv_hrtime() / 1000000;
 
   *context.wasActive = false;
@@ -676,6 +817,9 @@ void DataProcessingDevice::doPrepare(DataProcessorContext& context)
 
 void DataProcessingDevice::doRun(DataProcessorContext& context)
 {
+  // Only the algorithm runs concurrently when there is more than one
+  // stream, see tryDispatchComputation.
+  auto lock = lockStreams(context);
   auto switchState = [&registry = context.registry,
                       &state = context.deviceContext->state](StreamingState newState) {
     LOG(debug) << "New state " << (int)newState << " old state " << (int)state->streaming;
@@ -720,11 +864,20 @@ void DataProcessingDevice::doRun(DataProcessorContext& context)
     while (DataProcessingDevice::tryDispatchComputation(context, *context.completed)) {
       context.relayer->processDanglingInputs(*context.expirationHandlers, *context.registry, false);
     }
+    // The other streams might still be processing. One of them might also
+    // have ended the stream while we were waiting, in which case we are done.
+    waitAllStreams(context);
+    if (context.deviceContext->state->streaming != StreamingState::EndOfStreaming) {
+      return;
+    }
     EndOfStreamContext eosContext{*context.registry, *context.allocator};
 
     context.registry->preEOSCallbacks(eosContext);
     context.registry->get<CallbackService>()(CallbackService::Id::EndOfStream, eosContext);
     context.registry->postEOSCallbacks(eosContext);
+    if (context.stream) {
+      sendStreamOutputs(context);
+    }
 
     for (auto& channel : context.deviceContext->spec->outputChannels) {
       DataProcessingHelpers::sendEndOfStream(*context.deviceContext->device, channel);
@@ -1138,12 +1291,6 @@ bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context,
     }
   };
 
-  auto switchState = [&control = context.registry->get<ControlService>(),
-                      &state = context.deviceContext->state](StreamingState newState) {
-    state->streaming = newState;
-    control.notifyStreamingState(state->streaming);
-  };
-
   if (canDispatchSomeComputation() == false) {
     return false;
   }
@@ -1196,27 +1343,36 @@ bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context,
       }
     }
     markInputsAsDone(action.slot);
+    // With more than one stream, the outputs are sent according to
+    // the order of the tickets.
+    auto sync = context.deviceContext->streamsSync;
+    size_t ticket = sync ? sync->dispatched++ : 0;
+    bool processed = false;
 
     uint64_t tStart = uv_hrtime();
     preUpdateStats(action, record, tStart);
 
     static bool noCatch = getenv("O2_NO_CATCHALL_EXCEPTIONS") && strcmp(getenv("O2_NO_CATCHALL_EXCEPTIONS"), "0");
 
-    auto runNoCatch = [&context, &processContext]() {
+    auto runNoCatch = [&context, &processContext, &processed]() {
       if (context.deviceContext->state->quitRequested == false) {
-        if (*context.statefulProcess) {
-          ZoneScopedN("statefull process");
-          (*context.statefulProcess)(processContext);
-        }
-        if (*context.statelessProcess) {
-          ZoneScopedN("stateless process");
-          (*context.statelessProcess)(processContext);
+        {
+          StreamsUnlock unlock{context};
+          if (*context.statefulProcess) {
+            ZoneScopedN("statefull process");
+            (*context.statefulProcess)(processContext);
+          }
+          if (*context.statelessProcess) {
+            ZoneScopedN("stateless process");
+            (*context.statelessProcess)(processContext);
+          }
         }
 
         {
           ZoneScopedN("service post processing");
           context.registry->postProcessingCallbacks(processContext);
         }
+        processed = true;
       }
     };
 
@@ -1238,6 +1394,9 @@ bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context,
       }
     }
 
+    if (context.stream) {
+      completeStreamTimeslice(context, ticket, processed);
+    }
     postUpdateStats(action, record, tStart);
     // We forward inputs only when we consume them. If we simply Process them,
     // we keep them for next message arriving.
@@ -1253,14 +1412,8 @@ bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context,
       cleanTimers(action.slot, record);
     }
   }
-  // We now broadcast the end of stream if it was requested
-  if (context.deviceContext->state->streaming == StreamingState::EndOfStreaming) {
-    for (auto& channel : context.deviceContext->spec->outputChannels) {
-      DataProcessingHelpers::sendEndOfStream(*context.deviceContext->device, channel);
-    }
-    switchState(StreamingState::Idle);
-  }
-
+  // The end of stream, if it was requested, is broadcasted by doRun,
+  // once the EndOfStream callbacks were invoked.
   return true;
 }
 
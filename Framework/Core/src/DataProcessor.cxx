@@ -77,6 +77,11 @@ void DataProcessor::doSend(FairMQDevice& device, StringContext& context, Service
 }
 
 void DataProcessor::doSend(FairMQDevice& device, ArrowContext& context, ServiceRegistry& registry)
+{
+  doSend(device, context, registry, registry.get<DeviceState>().offerConsumers);
+}
+
+void DataProcessor::doSend(FairMQDevice& device, ArrowContext& context, ServiceRegistry& registry, std::vector<ComputingQuotaConsumer>& offerConsumers)
 {
   using o2::monitoring::Metric;
   using o2::monitoring::Monitoring;
@@ -106,8 +111,7 @@ void DataProcessor::doSend(FairMQDevice& device, ArrowContext& context, ServiceR
     parts.AddPart(std::move(payload));
     device.Send(parts, messageRef.channel, 0);
   }
-  static int64_t previousBytesSent = 0;
-  auto disposeResources = [bs = context.bytesSent() - previousBytesSent](int taskId, std::array<ComputingQuotaOffer, 16>& offers, std::function<void(ComputingQuotaOffer&)> accountDisposed) {
+  auto disposeResources = [bs = context.takeBytesSentSinceDispose()](int taskId, std::array<ComputingQuotaOffer, 16>& offers, std::function<void(ComputingQuotaOffer&)> accountDisposed) {
     ComputingQuotaOffer disposed;
     disposed.sharedMemory = 0;
     int64_t bytesSent = bs;
@@ -125,8 +129,7 @@ void DataProcessor::doSend(FairMQDevice& device, ArrowContext& context, ServiceR
     }
     return accountDisposed(disposed);
   };
-  registry.get<DeviceState>().offerConsumers.push_back(disposeResources);
-  previousBytesSent = context.bytesSent();
+  offerConsumers.push_back(disposeResources);
   monitoring.send(Metric{(uint64_t)context.bytesSent(), "arrow-bytes-created"}.addTag(Key::Subsystem, Value::DPL));
   monitoring.send(Metric{(uint64_t)context.messagesCreated(), "arrow-messages-created"}.addTag(Key::Subsystem, Value::DPL));
   monitoring.flushBuffer();
@@ -340,6 +340,8 @@ void DeviceSpecHelpers::processOutEdgeActions(std::vector<DeviceSpec>& devices,
     device.nSlots = processor.nSlots;
     device.inputTimesliceId = edge.producerTimeIndex;
     device.maxInputTimeslices = processor.maxInputTimeslices;
+    device.maxStreams = processor.maxStreams;
+    device.orderedStreams = processor.orderedStreams;
     device.resource = {acceptedOffer};
     device.labels = processor.labels;
     devices.push_back(device);
@@ -552,6 +554,8 @@ void DeviceSpecHelpers::processInEdgeActions(std::vector<DeviceSpec>& devices,
     device.nSlots = processor.nSlots;
     device.inputTimesliceId = edge.timeIndex;
     device.maxInputTimeslices = processor.maxInputTimeslices;
+    device.maxStreams = processor.maxStreams;
+    device.orderedStreams = processor.orderedStreams;
     device.resource = {acceptedOffer};
     device.labels = processor.labels;
 
@@ -0,0 +1,474 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#include "../src/ExpressionHelpers.h"
+#include "Framework/RuntimeError.h"
+#include "arrow/array.h"
+#include "arrow/table.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace o2::framework::expressions
+{
+namespace
+{
+std::atomic<int64_t> interpreterMaxRows{2048};
+
+/// The values of an operand, evaluated for all the rows of a batch or, for
+/// literals and operations on literals only, a single value. Integers are
+/// evaluated as int64_t and booleans as uint8_t.
+using Values = std::variant<std::vector<float>, std::vector<double>, std::vector<int64_t>, std::vector<uint8_t>>;
+
+struct Operand {
+  Values values;
+  bool scalar = false;
+};
+
+enum class ComputeType : int {
+  Bool = 0,
+  Int = 1,
+  Float = 2,
+  Double = 3
+};
+
+ComputeType computeType(atype::type type)
+{
+  switch (type) {
+    case atype::BOOL:
+      return ComputeType::Bool;
+    case atype::FLOAT:
+      return ComputeType::Float;
+    case atype::DOUBLE:
+      return ComputeType::Double;
+    default:
+      return ComputeType::Int;
+  }
+}
+
+ComputeType computeType(Operand const& operand)
+{
+  return std::visit(
+    [](auto const& values) {
+      using T = typename std::decay_t<decltype(values)>::value_type;
+      if constexpr (std::is_same_v<T, float>) {
+        return ComputeType::Float;
+      } else if constexpr (std::is_same_v<T, double>) {
+        return ComputeType::Double;
+      } else if constexpr (std::is_same_v<T, int64_t>) {
+        return ComputeType::Int;
+      } else {
+        return ComputeType::Bool;
+      }
+    },
+    operand.values);
+}
+
+/// pointer to the values of the operand as type T, converted into buffer if needed
+template <typename T>
+T const* valuesAs(Operand const& operand, std::vector<T>& buffer)
+{
+  if (auto values = std::get_if<std::vector<T>>(&operand.values)) {
+    return values->data();
+  }
+  std::visit(
+    [&buffer](auto const& values) {
+      buffer.resize(values.size());
+      for (size_t i = 0; i < values.size(); ++i) {
+        buffer[i] = static_cast<T>(values[i]);
+      }
+    },
+    operand.values);
+  return buffer.data();
+}
+
+template <typename T, typename A>
+void copyValues(A const& array, Operand& operand)
+{
+  auto const* raw = array.raw_values();
+  operand.values = std::vector<T>(raw, raw + array.length());
+}
+
+Operand fieldOperand(arrow::Array const& array)
+{
+  Operand operand;
+  switch (array.type_id()) {
+    case atype::BOOL: {
+      auto const& booleans = static_cast<arrow::BooleanArray const&>(array);
+      std::vector<uint8_t> values(booleans.length());
+      for (int64_t i = 0; i < booleans.length(); ++i) {
+        values[i] = booleans.Value(i);
+      }
+      operand.values = std::move(values);
+      break;
+    }
+    case atype::UINT8:
+      copyValues<int64_t>(static_cast<arrow::UInt8Array const&>(array), operand);
+      break;
+    case atype::INT8:
+      copyValues<int64_t>(static_cast<arrow::Int8Array const&>(array), operand);
+      break;
+    case atype::UINT16:
+      copyValues<int64_t>(static_cast<arrow::UInt16Array const&>(array), operand);
+      break;
+    case atype::INT16:
+      copyValues<int64_t>(static_cast<arrow::Int16Array const&>(array), operand);
+      break;
+    case atype::UINT32:
+      copyValues<int64_t>(static_cast<arrow::UInt32Array const&>(array), operand);
+      break;
+    case atype::INT32:
+      copyValues<int64_t>(static_cast<arrow::Int32Array const&>(array), operand);
+      break;
+    case atype::UINT64:
+      copyValues<int64_t>(static_cast<arrow::UInt64Array const&>(array), operand);
+      break;
+    case atype::INT64:
+      copyValues<int64_t>(static_cast<arrow::Int64Array const&>(array), operand);
+      break;
+    case atype::FLOAT:
+      copyValues<float>(static_cast<arrow::FloatArray const&>(array), operand);
+      break;
+    case atype::DOUBLE:
+      copyValues<double>(static_cast<arrow::DoubleArray const&>(array), operand);
+      break;
+    default:
+      throw runtime_error_f("Cannot interpret column of type %s", array.type()->ToString().c_str());
+  }
+  return operand;
+}
+
+Operand literalOperand(LiteralNode::var_t const& literal)
+{
+  Operand operand;
+  operand.scalar = true;
+  std::visit(
+    [&operand](auto value) {
+      using T = std::decay_t<decltype(value)>;
+      if constexpr (std::is_same_v<T, float>) {
+        operand.values = std::vector<float>{value};
+      } else if constexpr (std::is_same_v<T, double>) {
+        operand.values = std::vector<double>{value};
+      } else if constexpr (std::is_same_v<T, bool>) {
+        operand.values = std::vector<uint8_t>{value};
+      } else {
+        operand.values = std::vector<int64_t>{static_cast<int64_t>(value)};
+      }
+    },
+    literal);
+  return operand;
+}
+
+// the loops are kept free of branches on the operand kind so that they can be vectorised
+template <bool LeftScalar, bool RightScalar, typename R, typename T, typename F>
+void binaryLoop(R* result, T const* left, T const* right, size_t n, F f)
+{
+  for (size_t i = 0; i < n; ++i) {
+    result[i] = f(left[LeftScalar ? 0 : i], right[RightScalar ? 0 : i]);
+  }
+}
+
+template <typename R, typename T, typename F>
+Operand binary(Operand const& left, Operand const& right, size_t n, F f)
+{
+  std::vector<T> leftBuffer, rightBuffer;
+  auto l = valuesAs<T>(left, leftBuffer);
+  auto r = valuesAs<T>(right, rightBuffer);
+  bool scalar = left.scalar && right.scalar;
+  std::vector<R> result(scalar ? 1 : n);
+  if (scalar) {
+    binaryLoop<true, true>(result.data(), l, r, 1, f);
+  } else if (left.scalar) {
+    binaryLoop<true, false>(result.data(), l, r, n, f);
+  } else if (right.scalar) {
+    binaryLoop<false, true>(result.data(), l, r, n, f);
+  } else {
+    binaryLoop<false, false>(result.data(), l, r, n, f);
+  }
+  return Operand{std::move(result), scalar};
+}
+
+template <typename R, typename T, typename F>
+Operand unary(Operand const& operand, size_t n, F f)
+{
+  std::vector<T> buffer;
+  auto v = valuesAs<T>(operand, buffer);
+  std::vector<R> result(operand.scalar ? 1 : n);
+  for (size_t i = 0; i < result.size(); ++i) {
+    result[i] = f(v[i]);
+  }
+  return Operand{std::move(result), operand.scalar};
+}
+
+template <typename T>
+Operand compare(BasicOp op, Operand const& left, Operand const& right, size_t n)
+{
+  switch (op) {
+    case BasicOp::LessThan:
+      return binary<uint8_t, T>(left, right, n, [](T a, T b) -> uint8_t { return a < b; });
+    case BasicOp::LessThanOrEqual:
+      return binary<uint8_t, T>(left, right, n, [](T a, T b) -> uint8_t { return a <= b; });
+    case BasicOp::GreaterThan:
+      return binary<uint8_t, T>(left, right, n, [](T a, T b) -> uint8_t { return a > b; });
+    case BasicOp::GreaterThanOrEqual:
+      return binary<uint8_t, T>(left, right, n, [](T a, T b) -> uint8_t { return a >= b; });
+    case BasicOp::Equal:
+      return binary<uint8_t, T>(left, right, n, [](T a, T b) -> uint8_t { return a == b; });
+    case BasicOp::NotEqual:
+      return binary<uint8_t, T>(left, right, n, [](T a, T b) -> uint8_t { return a != b; });
+    default:
+      throw runtime_error_f("Operation %d is not a comparison", (int)op);
+  }
+}
+
+template <typename T>
+Operand arithmetic(BasicOp op, Operand const& left, Operand const& right, size_t n)
+{
+  switch (op) {
+    case BasicOp::Addition:
+      return binary<T, T>(left, right, n, [](T a, T b) -> T { return a + b; });
+    case BasicOp::Subtraction:
+      return binary<T, T>(left, right, n, [](T a, T b) -> T { return a - b; });
+    case BasicOp::Multiplication:
+      return binary<T, T>(left, right, n, [](T a, T b) -> T { return a * b; });
+    case BasicOp::Division:
+      if constexpr (std::is_integral_v<T>) {
+        std::vector<T> buffer;
+        auto r = valuesAs<T>(right, buffer);
+        for (size_t i = 0; i < (right.scalar ? 1 : n); ++i) {
+          if (r[i] == 0) {
+            throw runtime_error("Division by zero in expression");
+          }
+        }
+      }
+      return binary<T, T>(left, right, n, [](T a, T b) -> T { return a / b; });
+    case BasicOp::Power:
+      return binary<T, T>(left, right, n, [](T a, T b) -> T { return std::pow(a, b); });
+    default:
+      throw runtime_error_f("Operation %d is not an arithmetic operation", (int)op);
+  }
+}
+
+Operand bitwise(BasicOp op, Operand const& left, Operand const& right, size_t n)
+{
+  switch (op) {
+    case BasicOp::BitwiseAnd:
+      return binary<int64_t, int64_t>(left, right, n, [](int64_t a, int64_t b) { return a & b; });
+    case BasicOp::BitwiseOr:
+      return binary<int64_t, int64_t>(left, right, n, [](int64_t a, int64_t b) { return a | b; });
+    case BasicOp::BitwiseXor:
+      return binary<int64_t, int64_t>(left, right, n, [](int64_t a, int64_t b) { return a ^ b; });
+    case BasicOp::LogicalAnd:
+      return binary<uint8_t, uint8_t>(left, right, n, [](uint8_t a, uint8_t b) -> uint8_t { return a & b; });
+    case BasicOp::LogicalOr:
+      return binary<uint8_t, uint8_t>(left, right, n, [](uint8_t a, uint8_t b) -> uint8_t { return a | b; });
+    default:
+      throw runtime_error_f("Operation %d is not a bitwise operation", (int)op);
+  }
+}
+
+template <typename T>
+Operand function(BasicOp op, Operand const& operand, size_t n)
+{
+  switch (op) {
+    case BasicOp::Sqrt:
+      return unary<T, T>(operand, n, [](T a) -> T { return std::sqrt(a); });
+    case BasicOp::Exp:
+      return unary<T, T>(operand, n, [](T a) -> T { return std::exp(a); });
+    case BasicOp::Log:
+      return unary<T, T>(operand, n, [](T a) -> T { return std::log(a); });
+    case BasicOp::Log10:
+      return unary<T, T>(operand, n, [](T a) -> T { return std::log10(a); });
+    case BasicOp::Sin:
+      return unary<T, T>(operand, n, [](T a) -> T { return std::sin(a); });
+    case BasicOp::Cos:
+      return unary<T, T>(operand, n, [](T a) -> T { return std::cos(a); });
+    case BasicOp::Tan:
+      return unary<T, T>(operand, n, [](T a) -> T { return std::tan(a); });
+    case BasicOp::Asin:
+      return unary<T, T>(operand, n, [](T a) -> T { return std::asin(a); });
+    case BasicOp::Acos:
+      return unary<T, T>(operand, n, [](T a) -> T { return std::acos(a); });
+    case BasicOp::Atan:
+      return unary<T, T>(operand, n, [](T a) -> T { return std::atan(a); });
+    case BasicOp::Abs:
+      return unary<T, T>(operand, n, [](T a) -> T { return std::abs(a); });
+    default:
+      throw runtime_error_f("Operation %d is not a function", (int)op);
+  }
+}
+
+/// evaluate the operation sequence on a batch, the first operation being the root of the tree
+Operand evaluate(arrow::RecordBatch const& batch, Operations const& opSpecs)
+{
+  const size_t n = batch.num_rows();
+  std::vector<Operand> results(opSpecs.size());
+  std::unordered_map<std::string, Operand> fields;
+
+  auto datumOperand = [&](DatumSpec const& spec) -> Operand const& {
+    switch (spec.datum.index()) {
+      case 1:
+        return results[std::get<size_t>(spec.datum)];
+      case 2: {
+        // literals are stored with the fields, under a name which cannot be a column name
+        auto& literal = std::get<LiteralNode::var_t>(spec.datum);
+        // keyed on the type and the exact bit pattern of the value (a decimal rendering merges close literals)
+        auto key = std::to_string(spec.datum.index()) + "#" + std::to_string(literal.index()) + "#" + std::visit([](auto v) { return std::string(reinterpret_cast<char const*>(&v), sizeof(v)); }, literal);
+        auto it = fields.find(key);
+        if (it == fields.end()) {
+          it = fields.emplace(key, literalOperand(literal)).first;
+        }
+        return it->second;
+      }
+      case 3: {
+        auto& name = std::get<std::string>(spec.datum);
+        auto it = fields.find(name);
+        if (it == fields.end()) {
+          auto column = batch.GetColumnByName(name);
+          if (column == nullptr) {
+            throw runtime_error_f("Cannot find field \"%s\"", name.c_str());
+          }
+          it = fields.emplace(name, fieldOperand(*column)).first;
+        }
+        return it->second;
+      }
+      default:
+        throw runtime_error("Malformed DatumSpec");
+    }
+  };
+
+  for (auto it = opSpecs.rbegin(); it != opSpecs.rend(); ++it) {
+    auto const& left = datumOperand(it->left);
+    auto& result = results[std::get<size_t>(it->result.datum)];
+    if (it->right.datum.index() == 0) {
+      // unary operations
+      if (it->op == BasicOp::BitwiseNot) {
+        result = unary<int64_t, int64_t>(left, n, [](int64_t a) { return ~a; });
+      } else if (computeType(it->type) == ComputeType::Double) {
+        result = function<double>(it->op, left, n);
+      } else {
+        result = function<float>(it->op, left, n);
+      }
+      continue;
+    }
+
+    auto const& right = datumOperand(it->right);
+    switch (it->op) {
+      case BasicOp::LogicalAnd:
+      case BasicOp::LogicalOr:
+      case BasicOp::BitwiseAnd:
+      case BasicOp::BitwiseOr:
+      case BasicOp::BitwiseXor:
+        result = bitwise(it->op, left, right, n);
+        break;
+      case BasicOp::LessThan:
+      case BasicOp::LessThanOrEqual:
+      case BasicOp::GreaterThan:
+      case BasicOp::GreaterThanOrEqual:
+      case BasicOp::Equal:
+      case BasicOp::NotEqual:
+        // compared in the widest type of the operands
+        switch (std::max(computeType(left), computeType(right))) {
+          case ComputeType::Double:
+            result = compare<double>(it->op, left, right, n);
+            break;
+          case ComputeType::Float:
+            result = compare<float>(it->op, left, right, n);
+            break;
+          case ComputeType::Int:
+            result = compare<int64_t>(it->op, left, right, n);
+            break;
+          default:
+            result = compare<uint8_t>(it->op, left, right, n);
+            break;
+        }
+        break;
+      default:
+        // computed in the type of the result, as with gandiva where the operands are upcast
+        switch (computeType(it->type)) {
+          case ComputeType::Double:
+            result = arithmetic<double>(it->op, left, right, n);
+            break;
+          case ComputeType::Float:
+            result = arithmetic<float>(it->op, left, right, n);
+            break;
+          default:
+            result = arithmetic<int64_t>(it->op, left, right, n);
+            break;
+        }
+        break;
+    }
+  }
+  return std::move(results[0]);
+}
+} // namespace
+
+void setInterpreterMaxRows(int64_t maxRows)
+{
+  interpreterMaxRows = maxRows;
+}
+
+int64_t getInterpreterMaxRows()
+{
+  return interpreterMaxRows;
+}
+
+Selection createSelectionInterpreted(std::shared_ptr<arrow::Table> table, Operations const& opSpecs)
+{
+  Selection selection;
+  auto s = gandiva::SelectionVector::MakeInt64(table->num_rows(),
+                                               arrow::default_memory_pool(),
+                                               &selection);
+  if (!s.ok()) {
+    throw runtime_error_f("Cannot allocate selection vector %s", s.ToString().c_str());
+  }
+  if (table->num_rows() == 0 || opSpecs.empty()) {
+    return selection;
+  }
+
+  arrow::TableBatchReader reader(*table);
+  std::shared_ptr<arrow::RecordBatch> batch;
+  int64_t offset = 0;
+  int64_t nSelected = 0;
+  while (true) {
+    s = reader.ReadNext(&batch);
+    if (!s.ok()) {
+      throw runtime_error_f("Cannot read batches from table %s", s.ToString().c_str());
+    }
+    if (batch == nullptr) {
+      break;
+    }
+    auto result = evaluate(*batch, opSpecs);
+    std::vector<uint8_t> buffer;
+    auto mask = valuesAs<uint8_t>(result, buffer);
+    for (int64_t i = 0; i < batch->num_rows(); ++i) {
+      if (mask[result.scalar ? 0 : i]) {
+        selection->SetIndex(nSelected++, offset + i);
+      }
+    }
+    offset += batch->num_rows();
+  }
+  selection->SetNumSlots(nSelected);
+  return selection;
+}
+
+Selection createSelection(std::shared_ptr<arrow::Table> table, Operations const& opSpecs)
+{
+  if (table->num_rows() <= interpreterMaxRows) {
+    return createSelectionInterpreted(table, opSpecs);
+  }
+  return createSelection(table, createFilter(table->schema(), opSpecs));
+}
+
+} // namespace o2::framework::expressions
@@ -17,6 +17,7 @@
 #include "arrow/table.h"
 #include "fmt/format.h"
 #include <stack>
+#include <mutex>
 #include <iostream>
 #include <unordered_map>
 #include <set>
@@ -314,43 +315,67 @@ gandiva::ExpressionPtr makeExpression(gandiva::NodePtr node, gandiva::FieldPtr r
   return gandiva::TreeExprBuilder::MakeExpression(node, result);
 }
 
+namespace
+{
+/// Compiled filters and projectors, keyed by the schema and the expression
+/// they were made for, so that the same expression is compiled only once and
+/// not for every time frame. Shared by all the threads of a device.
+template <typename T>
+struct CompileCache {
+  std::mutex mutex;
+  std::unordered_map<std::string, std::shared_ptr<T>> entries;
+
+  template <typename F>
+  std::shared_ptr<T> get(std::string const& key, F&& make)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+      return it->second;
+    }
+    return entries.emplace(key, make()).first->second;
+  }
+};
+
+CompileCache<gandiva::Filter> filterCache;
+CompileCache<gandiva::Projector> projectorCache;
+} // namespace
+
 std::shared_ptr<gandiva::Filter>
   createFilter(gandiva::SchemaPtr const& Schema, Operations const& opSpecs)
 {
-  std::shared_ptr<gandiva::Filter> filter;
-  auto s = gandiva::Filter::Make(Schema,
-                                 makeCondition(createExpressionTree(opSpecs, Schema)),
-                                 &filter);
-  if (!s.ok()) {
-    throw runtime_error_f("Failed to create filter: %s", s.ToString().c_str());
-  }
-  return filter;
+  return createFilter(Schema, makeCondition(createExpressionTree(opSpecs, Schema)));
 }
 
 std::shared_ptr<gandiva::Filter>
   createFilter(gandiva::SchemaPtr const& Schema, gandiva::ConditionPtr condition)
 {
-  std::shared_ptr<gandiva::Filter> filter;
-  auto s = gandiva::Filter::Make(Schema,
-                                 condition,
-                                 &filter);
-  if (!s.ok()) {
-    throw runtime_error_f("Failed to create filter: %s", s.ToString().c_str());
-  }
-  return filter;
+  return filterCache.get(Schema->ToString() + "\n" + condition->ToString(), [&]() {
+    std::shared_ptr<gandiva::Filter> filter;
+    auto s = gandiva::Filter::Make(Schema,
+                                   condition,
+                                   &filter);
+    if (!s.ok()) {
+      throw runtime_error_f("Failed to create filter: %s", s.ToString().c_str());
+    }
+    return filter;
+  });
 }
 
 std::shared_ptr<gandiva::Projector>
   createProjector(gandiva::SchemaPtr const& Schema, Operations const& opSpecs, gandiva::FieldPtr result)
 {
-  std::shared_ptr<gandiva::Projector> projector;
-  auto s = gandiva::Projector::Make(Schema,
-                                    {makeExpression(createExpressionTree(opSpecs, Schema), result)},
-                                    &projector);
-  if (!s.ok()) {
-    throw runtime_error_f("Failed to create projector: %s", s.ToString().c_str());
-  }
-  return projector;
+  auto expression = makeExpression(createExpressionTree(opSpecs, Schema), result);
+  return projectorCache.get(Schema->ToString() + "\n" + expression->ToString(), [&]() {
+    std::shared_ptr<gandiva::Projector> projector;
+    auto s = gandiva::Projector::Make(Schema,
+                                      {expression},
+                                      &projector);
+    if (!s.ok()) {
+      throw runtime_error_f("Failed to create projector: %s", s.ToString().c_str());
+    }
+    return projector;
+  });
 }
 
 std::shared_ptr<gandiva::Projector>
@@ -393,7 +418,7 @@ Selection createSelection(std::shared_ptr<arrow::Table> table, std::shared_ptr<g
 Selection createSelection(std::shared_ptr<arrow::Table> table,
                           const Filter& expression)
 {
-  return createSelection(table, createFilter(table->schema(), createOperations(std::move(expression))));
+  return createSelection(table, createOperations(std::move(expression)));
 }
 
 auto createProjection(std::shared_ptr<arrow::Table> table, std::shared_ptr<gandiva::Projector> gprojector)
@@ -16,6 +16,12 @@
 namespace o2::framework
 {
 
+namespace
+{
+// slot of the current thread, -1 until it is set
+thread_local int threadSlot = -1;
+} // namespace
+
 constexpr HistogramRegistry::HistName::HistName(char const* const name)
   : str(name),
     hash(compile_time_hash(name)),
@@ -68,6 +74,7 @@ void HistogramRegistry::insert(const HistogramSpec& histSpec)
       registerName(histSpec.name);
       mRegistryKey[imask(idx + i)] = histSpec.hash;
       mRegistryValue[imask(idx + i)] = HistFactory::createHistVariant(histSpec);
+      createSlotCopies(imask(idx + i));
       lookup += i;
       return;
     }
@@ -173,6 +180,81 @@ double HistogramRegistry::getSize(double fillFraction)
   return size;
 }
 
+void HistogramRegistry::setThreadSlot(int slot)
+{
+  threadSlot = slot;
+}
+
+int HistogramRegistry::getThreadSlot()
+{
+  return threadSlot;
+}
+
+// create the copies of the histograms filled by the threads of slot 1 to nSlots - 1
+void HistogramRegistry::setConcurrentFill(int nSlots, bool mergeEachTimeFrame)
+{
+  mergeSlots();
+  mSlots.clear();
+  mSlots.resize(std::max(nSlots - 1, 0));
+  mMergeEachTimeFrame = mergeEachTimeFrame;
+  mOwnerThread = std::this_thread::get_id();
+  for (auto i = 0u; i < MAX_REGISTRY_SIZE; ++i) {
+    createSlotCopies(i);
+  }
+}
+
+// create the (empty) copies of histogram i for the slots
+void HistogramRegistry::createSlotCopies(uint32_t i)
+{
+  std::visit([&](const auto& sharedPtr) {
+    using T = std::decay_t<decltype(*sharedPtr)>;
+    if (!sharedPtr) {
+      return;
+    }
+    for (auto& values : mSlots) {
+      auto copy = std::shared_ptr<T>(static_cast<T*>(sharedPtr->Clone()));
+      copy->Reset();
+      if constexpr (std::is_base_of_v<TH1, T>) {
+        copy->SetDirectory(nullptr);
+      }
+      values[i] = copy;
+    }
+  },
+             mRegistryValue[i]);
+}
+
+// add the histograms of the slots to the ones of the registry
+void HistogramRegistry::mergeSlots()
+{
+  if (mSlots.empty()) {
+    return;
+  }
+  for (auto i = 0u; i < MAX_REGISTRY_SIZE; ++i) {
+    std::visit([&](auto& sharedPtr) {
+      using P = std::decay_t<decltype(sharedPtr)>;
+      if (!sharedPtr) {
+        return;
+      }
+      TList list;
+      for (auto& values : mSlots) {
+        list.Add(std::get<P>(values[i]).get());
+      }
+      sharedPtr->Merge(&list);
+      for (auto& values : mSlots) {
+        std::get<P>(values[i])->Reset();
+      }
+    },
+               mRegistryValue[i]);
+  }
+}
+
+void HistogramRegistry::endOfTimeFrame()
+{
+  if (mMergeEachTimeFrame) {
+    mergeSlots();
+  }
+}
+
 // print some useful meta-info about the stored histograms
 void HistogramRegistry::print(bool showAxisDetails)
 {
@@ -265,6 +347,8 @@ void HistogramRegistry::print(bool showAxisDetails)
 // create output structure will be propagated to file-sink
 TList* HistogramRegistry::operator*()
 {
+  mergeSlots();
+
   TList* list = new TList();
   list->SetName(mName.data());
 
@@ -13,6 +13,10 @@
 #include "Framework/Logger.h"
 
 #include "arrow/type_traits.h"
+#include "arrow/util/bit_util.h"
+#include <TBufferFile.h>
+#include <cstring>
+#include <tuple>
 
 namespace o2::framework
 {
@@ -21,7 +25,7 @@ namespace
 {
 // -----------------------------------------------------------------------------
 // TreeToTable allows to fill the contents of a given TTree to an arrow::Table
-//  ColumnIterator is used by TreeToTable
+//  ColumnReader is used by TreeToTable
 //
 // To copy the contents of a tree tr to a table ta do:
 //  . TreeToTable t2t(tr);
@@ -31,336 +35,151 @@ namespace
 //  . auto ta = t2t.process();
 //
 // .............................................................................
-class ColumnIterator
+// ColumnReader copies a branch to an arrow::Array with the bulk I/O of ROOT:
+// the entries of a basket are decompressed and copied in one go into the arrow
+// buffer, without going through a reader for each entry. Only single-value or
+// single-array branches of basic types are accepted, e.g. alpha/D or alpha[5]/D
+class ColumnReader
 {
+ public:
+  ColumnReader(TTree* tree, const char* colname);
+
+  // has the reader been properly initialized
+  bool getStatus() const { return mStatus; }
+
+  // read the first numEntries entries of the branch into mArray
+  void read(int64_t numEntries);
+
+  std::shared_ptr<arrow::Array> getArray() { return mArray; }
+  std::shared_ptr<arrow::Field> getSchema() { return mField; }
 
  private:
-  // all the possible TTreeReaderValue<T> types
-  TTreeReaderValue<bool>* mReaderValue_o = nullptr;
-  TTreeReaderValue<uint8_t>* mReaderValue_ub = nullptr;
-  TTreeReaderValue<uint16_t>* mReaderValue_us = nullptr;
-  TTreeReaderValue<uint32_t>* mReaderValue_ui = nullptr;
-  TTreeReaderValue<ULong64_t>* mReaderValue_ul = nullptr;
-  TTreeReaderValue<int8_t>* mReaderValue_b = nullptr;
-  TTreeReaderValue<int16_t>* mReaderValue_s = nullptr;
-  TTreeReaderValue<int32_t>* mReaderValue_i = nullptr;
-  TTreeReaderValue<int64_t>* mReaderValue_l = nullptr;
-  TTreeReaderValue<float>* mReaderValue_f = nullptr;
-  TTreeReaderValue<double>* mReaderValue_d = nullptr;
-
-  // all the possible TTreeReaderArray<T> types
-  TTreeReaderArray<bool>* mReaderArray_o = nullptr;
-  TTreeReaderArray<uint8_t>* mReaderArray_ub = nullptr;
-  TTreeReaderArray<uint16_t>* mReaderArray_us = nullptr;
-  TTreeReaderArray<uint32_t>* mReaderArray_ui = nullptr;
-  TTreeReaderArray<uint64_t>* mReaderArray_ul = nullptr;
-  TTreeReaderArray<int8_t>* mReaderArray_b = nullptr;
-  TTreeReaderArray<int16_t>* mReaderArray_s = nullptr;
-  TTreeReaderArray<int32_t>* mReaderArray_i = nullptr;
-  TTreeReaderArray<int64_t>* mReaderArray_l = nullptr;
-  TTreeReaderArray<float>* mReaderArray_f = nullptr;
-  TTreeReaderArray<double>* mReaderArray_d = nullptr;
-
-  // all the possible arrow::TBuilder types
-  arrow::FixedSizeListBuilder* mTableBuilder_list = nullptr;
-
-  arrow::BooleanBuilder* mTableBuilder_o = nullptr;
-  arrow::UInt8Builder* mTableBuilder_ub = nullptr;
-  arrow::UInt16Builder* mTableBuilder_us = nullptr;
-  arrow::UInt32Builder* mTableBuilder_ui = nullptr;
-  arrow::UInt64Builder* mTableBuilder_ul = nullptr;
-  arrow::Int8Builder* mTableBuilder_b = nullptr;
-  arrow::Int16Builder* mTableBuilder_s = nullptr;
-  arrow::Int32Builder* mTableBuilder_i = nullptr;
-  arrow::Int64Builder* mTableBuilder_l = nullptr;
-  arrow::FloatBuilder* mTableBuilder_f = nullptr;
-  arrow::DoubleBuilder* mTableBuilder_d = nullptr;
+  // read the entries [first, numEntries[ one by one, when the bulk read is not possible
+  void readEntryByEntry(int64_t first, int64_t numEntries, uint8_t* data);
 
+  TBranch* mBranch = nullptr;
   bool mStatus = false;
   EDataType mElementType;
-  int64_t mNumberElements;
-  const char* mColumnName;
+  int64_t mNumberElements = 1;
+  int mElementSize = 0;
 
+  std::shared_ptr<arrow::DataType> mElementArrowType;
   std::shared_ptr<arrow::Field> mField;
   std::shared_ptr<arrow::Array> mArray;
-
- public:
-  ColumnIterator(TTreeReader& reader, const char* colname);
-  ~ColumnIterator();
-
-  // has the iterator been properly initialized
-  bool getStatus();
-
-  // copy the TTreeReaderValue to the arrow::TBuilder
-  void push();
-
-  // reserve enough space to push s elements without reallocating
-  void reserve(size_t s);
-
-  std::shared_ptr<arrow::Array> getArray() { return mArray; }
-  std::shared_ptr<arrow::Field> getSchema() { return mField; }
-
-  // finish the arrow::TBuilder
-  // with this mArray is prepared to be used in arrow::Table::Make
-  void finish();
 };
 } // namespace
 
 // is used in TableToTree
-BranchIterator::BranchIterator(TTree* tree, std::shared_ptr<arrow::ChunkedArray> col, std::shared_ptr<arrow::Field> field)
+ColumnToBranch::ColumnToBranch(TTree* tree, std::shared_ptr<arrow::ChunkedArray> column, std::shared_ptr<arrow::Field> field)
+  : mChunks{column->chunks()}
 {
-  mField = field.get();
-  mBranchName = mField->name();
-
-  mFieldType = mField->type()->id();
-  mChunks = col->chunks();
-  mNumberChuncs = mChunks.size();
-
-  mLeaflistString = mBranchName;
-  mElementType = mFieldType;
-  mNumberElements = 1;
-  if (mFieldType == arrow::Type::type::FIXED_SIZE_LIST) {
-
-    // element type
-    if (mField->type()->num_fields() <= 0) {
-      LOGP(FATAL, "Field {} of type {} has no children!", mField->name(), mField->type()->ToString().c_str());
+  auto type = field->type();
+  auto isList = type->id() == arrow::Type::type::FIXED_SIZE_LIST;
+  if (isList) {
+    if (type->num_fields() <= 0) {
+      LOGP(FATAL, "Field {} of type {} has no children!", field->name(), type->ToString());
     }
-    mElementType = mField->type()->field(0)->type()->id();
-    // number of elements
-    mNumberElements = static_cast<const arrow::FixedSizeListType*>(mField->type().get())->list_size();
-    mLeaflistString += "[" + std::to_string(mNumberElements) + "]";
+    mNumberElements = static_cast<const arrow::FixedSizeListType*>(type.get())->list_size();
+    type = type->field(0)->type();
   }
+  mElementType = type->id();
 
-  // initialize the branch
-  mStatus = initBranch(tree);
+  // ROOT stores the booleans as bytes
+  auto elementSize = mElementType == arrow::Type::type::BOOL ? 1 : std::static_pointer_cast<arrow::FixedWidthType>(type)->bit_width() / 8;
+  mRowSize = mNumberElements * elementSize;
+  mBuffer.resize(mRowSize);
 
-  mCounterChunk = 0;
-  mStatus &= initDataBuffer(mCounterChunk);
+  mStatus = initBranch(tree, field->name(), isList);
 }
 
-BranchIterator::~BranchIterator()
-{
-  delete mBranchBuffer;
-
-  delete mVariable_o;
-  delete mVariable_ub;
-  delete mVariable_us;
-  delete mVariable_ui;
-  delete mVariable_ul;
-  delete mVariable_s;
-  delete mVariable_i;
-  delete mVariable_l;
-  delete mVariable_f;
-  delete mVariable_d;
-}
-
-bool BranchIterator::getStatus()
-{
-  return mStatus;
-}
-
-bool BranchIterator::initBranch(TTree* tree)
+bool ColumnToBranch::initBranch(TTree* tree, std::string const& name, bool isList)
 {
   // try to find branch in tree
-  mBranchPtr = tree->GetBranch(mBranchName.c_str());
+  mBranchPtr = tree->GetBranch(name.c_str());
   if (mBranchPtr) {
+    mBranchPtr->SetAddress(mBuffer.data());
     return true;
   }
 
   // create new branch of given data type
+  std::string leaflist = name;
+  if (isList) {
+    leaflist += "[" + std::to_string(mNumberElements) + "]";
+  }
   switch (mElementType) {
     case arrow::Type::type::BOOL:
-      mLeaflistString += "/O";
+      leaflist += "/O";
       break;
     case arrow::Type::type::UINT8:
-      mLeaflistString += "/b";
+      leaflist += "/b";
       break;
     case arrow::Type::type::UINT16:
-      mLeaflistString += "/s";
+      leaflist += "/s";
       break;
     case arrow::Type::type::UINT32:
-      mLeaflistString += "/i";
+      leaflist += "/i";
       break;
     case arrow::Type::type::UINT64:
-      mLeaflistString += "/l";
+      leaflist += "/l";
       break;
     case arrow::Type::type::INT8:
-      mLeaflistString += "/B";
+      leaflist += "/B";
       break;
     case arrow::Type::type::INT16:
-      mLeaflistString += "/S";
+      leaflist += "/S";
       break;
     case arrow::Type::type::INT32:
-      mLeaflistString += "/I";
+      leaflist += "/I";
       break;
     case arrow::Type::type::INT64:
-      mLeaflistString += "/L";
+      leaflist += "/L";
       break;
     case arrow::Type::type::FLOAT:
-      mLeaflistString += "/F";
+      leaflist += "/F";
       break;
     case arrow::Type::type::DOUBLE:
-      mLeaflistString += "/D";
+      leaflist += "/D";
       break;
     default:
       LOGP(FATAL, "Type {} not handled!", mElementType);
-      break;
+      return false;
   }
 
-  mBranchPtr = tree->Branch(mBranchName.c_str(), mBranchBuffer, mLeaflistString.c_str());
-  if (mBranchPtr) {
-    return true;
-  } else {
-    return false;
-  }
+  mBranchPtr = tree->Branch(name.c_str(), mBuffer.data(), leaflist.c_str());
+  return mBranchPtr != nullptr;
 }
 
-bool BranchIterator::initDataBuffer(Int_t ib)
+void ColumnToBranch::nextChunk()
 {
-
-  auto chunkToUse = mChunks.at(ib);
-  if (mFieldType == arrow::Type::type::FIXED_SIZE_LIST) {
-    chunkToUse = std::dynamic_pointer_cast<arrow::FixedSizeListArray>(chunkToUse)->values();
-  }
-
-  // reset actual row number
-  mCounterRow = 0;
-
-  // get next chunk of given data type mElementType
-  switch (mElementType) {
-    case arrow::Type::type::BOOL:
-      if (!mVariable_o) {
-        mVariable_o = new bool(mNumberElements);
-      }
-      mArray_o = std::dynamic_pointer_cast<arrow::BooleanArray>(chunkToUse);
-      for (int ii = 0; ii < mNumberElements; ii++) {
-        mVariable_o[ii] = (bool)mArray_o->Value(ii);
-      }
-      mValueBuffer = (void*)mVariable_o;
-      break;
-    case arrow::Type::type::UINT8:
-      mVariable_ub = (uint8_t*)std::dynamic_pointer_cast<arrow::UInt8Array>(chunkToUse)->raw_values();
-      mValueBuffer = (void*)mVariable_ub;
-      break;
-    case arrow::Type::type::UINT16:
-      mVariable_us = (uint16_t*)std::dynamic_pointer_cast<arrow::UInt16Array>(chunkToUse)->raw_values();
-      mValueBuffer = (void*)mVariable_us;
-      break;
-    case arrow::Type::type::UINT32:
-      mVariable_ui = (uint32_t*)std::dynamic_pointer_cast<arrow::UInt32Array>(chunkToUse)->raw_values();
-      mValueBuffer = (void*)mVariable_ui;
-      break;
-    case arrow::Type::type::UINT64:
-      mVariable_ul = (uint64_t*)std::dynamic_pointer_cast<arrow::UInt64Array>(chunkToUse)->raw_values();
-      mValueBuffer = (void*)mVariable_ul;
-      break;
-    case arrow::Type::type::INT8:
-      mVariable_b = (int8_t*)std::dynamic_pointer_cast<arrow::Int8Array>(chunkToUse)->raw_values();
-      mValueBuffer = (void*)mVariable_b;
-      break;
-    case arrow::Type::type::INT16:
-      mVariable_s = (int16_t*)std::dynamic_pointer_cast<arrow::Int16Array>(chunkToUse)->raw_values();
-      mValueBuffer = (void*)mVariable_s;
-      break;
-    case arrow::Type::type::INT32:
-      mVariable_i = (int32_t*)std::dynamic_pointer_cast<arrow::Int32Array>(chunkToUse)->raw_values();
-      mValueBuffer = (void*)mVariable_i;
-      break;
-    case arrow::Type::type::INT64:
-      mVariable_l = (int64_t*)std::dynamic_pointer_cast<arrow::Int64Array>(chunkToUse)->raw_values();
-      mValueBuffer = (void*)mVariable_l;
-      break;
-    case arrow::Type::type::FLOAT:
-      mVariable_f = (Float_t*)std::dynamic_pointer_cast<arrow::FloatArray>(chunkToUse)->raw_values();
-      mValueBuffer = (void*)mVariable_f;
-      break;
-    case arrow::Type::type::DOUBLE:
-      mVariable_d = (double*)std::dynamic_pointer_cast<arrow::DoubleArray>(chunkToUse)->raw_values();
-      mValueBuffer = (void*)mVariable_d;
-    default:
-      break;
-      LOGP(FATAL, "Type {} not handled!", mElementType);
-      break;
+  // skip empty chunks
+  do {
+    ++mCounterChunk;
+    if (mCounterChunk >= (int)mChunks.size()) {
+      throw std::runtime_error("No values left to fill the branch " + std::string(mBranchPtr->GetName()));
+    }
+    mChunkRows = mChunks[mCounterChunk]->length();
+  } while (mChunkRows == 0);
+  mRow = 0;
+
+  // values of the chunk, taking into account the offsets of sliced arrays
+  auto chunk = mChunks[mCounterChunk];
+  auto offset = chunk->offset() * mNumberElements;
+  if (chunk->type_id() == arrow::Type::type::FIXED_SIZE_LIST) {
+    chunk = std::static_pointer_cast<arrow::FixedSizeListArray>(chunk)->values();
+    offset += chunk->offset();
   }
-  mBranchPtr->SetAddress(mValueBuffer);
-
-  // reset number of rows mNumberRows and row counter mCounterRow
-  mNumberRows = mChunks.at(ib)->length();
-
-  return true;
-}
+  auto values = chunk->data()->buffers[1]->data();
 
-bool BranchIterator::push()
-{
-  // increment row counter
-  mCounterRow++;
-
-  // mCounterChunk and mCounterRow contain the current chunk and row
-  // return the next element if available
-  if (mCounterRow >= mNumberRows) {
-    mCounterChunk++;
-    if (mCounterChunk < mNumberChuncs) {
-      initDataBuffer(mCounterChunk);
-    } else {
-      // end of data buffer reached
-      return false;
+  if (mElementType == arrow::Type::type::BOOL) {
+    auto numValues = mChunkRows * mNumberElements;
+    mBoolValues.resize(numValues);
+    for (int64_t i = 0; i < numValues; ++i) {
+      mBoolValues[i] = arrow::BitUtil::GetBit(values, offset + i);
     }
+    mData = mBoolValues.data();
   } else {
-    switch (mElementType) {
-      case arrow::Type::type::BOOL:
-        for (int ii = 0; ii < mNumberElements; ii++) {
-          mVariable_o[ii] = (bool)mArray_o->Value(mCounterRow * mNumberElements + ii);
-        }
-        mValueBuffer = (void*)mVariable_o;
-        break;
-      case arrow::Type::type::UINT8:
-        mVariable_ub += mNumberElements;
-        mValueBuffer = (void*)mVariable_ub;
-        break;
-      case arrow::Type::type::UINT16:
-        mVariable_us += mNumberElements;
-        mValueBuffer = (void*)mVariable_us;
-        break;
-      case arrow::Type::type::UINT32:
-        mVariable_ui += mNumberElements;
-        mValueBuffer = (void*)mVariable_ui;
-        break;
-      case arrow::Type::type::UINT64:
-        mVariable_ul += mNumberElements;
-        mValueBuffer = (void*)mVariable_ul;
-        break;
-      case arrow::Type::type::INT8:
-        mVariable_b += mNumberElements;
-        mValueBuffer = (void*)mVariable_b;
-        break;
-      case arrow::Type::type::INT16:
-        mVariable_s += mNumberElements;
-        mValueBuffer = (void*)mVariable_s;
-        break;
-      case arrow::Type::type::INT32:
-        mVariable_i += mNumberElements;
-        mValueBuffer = (void*)mVariable_i;
-        break;
-      case arrow::Type::type::INT64:
-        mVariable_l += mNumberElements;
-        mValueBuffer = (void*)mVariable_l;
-        break;
-      case arrow::Type::type::FLOAT:
-        mVariable_f += mNumberElements;
-        mValueBuffer = (void*)mVariable_f;
-        break;
-      case arrow::Type::type::DOUBLE:
-        mVariable_d += mNumberElements;
-        mValueBuffer = (void*)mVariable_d;
-        break;
-      default:
-        LOGP(FATAL, "Type {} not handled!", mElementType);
-        break;
-    }
+    mData = values + offset * (mRowSize / mNumberElements);
   }
-  mBranchPtr->SetAddress(mValueBuffer);
-
-  return true;
 }
 
 TableToTree::TableToTree(std::shared_ptr<arrow::Table> table,
@@ -385,20 +204,17 @@ TableToTree::TableToTree(std::shared_ptr<arrow::Table> table,
   }
 }
 
-TableToTree::~TableToTree()
-{
-  // clean up branch iterators
-  mBranchIterators.clear();
-}
+TableToTree::~TableToTree() = default;
 
 bool TableToTree::addBranch(std::shared_ptr<arrow::ChunkedArray> col, std::shared_ptr<arrow::Field> field)
 {
-  BranchIterator* brit = new BranchIterator(mTreePtr, col, field);
-  if (brit->getStatus()) {
-    mBranchIterators.push_back(brit);
+  auto column = std::make_unique<ColumnToBranch>(mTreePtr, col, field);
+  auto status = column->getStatus();
+  if (status) {
+    mColumns.push_back(std::move(column));
   }
 
-  return brit->getStatus();
+  return status;
 }
 
 bool TableToTree::addAllBranches()
@@ -406,13 +222,7 @@ bool TableToTree::addAllBranches()
 
   bool status = mTable->num_columns() > 0;
   for (auto ii = 0; ii < mTable->num_columns(); ii++) {
-    BranchIterator* brit =
-      new BranchIterator(mTreePtr, mTable->column(ii), mTable->schema()->field(ii));
-    if (brit->getStatus()) {
-      mBranchIterators.push_back(brit);
-    } else {
-      status = false;
-    }
+    status &= addBranch(mTable->column(ii), mTable->schema()->field(ii));
   }
 
   return status;
@@ -420,15 +230,15 @@ bool TableToTree::addAllBranches()
 
 TTree* TableToTree::process()
 {
-
-  bool togo = mTreePtr->GetNbranches() > 0;
-  while (togo) {
-    // fill the tree
-    mTreePtr->Fill();
-
-    // update the branches
-    for (auto brit : mBranchIterators) {
-      togo &= brit->push();
+  // the branch buffers keep their address, so that with implicit multi-threading
+  // enabled the baskets of the different branches are compressed concurrently by TTree::Fill
+  if (mTreePtr->GetNbranches() > 0) {
+    auto numRows = mTable->num_rows();
+    for (int64_t row = 0; row < numRows; ++row) {
+      for (auto& column : mColumns) {
+        column->next();
+      }
+      mTreePtr->Fill();
     }
   }
   mTreePtr->Write("", TObject::kOverwrite);
@@ -437,404 +247,172 @@ TTree* TableToTree::process()
 }
 
 // -----------------------------------------------------------------------------
-#define MAKE_LIST_BUILDER(ElementType, NumElements)                \
-  std::unique_ptr<arrow::ArrayBuilder> ValueBuilder;               \
-  arrow::MemoryPool* MemoryPool = arrow::default_memory_pool();    \
-  auto stat = MakeBuilder(MemoryPool, ElementType, &ValueBuilder); \
-  mTableBuilder_list = new arrow::FixedSizeListBuilder(            \
-    MemoryPool,                                                    \
-    std::move(ValueBuilder),                                       \
-    NumElements);
-
-#define MAKE_FIELD(ElementType, NumElements)                                                         \
-  if (NumElements == 1) {                                                                            \
-    mField =                                                                                         \
-      std::make_shared<arrow::Field>(mColumnName, ElementType);                                      \
-  } else {                                                                                           \
-    mField =                                                                                         \
-      std::make_shared<arrow::Field>(mColumnName, arrow::fixed_size_list(ElementType, NumElements)); \
+namespace
+{
+// size in bytes and arrow type of the basic types which can be read from a branch
+std::pair<int, std::shared_ptr<arrow::DataType>> elementType(EDataType type)
+{
+  switch (type) {
+    case EDataType::kBool_t:
+      return {1, arrow::boolean()};
+    case EDataType::kUChar_t:
+      return {1, arrow::uint8()};
+    case EDataType::kUShort_t:
+      return {2, arrow::uint16()};
+    case EDataType::kUInt_t:
+      return {4, arrow::uint32()};
+    case EDataType::kULong64_t:
+      return {8, arrow::uint64()};
+    case EDataType::kChar_t:
+      return {1, arrow::int8()};
+    case EDataType::kShort_t:
+      return {2, arrow::int16()};
+    case EDataType::kInt_t:
+      return {4, arrow::int32()};
+    case EDataType::kLong64_t:
+      return {8, arrow::int64()};
+    case EDataType::kFloat_t:
+      return {4, arrow::float32()};
+    case EDataType::kDouble_t:
+      return {8, arrow::float64()};
+    default:
+      return {0, nullptr};
   }
+}
 
-#define MAKE_FIELD_AND_BUILDER(ElementCType, NumElements, Builder)                                                                            \
-  MAKE_FIELD(arrow::TypeTraits<arrow::CTypeTraits<ElementCType>::ArrowType>::type_singleton(), NumElements);                                  \
-  if (NumElements == 1) {                                                                                                                     \
-    arrow::MemoryPool* MemoryPool = arrow::default_memory_pool();                                                                             \
-    Builder = new arrow::TypeTraits<arrow::CTypeTraits<ElementCType>::ArrowType>::BuilderType(MemoryPool);                                    \
-  } else {                                                                                                                                    \
-    MAKE_LIST_BUILDER(arrow::TypeTraits<arrow::CTypeTraits<ElementCType>::ArrowType>::type_singleton(), NumElements);                         \
-    Builder = static_cast<arrow::TypeTraits<arrow::CTypeTraits<ElementCType>::ArrowType>::BuilderType*>(mTableBuilder_list->value_builder()); \
+// the serialized entries are big-endian
+template <typename T>
+void swapCopy(uint8_t* dest, char const* src, int64_t n)
+{
+  for (int64_t i = 0; i < n; ++i) {
+    T value;
+    std::memcpy(&value, src + i * sizeof(T), sizeof(T));
+    if constexpr (sizeof(T) == 2) {
+      value = __builtin_bswap16(value);
+    } else if constexpr (sizeof(T) == 4) {
+      value = __builtin_bswap32(value);
+    } else {
+      value = __builtin_bswap64(value);
+    }
+    std::memcpy(dest + i * sizeof(T), &value, sizeof(T));
   }
+}
 
-// is used in TreeToTable
-ColumnIterator::ColumnIterator(TTreeReader& reader, const char* colname)
+void copySerialized(uint8_t* dest, char const* src, int64_t n, int size)
 {
+#ifdef R__BYTESWAP
+  switch (size) {
+    case 2:
+      swapCopy<uint16_t>(dest, src, n);
+      return;
+    case 4:
+      swapCopy<uint32_t>(dest, src, n);
+      return;
+    case 8:
+      swapCopy<uint64_t>(dest, src, n);
+      return;
+  }
+#endif
+  std::memcpy(dest, src, n * size);
+}
 
-  // find branch
-  auto tree = reader.GetTree();
-  if (!tree) {
-    LOGP(FATAL, "Can not locate tree!");
-    return;
+std::shared_ptr<arrow::Buffer> allocateBuffer(int64_t size)
+{
+  auto buffer = arrow::AllocateBuffer(size);
+  if (!buffer.ok()) {
+    throw std::runtime_error(fmt::format("Unable to allocate {} bytes: {}", size, buffer.status().ToString()));
   }
+  return std::move(buffer).ValueOrDie();
+}
+} // namespace
 
-  auto br = tree->GetBranch(colname);
-  if (!br) {
+// is used in TreeToTable
+ColumnReader::ColumnReader(TTree* tree, const char* colname)
+{
+  mBranch = tree->GetBranch(colname);
+  if (!mBranch) {
     LOGP(WARNING, "Can not locate branch {}", colname);
     return;
   }
-  mColumnName = colname;
 
   // type of the branch elements
   TClass* cl;
-  br->GetExpectedType(cl, mElementType);
+  mBranch->GetExpectedType(cl, mElementType);
+  std::tie(mElementSize, mElementArrowType) = elementType(mElementType);
+  if (!mElementArrowType) {
+    LOGP(FATAL, "Type {} not handled!", mElementType);
+    return;
+  }
 
-  // currently only single-value or single-array branches are accepted
-  // thus of the form e.g. alpha/D or alpha[5]/D
   // check if this is a single-value or single-array branch
-  mNumberElements = 1;
-  std::string branchTitle = br->GetTitle();
+  std::string branchTitle = mBranch->GetTitle();
   Int_t pos0 = branchTitle.find("[");
   Int_t pos1 = branchTitle.find("]");
   if (pos0 > 0 && pos1 > 0) {
     mNumberElements = atoi(branchTitle.substr(pos0 + 1, pos1 - pos0 - 1).c_str());
   }
 
-  // initialize the TTreeReaderValue<T> / TTreeReaderArray<T>
-  //            the corresponding arrow::TBuilder
-  //            the column field
-  // the TTreeReaderValue is incremented by reader->Next()
-  // switch according to mElementType
-  mStatus = true;
-
   if (mNumberElements == 1) {
-    switch (mElementType) {
-      case EDataType::kBool_t:
-        mReaderValue_o = new TTreeReaderValue<bool>(reader, mColumnName);
-        MAKE_FIELD_AND_BUILDER(bool, 1, mTableBuilder_o);
-        break;
-      case EDataType::kUChar_t:
-        mReaderValue_ub = new TTreeReaderValue<uint8_t>(reader, mColumnName);
-        MAKE_FIELD_AND_BUILDER(uint8_t, 1, mTableBuilder_ub);
-        break;
-      case EDataType::kUShort_t:
-        mReaderValue_us = new TTreeReaderValue<uint16_t>(reader, mColumnName);
-        MAKE_FIELD_AND_BUILDER(uint16_t, 1, mTableBuilder_us);
-        break;
-      case EDataType::kUInt_t:
-        mReaderValue_ui = new TTreeReaderValue<uint32_t>(reader, mColumnName);
-        MAKE_FIELD_AND_BUILDER(uint32_t, 1, mTableBuilder_ui);
-        break;
-      case EDataType::kULong64_t:
-        mReaderValue_ul = new TTreeReaderValue<ULong64_t>(reader, mColumnName);
-        MAKE_FIELD_AND_BUILDER(uint64_t, 1, mTableBuilder_ul);
-        break;
-      case EDataType::kChar_t:
-        mReaderValue_b = new TTreeReaderValue<int8_t>(reader, mColumnName);
-        MAKE_FIELD_AND_BUILDER(int8_t, 1, mTableBuilder_b);
-        break;
-      case EDataType::kShort_t:
-        mReaderValue_s = new TTreeReaderValue<int16_t>(reader, mColumnName);
-        MAKE_FIELD_AND_BUILDER(int16_t, 1, mTableBuilder_s);
-        break;
-      case EDataType::kInt_t:
-        mReaderValue_i = new TTreeReaderValue<int32_t>(reader, mColumnName);
-        MAKE_FIELD_AND_BUILDER(int32_t, 1, mTableBuilder_i);
-        break;
-      case EDataType::kLong64_t:
-        mReaderValue_l = new TTreeReaderValue<int64_t>(reader, mColumnName);
-        MAKE_FIELD_AND_BUILDER(int64_t, 1, mTableBuilder_l);
-        break;
-      case EDataType::kFloat_t:
-        mReaderValue_f = new TTreeReaderValue<float>(reader, mColumnName);
-        MAKE_FIELD_AND_BUILDER(float, 1, mTableBuilder_f);
-        break;
-      case EDataType::kDouble_t:
-        mReaderValue_d = new TTreeReaderValue<double>(reader, mColumnName);
-        MAKE_FIELD_AND_BUILDER(double, 1, mTableBuilder_d);
-        break;
-      default:
-        LOGP(FATAL, "Type {} not handled!", mElementType);
-        break;
-    }
+    mField = std::make_shared<arrow::Field>(colname, mElementArrowType);
   } else {
-    switch (mElementType) {
-      case EDataType::kBool_t:
-        mReaderArray_o = new TTreeReaderArray<bool>(reader, mColumnName);
-        MAKE_FIELD_AND_BUILDER(bool, mNumberElements, mTableBuilder_o);
-        break;
-      case EDataType::kUChar_t:
-        mReaderArray_ub = new TTreeReaderArray<uint8_t>(reader, mColumnName);
-        MAKE_FIELD_AND_BUILDER(uint8_t, mNumberElements, mTableBuilder_ub);
-        break;
-      case EDataType::kUShort_t:
-        mReaderArray_us = new TTreeReaderArray<uint16_t>(reader, mColumnName);
-        MAKE_FIELD_AND_BUILDER(uint16_t, mNumberElements, mTableBuilder_us);
-        break;
-      case EDataType::kUInt_t:
-        mReaderArray_ui = new TTreeReaderArray<uint32_t>(reader, mColumnName);
-        MAKE_FIELD_AND_BUILDER(uint32_t, mNumberElements, mTableBuilder_ui);
-        break;
-      case EDataType::kULong64_t:
-        mReaderArray_ul = new TTreeReaderArray<uint64_t>(reader, mColumnName);
-        MAKE_FIELD_AND_BUILDER(uint64_t, mNumberElements, mTableBuilder_ul);
-        break;
-      case EDataType::kChar_t:
-        mReaderArray_b = new TTreeReaderArray<int8_t>(reader, mColumnName);
-        MAKE_FIELD_AND_BUILDER(int8_t, mNumberElements, mTableBuilder_b);
-        break;
-      case EDataType::kShort_t:
-        mReaderArray_s = new TTreeReaderArray<int16_t>(reader, mColumnName);
-        MAKE_FIELD_AND_BUILDER(int16_t, mNumberElements, mTableBuilder_s);
-        break;
-      case EDataType::kInt_t:
-        mReaderArray_i = new TTreeReaderArray<int32_t>(reader, mColumnName);
-        MAKE_FIELD_AND_BUILDER(int32_t, mNumberElements, mTableBuilder_i);
-        break;
-      case EDataType::kLong64_t:
-        mReaderArray_l = new TTreeReaderArray<int64_t>(reader, mColumnName);
-        MAKE_FIELD_AND_BUILDER(int64_t, mNumberElements, mTableBuilder_l);
-        break;
-      case EDataType::kFloat_t:
-        mReaderArray_f = new TTreeReaderArray<float>(reader, mColumnName);
-        MAKE_FIELD_AND_BUILDER(float, mNumberElements, mTableBuilder_f);
-        break;
-      case EDataType::kDouble_t:
-        mReaderArray_d = new TTreeReaderArray<double>(reader, mColumnName);
-        MAKE_FIELD_AND_BUILDER(double, mNumberElements, mTableBuilder_d);
-        break;
-      default:
-        LOGP(FATAL, "Type {} not handled!", mElementType);
-        break;
-    }
-  }
-}
-
-ColumnIterator::~ColumnIterator()
-{
-  // delete all pointers
-  delete mReaderValue_o;
-  delete mReaderValue_ub;
-  delete mReaderValue_us;
-  delete mReaderValue_ui;
-  delete mReaderValue_ul;
-  delete mReaderValue_b;
-  delete mReaderValue_s;
-  delete mReaderValue_i;
-  delete mReaderValue_l;
-  delete mReaderValue_f;
-  delete mReaderValue_d;
-
-  delete mReaderArray_o;
-  delete mReaderArray_ub;
-  delete mReaderArray_us;
-  delete mReaderArray_ui;
-  delete mReaderArray_ul;
-  delete mReaderArray_b;
-  delete mReaderArray_s;
-  delete mReaderArray_i;
-  delete mReaderArray_l;
-  delete mReaderArray_f;
-  delete mReaderArray_d;
-
-  if (mTableBuilder_list) {
-    delete mTableBuilder_list;
-  } else {
-    delete mTableBuilder_o;
-    delete mTableBuilder_ub;
-    delete mTableBuilder_us;
-    delete mTableBuilder_ui;
-    delete mTableBuilder_ul;
-    delete mTableBuilder_b;
-    delete mTableBuilder_s;
-    delete mTableBuilder_i;
-    delete mTableBuilder_l;
-    delete mTableBuilder_f;
-    delete mTableBuilder_d;
+    mField = std::make_shared<arrow::Field>(colname, arrow::fixed_size_list(mElementArrowType, mNumberElements));
   }
-};
-
-bool ColumnIterator::getStatus()
-{
-  return mStatus;
+  mStatus = true;
 }
 
-void ColumnIterator::reserve(size_t s)
+void ColumnReader::read(int64_t numEntries)
 {
-  arrow::Status stat;
+  auto numValues = numEntries * mNumberElements;
+  auto values = allocateBuffer(numValues * mElementSize);
+  auto data = values->mutable_data();
 
-  switch (mElementType) {
-    case EDataType::kBool_t:
-      stat = mTableBuilder_o->Reserve(s * mNumberElements);
-      break;
-    case EDataType::kUChar_t:
-      stat = mTableBuilder_ub->Reserve(s * mNumberElements);
-      break;
-    case EDataType::kUShort_t:
-      stat = mTableBuilder_us->Reserve(s * mNumberElements);
-      break;
-    case EDataType::kUInt_t:
-      stat = mTableBuilder_ui->Reserve(s * mNumberElements);
-      break;
-    case EDataType::kULong64_t:
-      stat = mTableBuilder_ul->Reserve(s * mNumberElements);
-      break;
-    case EDataType::kChar_t:
-      stat = mTableBuilder_b->Reserve(s * mNumberElements);
-      break;
-    case EDataType::kShort_t:
-      stat = mTableBuilder_s->Reserve(s * mNumberElements);
-      break;
-    case EDataType::kInt_t:
-      stat = mTableBuilder_i->Reserve(s * mNumberElements);
-      break;
-    case EDataType::kLong64_t:
-      stat = mTableBuilder_l->Reserve(s * mNumberElements);
-      break;
-    case EDataType::kFloat_t:
-      stat = mTableBuilder_f->Reserve(s * mNumberElements);
-      break;
-    case EDataType::kDouble_t:
-      stat = mTableBuilder_d->Reserve(s * mNumberElements);
-      break;
-    default:
-      LOGP(FATAL, "Type {} not handled!", mElementType);
+  // copy the baskets, as long as the branch supports the bulk read
+  TBufferFile buffer{TBuffer::EMode::kWrite, 4 * 1024 * 1024};
+  int64_t readEntries = 0;
+  while (readEntries < numEntries) {
+    auto readLast = mBranch->GetBulkRead().GetEntriesSerialized(readEntries, buffer);
+    if (readLast <= 0) {
       break;
+    }
+    readLast = std::min<int64_t>(readLast, numEntries - readEntries);
+    copySerialized(data + readEntries * mNumberElements * mElementSize, buffer.GetCurrent(), readLast * mNumberElements, mElementSize);
+    readEntries += readLast;
+  }
+  if (readEntries < numEntries) {
+    readEntryByEntry(readEntries, numEntries, data);
   }
-}
 
-void ColumnIterator::push()
-{
-  arrow::Status stat;
+  // arrow stores the booleans as bits
+  if (mElementType == EDataType::kBool_t) {
+    auto bits = allocateBuffer(arrow::BitUtil::BytesForBits(numValues));
+    auto bitsData = bits->mutable_data();
+    std::memset(bitsData, 0, bits->size());
+    for (int64_t i = 0; i < numValues; ++i) {
+      if (data[i]) {
+        arrow::BitUtil::SetBit(bitsData, i);
+      }
+    }
+    values = bits;
+  }
 
-  // switch according to mElementType
+  auto valueArray = arrow::MakeArray(arrow::ArrayData::Make(mElementArrowType, numValues, {nullptr, values}));
   if (mNumberElements == 1) {
-    switch (mElementType) {
-      case EDataType::kBool_t:
-        mTableBuilder_o->UnsafeAppend((bool)**mReaderValue_o);
-        break;
-      case EDataType::kUChar_t:
-        mTableBuilder_ub->UnsafeAppend(**mReaderValue_ub);
-        break;
-      case EDataType::kUShort_t:
-        mTableBuilder_us->UnsafeAppend(**mReaderValue_us);
-        break;
-      case EDataType::kUInt_t:
-        mTableBuilder_ui->UnsafeAppend(**mReaderValue_ui);
-        break;
-      case EDataType::kULong64_t:
-        mTableBuilder_ul->UnsafeAppend(**mReaderValue_ul);
-        break;
-      case EDataType::kChar_t:
-        mTableBuilder_b->UnsafeAppend(**mReaderValue_b);
-        break;
-      case EDataType::kShort_t:
-        mTableBuilder_s->UnsafeAppend(**mReaderValue_s);
-        break;
-      case EDataType::kInt_t:
-        mTableBuilder_i->UnsafeAppend(**mReaderValue_i);
-        break;
-      case EDataType::kLong64_t:
-        mTableBuilder_l->UnsafeAppend(**mReaderValue_l);
-        break;
-      case EDataType::kFloat_t:
-        mTableBuilder_f->UnsafeAppend(**mReaderValue_f);
-        break;
-      case EDataType::kDouble_t:
-        mTableBuilder_d->UnsafeAppend(**mReaderValue_d);
-        break;
-      default:
-        LOGP(FATAL, "Type {} not handled!", mElementType);
-        break;
-    }
+    mArray = valueArray;
   } else {
-    stat = mTableBuilder_list->AppendValues(1);
-    switch (mElementType) {
-      case EDataType::kBool_t:
-        stat &= mTableBuilder_o->AppendValues((uint8_t*)&((*mReaderArray_o)[0]), mNumberElements);
-        break;
-      case EDataType::kUChar_t:
-        stat &= mTableBuilder_ub->AppendValues(&((*mReaderArray_ub)[0]), mNumberElements);
-        break;
-      case EDataType::kUShort_t:
-        stat &= mTableBuilder_us->AppendValues(&((*mReaderArray_us)[0]), mNumberElements);
-        break;
-      case EDataType::kUInt_t:
-        stat &= mTableBuilder_ui->AppendValues(&((*mReaderArray_ui)[0]), mNumberElements);
-        break;
-      case EDataType::kULong64_t:
-        stat &= mTableBuilder_ul->AppendValues(&((*mReaderArray_ul)[0]), mNumberElements);
-        break;
-      case EDataType::kChar_t:
-        stat &= mTableBuilder_b->AppendValues(&((*mReaderArray_b)[0]), mNumberElements);
-        break;
-      case EDataType::kShort_t:
-        stat &= mTableBuilder_s->AppendValues(&((*mReaderArray_s)[0]), mNumberElements);
-        break;
-      case EDataType::kInt_t:
-        stat &= mTableBuilder_i->AppendValues(&((*mReaderArray_i)[0]), mNumberElements);
-        break;
-      case EDataType::kLong64_t:
-        stat &= mTableBuilder_l->AppendValues(&((*mReaderArray_l)[0]), mNumberElements);
-        break;
-      case EDataType::kFloat_t:
-        stat &= mTableBuilder_f->AppendValues(&((*mReaderArray_f)[0]), mNumberElements);
-        break;
-      case EDataType::kDouble_t:
-        stat &= mTableBuilder_d->AppendValues(&((*mReaderArray_d)[0]), mNumberElements);
-        break;
-      default:
-        LOGP(FATAL, "Type {} not handled!", mElementType);
-        break;
-    }
+    mArray = std::make_shared<arrow::FixedSizeListArray>(mField->type(), numEntries, valueArray);
   }
 }
 
-void ColumnIterator::finish()
+void ColumnReader::readEntryByEntry(int64_t first, int64_t numEntries, uint8_t* data)
 {
-  arrow::Status stat;
-
-  // switch according to mElementType
-  if (mNumberElements == 1) {
-    switch (mElementType) {
-      case EDataType::kBool_t:
-        stat = mTableBuilder_o->Finish(&mArray);
-        break;
-      case EDataType::kUChar_t:
-        stat = mTableBuilder_ub->Finish(&mArray);
-        break;
-      case EDataType::kUShort_t:
-        stat = mTableBuilder_us->Finish(&mArray);
-        break;
-      case EDataType::kUInt_t:
-        stat = mTableBuilder_ui->Finish(&mArray);
-        break;
-      case EDataType::kULong64_t:
-        stat = mTableBuilder_ul->Finish(&mArray);
-        break;
-      case EDataType::kChar_t:
-        stat = mTableBuilder_b->Finish(&mArray);
-        break;
-      case EDataType::kShort_t:
-        stat = mTableBuilder_s->Finish(&mArray);
-        break;
-      case EDataType::kInt_t:
-        stat = mTableBuilder_i->Finish(&mArray);
-        break;
-      case EDataType::kLong64_t:
-        stat = mTableBuilder_l->Finish(&mArray);
-        break;
-      case EDataType::kFloat_t:
-        stat = mTableBuilder_f->Finish(&mArray);
-        break;
-      case EDataType::kDouble_t:
-        stat = mTableBuilder_d->Finish(&mArray);
-        break;
-      default:
-        LOGP(FATAL, "Type {} not handled!", mElementType);
-        break;
-    }
-  } else {
-    stat = mTableBuilder_list->Finish(&mArray);
+  auto entrySize = mNumberElements * mElementSize;
+  std::vector<uint8_t> entry(entrySize);
+  mBranch->SetAddress(entry.data());
+  for (auto i = first; i < numEntries; ++i) {
+    mBranch->GetEntry(i);
+    std::memcpy(data + i * entrySize, entry.data(), entrySize);
   }
+  mBranch->ResetAddress();
 }
 
 void TreeToTable::addColumn(const char* colname)
@@ -861,42 +439,29 @@ bool TreeToTable::addAllColumns(TTree* tree)
 
 void TreeToTable::fill(TTree* tree)
 {
-  std::vector<std::unique_ptr<ColumnIterator>> columnIterators;
-  TTreeReader treeReader{tree};
+  std::vector<std::unique_ptr<ColumnReader>> columnReaders;
 
   tree->SetCacheSize(50000000);
   tree->SetClusterPrefetch(true);
   for (auto&& columnName : mColumnNames) {
     tree->AddBranchToCache(columnName.c_str(), true);
-    auto colit = std::make_unique<ColumnIterator>(treeReader, columnName.c_str());
-    auto stat = colit->getStatus();
-    if (!stat) {
+    auto reader = std::make_unique<ColumnReader>(tree, columnName.c_str());
+    if (!reader->getStatus()) {
       throw std::runtime_error("Unable to convert column " + columnName);
     }
-    columnIterators.push_back(std::move(colit));
+    columnReaders.push_back(std::move(reader));
   }
   tree->StopCacheLearningPhase();
-  auto numEntries = treeReader.GetEntries(true);
-  if (numEntries > 0) {
-    for (auto&& column : columnIterators) {
-      column->reserve(numEntries);
-    }
-    // copy all values from the tree to the table builders
-    treeReader.Restart();
-    while (treeReader.Next()) {
-      for (auto&& column : columnIterators) {
-        column->push();
-      }
-    }
-  }
+  auto numEntries = tree->GetEntries();
 
-  // prepare the elements needed to create the final table
+  // copy all values from the tree to the arrays, column by column,
+  // and prepare the elements needed to create the final table
   std::vector<std::shared_ptr<arrow::Array>> array_vector;
   std::vector<std::shared_ptr<arrow::Field>> schema_vector;
-  for (auto&& colit : columnIterators) {
-    colit->finish();
-    array_vector.push_back(colit->getArray());
-    schema_vector.push_back(colit->getSchema());
+  for (auto&& reader : columnReaders) {
+    reader->read(numEntries);
+    array_vector.push_back(reader->getArray());
+    schema_vector.push_back(reader->getSchema());
   }
   auto fields = std::make_shared<arrow::Schema>(schema_vector);
 
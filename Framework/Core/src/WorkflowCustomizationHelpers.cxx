@@ -45,6 +45,7 @@ std::vector<ConfigParamSpec> WorkflowCustomizationHelpers::requiredWorkflowOptio
                                        ConfigParamSpec{"aod-writer-json", VariantType::String, "", {"Name of the json configuration file"}},
                                        ConfigParamSpec{"aod-writer-resfile", VariantType::String, "", {"Default name of the output file"}},
                                        ConfigParamSpec{"aod-writer-resmode", VariantType::String, "RECREATE", {"Creation mode of the result files: NEW, CREATE, RECREATE, UPDATE"}},
+                                       ConfigParamSpec{"aod-writer-format", VariantType::String, "root", {"Format of the result files: root, arrow, arrow-lz4"}},
                                        ConfigParamSpec{"aod-writer-ntfmerge", VariantType::Int, -1, {"Number of time frames to merge into one file"}},
                                        ConfigParamSpec{"aod-writer-keep", VariantType::String, "", {"Comma separated list of ORIGIN/DESCRIPTION/SUBSPECIFICATION:treename:col1/col2/..:filename"}},
 
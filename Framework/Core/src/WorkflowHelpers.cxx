@@ -263,6 +263,7 @@ void WorkflowHelpers::injectServiceDevices(WorkflowSpec& workflow, ConfigContext
     {ConfigParamSpec{"aod-file", VariantType::String, {"Input AOD file"}},
      ConfigParamSpec{"aod-reader-json", VariantType::String, {"json configuration file"}},
      ConfigParamSpec{"time-limit", VariantType::Int64, 0ll, {"Maximum run time limit in seconds"}},
+     ConfigParamSpec{"aod-reader-no-prefetch", VariantType::Bool, false, {"Do not read the next time frame while the current one is processed"}},
      ConfigParamSpec{"orbit-offset-enumeration", VariantType::Int64, 0ll, {"initial value for the orbit"}},
      ConfigParamSpec{"orbit-multiplier-enumeration", VariantType::Int64, 0ll, {"multiplier to get the orbit from the counter"}},
      ConfigParamSpec{"start-value-enumeration", VariantType::Int64, 0ll, {"initial value for the enumeration"}},
@@ -889,6 +890,13 @@ std::shared_ptr<DataOutputDirector> WorkflowHelpers::getDataOutputDirector(Confi
       filemode = fmo;
     }
   }
+  if (options.isSet("aod-writer-format")) {
+    auto format = options.get<std::string>("aod-writer-format");
+    if (format != "root" && format != "arrow" && format != "arrow-lz4") {
+      throw std::runtime_error("Unknown AOD output format " + format + ", use root, arrow or arrow-lz4");
+    }
+    dod->setFileFormat(format);
+  }
   if (options.isSet("aod-writer-ntfmerge")) {
     ntfm = options.get<int>("aod-writer-ntfmerge");
     if (ntfm > 0) {
@@ -45,6 +45,8 @@ struct WorkflowImporter : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>,
     IN_DATAPROCESSOR_N_SLOTS,
     IN_DATAPROCESSOR_TIMESLICE_ID,
     IN_DATAPROCESSOR_MAX_TIMESLICES,
+    IN_DATAPROCESSOR_MAX_STREAMS,
+    IN_DATAPROCESSOR_ORDERED_STREAMS,
     IN_INPUTS,
     IN_OUTPUTS,
     IN_OPTIONS,
@@ -116,6 +118,12 @@ struct WorkflowImporter : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>,
       case State::IN_DATAPROCESSOR_MAX_TIMESLICES:
         s << "IN_DATAPROCESSOR_MAX_TIMESLICES";
         break;
+      case State::IN_DATAPROCESSOR_MAX_STREAMS:
+        s << "IN_DATAPROCESSOR_MAX_STREAMS";
+        break;
+      case State::IN_DATAPROCESSOR_ORDERED_STREAMS:
+        s << "IN_DATAPROCESSOR_ORDERED_STREAMS";
+        break;
       case State::IN_INPUTS:
         s << "IN_INPUTS";
         break;
@@ -463,6 +471,10 @@ struct WorkflowImporter : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>,
       push(State::IN_DATAPROCESSOR_TIMESLICE_ID);
     } else if (in(State::IN_DATAPROCESSOR) && strncmp(str, "maxInputTimeslices", length) == 0) {
       push(State::IN_DATAPROCESSOR_MAX_TIMESLICES);
+    } else if (in(State::IN_DATAPROCESSOR) && strncmp(str, "maxStreams", length) == 0) {
+      push(State::IN_DATAPROCESSOR_MAX_STREAMS);
+    } else if (in(State::IN_DATAPROCESSOR) && strncmp(str, "orderedStreams", length) == 0) {
+      push(State::IN_DATAPROCESSOR_ORDERED_STREAMS);
     } else if (in(State::IN_DATAPROCESSOR) && strncmp(str, "inputs", length) == 0) {
       push(State::IN_INPUTS);
     } else if (in(State::IN_DATAPROCESSOR) && strncmp(str, "outputs", length) == 0) {
@@ -578,6 +590,10 @@ struct WorkflowImporter : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>,
       dataProcessors.back().inputTimeSliceId = i;
     } else if (in(State::IN_DATAPROCESSOR_MAX_TIMESLICES)) {
       dataProcessors.back().maxInputTimeslices = i;
+    } else if (in(State::IN_DATAPROCESSOR_MAX_STREAMS)) {
+      dataProcessors.back().maxStreams = i;
+    } else if (in(State::IN_DATAPROCESSOR_ORDERED_STREAMS)) {
+      dataProcessors.back().orderedStreams = i != 0;
     }
     pop();
     return true;
@@ -857,6 +873,10 @@ void WorkflowSerializationHelpers::dump(std::ostream& out,
     w.Int(processor.inputTimeSliceId);
     w.Key("maxInputTimeslices");
     w.Int(processor.maxInputTimeslices);
+    w.Key("maxStreams");
+    w.Int(processor.maxStreams);
+    w.Key("orderedStreams");
+    w.Int(processor.orderedStreams ? 1 : 0);
 
     w.EndObject();
   }
@@ -15,6 +15,7 @@
 
 #include <cstddef>
 #include <functional>
+#include <stdexcept>
 #include <string>
 
 namespace o2
@@ -149,6 +150,18 @@ DataProcessorSpec timePipeline(DataProcessorSpec original,
   return original;
 }
 
+DataProcessorSpec processingStreams(DataProcessorSpec original,
+                                    size_t count,
+                                    bool ordered)
+{
+  if (count == 0) {
+    throw std::runtime_error("At least one processing stream is needed");
+  }
+  original.maxStreams = count;
+  original.orderedStreams = ordered;
+  return original;
+}
+
 /// Really a wrapper around `DataDescriptorQueryBuilder::parse`
 /// FIXME: should really use an rvalue..
 std::vector<InputSpec> select(const char* matcher)
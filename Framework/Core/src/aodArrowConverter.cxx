@@ -0,0 +1,42 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "Framework/ArrowFileHelpers.h"
+#include "Framework/Logger.h"
+#include <exception>
+#include <string>
+
+using namespace o2::framework;
+
+// converts an AO2D from ROOT to arrow format, or from arrow to ROOT format
+// when the input is an AO2D in arrow format (name ending with .arrow)
+int main(int argc, char** argv)
+{
+  if (argc < 3 || argc > 4 || (argc == 4 && std::string(argv[3]) != "--compress")) {
+    LOG(ERROR) << "Usage: " << argv[0] << " <input AO2D> <output AO2D> [--compress]";
+    return 1;
+  }
+  std::string input(argv[1]), output(argv[2]);
+  try {
+    if (ArrowFileHelpers::isArrowAOD(input)) {
+      ArrowFileHelpers::convertToRoot(input, output);
+    } else if (ArrowFileHelpers::isArrowAOD(output)) {
+      ArrowFileHelpers::convertToArrow(input, output, argc == 4);
+    } else {
+      LOG(ERROR) << "One of the AO2Ds must be in arrow format, with a name ending with .arrow";
+      return 1;
+    }
+  } catch (std::exception const& e) {
+    LOG(ERROR) << "Conversion failed: " << e.what();
+    return 1;
+  }
+  return 0;
+}
@@ -1590,6 +1590,7 @@ int runStateMachine(DataProcessorSpecs const& workflow,
           const auto uniformOptions = {
             "--aod-file",
             "--aod-memory-rate-limit",
+            "--aod-writer-format",
             "--aod-writer-json",
             "--aod-writer-ntfmerge",
             "--aod-writer-resfile",
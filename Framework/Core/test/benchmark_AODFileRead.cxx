@@ -0,0 +1,103 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "Framework/ArrowFileHelpers.h"
+#include "Framework/TableTreeHelpers.h"
+#include "Framework/Logger.h"
+#include <benchmark/benchmark.h>
+#include <arrow/table.h>
+#include <filesystem>
+#include <random>
+
+#include <TFile.h>
+
+using namespace o2::framework;
+
+#ifdef __APPLE__
+constexpr unsigned int maxrange = 15;
+#else
+constexpr unsigned int maxrange = 16;
+#endif
+
+// a skim-like table: a few kinematic variables, an index and a selection bit
+std::shared_ptr<arrow::Table> makeSkim(int64_t nrows)
+{
+  std::default_random_engine e1(1234567891);
+  std::normal_distribution<float> rf(5., 2.);
+  std::uniform_int_distribution<int> ri(0, 1000);
+
+  TableBuilder builder;
+  auto rowWriter = builder.persist<float, float, float, int, bool>({"fPt", "fEta", "fPhi", "fIndexCollisions", "fSel"});
+  for (auto i = 0; i < nrows; ++i) {
+    rowWriter(0, rf(e1), rf(e1), rf(e1), ri(e1), ri(e1) % 2);
+  }
+  return builder.finalize();
+}
+
+// bytes of the table once read
+static int64_t skimBytes(int64_t nrows) { return nrows * (3 * 4 + 4) + nrows / 8; }
+
+static void BM_ReadSkimROOT(benchmark::State& state)
+{
+  auto table = makeSkim(state.range(0));
+  {
+    TFile fout("skim.root", "RECREATE", "", 501);
+    TableToTree ta2tr(table, &fout, "O2skim");
+    ta2tr.addAllBranches();
+    ta2tr.process();
+    fout.Close();
+  }
+
+  for (auto _ : state) {
+    TFile f("skim.root", "READ");
+    auto tr = (TTree*)f.Get("O2skim");
+    TreeToTable tr2ta;
+    tr2ta.addAllColumns(tr);
+    tr2ta.fill(tr);
+    benchmark::DoNotOptimize(tr2ta.finalize());
+    delete tr;
+  }
+
+  state.SetBytesProcessed(state.iterations() * skimBytes(state.range(0)));
+}
+
+static void readSkimArrow(benchmark::State& state, bool compress)
+{
+  auto table = makeSkim(state.range(0));
+  auto filename = ArrowFileHelpers::getTableFileName("skim.arrow", "DF_0", "O2skim");
+  std::filesystem::remove(filename);
+  {
+    ArrowTableWriter writer(filename, table->schema(), compress);
+    writer.write(table);
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ArrowFileHelpers::readTable(filename));
+  }
+
+  state.SetBytesProcessed(state.iterations() * skimBytes(state.range(0)));
+}
+
+static void BM_ReadSkimArrow(benchmark::State& state)
+{
+  readSkimArrow(state, false);
+}
+
+static void BM_ReadSkimArrowLZ4(benchmark::State& state)
+{
+  readSkimArrow(state, true);
+}
+
+BENCHMARK(BM_ReadSkimROOT)->Range(8, 8 << maxrange);
+BENCHMARK(BM_ReadSkimArrow)->Range(8, 8 << maxrange);
+BENCHMARK(BM_ReadSkimArrowLZ4)->Range(8, 8 << maxrange);
+
+BENCHMARK_MAIN();
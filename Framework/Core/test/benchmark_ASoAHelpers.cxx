@@ -714,4 +714,85 @@ static void BM_ASoAHelpersCombGenCollisionsFivesCategories(benchmark::State& sta
 
 BENCHMARK(BM_ASoAHelpersCombGenCollisionsFivesCategories)->RangeMultiplier(2)->Range(8, 8 << (maxFivesRange + 1));
 
+// Event mixing: pairs of collisions within 5 neighbours in 100 categories
+static void BM_ASoAHelpersCombGenCollisionsPairsMixing(benchmark::State& state)
+{
+  // Seed with a real random value, if available
+  std::default_random_engine e1(1234567891);
+  std::uniform_real_distribution<float> uniform_dist(0, 1);
+  std::uniform_int_distribution<int> uniform_dist_int(0, 99);
+
+  TableBuilder builder;
+  auto rowWriter = builder.cursor<o2::aod::Collisions>();
+  for (auto i = 0; i < state.range(0); ++i) {
+    rowWriter(0, uniform_dist_int(e1),
+              uniform_dist(e1), uniform_dist(e1), uniform_dist(e1),
+              uniform_dist(e1), uniform_dist(e1), uniform_dist(e1),
+              uniform_dist(e1), uniform_dist(e1), uniform_dist(e1),
+              uniform_dist_int(e1), uniform_dist(e1),
+              uniform_dist_int(e1),
+              uniform_dist(e1), uniform_dist(e1), uniform_dist_int(e1));
+  }
+  auto table = builder.finalize();
+
+  o2::aod::Collisions collisions{table};
+
+  int64_t count = 0;
+  float sum = 0;
+
+  for (auto _ : state) {
+    count = 0;
+    for (auto& [c0, c1] : selfPairCombinations("fNumContrib", 5, -1, collisions)) {
+      sum += c0.posZ() - c1.posZ();
+      count++;
+    }
+    benchmark::DoNotOptimize(count);
+    benchmark::DoNotOptimize(sum);
+  }
+  state.counters["Combinations"] = count;
+  state.SetBytesProcessed(state.iterations() * sizeof(float) * count);
+}
+
+BENCHMARK(BM_ASoAHelpersCombGenCollisionsPairsMixing)->Range(8, 8 << (maxPairsRange + 2));
+
+static void BM_ASoAHelpersIndicesCollisionsPairsMixing(benchmark::State& state)
+{
+  // Seed with a real random value, if available
+  std::default_random_engine e1(1234567891);
+  std::uniform_real_distribution<float> uniform_dist(0, 1);
+  std::uniform_int_distribution<int> uniform_dist_int(0, 99);
+
+  TableBuilder builder;
+  auto rowWriter = builder.cursor<o2::aod::Collisions>();
+  for (auto i = 0; i < state.range(0); ++i) {
+    rowWriter(0, uniform_dist_int(e1),
+              uniform_dist(e1), uniform_dist(e1), uniform_dist(e1),
+              uniform_dist(e1), uniform_dist(e1), uniform_dist(e1),
+              uniform_dist(e1), uniform_dist(e1), uniform_dist(e1),
+              uniform_dist_int(e1), uniform_dist(e1),
+              uniform_dist_int(e1),
+              uniform_dist(e1), uniform_dist(e1), uniform_dist_int(e1));
+  }
+  auto table = builder.finalize();
+
+  o2::aod::Collisions collisions{table};
+
+  int64_t count = 0;
+  float sum = 0;
+
+  for (auto _ : state) {
+    count = 0;
+    for (auto& [i0, i1] : selfCombinationsIndices<2>("fNumContrib", 5, -1, collisions)) {
+      sum += collisions.iteratorAt(i0).posZ() - collisions.iteratorAt(i1).posZ();
+      count++;
+    }
+    benchmark::DoNotOptimize(count);
+    benchmark::DoNotOptimize(sum);
+  }
+  state.counters["Combinations"] = count;
+  state.SetBytesProcessed(state.iterations() * sizeof(float) * count);
+}
+
+BENCHMARK(BM_ASoAHelpersIndicesCollisionsPairsMixing)->Range(8, 8 << (maxPairsRange + 2));
+
 BENCHMARK_MAIN();
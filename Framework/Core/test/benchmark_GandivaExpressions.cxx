@@ -10,65 +10,126 @@
 // or submit itself to any jurisdiction.
 
 #include "Framework/Expressions.h"
-#include "../src/ExpressionHelpers.h"
-
-#include "Framework/HistogramRegistry.h"
-#include "Framework/Logger.h"
+#include "Framework/TableBuilder.h"
 #include "../src/ExpressionHelpers.h"
 
 #include <benchmark/benchmark.h>
 #include <random>
 
 using namespace o2::framework;
-using namespace arrow;
-using namespace o2::soa;
+using namespace o2::framework::expressions;
 
 namespace test
 {
-DECLARE_SOA_COLUMN(X, x, float, "x");
-DECLARE_SOA_COLUMN(Y, y, float, "y");
-DECLARE_SOA_COLUMN(Z, z, float, "z");
-DECLARE_SOA_COLUMN(cD, cd, float, "cd");
-DECLARE_SOA_DYNAMIC_COLUMN(D, d, [](float x, float y, float z) { return std::sqrt(x * x + y * y + z * z); });
+static BindingNode x{"x", 1, atype::FLOAT};
+static BindingNode y{"y", 2, atype::FLOAT};
+static BindingNode z{"z", 3, atype::FLOAT};
 } // namespace test
 
-using TT = o2::soa::Table<test::X, test::Y, test::Z, test::D<test::X, test::Y, test::Z>>;
-using RT = o2::soa::Table<test::X, test::Y, test::Z, test::cD, test::D<test::X, test::Y, test::Z>>;
-
-const static size_t maxrows = 100;
-
-static std::default_random_engine e(1234567890);
-static std::normal_distribution<float> G;
-
-auto createTable = [](size_t nrows) {
-  static TableBuilder builder;
-  auto static rowWriter = builder.persist<float, float, float>({"x", "y", "z"});
+#ifdef __APPLE__
+constexpr unsigned int maxrange = 16;
+#else
+constexpr unsigned int maxrange = 20;
+#endif
 
+static std::shared_ptr<arrow::Table> createTable(size_t nrows)
+{
+  std::default_random_engine e(1234567890);
+  std::normal_distribution<float> G;
+  TableBuilder builder;
+  auto rowWriter = builder.persist<float, float, float>({"x", "y", "z"});
   for (auto i = 0u; i < nrows; ++i) {
     rowWriter(0, G(e), G(e), G(e));
   }
-  auto table = builder.finalize();
+  return builder.finalize();
+}
 
-  return TT{table};
-};
+static Filter createFilterExpression()
+{
+  return (nsqrt(test::x * test::x + test::y * test::y) > 1.f) && (nabs(test::z) < 0.5f);
+}
 
+/// Loop written by hand, the best case for the selection
 static void BM_DirectCalculation(benchmark::State& state)
 {
-  state.PauseTiming();
-  auto tt = createTable(state.range(0));
-  state.ResumeTiming();
-  benchmark::DoNotOptimize(tt);
+  auto table = createTable(state.range(0));
+  for (auto _ : state) {
+    std::vector<int64_t> selected;
+    int64_t offset = 0;
+    for (auto c = 0; c < table->column(0)->num_chunks(); ++c) {
+      auto x = std::static_pointer_cast<arrow::FloatArray>(table->column(0)->chunk(c));
+      auto y = std::static_pointer_cast<arrow::FloatArray>(table->column(1)->chunk(c))->raw_values();
+      auto z = std::static_pointer_cast<arrow::FloatArray>(table->column(2)->chunk(c))->raw_values();
+      for (auto i = 0; i < x->length(); ++i) {
+        if (std::sqrt(x->Value(i) * x->Value(i) + y[i] * y[i]) > 1.f && std::abs(z[i]) < 0.5f) {
+          selected.push_back(offset + i);
+        }
+      }
+      offset += x->length();
+    }
+    benchmark::DoNotOptimize(selected);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
 }
 
+/// Filter compiled for every table, what happened for every time frame before the compiled filters were cached
 static void BM_GandivaExpression(benchmark::State& state)
 {
-  state.PauseTiming();
-  auto tt = createTable(state.range(0));
-  state.ResumeTiming();
-  benchmark::DoNotOptimize(tt);
+  auto table = createTable(state.range(0));
+  auto ops = createOperations(createFilterExpression());
+  auto condition = makeCondition(createExpressionTree(ops, table->schema()));
+  for (auto _ : state) {
+    std::shared_ptr<gandiva::Filter> filter;
+    auto s = gandiva::Filter::Make(table->schema(), condition, &filter);
+    if (!s.ok()) {
+      state.SkipWithError(s.ToString().c_str());
+      break;
+    }
+    auto selection = createSelection(table, filter);
+    benchmark::DoNotOptimize(selection);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// Filter compiled once and taken from the cache
+static void BM_GandivaExpressionCached(benchmark::State& state)
+{
+  auto table = createTable(state.range(0));
+  auto ops = createOperations(createFilterExpression());
+  for (auto _ : state) {
+    auto selection = createSelection(table, createFilter(table->schema(), ops));
+    benchmark::DoNotOptimize(selection);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_InterpretedExpression(benchmark::State& state)
+{
+  auto table = createTable(state.range(0));
+  auto ops = createOperations(createFilterExpression());
+  for (auto _ : state) {
+    auto selection = createSelectionInterpreted(table, ops);
+    benchmark::DoNotOptimize(selection);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// Automatic choice between the interpreter and the cached gandiva filter
+static void BM_SelectedExpression(benchmark::State& state)
+{
+  auto table = createTable(state.range(0));
+  auto ops = createOperations(createFilterExpression());
+  for (auto _ : state) {
+    auto selection = createSelection(table, ops);
+    benchmark::DoNotOptimize(selection);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
 }
 
-BENCHMARK(BM_DirectCalculation)->Arg(maxrows);
-BENCHMARK(BM_GandivaExpression)->Arg(maxrows);
+BENCHMARK(BM_DirectCalculation)->Range(8, 8 << maxrange);
+BENCHMARK(BM_GandivaExpression)->Range(8, 8 << 10);
+BENCHMARK(BM_GandivaExpressionCached)->Range(8, 8 << maxrange);
+BENCHMARK(BM_InterpretedExpression)->Range(8, 8 << maxrange);
+BENCHMARK(BM_SelectedExpression)->Range(8, 8 << maxrange);
 
 BENCHMARK_MAIN();
@@ -16,6 +16,8 @@
 
 #include <benchmark/benchmark.h>
 #include <boost/format.hpp>
+#include <random>
+#include <thread>
 
 using namespace o2::framework;
 using namespace arrow;
@@ -62,7 +64,71 @@ static void BM_StandardNameLookup(benchmark::State& state)
     }
   }
 }
+/// Number of fills per thread
+const int nFills = 1000000;
+
+/// Fill the histograms of a HistogramRegistry from state.range(0) threads at the same time
+static void BM_ConcurrentFill(benchmark::State& state)
+{
+  const int nThreads = state.range(0);
+  std::vector<float> values(nFills);
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<float> dist(0.f, 1.f);
+  std::generate(values.begin(), values.end(), [&]() { return dist(gen); });
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    HistogramRegistry registry{"registry", {{"x", "x", {HistType::kTH1F, {{100, 0, 1}}}}, {"xy", "xy", {HistType::kTH2F, {{100, 0, 1}, {100, 0, 1}}}}}};
+    registry.add("stepTHn", "stepTHn", {kStepTHnF, {{100, 0, 1}, {100, 0, 1}}, 1});
+    registry.setConcurrentFill(nThreads);
+    state.ResumeTiming();
+
+    std::vector<std::thread> threads;
+    for (int slot = 0; slot < nThreads; ++slot) {
+      threads.emplace_back([&registry, &values, slot]() {
+        HistogramRegistry::setThreadSlot(slot);
+        for (auto& x : values) {
+          registry.fill(HIST("x"), x);
+          registry.fill(HIST("xy"), x, 1.f - x);
+          registry.fill(HIST("stepTHn"), 0, x, 1.f - x);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    registry.mergeSlots();
+  }
+  state.counters["fills/s"] = benchmark::Counter(3. * nFills * nThreads * state.iterations(), benchmark::Counter::kIsRate);
+}
+
+/// Fill a histogram value by value or by columns of values
+static void BM_ColumnFill(benchmark::State& state)
+{
+  const bool columns = state.range(0);
+  std::vector<float> xs(nFills), ys(nFills);
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<float> dist(0.f, 1.f);
+  std::generate(xs.begin(), xs.end(), [&]() { return dist(gen); });
+  std::generate(ys.begin(), ys.end(), [&]() { return dist(gen); });
+  HistogramRegistry registry{"registry", {{"xy", "xy", {HistType::kTH2F, {{100, 0, 1}, {100, 0, 1}}}}}};
+
+  for (auto _ : state) {
+    if (columns) {
+      registry.fillColumns(HIST("xy"), gsl::span<const float>(xs), gsl::span<const float>(ys));
+    } else {
+      for (auto i = 0; i < nFills; ++i) {
+        registry.fill(HIST("xy"), xs[i], ys[i]);
+      }
+    }
+  }
+  state.counters["fills/s"] = benchmark::Counter(1. * nFills * state.iterations(), benchmark::Counter::kIsRate);
+}
+
 BENCHMARK(BM_HashedNameLookup)->Arg(4)->Arg(8)->Arg(16)->Arg(64)->Arg(128)->Arg(256)->Arg(512);
 BENCHMARK(BM_StandardNameLookup)->Arg(4)->Arg(8)->Arg(16)->Arg(64)->Arg(128)->Arg(256)->Arg(512);
 
+BENCHMARK(BM_ConcurrentFill)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16)->UseRealTime();
+BENCHMARK(BM_ColumnFill)->Arg(0)->Arg(1);
+
 BENCHMARK_MAIN();
@@ -16,6 +16,7 @@
 #include <vector>
 
 #include <TFile.h>
+#include <TROOT.h>
 
 using namespace o2::framework;
 using namespace arrow;
@@ -35,7 +36,7 @@ constexpr unsigned int maxrange = 15;
 constexpr unsigned int maxrange = 16;
 #endif
 
-static void BM_TableToTree(benchmark::State& state)
+static void tableToTree(benchmark::State& state)
 {
 
   // initialize a random generator
@@ -73,6 +74,20 @@ static void BM_TableToTree(benchmark::State& state)
   state.SetBytesProcessed(state.iterations() * state.range(0) * 24);
 }
 
+static void BM_TableToTree(benchmark::State& state)
+{
+  tableToTree(state);
+}
+
+// the baskets of the branches are compressed in parallel
+static void BM_TableToTreeIMT(benchmark::State& state)
+{
+  ROOT::EnableImplicitMT(4);
+  tableToTree(state);
+  ROOT::DisableImplicitMT();
+}
+
 BENCHMARK(BM_TableToTree)->Range(8, 8 << maxrange);
+BENCHMARK(BM_TableToTreeIMT)->Range(8, 8 << maxrange);
 
 BENCHMARK_MAIN();
@@ -1119,6 +1119,23 @@ BOOST_AUTO_TEST_CASE(BlockCombinations)
   }
   BOOST_CHECK_EQUAL(count, 0);
 
+  // Same combinations as row indices
+  auto pairIndices = selfCombinationsIndices<2>("y", 2, -1, testAux);
+  BOOST_REQUIRE_EQUAL(pairIndices.size(), expectedStrictlyUpperPairs.size());
+  for (auto i = 0u; i < pairIndices.size(); i++) {
+    BOOST_CHECK_EQUAL(testAux.iteratorAt(pairIndices[i][0]).x(), std::get<0>(expectedStrictlyUpperPairs[i]));
+    BOOST_CHECK_EQUAL(testAux.iteratorAt(pairIndices[i][1]).x(), std::get<1>(expectedStrictlyUpperPairs[i]));
+  }
+
+  auto tripleIndices = selfCombinationsIndices<3>("y", 2, -1, testAux);
+  BOOST_REQUIRE_EQUAL(tripleIndices.size(), expectedStrictlyUpperTriples.size());
+  for (auto i = 0u; i < tripleIndices.size(); i++) {
+    BOOST_CHECK_EQUAL(testAux.iteratorAt(tripleIndices[i][0]).x(), std::get<0>(expectedStrictlyUpperTriples[i]));
+    BOOST_CHECK_EQUAL(testAux.iteratorAt(tripleIndices[i][1]).x(), std::get<1>(expectedStrictlyUpperTriples[i]));
+    BOOST_CHECK_EQUAL(testAux.iteratorAt(tripleIndices[i][2]).x(), std::get<2>(expectedStrictlyUpperTriples[i]));
+  }
+  BOOST_CHECK_EQUAL((selfCombinationsIndices<5>("y", 1, -1, testAux).size()), 0);
+
   // Different tables of different size
   std::vector<std::tuple<int32_t, int32_t>> expectedFullPairsFirstSmaller{
     {0, 0}, {0, 4}, {4, 0}, {4, 4}, {4, 7}, {1, 1}, {1, 6}, {3, 3}, {3, 5}, {2, 2}, {2, 8}};
@@ -18,6 +18,8 @@
 #include "Framework/AnalysisDataModel.h"
 
 #include <boost/test/unit_test.hpp>
+#include <TH1F.h>
+#include <TNamed.h>
 
 using namespace o2;
 using namespace o2::framework;
@@ -155,6 +157,8 @@ BOOST_AUTO_TEST_CASE(AdaptorCompilation)
   BOOST_CHECK_EQUAL(task1.inputs[1].binding, std::string("TracksExtension"));
   BOOST_CHECK_EQUAL(task1.inputs[0].binding, std::string("Tracks"));
   BOOST_CHECK_EQUAL(task1.outputs[0].binding.value, std::string("FooBars"));
+  BOOST_REQUIRE_EQUAL(task1.options.size(), 1);
+  BOOST_CHECK_EQUAL(task1.options[0].name, "process-threads");
 
   auto task2 = adaptAnalysisTask<BTask>(*cfgc, TaskName{"test2"});
   BOOST_CHECK_EQUAL(task2.inputs.size(), 9);
@@ -199,6 +203,62 @@ BOOST_AUTO_TEST_CASE(AdaptorCompilation)
   auto task10 = adaptAnalysisTask<JTask>(*cfgc, TaskName{"test10"});
 }
 
+BOOST_AUTO_TEST_CASE(TestProducesChunks)
+{
+  TableBuilder builder;
+  Produces<aod::XYZ> xyz;
+  xyz.resetCursor(builder);
+  xyz(-1.f, -2.f, -3.f);
+
+  // copies of the cursor fill the chunks in any order, the rows are written in the order of the chunks
+  xyz.setChunks(3);
+  auto first = xyz;
+  auto second = xyz;
+  second.setChunk(2);
+  second(4.f, 5.f, 6.f);
+  first.setChunk(0);
+  first(0.f, 1.f, 2.f);
+  second(5.f, 6.f, 7.f);
+  first.setChunk(1);
+  first.reserve(10);
+  first(1.f, 2.f, 3.f);
+  // the index of the rows in the final table is not known while they are buffered
+  BOOST_CHECK_THROW(first.lastIndex(), RuntimeErrorRef);
+  xyz.writeChunks();
+  BOOST_CHECK_EQUAL(xyz.lastIndex(), 4);
+
+  auto table = builder.finalize();
+  BOOST_REQUIRE_EQUAL(table->num_rows(), 5);
+  aod::XYZ t{table};
+  std::vector<float> xs;
+  for (auto& row : t) {
+    xs.push_back(row.x());
+  }
+  BOOST_CHECK(xs == (std::vector<float>{-1.f, 0.f, 1.f, 4.f, 5.f}));
+}
+
+BOOST_AUTO_TEST_CASE(TestOutputObjParallelProcess)
+{
+  OutputObj<TH1F> histo{TH1F("histo", "histo", 10, 0., 10.)};
+  BOOST_CHECK(ParallelProcessManager<OutputObj<TH1F>>::isSupported(histo));
+  OutputObj<TNamed> named{TNamed("named", "named")};
+  BOOST_CHECK(!ParallelProcessManager<OutputObj<TNamed>>::isSupported(named));
+
+  // each copy fills its own empty clone, which is added to the original
+  histo->Fill(1.);
+  std::vector<std::function<void()>> merges;
+  auto copy = histo;
+  BOOST_CHECK(ParallelProcessManager<OutputObj<TH1F>>::detach(copy, merges));
+  BOOST_REQUIRE_EQUAL(merges.size(), 1);
+  BOOST_CHECK(copy.object != histo.object);
+  BOOST_CHECK_EQUAL(copy->GetEntries(), 0);
+  copy->Fill(2.);
+  copy->Fill(2.);
+  merges[0]();
+  BOOST_CHECK_EQUAL(histo->GetEntries(), 3);
+  BOOST_CHECK_EQUAL(histo->GetBinContent(histo->FindBin(2.)), 2);
+}
+
 BOOST_AUTO_TEST_CASE(TestPartitionIteration)
 {
   TableBuilder builderA;
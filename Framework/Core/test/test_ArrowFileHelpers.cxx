@@ -0,0 +1,103 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test Framework ArrowFileHelpers
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include "Framework/ArrowFileHelpers.h"
+#include "Framework/DataInputDirector.h"
+#include "Framework/TableBuilder.h"
+#include "Headers/DataHeader.h"
+
+#include <arrow/table.h>
+#include <filesystem>
+
+using namespace o2::framework;
+
+std::shared_ptr<arrow::Table> makeTable(int nrows, int offset)
+{
+  TableBuilder builder;
+  auto rowWriter = builder.persist<float, int>({"fX", "fIndex"});
+  for (auto i = 0; i < nrows; ++i) {
+    rowWriter(0, 0.5f * i, offset + i);
+  }
+  return builder.finalize();
+}
+
+void checkTable(std::shared_ptr<arrow::Table> table, int nrows, int offset)
+{
+  BOOST_REQUIRE(table->Validate().ok());
+  BOOST_REQUIRE_EQUAL(table->num_rows(), nrows);
+  BOOST_REQUIRE_EQUAL(table->num_columns(), 2);
+  int row = 0;
+  auto column = table->GetColumnByName("fIndex");
+  for (auto chunk : column->chunks()) {
+    auto values = std::static_pointer_cast<arrow::Int32Array>(chunk);
+    for (auto i = 0; i < values->length(); ++i, ++row) {
+      BOOST_CHECK_EQUAL(values->Value(i), offset + row);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ArrowTableWriterReader)
+{
+  std::filesystem::remove_all("arrowfile.arrow");
+  auto filename = ArrowFileHelpers::getTableFileName("arrowfile.arrow", "DF_3", "O2track");
+  {
+    ArrowTableWriter writer(filename, makeTable(10, 0)->schema());
+    writer.write(makeTable(10, 0));
+    writer.write(makeTable(5, 10));
+  }
+  checkTable(ArrowFileHelpers::readTable(filename), 15, 0);
+
+  // a reopened file is extended
+  {
+    ArrowTableWriter writer(filename, makeTable(10, 0)->schema());
+    writer.write(makeTable(7, 15));
+  }
+  checkTable(ArrowFileHelpers::readTable(filename), 22, 0);
+
+  BOOST_CHECK(ArrowFileHelpers::isArrowAOD("arrowfile.arrow"));
+  BOOST_CHECK(!ArrowFileHelpers::isArrowAOD("arrowfile.root"));
+  auto numbers = ArrowFileHelpers::getTimeFrameNumbers("arrowfile.arrow");
+  BOOST_REQUIRE_EQUAL(numbers.size(), 1);
+  BOOST_CHECK_EQUAL(numbers[0], 3);
+}
+
+BOOST_AUTO_TEST_CASE(ArrowAODConversion)
+{
+  std::filesystem::remove_all("arrowaod.arrow");
+  std::filesystem::remove_all("arrowaod2.arrow");
+  for (int tf = 0; tf < 3; ++tf) {
+    auto table = makeTable(10 + tf, 100 * tf);
+    ArrowTableWriter writer(ArrowFileHelpers::getTableFileName("arrowaod.arrow", "DF_" + std::to_string(tf), "O2track"), table->schema());
+    writer.write(table);
+  }
+
+  // to ROOT and back
+  ArrowFileHelpers::convertToRoot("arrowaod.arrow", "arrowaod.root");
+  ArrowFileHelpers::convertToArrow("arrowaod.root", "arrowaod2.arrow");
+
+  // read back with the DataInputDirector
+  DataInputDirector didir("arrowaod2.arrow");
+  auto dh = o2::header::DataHeader(o2::header::DataDescription{"TRACK"}, o2::header::DataOrigin{"AOD"}, 0);
+  BOOST_REQUIRE(didir.isArrowAOD(dh, 0));
+  for (int tf = 0; tf < 3; ++tf) {
+    auto table = didir.getDataTable(dh, 0, tf);
+    BOOST_REQUIRE(table != nullptr);
+    BOOST_CHECK_EQUAL(didir.getTimeFrameNumber(dh, 0, tf), tf);
+    checkTable(table, 10 + tf, 100 * tf);
+  }
+  BOOST_CHECK(didir.getDataTable(dh, 0, 3) == nullptr);
+}
@@ -17,6 +17,7 @@
 #include "../src/ExpressionHelpers.h"
 #include "Framework/AnalysisDataModel.h"
 #include "Framework/AODReaderHelpers.h"
+#include "Framework/TableBuilder.h"
 #include <boost/test/unit_test.hpp>
 #include <arrow/util/config.h>
 
@@ -203,3 +204,46 @@ BOOST_AUTO_TEST_CASE(TestGandivaTreeCreation)
   BOOST_REQUIRE(s.ok());
 #endif
 }
+
+BOOST_AUTO_TEST_CASE(TestExpressionInterpreter)
+{
+  static BindingNode x{"x", 11, atype::FLOAT};
+  static BindingNode y{"y", 12, atype::DOUBLE};
+  static BindingNode i{"i", 13, atype::INT32};
+
+  TableBuilder builder;
+  auto rowWriter = builder.persist<float, double, int32_t>({"x", "y", "i"});
+  for (auto row = 0; row < 100; ++row) {
+    rowWriter(0, 0.1f * row - 5.f, 0.01 * row * row, row);
+  }
+  auto table = builder.finalize();
+
+  std::vector<Filter> filters;
+  filters.emplace_back(x > 1.f);
+  filters.emplace_back((x > -1.f) && (y < 20.));
+  filters.emplace_back((nabs(x) < 2.f) || ((i & 3) == 0));
+  filters.emplace_back(nsqrt(y) * x > 2.f);
+  filters.emplace_back((i / 7) == 3);
+  filters.emplace_back(x + 1.f >= i * 0.1f);
+  // literals which only differ beyond the 6th decimal
+  filters.emplace_back((x * 1e-7f > -4e-7f) && (x * 4e-7f < 1e-7f));
+  for (auto& filter : filters) {
+    auto ops = createOperations(filter);
+    auto interpreted = createSelectionInterpreted(table, ops);
+    auto compiled = createSelection(table, createFilter(table->schema(), ops));
+    BOOST_REQUIRE_EQUAL(interpreted->GetNumSlots(), compiled->GetNumSlots());
+    for (auto slot = 0; slot < compiled->GetNumSlots(); ++slot) {
+      BOOST_CHECK_EQUAL(interpreted->GetIndex(slot), compiled->GetIndex(slot));
+    }
+  }
+
+  // the automatic choice is the same selection
+  setInterpreterMaxRows(10);
+  auto ops = createOperations(filters[1]);
+  BOOST_CHECK_EQUAL(createSelection(table, ops)->GetNumSlots(), createSelectionInterpreted(table, ops)->GetNumSlots());
+  setInterpreterMaxRows(1000);
+  BOOST_CHECK_EQUAL(createSelection(table, ops)->GetNumSlots(), createSelectionInterpreted(table, ops)->GetNumSlots());
+
+  // the compiled filter is cached
+  BOOST_CHECK(createFilter(table->schema(), ops) == createFilter(table->schema(), ops));
+}
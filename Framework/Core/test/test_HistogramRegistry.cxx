@@ -15,6 +15,7 @@
 #include "Framework/HistogramRegistry.h"
 #include <boost/test/unit_test.hpp>
 #include <iostream>
+#include <thread>
 
 using namespace o2;
 using namespace o2::framework;
@@ -129,3 +130,65 @@ BOOST_AUTO_TEST_CASE(HistogramRegistryStepTHn)
 
   registry.print();
 }
+
+BOOST_AUTO_TEST_CASE(HistogramRegistryConcurrentFill)
+{
+  HistogramRegistry registry{"registry", {{"x", "x", {HistType::kTH1F, {{100, 0, 1}}}}}};
+  registry.add("stepTHnF", "a", {kStepTHnF, {{100, -10.0f, 10.01f}, {100, -10.0f, 10.01f}}, 2});
+
+  const int nSlots = 4;
+  const int nFills = 1000;
+  registry.setConcurrentFill(nSlots);
+  BOOST_REQUIRE_EQUAL(registry.getNSlots(), nSlots);
+  // added after the slots, must be copied as well
+  registry.add("y", "y", {HistType::kTH1D, {{10, 0, 1}}});
+
+  std::vector<std::thread> threads;
+  for (int slot = 0; slot < nSlots; ++slot) {
+    threads.emplace_back([&registry, slot]() {
+      HistogramRegistry::setThreadSlot(slot);
+      for (int i = 0; i < nFills; ++i) {
+        registry.fill(HIST("x"), 0.5);
+        registry.fill(HIST("y"), 0.5, 2.);
+        registry.fill(HIST("stepTHnF"), 0, 0., 3.);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // the registry histograms contain slot 0 only until the merge
+  BOOST_CHECK_EQUAL(registry.get<TH1>(HIST("x"))->GetEntries(), nFills);
+  registry.mergeSlots();
+  BOOST_CHECK_EQUAL(registry.get<TH1>(HIST("x"))->GetEntries(), nSlots * nFills);
+  BOOST_CHECK_EQUAL(registry.get<TH1>(HIST("y"))->GetSumOfWeights(), 2. * nSlots * nFills);
+  auto values = static_cast<TArrayF*>(registry.get<StepTHn>(HIST("stepTHnF"))->getValues(0));
+  BOOST_CHECK_EQUAL(values->GetSum(), nSlots * nFills);
+
+  // the slots are empty after the merge
+  registry.mergeSlots();
+  BOOST_CHECK_EQUAL(registry.get<TH1>(HIST("x"))->GetEntries(), nSlots * nFills);
+
+  // the thread which configured the registry fills slot 0 without setting it
+  BOOST_REQUIRE_EQUAL(HistogramRegistry::getThreadSlot(), -1);
+  registry.fill(HIST("x"), 0.5);
+  BOOST_CHECK_EQUAL(registry.get<TH1>(HIST("x"))->GetEntries(), nSlots * nFills + 1);
+  BOOST_CHECK_EQUAL(HistogramRegistry::getThreadSlot(), -1);
+}
+
+BOOST_AUTO_TEST_CASE(HistogramRegistryColumnFill)
+{
+  HistogramRegistry registry{"registry", {{"x", "x", {HistType::kTH1F, {{100, 0, 1}}}}, {"xy", "xy", {HistType::kTH2F, {{10, 0, 1}, {10, 0, 1}}}}}};
+
+  std::vector<float> x{0.1f, 0.2f, 0.3f, 0.4f};
+  std::vector<double> y{0.5, 0.6, 0.7, 0.8};
+  std::vector<double> w{1., 2., 3., 4.};
+  registry.fillColumns(HIST("x"), gsl::span<const float>(x));
+  BOOST_CHECK_EQUAL(registry.get<TH1>(HIST("x"))->GetEntries(), 4);
+
+  registry.fillColumns(HIST("xy"), gsl::span<const float>(x), gsl::span<const double>(y), gsl::span<const double>(w));
+  BOOST_CHECK_EQUAL(registry.get<TH2>(HIST("xy"))->GetSumOfWeights(), 10.);
+
+  BOOST_CHECK_THROW(registry.fillColumns(HIST("xy"), gsl::span<const float>(x), gsl::span<const double>(y).subspan(1)), o2::framework::RuntimeErrorRef);
+}
@@ -0,0 +1,97 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#include "Framework/CallbackService.h"
+#include "Framework/ControlService.h"
+#include "Framework/EndOfStreamContext.h"
+#include "Framework/RawDeviceService.h"
+#include "Framework/Logger.h"
+#include <FairMQDevice.h>
+
+#include <atomic>
+#include <chrono>
+
+#include "Framework/runDataProcessing.h"
+using namespace o2::framework;
+
+// A source feeds a device which processes up to three timeslices at
+// the same time, taking a different time for each of them. The
+// outputs must still arrive in order and the EndOfStream callback of
+// the device must run once, after all the timeslices were processed.
+constexpr int nTimeslices = 100;
+
+WorkflowSpec defineDataProcessing(ConfigContext const&)
+{
+  return WorkflowSpec{
+    {"A",
+     Inputs{},
+     {OutputSpec{{"a"}, "TST", "A"}},
+     AlgorithmSpec{adaptStateful([]() { return adaptStateless(
+                                          [](DataAllocator& outputs, ControlService& control) {
+                                            static int count = 0;
+                                            auto& aData = outputs.make<int>(OutputRef{"a"});
+                                            aData = count++;
+                                            if (count == nTimeslices) {
+                                              control.endOfStream();
+                                              control.readyToQuit(QuitRequest::Me);
+                                            }
+                                          }); })}},
+    processingStreams({"B",
+                       {InputSpec{"x", "TST", "A", Lifetime::Timeframe}},
+                       {OutputSpec{{"b"}, "TST", "B"}, OutputSpec{{"eos"}, "TST", "EOS"}},
+                       AlgorithmSpec{adaptStateful([](CallbackService& callbacks) {
+                         static std::atomic<int> processed{0};
+                         callbacks.set(CallbackService::Id::EndOfStream, [](EndOfStreamContext& context) {
+                           context.outputs().make<int>(OutputRef{"eos"}) = processed.load();
+                         });
+                         return adaptStateless([](InputRecord& inputs, DataAllocator& outputs, RawDeviceService& device) {
+                           auto& count = inputs.get<int>("x");
+                           device.device()->WaitFor(std::chrono::milliseconds((count * 7) % 5));
+                           auto& bData = outputs.make<int>(OutputRef{"b"});
+                           bData = count;
+                           processed++;
+                         }); })}},
+                      3),
+    {"C",
+     {InputSpec{"y", "TST", "B", Lifetime::Timeframe}},
+     {},
+     AlgorithmSpec{adaptStateful([](CallbackService& callbacks) {
+       static int expected = 0;
+       callbacks.set(CallbackService::Id::EndOfStream, [](EndOfStreamContext&) {
+         if (expected != nTimeslices) {
+           LOGP(ERROR, "Missing messages. Expected: {}, Found {}.", nTimeslices, expected);
+         }
+       });
+       return adaptStateless([](InputRecord& inputs, ControlService& control) {
+         auto& count = inputs.get<int>("y");
+         if (expected != count) {
+           LOGP(ERROR, "Messages out of order. Expected: {}, Found {}.", expected, count);
+           control.readyToQuit(QuitRequest::All);
+         }
+         expected++;
+       }); })}},
+    {"D",
+     {InputSpec{"z", "TST", "EOS", Lifetime::Timeframe}},
+     {},
+     AlgorithmSpec{adaptStateful([](CallbackService& callbacks) {
+       static int received = 0;
+       callbacks.set(CallbackService::Id::EndOfStream, [](EndOfStreamContext&) {
+         if (received != 1) {
+           LOGP(ERROR, "EndOfStream of the streamed device seen {} times.", received);
+         }
+       });
+       return adaptStateless([](InputRecord& inputs) {
+         auto& processed = inputs.get<int>("z");
+         if (processed != nTimeslices) {
+           LOGP(ERROR, "EndOfStream before all the timeslices were processed: {} of {}.", processed, nTimeslices);
+         }
+         received++;
+       }); })}}};
+}
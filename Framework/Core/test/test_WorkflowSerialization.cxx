@@ -53,6 +53,8 @@ BOOST_AUTO_TEST_CASE(TestVerifyWorkflow)
                                     CommonServices::defaultServices(),                                                                                                                          //
                                     {{"label a"}, {"label \"b\""}}}};
 
+  w0[1] = processingStreams(w0[1], 4, false);
+
   std::vector<DataProcessorInfo> metadataOut{
     {"A", "test_Framework_test_SerializationWorkflow", {"foo"}, {ConfigParamSpec{"aBool", VariantType::Bool, true, {"A Bool"}}}},
     {"B", "test_Framework_test_SerializationWorkflow", {"b-bar", "bfoof", "fbdbfaso"}},
@@ -78,5 +80,9 @@ BOOST_AUTO_TEST_CASE(TestVerifyWorkflow)
   BOOST_REQUIRE_EQUAL(w0.size(), 4);
   BOOST_REQUIRE_EQUAL(w0.size(), w1.size());
   BOOST_CHECK_EQUAL(firstDump.str(), secondDump.str());
+  BOOST_CHECK_EQUAL(w1[0].maxStreams, 1);
+  BOOST_CHECK_EQUAL(w1[0].orderedStreams, true);
+  BOOST_CHECK_EQUAL(w1[1].maxStreams, 4);
+  BOOST_CHECK_EQUAL(w1[1].orderedStreams, false);
   BOOST_CHECK_EQUAL(commandInfoIn.command, commandInfoOut.command);
 }
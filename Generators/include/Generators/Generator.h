@@ -91,6 +91,8 @@ class Generator : public FairGenerator
 
   /** notification methods **/
   virtual void notifyEmbedding(const o2::dataformats::MCEventHeader* eventHeader){};
+  /** reseed the random engine internal to the generator (if any) before the next event **/
+  virtual void notifyEventSeed(ULong_t seed){};
 
   void setTriggerOkHook(std::function<void(std::vector<TParticle> const& p, int eventCount)> f) { mTriggerOkHook = f; }
   void setTriggerFalseHook(std::function<void(std::vector<TParticle> const& p, int eventCount)> f) { mTriggerFalseHook = f; }
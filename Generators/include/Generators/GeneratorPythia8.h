@@ -60,6 +60,9 @@ class GeneratorPythia8 : public Generator
   bool readString(std::string val) { return mPythia.readString(val, true); };
   bool readFile(std::string val) { return mPythia.readFile(val, true); };
 
+  /** notification methods **/
+  void notifyEventSeed(ULong_t seed) override { mPythia.rndm.init(1 + seed % 900000000); };
+
   /** utilities **/
   void getNcoll(int& nColl)
   {
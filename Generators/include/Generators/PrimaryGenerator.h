@@ -70,6 +70,15 @@ class PrimaryGenerator : public FairPrimaryGenerator
 
   /** Public embedding methods **/
   Bool_t embedInto(TString fname);
+  /** set the index of the next event to embed into (wrapped around the number of events) **/
+  void setEmbedIndex(Int_t index)
+  {
+    if (mEmbedEntries > 0) {
+      mEmbedIndex = index % mEmbedEntries;
+    }
+  }
+  /** pass the seed of the next event to the random engines internal to the generators **/
+  void setEventSeed(ULong_t seed);
 
  protected:
   /** copy constructor **/
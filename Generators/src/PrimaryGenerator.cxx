@@ -285,6 +285,20 @@ Bool_t PrimaryGenerator::embedInto(TString fname)
   return kTRUE;
 }
 
+/*****************************************************************/
+
+void PrimaryGenerator::setEventSeed(ULong_t seed)
+{
+  /** notify event generators **/
+  auto genList = GetListOfGenerators();
+  for (int igen = 0; igen < genList->GetEntries(); ++igen) {
+    auto o2gen = dynamic_cast<Generator*>(genList->At(igen));
+    if (o2gen) {
+      o2gen->notifyEventSeed(seed);
+    }
+  }
+}
+
 /*****************************************************************/
 /*****************************************************************/
 
@@ -38,6 +38,9 @@
 #include <fstream>
 #include <iostream>
 #include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
 #include "PrimaryServerState.h"
 #include "SimPublishChannelHelper.h"
 #include <chrono>
@@ -57,6 +60,7 @@ class O2PrimaryServerDevice final : public FairMQDevice
   ~O2PrimaryServerDevice() final
   {
     try {
+      stopGeneration();
       if (mGeneratorThread.joinable()) {
         mGeneratorThread.join();
       }
@@ -68,6 +72,19 @@ class O2PrimaryServerDevice final : public FairMQDevice
   }
 
  protected:
+  // a generator instance together with the stack and event header it fills
+  struct GenWorker {
+    o2::eventgen::PrimaryGenerator* primGen = nullptr; // owned by mPrimGeneratorCache
+    std::unique_ptr<o2::data::Stack> stack;
+    o2::dataformats::MCEventHeader eventHeader;
+  };
+
+  // a generated event, waiting in the queue or being served
+  struct GeneratedEvent {
+    std::vector<TParticle> primaries;
+    o2::dataformats::MCEventHeader eventHeader;
+  };
+
   void initGenerator()
   {
     TStopwatch timer;
@@ -89,58 +106,138 @@ class O2PrimaryServerDevice final : public FairMQDevice
     //
     // Not using cached instances for external kinematics since these might change input filenames etc.
     // and are in any case quickly setup.
-    mPrimGen = nullptr;
+    std::vector<o2::eventgen::PrimaryGenerator*> generators;
     if (conf.getGenerator().compare("extkin") != 0 || conf.getGenerator().compare("extkinO2") != 0) {
       auto iter = mPrimGeneratorCache.find(conf.getGenerator());
       if (iter != mPrimGeneratorCache.end()) {
-        mPrimGen = iter->second;
-        LOG(INFO) << "Found cached generator for " << conf.getGenerator();
+        generators = iter->second;
+        LOG(INFO) << "Found " << generators.size() << " cached generator(s) for " << conf.getGenerator();
       }
     }
 
-    if (mPrimGen == nullptr) {
-      mPrimGen = new o2::eventgen::PrimaryGenerator;
-      o2::eventgen::GeneratorFactory::setPrimaryGenerator(conf, mPrimGen);
+    // generators reading their events in sequence from a file or stream can only be run as one instance
+    mNActiveGenWorkers = isSequentialGenerator(conf.getGenerator()) ? 1 : (int)mGenWorkers.size();
+    if (mNActiveGenWorkers < (int)mGenWorkers.size()) {
+      LOG(WARN) << "Generator " << conf.getGenerator() << " reads events in sequence: using a single generator instance";
+    }
+
+    // instances are initialized one after the other (generator setup is not thread-safe)
+    for (int k = (int)generators.size(); k < mNActiveGenWorkers; ++k) {
+      // engines internal to the generators (e.g. Pythia8) take their seed from gRandom
+      gRandom->SetSeed(generationSeed(mInitialSeed, -1 - k));
+      auto primGen = new o2::eventgen::PrimaryGenerator;
+      o2::eventgen::GeneratorFactory::setPrimaryGenerator(conf, primGen);
 
       auto embedinto_filename = conf.getEmbedIntoFileName();
       if (!embedinto_filename.empty()) {
-        mPrimGen->embedInto(embedinto_filename);
+        primGen->embedInto(embedinto_filename);
       }
 
-      mPrimGen->Init();
+      primGen->Init();
+      generators.push_back(primGen);
+    }
+    mPrimGeneratorCache[conf.getGenerator()] = generators;
 
-      mPrimGeneratorCache[conf.getGenerator()] = mPrimGen;
+    for (int k = 0; k < mNActiveGenWorkers; ++k) {
+      mGenWorkers[k]->primGen = generators[k];
+      mGenWorkers[k]->primGen->SetEvent(&mGenWorkers[k]->eventHeader);
     }
-    mPrimGen->SetEvent(&mEventHeader);
 
     LOG(INFO) << "Generator initialization took " << timer.CpuTime() << "s";
     if (mMaxEvents > 0) {
-      generateEvent(); // generate a first event
+      startGeneration(); // start filling the queue of events
     }
   }
 
-  // function generating one event
-  void generateEvent(/*bool changeState = false*/)
+  static bool isSequentialGenerator(std::string const& name)
   {
-    bool changeState = false;
-    LOG(INFO) << "Event generation started ";
-    if (changeState) {
-      stateTransition(O2PrimaryServerState::WaitingEvent, "GENEVENT");
+    return name == "extkin" || name == "extkinO2" || name == "hepmc";
+  }
+
+  // seed of the random sequence used to generate an event (negative IDs for the generator
+  // instances): a splitmix64 step, decorrelating it from the transport seed mInitialSeed + eventID
+  static ULong_t generationSeed(int initialSeed, int eventID)
+  {
+    uint64_t z = ((uint64_t)(uint32_t)initialSeed << 32) + (uint32_t)eventID + 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    z = (z ^ (z >> 31)) & 0xffffffff;
+    return z == 0 ? 1 : z; // 0 would ask TRandom3 for a random seed
+  }
+
+  // launches the generator instances, instance k generating the events k+1, k+1+n, ...
+  // so that the content of an event only depends on its number (for a given number n of instances)
+  void startGeneration()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mQueueMutex);
+      mEventQueue.clear();
+      mStopGeneration = false;
+    }
+    for (int k = 0; k < mNActiveGenWorkers; ++k) {
+      mGenThreads.emplace_back(&O2PrimaryServerDevice::generateEvents, this, k);
     }
+  }
+
+  void stopGeneration()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mQueueMutex);
+      mStopGeneration = true;
+    }
+    mQueueCondition.notify_all();
+    for (auto& t : mGenThreads) {
+      if (t.joinable()) {
+        t.join();
+      }
+    }
+    mGenThreads.clear();
+  }
+
+  // loop of one generator instance; it runs at most mQueueCapacity events ahead of the served ones
+  void generateEvents(int k)
+  {
+    auto& worker = *mGenWorkers[k];
+    for (int eventID = k + 1; eventID <= mMaxEvents; eventID += mNActiveGenWorkers) {
+      {
+        std::unique_lock<std::mutex> lock(mQueueMutex);
+        mQueueCondition.wait(lock, [this, eventID]() { return mStopGeneration || eventID <= mEventCounter + mQueueCapacity; });
+        if (mStopGeneration) {
+          return;
+        }
+      }
+      generateEvent(worker, eventID);
+      {
+        std::lock_guard<std::mutex> lock(mQueueMutex);
+        auto& event = mEventQueue[eventID];
+        event.primaries = worker.stack->getPrimaries();
+        event.eventHeader = worker.eventHeader;
+      }
+      mQueueCondition.notify_all();
+    }
+  }
+
+  // function generating one event
+  void generateEvent(GenWorker& worker, int eventID)
+  {
+    LOG(INFO) << "Event generation started for event " << eventID;
     TStopwatch timer;
     timer.Start();
+    // gRandom is a per-thread engine, reseeded such that the event does not depend on the instance generating it
+    // the same holds for the engines internal to the generators (e.g. Pythia8)
+    gRandom->SetSeed(generationSeed(mInitialSeed, eventID));
+    worker.primGen->setEventSeed(generationSeed(mInitialSeed, eventID));
+    worker.primGen->setEmbedIndex(eventID - 1);
     try {
-      mStack->Reset();
-      mPrimGen->GenerateEvent(mStack);
+      worker.stack->Reset();
+      worker.primGen->GenerateEvent(worker.stack.get());
     } catch (std::exception const& e) {
       LOG(ERROR) << " Exception occurred during event gen ";
     }
     timer.Stop();
-    LOG(INFO) << "Event generation took " << timer.CpuTime() << "s"
-              << " and produced " << mStack->getPrimaries().size() << " primaries ";
-    if (changeState) {
-      stateTransition(O2PrimaryServerState::ReadyToServe, "GENEVENT");
-    }
+    // CpuTime is process wide and would include the other generator threads
+    LOG(INFO) << "Event generation took " << timer.RealTime() << "s"
+              << " and produced " << worker.stack->getPrimaries().size() << " primaries ";
   }
 
   // launches a thread that listens for status requests from outside asynchronously
@@ -204,8 +301,14 @@ class O2PrimaryServerDevice final : public FairMQDevice
     // from now on mSimConfig should be used within this process
     mSimConfig = conf;
 
-    mStack = new o2::data::Stack();
-    mStack->setExternalMode(true);
+    // one stack per generator instance; the queue holds up to 2 events per instance in advance
+    for (int k = 0; k < std::max(1, conf.getNGenWorkers()); ++k) {
+      auto& worker = mGenWorkers.emplace_back(std::make_unique<GenWorker>());
+      worker->stack = std::make_unique<o2::data::Stack>();
+      worker->stack->setExternalMode(true);
+    }
+    mQueueCapacity = 2 * mGenWorkers.size();
+    LOG(INFO) << "GENERATOR INSTANCES SET TO " << mGenWorkers.size();
 
     // MC ENGINE
     LOG(INFO) << "ENGINE SET TO " << vm["mcEngine"].as<std::string>();
@@ -213,6 +316,9 @@ class O2PrimaryServerDevice final : public FairMQDevice
     mChunkGranularity = vm["chunkSize"].as<unsigned int>();
     LOG(INFO) << "CHUNK SIZE SET TO " << mChunkGranularity;
 
+    // generator instances run in parallel threads: give each its own engine behind gRandom
+    gRandom = new o2::utils::ThreadLocalRandom();
+
     // initial initial seed --> we should store this somewhere
     mInitialSeed = vm["seed"].as<int>();
     mInitialSeed = o2::utils::RngHelper::setGRandomSeed(mInitialSeed);
@@ -282,6 +388,7 @@ class O2PrimaryServerDevice final : public FairMQDevice
     mSimConfig.getConfigData().mTrigger = reconfig.trigger;
     mSimConfig.getConfigData().mExtKinFileName = reconfig.extKinfileName;
 
+    stopGeneration();
     mEventCounter = 0;
     mPartCounter = 0;
     mNeedNewEvent = true;
@@ -398,37 +505,36 @@ class O2PrimaryServerDevice final : public FairMQDevice
     reply.AddPart(std::move(headermsg));
 
     LOG(INFO) << "Received request for work " << mEventCounter << " " << mMaxEvents << " " << mNeedNewEvent << " available " << workavailable;
-    if (mNeedNewEvent) {
-      // we need a newly generated event now
-      if (mGeneratorThread.joinable()) {
-        try {
-          mGeneratorThread.join();
-        } catch (std::exception const& e) {
-          LOG(WARN) << "Exception during thread join ..ignoring";
-        }
+    if (mNeedNewEvent && workavailable) {
+      // we need the next event from the queue now (waiting for its generation if needed)
+      {
+        std::unique_lock<std::mutex> lock(mQueueMutex);
+        mQueueCondition.wait(lock, [this]() { return mEventQueue.count(mEventCounter + 1) > 0; });
+        auto iter = mEventQueue.find(mEventCounter + 1);
+        mCurrentEvent = std::move(iter->second);
+        mEventQueue.erase(iter);
+        mNeedNewEvent = false;
+        mPartCounter = 0;
+        mEventCounter++;
       }
-      mNeedNewEvent = false;
-      mPartCounter = 0;
-      mEventCounter++;
+      mQueueCondition.notify_all(); // a place in the queue became free
     }
 
-    auto& prims = mStack->getPrimaries();
+    auto& prims = mCurrentEvent.primaries;
     auto numberofparts = (int)std::ceil(prims.size() / (1. * mChunkGranularity));
     // number of parts should be at least 1 (even if empty)
     numberofparts = std::max(1, numberofparts);
 
     LOG(INFO) << "Have " << prims.size() << " " << numberofparts;
 
-    o2::data::PrimaryChunk m;
     o2::data::SubEventInfo i;
     i.eventID = workavailable ? mEventCounter : -1;
     i.maxEvents = mMaxEvents;
     i.part = mPartCounter + 1;
     i.nparts = numberofparts;
     i.seed = mEventCounter + mInitialSeed;
-    i.index = m.mParticles.size();
-    i.mMCEventHeader = mEventHeader;
-    m.mSubEventInfo = i;
+    i.index = 0;
+    i.mMCEventHeader = mCurrentEvent.eventHeader;
 
     if (workavailable) {
       int endindex = prims.size() - mPartCounter * mChunkGranularity;
@@ -442,11 +548,14 @@ class O2PrimaryServerDevice final : public FairMQDevice
         endindex = 0;
       }
 
+      // the particles are sent as a flat array (reserving at least one element for a valid buffer address)
+      auto particles = new std::vector<o2::data::FlatPrimary>();
+      particles->reserve(std::max(1, endindex - startindex));
       for (int index = startindex; index < endindex; ++index) {
-        m.mParticles.emplace_back(prims[index]);
+        particles->emplace_back(prims[index]);
       }
 
-      LOG(INFO) << "Sending " << m.mParticles.size() << " particles";
+      LOG(INFO) << "Sending " << particles->size() << " particles";
       LOG(INFO) << "treating ev " << mEventCounter << " part " << i.part << " out of " << i.nparts;
 
       // feedback to driver if new event started
@@ -458,18 +567,23 @@ class O2PrimaryServerDevice final : public FairMQDevice
       mPartCounter++;
       if (mPartCounter == numberofparts) {
         mNeedNewEvent = true;
-        // start generation of a new event
-        mGeneratorThread = std::thread(&O2PrimaryServerDevice::generateEvent, this);
       }
 
+      // the sub-event info (holding the event header) still goes through ROOT serialization
       TMessage* tmsg = new TMessage(kMESS_OBJECT);
-      tmsg->WriteObjectAny((void*)&m, TClass::GetClass("o2::data::PrimaryChunk"));
+      tmsg->WriteObjectAny((void*)&i, TClass::GetClass("o2::data::SubEventInfo"));
 
       auto free_tmessage = [](void* data, void* hint) { delete static_cast<TMessage*>(hint); };
 
       std::unique_ptr<FairMQMessage> message(channel.NewMessage(tmsg->Buffer(), tmsg->BufferSize(), free_tmessage, tmsg));
 
       reply.AddPart(std::move(message));
+
+      auto free_particles = [](void* data, void* hint) { delete static_cast<std::vector<o2::data::FlatPrimary>*>(hint); };
+
+      std::unique_ptr<FairMQMessage> particlemessage(channel.NewMessage(particles->data(), particles->size() * sizeof(o2::data::FlatPrimary), free_particles, particles));
+
+      reply.AddPart(std::move(particlemessage));
     }
 
     // send answer
@@ -542,10 +656,16 @@ class O2PrimaryServerDevice final : public FairMQDevice
 
  private:
   o2::conf::SimConfig mSimConfig = o2::conf::SimConfig::Instance(); // local sim config object
-  o2::eventgen::PrimaryGenerator* mPrimGen = nullptr;               // the current primary generator
-  o2::dataformats::MCEventHeader mEventHeader;
-  o2::data::Stack* mStack = nullptr; // the stack which is filled (pointer since constructor to be called only init method)
-  int mChunkGranularity = 500;       // how many primaries to send to a worker
+  std::vector<std::unique_ptr<GenWorker>> mGenWorkers;              // the generator instances (stable addresses for the event headers)
+  int mNActiveGenWorkers = 1;                                       // how many of them are used by the current generator
+  std::vector<std::thread> mGenThreads;                             //! threads running the generator instances
+  std::map<int, GeneratedEvent> mEventQueue;                        // pre-generated events by event number
+  GeneratedEvent mCurrentEvent;                                     // the event currently served
+  std::mutex mQueueMutex;                                           // guards mEventQueue, mEventCounter updates and mStopGeneration
+  std::condition_variable mQueueCondition;
+  int mQueueCapacity = 2;       // how many events may be generated ahead of the served ones
+  bool mStopGeneration = false; // asks the generator threads to finish
+  int mChunkGranularity = 500;  // how many primaries to send to a worker
   int mPartCounter = 0;
   bool mNeedNewEvent = true;
   int mMaxEvents = 2;
@@ -563,7 +683,7 @@ class O2PrimaryServerDevice final : public FairMQDevice
   // TODO: some care needs to be taken (or the user warned) that the caching is based on generator name
   //       and that parameter-based reconfiguration is not yet implemented (for which we would need to hash all
   //       configuration parameters as well)
-  std::map<std::string, o2::eventgen::PrimaryGenerator*> mPrimGeneratorCache;
+  std::map<std::string, std::vector<o2::eventgen::PrimaryGenerator*>> mPrimGeneratorCache;
 
   std::atomic<O2PrimaryServerState> mState{O2PrimaryServerState::Initializing};
   std::atomic<int> mWaitingControlInput{0};
@@ -227,28 +227,32 @@ class O2SimDevice final : public FairMQDevice
           }
           return false;
         } else {
-          auto payload = std::move(reply.At(1));
+          // the payload is the sub-event info (as TMessage) followed by the particles as flat array
+          auto infopayload = std::move(reply.At(1));
+          auto particlepayload = std::move(reply.At(2));
           // wrap incoming bytes as a TMessageWrapper which offers "adoption" of a buffer
-          auto message = new TMessageWrapper(payload->GetData(), payload->GetSize());
-          auto chunk = static_cast<o2::data::PrimaryChunk*>(message->ReadObjectAny(message->GetClass()));
+          auto message = new TMessageWrapper(infopayload->GetData(), infopayload->GetSize());
+          auto subeventinfo = static_cast<o2::data::SubEventInfo*>(message->ReadObjectAny(message->GetClass()));
+          std::vector<TParticle> particles;
+          o2::data::decodePrimaries(particlepayload->GetData(), particlepayload->GetSize(), particles);
 
           bool goon = true;
           // no particles and eventID == -1 --> indication for no more work
-          if (chunk->mParticles.size() == 0 && chunk->mSubEventInfo.eventID == -1) {
+          if (particles.size() == 0 && subeventinfo->eventID == -1) {
             LOG(INFO) << workerStr() << " No particles in reply : quitting kernel";
             goon = false;
           }
 
           if (goon) {
-            mVMCApp->setPrimaries(chunk->mParticles);
+            mVMCApp->setPrimaries(particles);
 
-            auto info = chunk->mSubEventInfo;
+            auto info = *subeventinfo;
             mVMCApp->setSubEventInfo(&info);
 
-            LOG(INFO) << workerStr() << " Processing " << chunk->mParticles.size() << " primary particles "
+            LOG(INFO) << workerStr() << " Processing " << particles.size() << " primary particles "
                       << "for event " << info.eventID << "/" << info.maxEvents << " "
                       << "part " << info.part << "/" << info.nparts;
-            gRandom->SetSeed(chunk->mSubEventInfo.seed);
+            gRandom->SetSeed(info.seed);
 
             // Process one event
             auto& conf = o2::conf::SimConfig::Instance();
@@ -269,7 +273,7 @@ class O2SimDevice final : public FairMQDevice
                       << sysinfo.GetMaxMemory() << " MB\n";
           }
           delete message;
-          delete chunk;
+          delete subeventinfo;
         }
       } else {
         LOG(INFO) << workerStr() << " No primary answer received from server (within timeout). Return code " << code;